@@ -1,4 +1,4 @@
-from .async_wrapper import check_rug_pull
+from .async_wrapper import check_rug_pull, check_rug_pull_batch
 
 
-__all__ = ["check_rug_pull"]
+__all__ = ["check_rug_pull", "check_rug_pull_batch"]
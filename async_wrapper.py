@@ -1,21 +1,33 @@
 import asyncio
 from functools import partial
-from typing import Dict
-from .rugpull_detector import check_rug_pull_sync
+from typing import Dict, List
+from .rugpull_detector import check_rug_pull_async
+from .rugpull_detector import check_rug_pull_batch as check_rug_pull_batch_sync
 
 
 async def check_rug_pull(
     mint_address: str, redis_url: str = "redis://localhost"
 ) -> Dict:
     """
-    Async wrapper for the rug pull detector.
+    Async rug pull check. The C++ side pipelines the fetch on a shared
+    event-loop driven Redis client and completes the returned future itself,
+    so no thread is tied up per call.
     """
-    loop = asyncio.get_running_loop()
     try:
-        # Run sync function in a thread pool
-        result = await loop.run_in_executor(
-            None, partial(check_rug_pull_sync, mint_address, redis_url)
-        )
-        return result
+        return await check_rug_pull_async(mint_address, redis_url)
     except Exception as e:
         return {"rug_pulled": False, "timestamp": None, "debug_info": {"error": str(e)}}
+
+
+async def check_rug_pull_batch(
+    mint_addresses: List[str], redis_url: str = "redis://localhost", max_threads: int = 0
+) -> Dict:
+    """
+    Async wrapper for the batch detector. The C++ side releases the GIL and
+    parallelises internally, so one executor thread covers the whole scan.
+    """
+    loop = asyncio.get_running_loop()
+    return await loop.run_in_executor(
+        None,
+        partial(check_rug_pull_batch_sync, mint_addresses, redis_url, max_threads),
+    )
@@ -0,0 +1,254 @@
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "bar_detector.hpp"
+#include "detection_config.hpp"
+#include "mint_scorer.hpp"
+#include "rug_pull_detector.hpp"
+#include "simd_kernels.hpp"
+#include "synthetic_trades.hpp"
+#include "trade_columns.hpp"
+#include "window_stats.hpp"
+
+namespace {
+
+// Window queries per iteration for the per-window stages
+constexpr size_t WINDOW_SAMPLES = 1024;
+
+struct Fixture {
+  std::vector<Trade> trades;
+  TradeColumns columns;
+  std::vector<int64_t> sample_times; // window end points, spread evenly
+};
+
+Fixture makeFixture(const benchmark::State &state) {
+  Fixture fixture;
+  fixture.trades = makeSyntheticTrades(static_cast<MintShape>(state.range(0)),
+                                       static_cast<size_t>(state.range(1)));
+  fixture.columns.reserve(fixture.trades.size());
+  for (const auto &trade : fixture.trades)
+    fixture.columns.push_back(trade);
+
+  const size_t count = fixture.columns.size();
+  for (size_t s = 0; s < WINDOW_SAMPLES; ++s)
+    fixture.sample_times.push_back(
+        fixture.columns.timestamp_us(s * (count - 1) / (WINDOW_SAMPLES - 1)));
+  return fixture;
+}
+
+void setLabel(benchmark::State &state) {
+  state.SetLabel(shapeName(static_cast<MintShape>(state.range(0))));
+}
+
+// Binary-searched window lookup
+void BM_GetRecentTrades(benchmark::State &state) {
+  const auto fixture = makeFixture(state);
+  const auto series = fixture.columns.view();
+  const int64_t start = fixture.columns.timestamp_us(0);
+  for (auto _ : state) {
+    for (int64_t now : fixture.sample_times) {
+      auto window = getRecentTrades(series, start, now,
+                                    DetectionConfig::max_detection_time);
+      benchmark::DoNotOptimize(window.timestamp_us.data());
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * WINDOW_SAMPLES);
+  setLabel(state);
+}
+
+// Full-scan stats over each sampled window
+void BM_ComputeWindowStats(benchmark::State &state) {
+  const auto fixture = makeFixture(state);
+  const auto series = fixture.columns.view();
+  const int64_t start = fixture.columns.timestamp_us(0);
+  std::vector<TradeSeries> windows;
+  for (int64_t now : fixture.sample_times)
+    windows.push_back(getRecentTrades(series, start, now,
+                                      DetectionConfig::max_detection_time));
+
+  size_t window_trades = 0;
+  for (auto _ : state) {
+    for (const auto &window : windows) {
+      auto stats = computeWindowStats(window);
+      benchmark::DoNotOptimize(stats);
+      window_trades += window.size();
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * WINDOW_SAMPLES);
+  state.counters["avg_window"] =
+      static_cast<double>(window_trades) /
+      static_cast<double>(state.iterations() * WINDOW_SAMPLES);
+  setLabel(state);
+}
+
+// Incremental window walked over every trade, as processTrades drives it
+void BM_SlidingWindowPass(benchmark::State &state) {
+  const auto fixture = makeFixture(state);
+  const auto series = fixture.columns.view();
+  const int64_t start = fixture.columns.timestamp_us(0);
+  for (auto _ : state) {
+    SlidingWindowStats window;
+    for (size_t i = 0; i < series.size(); ++i) {
+      window.advance(series, start, series.timestamp_us[i],
+                     DetectionConfig::max_detection_time);
+      if (window.size() > 1)
+        benchmark::DoNotOptimize(window.stats(series));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * series.size());
+  setLabel(state);
+}
+
+// addTrade for every trade plus one processTrades, from a fresh detector.
+// Mints that trigger stop scanning early, as in production.
+void BM_ProcessTrades(benchmark::State &state) {
+  const auto fixture = makeFixture(state);
+  bool detected = false;
+  for (auto _ : state) {
+    RugPullDetector detector;
+    for (auto trade : fixture.trades)
+      detector.addTrade(std::move(trade));
+    detected = detector.processTrades(DetectionConfig{}).rug_pulled;
+    benchmark::DoNotOptimize(detected);
+  }
+  state.SetItemsProcessed(state.iterations() * fixture.trades.size());
+  state.counters["detected"] = detected;
+  setLabel(state);
+}
+
+// One-shot detection per trade, against the same trades scored on 1s bar
+// close: the first costs work per trade, the second per elapsed second
+void BM_DetectPerTrade(benchmark::State &state) {
+  const auto fixture = makeFixture(state);
+  const auto series = fixture.columns.view();
+  bool detected = false;
+  for (auto _ : state) {
+    detected = RugPullDetector::detect(series, DetectionConfig{}).rug_pulled;
+    benchmark::DoNotOptimize(detected);
+  }
+  state.SetItemsProcessed(state.iterations() * series.size());
+  state.counters["detected"] = detected;
+  setLabel(state);
+}
+
+void BM_DetectOnBars(benchmark::State &state) {
+  const auto fixture = makeFixture(state);
+  const auto series = fixture.columns.view();
+  bool detected = false;
+  for (auto _ : state) {
+    detected = BarDetector::detect(series, std::chrono::seconds(1),
+                                   DetectionConfig{})
+                   .rug_pulled;
+    benchmark::DoNotOptimize(detected);
+  }
+  state.SetItemsProcessed(state.iterations() * series.size());
+  state.counters["detected"] = detected;
+  state.counters["bars"] = static_cast<double>(
+      countBars(series, std::chrono::seconds(1)));
+  setLabel(state);
+}
+
+// One tick of a scanner: current features of state.range(0) mints, about
+// a tenth of them without a pattern window yet
+MintFeatureColumns makeMintFeatures(size_t count) {
+  std::mt19937 rng(11);
+  std::uniform_real_distribution<double> drop(0.0, 0.5);
+  std::uniform_int_distribution<int> seconds(0, 200);
+  std::uniform_real_distribution<double> signal(0.0, 2.0);
+  MintFeatureColumns features;
+  features.resize(count);
+  for (size_t i = 0; i < count; ++i) {
+    const bool has_window = i % 10 != 0;
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    features.set(i, drop(rng), seconds(rng), has_window ? signal(rng) : nan,
+                 has_window ? signal(rng) : nan);
+  }
+  return features;
+}
+
+// The per-mint rule as scan applies it, one mint at a time
+void BM_ScoreMintsOneByOne(benchmark::State &state) {
+  const auto features = makeMintFeatures(static_cast<size_t>(state.range(0)));
+  const DetectionParams config;
+  MintScores scores;
+  scores.confidence.resize(features.size());
+  scores.trigger.resize(features.size());
+  for (auto _ : state) {
+    for (size_t i = 0; i < features.size(); ++i) {
+      if (features.drop[i] >= config.stop_loss_threshold) {
+        scores.confidence[i] = 1.0;
+        scores.trigger[i] = SweepTrigger::StopLoss;
+        continue;
+      }
+      scores.confidence[i] = RugPullDetector::calculateConfidence(
+          features.drop[i], features.time_since_peak[i],
+          features.pattern_strength[i], features.volume_trend[i], config);
+      scores.trigger[i] = !std::isnan(features.pattern_strength[i]) &&
+                                  scores.confidence[i] >=
+                                      config.min_confidence_score
+                              ? SweepTrigger::Pattern
+                              : SweepTrigger::None;
+    }
+    benchmark::DoNotOptimize(scores.confidence.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * features.size());
+}
+
+void BM_ScoreMints(benchmark::State &state) {
+  const auto features = makeMintFeatures(static_cast<size_t>(state.range(0)));
+  const DetectionParams config;
+  MintScores scores;
+  for (auto _ : state) {
+    scoreMints(features, config, scores);
+    benchmark::DoNotOptimize(scores.confidence.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * features.size());
+  state.SetLabel(simd::kernels().name);
+}
+
+// Shapes x sizes from 100 to 1M trades
+void shapeSizeArgs(benchmark::internal::Benchmark *bench) {
+  for (auto shape : ALL_MINT_SHAPES) {
+    for (int64_t trades : {100, 1000, 10000, 100000, 1000000}) {
+      bench->Args({static_cast<int64_t>(shape), trades});
+    }
+  }
+  bench->ArgNames({"shape", "trades"});
+}
+
+} // namespace
+
+BENCHMARK(BM_GetRecentTrades)
+    ->Apply(shapeSizeArgs)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_ComputeWindowStats)
+    ->Apply(shapeSizeArgs)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_SlidingWindowPass)
+    ->Apply(shapeSizeArgs)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_ProcessTrades)->Apply(shapeSizeArgs)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_DetectPerTrade)
+    ->Apply(shapeSizeArgs)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_DetectOnBars)
+    ->Apply(shapeSizeArgs)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_ScoreMintsOneByOne)
+    ->ArgName("mints")
+    ->Arg(1000)
+    ->Arg(100000)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_ScoreMints)
+    ->ArgName("mints")
+    ->Arg(1000)
+    ->Arg(100000)
+    ->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,88 @@
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "detector_registry.hpp"
+#include "rug_pull_detector.hpp"
+
+namespace {
+
+constexpr size_t TRADES_PER_MINT = 8;
+// Walks the mints in a scattered order so the table is not read
+// sequentially; odd, so it visits every mint for power-of-ten counts
+constexpr size_t MINT_STRIDE = 7919;
+
+std::vector<std::string> makeMintNames(size_t count) {
+  std::vector<std::string> names;
+  names.reserve(count);
+  for (size_t i = 0; i < count; ++i)
+    names.push_back("recent_trades:Mint" + std::to_string(i * 2654435761u));
+  return names;
+}
+
+// Steadily rising market cap at constant volume, so nothing is detected
+// and every update runs the full detection step
+Trade nextTrade(int64_t &clock_us) {
+  clock_us += 1000;
+  return {fromMicros(clock_us), 100.0 + static_cast<double>(clock_us) * 1e-9,
+          1.0};
+}
+
+// One new trade for one of N tracked mints
+void BM_RegistryUpdate(benchmark::State &state) {
+  const auto mints = static_cast<size_t>(state.range(0));
+  const auto names = makeMintNames(mints);
+  DetectorRegistry registry;
+  int64_t clock_us = 1739184338LL * MICROS_PER_SECOND;
+  for (size_t t = 0; t < TRADES_PER_MINT; ++t) {
+    for (const auto &name : names) {
+      const Trade trade = nextTrade(clock_us);
+      registry.update(name, {&trade, 1}, 0.0, DetectionParams{});
+    }
+  }
+
+  size_t next = 0;
+  for (auto _ : state) {
+    const Trade trade = nextTrade(clock_us);
+    next = (next + MINT_STRIDE) % mints;
+    benchmark::DoNotOptimize(
+        registry.update(names[next], {&trade, 1}, 0.0, DetectionParams{}));
+  }
+  state.SetItemsProcessed(state.iterations());
+  state.counters["bytes_per_mint"] = registry.stats().bytesPerMint();
+}
+BENCHMARK(BM_RegistryUpdate)->RangeMultiplier(10)->Range(1000, 100'000);
+
+// What the live monitor did before: a node-based map of full detectors,
+// each reserving INITIAL_TRADE_BUFFER trades
+void BM_DetectorMapUpdate(benchmark::State &state) {
+  const auto mints = static_cast<size_t>(state.range(0));
+  const auto names = makeMintNames(mints);
+  std::unordered_map<std::string, std::unique_ptr<RugPullDetector>> detectors;
+  int64_t clock_us = 1739184338LL * MICROS_PER_SECOND;
+  for (size_t t = 0; t < TRADES_PER_MINT; ++t) {
+    for (const auto &name : names) {
+      auto &detector = detectors[name];
+      if (!detector)
+        detector = std::make_unique<RugPullDetector>();
+      detector->addTrade(nextTrade(clock_us));
+      detector->processTrades(DetectionParams{});
+    }
+  }
+
+  size_t next = 0;
+  for (auto _ : state) {
+    next = (next + MINT_STRIDE) % mints;
+    auto &detector = *detectors.find(names[next])->second;
+    detector.addTrade(nextTrade(clock_us));
+    benchmark::DoNotOptimize(detector.processTrades(DetectionParams{}));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+// 100k detectors would reserve ~2.4 GB up front
+BENCHMARK(BM_DetectorMapUpdate)->RangeMultiplier(10)->Range(1000, 10'000);
+
+} // namespace
@@ -0,0 +1,86 @@
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "parameter_sweep.hpp"
+#include "rug_pull_detector.hpp"
+#include "synthetic_trades.hpp"
+
+namespace {
+
+constexpr size_t SWEEP_MINTS = 64;
+constexpr size_t TRADES_PER_MINT = 2000;
+
+// Every other mint dumps in its second half
+std::vector<TradeColumns> makeCorpus() {
+  std::vector<TradeColumns> corpus(SWEEP_MINTS);
+  for (size_t m = 0; m < SWEEP_MINTS; ++m) {
+    corpus[m].reserve(TRADES_PER_MINT);
+    for (const auto &trade : makeRandomWalkTrades(
+             static_cast<uint32_t>(m), TRADES_PER_MINT, m % 2 == 0))
+      corpus[m].push_back(trade);
+  }
+  return corpus;
+}
+
+std::vector<DetectionParams> makeGrid(size_t size) {
+  std::vector<DetectionParams> grid(size);
+  for (size_t i = 0; i < size; ++i) {
+    const auto step = [i](size_t stride) {
+      return static_cast<double>(i / stride % 10);
+    };
+    grid[i].min_confidence_score = 0.3 + 0.06 * step(1);
+    grid[i].stop_loss_threshold = 0.1 + 0.05 * step(10);
+    grid[i].pattern_strength_threshold = 0.2 + 0.05 * step(100);
+  }
+  return grid;
+}
+
+// One full detector pass per (config, mint), as a script looping over
+// check calls would do it
+void BM_SweepDetectorPerConfig(benchmark::State &state) {
+  const auto corpus = makeCorpus();
+  const auto grid = makeGrid(static_cast<size_t>(state.range(0)));
+  for (auto _ : state) {
+    size_t hits = 0;
+    for (const auto &config : grid) {
+      for (const auto &columns : corpus) {
+        RugPullDetector detector;
+        for (size_t i = 0; i < columns.size(); ++i) {
+          detector.addTrade({fromMicros(columns.timestamp_us(i)),
+                             columns.market_cap_sol(i),
+                             columns.sol_amount(i)});
+        }
+        hits += detector.processTrades(config).rug_pulled;
+      }
+    }
+    benchmark::DoNotOptimize(hits);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0) * SWEEP_MINTS);
+}
+
+void BM_SweepEngine(benchmark::State &state) {
+  const auto corpus = makeCorpus();
+  std::vector<TradeSeries> mints;
+  for (const auto &columns : corpus)
+    mints.push_back(columns.view());
+  const auto grid = makeGrid(static_cast<size_t>(state.range(0)));
+  for (auto _ : state) {
+    auto results = runParameterSweep(mints, grid, 1);
+    benchmark::DoNotOptimize(results.at(0, 0));
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0) * SWEEP_MINTS);
+}
+
+} // namespace
+
+// items/s is (config, mint) evaluations per second, single-threaded
+BENCHMARK(BM_SweepDetectorPerConfig)
+    ->Arg(10)
+    ->Arg(100)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_SweepEngine)
+    ->Arg(10)
+    ->Arg(100)
+    ->Arg(1000)
+    ->Unit(benchmark::kMillisecond);
@@ -0,0 +1,141 @@
+#include <condition_variable>
+#include <mutex>
+#include <string>
+
+#include <benchmark/benchmark.h>
+#include <spdlog/spdlog.h>
+#include <sw/redis++/redis++.h>
+
+#include "async_check_pool.hpp"
+#include "async_redis_client.hpp"
+#include "key_worker.hpp"
+#include "redis_bench_utils.hpp"
+#include "redis_client.hpp"
+
+namespace {
+
+// Repeated single-mint checks, the way check_rug_pull_sync issues them.
+// Reports wall time per check and TCP connections accepted by the server
+// per check.
+template <typename Check>
+void runRepeatedChecks(benchmark::State &state, Check &&check) {
+  spdlog::set_level(spdlog::level::warn);
+  try {
+    sw::redis::Redis redis(benchRedisUrl());
+    const auto key = populateBenchKey(redis, 100);
+
+    const long long before = serverStat(redis, "total_connections_received");
+    for (auto _ : state) {
+      auto trades = check(key);
+      benchmark::DoNotOptimize(trades.data());
+    }
+    const long long connections =
+        serverStat(redis, "total_connections_received") - before;
+
+    state.counters["connects_per_check"] = benchmark::Counter(
+        static_cast<double>(connections) /
+        static_cast<double>(state.iterations()));
+    redis.del(key);
+  } catch (const sw::redis::Error &e) {
+    state.SkipWithError(e.what());
+  }
+}
+
+// Previous behaviour: a new client (and connection) per call
+void BM_CheckNewClientPerCall(benchmark::State &state) {
+  runRepeatedChecks(state, [](const std::string &key) {
+    RedisClient client(benchRedisUrl());
+    return client.getTrades(key);
+  });
+}
+
+void BM_CheckSharedClient(benchmark::State &state) {
+  runRepeatedChecks(state, [](const std::string &key) {
+    return RedisClientRegistry::instance().get(benchRedisUrl())->getTrades(key);
+  });
+}
+
+// Checks in flight at once, as check_rug_pull_async sees them from
+// asyncio.gather over many mints
+constexpr size_t CONCURRENT_CHECKS = 10'000;
+// Trades per key; enough that decoding, not the round trip, dominates
+constexpr size_t CONCURRENT_CHECK_TRADES = 1000;
+
+// Issue CONCURRENT_CHECKS checks at once through issue(key, done) and wait
+// for every done. Reports checks per second.
+template <typename Issue>
+void runConcurrentChecks(benchmark::State &state, Issue &&issue) {
+  spdlog::set_level(spdlog::level::warn);
+  try {
+    sw::redis::Redis redis(benchRedisUrl());
+    const auto key = populateBenchKey(redis, CONCURRENT_CHECK_TRADES);
+
+    std::mutex mutex;
+    std::condition_variable all_done;
+    size_t done = 0;
+    const auto finish = [&] {
+      std::lock_guard lock(mutex);
+      if (++done == CONCURRENT_CHECKS)
+        all_done.notify_one();
+    };
+    for (auto _ : state) {
+      done = 0;
+      for (size_t i = 0; i < CONCURRENT_CHECKS; ++i)
+        issue(key, finish);
+      std::unique_lock lock(mutex);
+      all_done.wait(lock, [&] { return done == CONCURRENT_CHECKS; });
+    }
+    state.SetItemsProcessed(state.iterations() * CONCURRENT_CHECKS);
+    redis.del(key);
+  } catch (const sw::redis::Error &e) {
+    state.SkipWithError(e.what());
+  }
+}
+
+// Previous design: decode and detect in the reply callback, on the
+// client's one I/O thread
+void BM_ConcurrentChecksOnLoopThread(benchmark::State &state) {
+  RedisClientOptions options;
+  options.pool_size = 4;
+  AsyncRedisClient client(benchRedisUrl(), options);
+  runConcurrentChecks(state, [&](const std::string &key, const auto &finish) {
+    client.command({"ZRANGE", key, "0", "-1", "WITHSCORES"},
+                   [&finish](const redisReply *reply, std::string_view) {
+                     thread_local KeyWorker worker;
+                     if (reply)
+                       benchmark::DoNotOptimize(
+                           worker.check(*reply, DetectionParams{}));
+                     finish();
+                   });
+  });
+}
+
+// The I/O thread hands replies to an AsyncCheckPool of range(0) threads
+void BM_ConcurrentChecksOnPool(benchmark::State &state) {
+  RedisClientOptions options;
+  options.pool_size = 4;
+  AsyncRedisClient client(benchRedisUrl(), options);
+  AsyncCheckPool pool(static_cast<size_t>(state.range(0)));
+  runConcurrentChecks(state, [&](const std::string &key, const auto &finish) {
+    pool.check(client, key, DetectionParams{},
+               [&finish](const KeyWorker::Check &check, std::string_view) {
+                 benchmark::DoNotOptimize(check);
+                 finish();
+               });
+  });
+}
+
+} // namespace
+
+BENCHMARK(BM_CheckNewClientPerCall)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_CheckSharedClient)->Unit(benchmark::kMicrosecond);
+// items/s is checks per second with CONCURRENT_CHECKS in flight
+BENCHMARK(BM_ConcurrentChecksOnLoopThread)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+BENCHMARK(BM_ConcurrentChecksOnPool)
+    ->Arg(1)
+    ->Arg(2)
+    ->Arg(4)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
@@ -0,0 +1,139 @@
+#include <algorithm>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <nlohmann/json.hpp>
+#include <spdlog/spdlog.h>
+#include <sw/redis++/redis++.h>
+
+#include "redis_bench_utils.hpp"
+#include "redis_client.hpp"
+#include "rug_pull_detector.hpp"
+
+namespace {
+
+// Fetch path before ZRANGE ... WITHSCORES: key diagnostics, a bare ZRANGE,
+// then one ZSCORE round trip per member and a re-sort
+std::vector<Trade> legacyGetTrades(sw::redis::Redis &redis,
+                                   const std::string &key) {
+  std::vector<Trade> trades;
+  if (!redis.exists(key))
+    return trades;
+  benchmark::DoNotOptimize(redis.type(key));
+  benchmark::DoNotOptimize(redis.ttl(key));
+
+  std::vector<std::string> members;
+  redis.zrange(key, 0, -1, std::back_inserter(members));
+  trades.reserve(members.size());
+  for (const auto &member : members) {
+    auto score = redis.zscore(key, member);
+    if (!score)
+      continue;
+    auto trade_json = nlohmann::json::parse(member);
+    Trade trade;
+    trade.timestamp = std::chrono::system_clock::from_time_t(
+        static_cast<std::time_t>(*score));
+    trade.market_cap_sol = trade_json["marketCapSol"].get<double>();
+    trade.sol_amount = trade_json["solAmount"].get<double>();
+    trades.push_back(trade);
+  }
+  std::sort(trades.begin(), trades.end(),
+            [](const Trade &a, const Trade &b) {
+              return a.timestamp < b.timestamp;
+            });
+  return trades;
+}
+
+// Reports wall time per key plus the number of commands the server saw per
+// key, which is the round-trip count for these strictly sequential paths
+template <typename Fetch>
+void runFetch(benchmark::State &state, Fetch &&fetch) {
+  spdlog::set_level(spdlog::level::warn);
+  try {
+    sw::redis::Redis redis(benchRedisUrl());
+    const auto key =
+        populateBenchKey(redis, static_cast<size_t>(state.range(0)));
+
+    const long long before = serverStat(redis, "total_commands_processed");
+    size_t fetched = 0;
+    for (auto _ : state) {
+      auto trades = fetch(key);
+      fetched = trades.size();
+      benchmark::DoNotOptimize(trades.data());
+    }
+    // Discount the INFO call that produced the `before` sample
+    const long long commands =
+        serverStat(redis, "total_commands_processed") - before - 1;
+
+    state.counters["round_trips"] = benchmark::Counter(
+        static_cast<double>(commands) / static_cast<double>(state.iterations()));
+    state.counters["trades"] = static_cast<double>(fetched);
+    redis.del(key);
+  } catch (const sw::redis::Error &e) {
+    state.SkipWithError(e.what());
+  }
+}
+
+void BM_GetTradesLegacy(benchmark::State &state) {
+  sw::redis::Redis redis(benchRedisUrl());
+  runFetch(state,
+           [&redis](const std::string &key) { return legacyGetTrades(redis, key); });
+}
+
+void BM_GetTrades(benchmark::State &state) {
+  RedisClient client(benchRedisUrl(), 1);
+  runFetch(state,
+           [&client](const std::string &key) { return client.getTrades(key); });
+}
+
+// What processRedisKey does per key: fetch, decode, detect. Args: mint
+// shape, trades in the key.
+void BM_GetTradesAndDetect(benchmark::State &state) {
+  spdlog::set_level(spdlog::level::warn);
+  try {
+    sw::redis::Redis redis(benchRedisUrl());
+    const auto shape = static_cast<MintShape>(state.range(0));
+    const auto key = populateShapedKey(redis, shape,
+                                       static_cast<size_t>(state.range(1)));
+
+    RedisClient client(benchRedisUrl(), 1);
+    for (auto _ : state) {
+      RugPullDetector detector;
+      for (auto &&trade : client.getTrades(key))
+        detector.addTrade(std::move(trade));
+      benchmark::DoNotOptimize(detector.processTrades(DetectionConfig{}));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(1));
+    state.SetLabel(shapeName(shape));
+    redis.del(key);
+  } catch (const sw::redis::Error &e) {
+    state.SkipWithError(e.what());
+  }
+}
+
+void shapeSizeArgs(benchmark::internal::Benchmark *bench) {
+  for (auto shape : ALL_MINT_SHAPES) {
+    for (int64_t trades : {100, 1000, 10000, 100000}) {
+      bench->Args({static_cast<int64_t>(shape), trades});
+    }
+  }
+  bench->ArgNames({"shape", "trades"});
+}
+
+} // namespace
+
+BENCHMARK(BM_GetTradesLegacy)
+    ->Arg(100)
+    ->Arg(1000)
+    ->Arg(20000)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_GetTrades)
+    ->Arg(100)
+    ->Arg(1000)
+    ->Arg(20000)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_GetTradesAndDetect)
+    ->Apply(shapeSizeArgs)
+    ->Unit(benchmark::kMillisecond);
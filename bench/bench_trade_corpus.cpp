@@ -0,0 +1,83 @@
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "batch_detector.hpp"
+#include "rug_pull_detector.hpp"
+#include "synthetic_trades.hpp"
+#include "trade_corpus.hpp"
+
+namespace {
+
+constexpr size_t CORPUS_MINTS = 2000;
+constexpr size_t CORPUS_TRADES_PER_MINT = 500;
+
+// Written once per process, removed at exit
+const std::string &corpusPath() {
+  static const struct CorpusFile {
+    CorpusFile() : path("/tmp/rugpull_bench_corpus.bin") {
+      TradeCorpusWriter writer(path);
+      for (size_t m = 0; m < CORPUS_MINTS; ++m) {
+        writer.addMint("recent_trades:" + std::to_string(m),
+                       makeRandomWalkTrades(static_cast<uint32_t>(m),
+                                            CORPUS_TRADES_PER_MINT,
+                                            m % 3 == 0));
+      }
+    }
+    ~CorpusFile() { std::remove(path.c_str()); }
+    std::string path;
+  } file;
+  return file.path;
+}
+
+// Replay the way it worked before the corpus: every mint's trades copied
+// into a fresh detector
+void BM_ReplayCopyIntoDetector(benchmark::State &state) {
+  TradeCorpus corpus(corpusPath());
+  for (auto _ : state) {
+    size_t hits = 0;
+    for (size_t m = 0; m < corpus.mintCount(); ++m) {
+      const auto series = corpus.series(m);
+      RugPullDetector detector;
+      for (size_t i = 0; i < series.size(); ++i) {
+        detector.addTrade({fromMicros(series.timestamp_us[i]),
+                           series.market_cap_sol[i], series.sol_amount[i]});
+      }
+      hits += detector.processTrades(DetectionConfig{}).rug_pulled;
+    }
+    benchmark::DoNotOptimize(hits);
+  }
+  state.SetItemsProcessed(state.iterations() * corpus.tradeCount());
+}
+
+// Zero-copy replay over the mapping; arg is the thread count
+void BM_ReplayCorpus(benchmark::State &state) {
+  TradeCorpus corpus(corpusPath());
+  for (auto _ : state) {
+    auto results = detectCorpus(corpus, DetectionConfig{},
+                                static_cast<size_t>(state.range(0)));
+    benchmark::DoNotOptimize(results.data());
+  }
+  state.SetItemsProcessed(state.iterations() * corpus.tradeCount());
+}
+
+void BM_OpenCorpus(benchmark::State &state) {
+  const auto &path = corpusPath();
+  for (auto _ : state) {
+    TradeCorpus corpus(path);
+    benchmark::DoNotOptimize(corpus.mintCount());
+  }
+}
+
+} // namespace
+
+// items/s is trades replayed per second
+BENCHMARK(BM_ReplayCopyIntoDetector)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_ReplayCorpus)
+    ->Arg(1)
+    ->Arg(4)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+BENCHMARK(BM_OpenCorpus)->Unit(benchmark::kMicrosecond);
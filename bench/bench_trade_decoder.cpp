@@ -0,0 +1,105 @@
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <nlohmann/json.hpp>
+
+#include "trade_decoder.hpp"
+#include "trade_record.hpp"
+#include "trade_records.hpp"
+
+namespace {
+
+const std::vector<std::string> &records() {
+  static const std::vector<std::string> members = [] {
+    std::vector<std::string> out;
+    out.reserve(1024);
+    for (size_t i = 0; i < 1024; ++i) {
+      out.push_back(makeTradeMember(i, 1739184338.6333098 + i * 0.25,
+                                    28.028628070587033 + i * 0.01,
+                                    0.001014365 * (i % 17 + 1)));
+    }
+    return out;
+  }();
+  return members;
+}
+
+// The same trades in the compact binary encoding
+const std::vector<std::string> &binaryRecords() {
+  static const std::vector<std::string> members = [] {
+    std::vector<std::string> out;
+    out.reserve(records().size());
+    for (const auto &member : records()) {
+      auto trade_json = nlohmann::json::parse(member);
+      out.push_back(encodeTradeRecord(
+          static_cast<int64_t>(trade_json["timestamp"].get<double>() * 1e6),
+          trade_json["marketCapSol"].get<double>(),
+          trade_json["solAmount"].get<double>()));
+    }
+    return out;
+  }();
+  return members;
+}
+
+double bytesPerTrade(const std::vector<std::string> &members) {
+  size_t bytes = 0;
+  for (const auto &member : members)
+    bytes += member.size();
+  return static_cast<double>(bytes) / members.size();
+}
+
+// What getTrades did per member before the selective decoder
+void BM_DecodeJsonDom(benchmark::State &state) {
+  const auto &members = records();
+  size_t bytes = 0;
+  for (auto _ : state) {
+    for (const auto &member : members) {
+      auto trade_json = nlohmann::json::parse(member);
+      double market_cap = trade_json["marketCapSol"].get<double>();
+      double sol_amount = trade_json["solAmount"].get<double>();
+      benchmark::DoNotOptimize(market_cap);
+      benchmark::DoNotOptimize(sol_amount);
+      bytes += member.size();
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * members.size());
+  state.SetBytesProcessed(static_cast<int64_t>(bytes));
+  state.counters["bytes_per_trade"] = bytesPerTrade(members);
+}
+
+void BM_DecodeSelective(benchmark::State &state) {
+  const auto &members = records();
+  size_t bytes = 0;
+  for (auto _ : state) {
+    for (const auto &member : members) {
+      TradeFields fields;
+      benchmark::DoNotOptimize(decodeTradeFields(member, fields));
+      benchmark::DoNotOptimize(fields);
+      bytes += member.size();
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * members.size());
+  state.SetBytesProcessed(static_cast<int64_t>(bytes));
+}
+
+// decodeTradeMember over binary members, dispatch included
+void BM_DecodeBinary(benchmark::State &state) {
+  const auto &members = binaryRecords();
+  size_t bytes = 0;
+  for (auto _ : state) {
+    for (const auto &member : members) {
+      auto fields = decodeTradeMember(member);
+      benchmark::DoNotOptimize(fields);
+      bytes += member.size();
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * members.size());
+  state.SetBytesProcessed(static_cast<int64_t>(bytes));
+  state.counters["bytes_per_trade"] = bytesPerTrade(members);
+}
+
+} // namespace
+
+BENCHMARK(BM_DecodeJsonDom);
+BENCHMARK(BM_DecodeSelective);
+BENCHMARK(BM_DecodeBinary);
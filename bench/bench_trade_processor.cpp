@@ -0,0 +1,254 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "trade_processor.hpp"
+
+namespace {
+
+// The mutex-per-queue processor that TradeProcessor replaced, with the
+// Redis work swapped for a handler so both run the same tasks
+class LegacyTradeProcessor {
+public:
+  using TaskHandler = TradeProcessor::TaskHandler;
+
+  LegacyTradeProcessor(size_t num_threads, TaskHandler handler)
+      : handler_(std::move(handler)), work_queues_(num_threads),
+        queue_mutexes_(num_threads), should_stop_(false) {
+    for (size_t i = 0; i < num_threads; ++i) {
+      workers_.emplace_back([this, i] { processTradesWorker(i); });
+    }
+  }
+
+  ~LegacyTradeProcessor() {
+    {
+      std::unique_lock<std::mutex> lock(queue_mutex_);
+      should_stop_ = true;
+    }
+    queue_cv_.notify_all();
+    for (auto &worker : workers_) {
+      worker.join();
+    }
+  }
+
+  void addTask(const std::string &redis_key) {
+    size_t queue_index = round_robin_++ % work_queues_.size();
+    {
+      std::unique_lock<std::mutex> lock(queue_mutexes_[queue_index]);
+      work_queues_[queue_index].push(redis_key);
+    }
+    queue_cv_.notify_one();
+  }
+
+private:
+  void processTradesWorker(size_t worker_id) {
+    while (true) {
+      std::string task;
+      bool found_task = false;
+      {
+        std::unique_lock<std::mutex> lock(queue_mutexes_[worker_id]);
+        if (!work_queues_[worker_id].empty()) {
+          task = work_queues_[worker_id].front();
+          work_queues_[worker_id].pop();
+          found_task = true;
+        }
+      }
+      if (!found_task) {
+        for (size_t i = 0; i < work_queues_.size(); ++i) {
+          if (i == worker_id)
+            continue;
+          std::unique_lock<std::mutex> lock(queue_mutexes_[i]);
+          if (!work_queues_[i].empty()) {
+            task = work_queues_[i].front();
+            work_queues_[i].pop();
+            found_task = true;
+            break;
+          }
+        }
+      }
+      if (!found_task) {
+        std::unique_lock<std::mutex> lock(queue_mutex_);
+        if (should_stop_ && allQueuesEmpty()) {
+          return;
+        }
+        queue_cv_.wait(lock);
+        continue;
+      }
+      handler_(worker_id, task);
+    }
+  }
+
+  bool allQueuesEmpty() const {
+    for (size_t i = 0; i < work_queues_.size(); ++i) {
+      std::unique_lock<std::mutex> lock(queue_mutexes_[i]);
+      if (!work_queues_[i].empty())
+        return false;
+    }
+    return true;
+  }
+
+  TaskHandler handler_;
+  std::vector<std::thread> workers_;
+  std::vector<std::queue<std::string>> work_queues_;
+  mutable std::vector<std::mutex> queue_mutexes_;
+  std::mutex queue_mutex_;
+  std::condition_variable queue_cv_;
+  bool should_stop_;
+  std::atomic<size_t> round_robin_{0};
+};
+
+constexpr size_t TASKS_PER_ITERATION = 100000;
+
+// Busy work standing in for a detection, in nanoseconds
+void spinFor(std::chrono::nanoseconds duration) {
+  const auto end = std::chrono::steady_clock::now() + duration;
+  while (std::chrono::steady_clock::now() < end) {
+  }
+}
+
+// One producer submits TASKS_PER_ITERATION keys; the iteration ends when the
+// pool has run all of them and shut down. Args: worker threads, ns of work
+// per task.
+template <typename Processor>
+void runThroughput(benchmark::State &state) {
+  const auto threads = static_cast<size_t>(state.range(0));
+  const std::chrono::nanoseconds work(state.range(1));
+  const std::string key = "recent_trades:So11111111111111111111111111111111";
+
+  for (auto _ : state) {
+    std::atomic<size_t> done{0};
+    {
+      Processor processor(threads, [&](size_t, const std::string &task) {
+        benchmark::DoNotOptimize(task.data());
+        if (work.count() > 0)
+          spinFor(work);
+        done.fetch_add(1, std::memory_order_relaxed);
+      });
+      for (size_t i = 0; i < TASKS_PER_ITERATION; ++i) {
+        processor.addTask(key);
+      }
+    }
+    benchmark::DoNotOptimize(done.load());
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() *
+                                               TASKS_PER_ITERATION));
+}
+
+void BM_LegacyTradeProcessor(benchmark::State &state) {
+  runThroughput<LegacyTradeProcessor>(state);
+}
+
+void BM_WorkStealingTradeProcessor(benchmark::State &state) {
+  runThroughput<TradeProcessor>(state);
+}
+
+void throughputArgs(benchmark::internal::Benchmark *bench) {
+  for (int64_t threads : {1, 2, 4, 8}) {
+    for (int64_t work_ns : {0, 1000}) {
+      bench->Args({threads, work_ns});
+    }
+  }
+  bench->ArgNames({"threads", "work_ns"})
+      ->Unit(benchmark::kMillisecond)
+      ->UseRealTime();
+}
+
+// p-th quantile of values, sorting them
+double percentile(std::vector<double> &values, double p) {
+  if (values.empty())
+    return 0.0;
+  std::sort(values.begin(), values.end());
+  return values[static_cast<size_t>(p * static_cast<double>(values.size() - 1))];
+}
+
+// Every millisecond a producer submits a burst twice the size the workers
+// can run in that time (20 us per task), 5% of it High, 25% Medium and 70%
+// Low, for 200 ms; then the pool drains. Reports the p99 of submission to
+// completion per class and the share of keys shed. Args: mode (0: one FIFO
+// class, every key Medium; 1: risk classes; 2: risk classes, shedding late
+// Low keys), worker threads.
+void BM_OverloadLatencyByRisk(benchmark::State &state) {
+  using Clock = std::chrono::steady_clock;
+  const auto mode = state.range(0);
+  const auto threads = static_cast<size_t>(state.range(1));
+  const std::chrono::microseconds work(20);
+  constexpr size_t BURSTS = 200;
+  const size_t per_burst = 2 * threads * (1000 / work.count());
+  const size_t total = BURSTS * per_burst;
+  auto riskOf = [](size_t j) {
+    return j % 20 == 0 ? RiskClass::High
+           : j % 20 <= 5 ? RiskClass::Medium
+                         : RiskClass::Low;
+  };
+
+  std::array<std::vector<double>, RISK_CLASS_COUNT> latency_ms;
+  uint64_t shed = 0;
+  uint64_t offered = 0;
+  for (auto _ : state) {
+    std::vector<Clock::time_point> submitted(total);
+    std::vector<Clock::time_point> finished(total);
+    TradeProcessorOptions options;
+    options.shed_low_risk = mode == 2;
+    {
+      TradeProcessor processor(
+          threads,
+          [&](size_t, const std::string &key) {
+            spinFor(work);
+            finished[std::stoul(key)] = Clock::now();
+          },
+          options);
+      auto next_burst = Clock::now();
+      for (size_t burst = 0; burst < BURSTS; ++burst) {
+        for (size_t j = 0; j < per_burst; ++j) {
+          const size_t i = burst * per_burst + j;
+          submitted[i] = Clock::now();
+          processor.addTask(std::to_string(i),
+                            mode == 0 ? RiskClass::Medium : riskOf(j));
+        }
+        next_burst += std::chrono::milliseconds(1);
+        std::this_thread::sleep_until(next_burst);
+      }
+      shed += processor.shedTasks();
+    }
+    offered += total;
+    for (size_t i = 0; i < total; ++i) {
+      if (finished[i] == Clock::time_point{})
+        continue;
+      const std::chrono::duration<double, std::milli> latency =
+          finished[i] - submitted[i];
+      latency_ms[static_cast<size_t>(riskOf(i % per_burst))].push_back(
+          latency.count());
+    }
+  }
+
+  for (size_t risk = 0; risk < RISK_CLASS_COUNT; ++risk) {
+    state.counters[std::string("p99_") +
+                   riskClassName(static_cast<RiskClass>(risk)) + "_ms"] =
+        percentile(latency_ms[risk], 0.99);
+  }
+  state.counters["shed_pct"] =
+      100.0 * static_cast<double>(shed) / static_cast<double>(offered);
+}
+
+} // namespace
+
+BENCHMARK(BM_LegacyTradeProcessor)->Apply(throughputArgs);
+BENCHMARK(BM_WorkStealingTradeProcessor)->Apply(throughputArgs);
+BENCHMARK(BM_OverloadLatencyByRisk)
+    ->ArgNames({"mode", "threads"})
+    ->Args({0, 1})
+    ->Args({1, 1})
+    ->Args({2, 1})
+    ->Iterations(3)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
@@ -0,0 +1,77 @@
+#pragma once
+#include <chrono>
+#include <cstdlib>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <sw/redis++/redis++.h>
+
+#include "synthetic_trades.hpp"
+#include "trade_records.hpp"
+
+inline std::string benchRedisUrl() {
+  const char *url = std::getenv("RUGPULL_BENCH_REDIS");
+  return url ? url : "redis://localhost";
+}
+
+// Fill bench_trades:<num_trades> with spec-shaped members a quarter second
+// apart. The key expires after an hour in case a run is interrupted.
+inline std::string populateBenchKey(sw::redis::Redis &redis,
+                                    size_t num_trades) {
+  const std::string key = "bench_trades:" + std::to_string(num_trades);
+  redis.del(key);
+
+  constexpr size_t batch_size = 1000;
+  std::vector<std::pair<std::string, double>> batch;
+  batch.reserve(batch_size);
+  for (size_t i = 0; i < num_trades; ++i) {
+    const double timestamp = 1739184338.0 + static_cast<double>(i) * 0.25;
+    const double market_cap = 28.0 + static_cast<double>(i % 97) * 0.1;
+    batch.emplace_back(
+        makeTradeMember(i, timestamp, market_cap, 0.001 * (i % 13)), timestamp);
+    if (batch.size() == batch_size || i + 1 == num_trades) {
+      redis.zadd(key, batch.begin(), batch.end());
+      batch.clear();
+    }
+  }
+  redis.expire(key, std::chrono::seconds(3600));
+  return key;
+}
+
+// Fill bench_trades:<shape>:<num_trades> with spec-shaped members following
+// one of the synthetic price paths. Expires after an hour like the above.
+inline std::string populateShapedKey(sw::redis::Redis &redis, MintShape shape,
+                                     size_t num_trades) {
+  const std::string key = std::string("bench_trades:") + shapeName(shape) +
+                          ":" + std::to_string(num_trades);
+  redis.del(key);
+
+  constexpr size_t batch_size = 1000;
+  const auto trades = makeSyntheticTrades(shape, num_trades);
+  std::vector<std::pair<std::string, double>> batch;
+  batch.reserve(batch_size);
+  for (size_t i = 0; i < trades.size(); ++i) {
+    const double timestamp =
+        static_cast<double>(toMicros(trades[i].timestamp)) / MICROS_PER_SECOND;
+    batch.emplace_back(makeTradeMember(i, timestamp, trades[i].market_cap_sol,
+                                       trades[i].sol_amount),
+                       timestamp);
+    if (batch.size() == batch_size || i + 1 == trades.size()) {
+      redis.zadd(key, batch.begin(), batch.end());
+      batch.clear();
+    }
+  }
+  redis.expire(key, std::chrono::seconds(3600));
+  return key;
+}
+
+// Integer field from INFO stats, e.g. total_commands_processed
+inline long long serverStat(sw::redis::Redis &redis, const std::string &name) {
+  const std::string stats = redis.info("stats");
+  const std::string field = name + ":";
+  const auto pos = stats.find(field);
+  return pos == std::string::npos
+             ? 0
+             : std::stoll(stats.substr(pos + field.size()));
+}
@@ -0,0 +1,193 @@
+#!/bin/bash
+# Live-mode scaling across processes. For each N from 1 to MAX_N: start N
+# redis-server instances as a Redis Cluster with the slots split evenly,
+# start N live monitors in one shard group against it, write KEYS keys of
+# TRADES trades each (one ZADD per key), and time how long the monitors
+# take between them to fetch every key. Prints keys/s per N and the
+# speedup over N = 1.
+#
+#   bench/shard_scaling.sh [path/to/rugpull-detector]
+#
+# Environment: MAX_N (default 4), KEYS (default 20000), TRADES (default
+# 50), PORT_BASE (default 7100), METRICS_PORT_BASE (default 9200),
+# REDIS_SERVER and REDIS_CLI (default from PATH).
+#
+# Everything runs on this machine, so past about nproc / 2 monitors the
+# servers and monitors compete for cores and the curve flattens for that
+# reason alone. The load is written from pre-generated files, one
+# redis-cli --pipe per server in parallel; if the load time printed is
+# close to the fetch time, the writer rather than the monitors is the
+# limit.
+set -euo pipefail
+
+BIN=${1:-build/rugpull-detector}
+MAX_N=${MAX_N:-4}
+KEYS=${KEYS:-20000}
+TRADES=${TRADES:-50}
+PORT_BASE=${PORT_BASE:-7100}
+METRICS_PORT_BASE=${METRICS_PORT_BASE:-9200}
+REDIS_SERVER=${REDIS_SERVER:-redis-server}
+REDIS_CLI=${REDIS_CLI:-redis-cli}
+TIMEOUT_S=600
+
+for tool in "$BIN" "$REDIS_SERVER" "$REDIS_CLI" curl python3; do
+  if ! command -v "$tool" >/dev/null; then
+    echo "shard_scaling: $tool not found" >&2
+    exit 1
+  fi
+done
+
+WORK=$(mktemp -d)
+PIDS=()
+cleanup() {
+  for pid in "${PIDS[@]}"; do
+    kill "$pid" 2>/dev/null || true
+  done
+  wait 2>/dev/null || true
+  rm -rf "$WORK"
+}
+trap cleanup EXIT
+
+# RESP-encoded ZADDs, one file per server, each key sent to the server
+# owning its slot when n servers split the 16384 slots evenly
+generate_load() {
+  local n=$1
+  python3 - "$WORK" "$n" "$KEYS" "$TRADES" <<'EOF'
+import random
+import sys
+import time
+
+work, n, keys, trades = sys.argv[1], int(sys.argv[2]), int(sys.argv[3]), int(sys.argv[4])
+
+def crc16(data):
+    crc = 0
+    for byte in data:
+        crc ^= byte << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if crc & 0x8000 else crc << 1
+            crc &= 0xFFFF
+    return crc
+
+def bulk(value):
+    return b"$%d\r\n%s\r\n" % (len(value), value)
+
+files = [open(f"{work}/load_{n}_{i}.resp", "wb") for i in range(n)]
+rng = random.Random(n)
+start = time.time() - trades
+for k in range(keys):
+    mint = f"scale_{k}"
+    key = f"recent_trades:{mint}".encode()
+    owner = crc16(key) % 16384 * n // 16384
+    parts = [b"ZADD", key]
+    market_cap = 30.0
+    for t in range(trades):
+        timestamp = start + t + rng.random() * 0.5
+        market_cap *= 1.0 + rng.uniform(-0.02, 0.021)
+        member = (
+            f'{{"signature":"{mint}_{t}","mint":"{mint}","txType":"buy",'
+            f'"timestamp":{timestamp!r},"marketCapSol":{market_cap!r},'
+            f'"solAmount":{rng.uniform(0.01, 2.0)!r}}}'
+        )
+        parts += [repr(timestamp).encode(), member.encode()]
+    files[owner].write(b"*%d\r\n" % len(parts) + b"".join(map(bulk, parts)))
+for f in files:
+    f.close()
+EOF
+}
+
+# Sum of a metric over the first n monitors' /metrics
+metric_sum() {
+  local n=$1 name=$2 total=0 value
+  for ((i = 0; i < n; i++)); do
+    value=$(curl -sf "http://127.0.0.1:$((METRICS_PORT_BASE + i))/metrics" |
+      awk -v name="$name" '$1 == name { print $2 }')
+    total=$(awk -v a="$total" -v b="${value:-0}" 'BEGIN { printf "%d", a + b }')
+  done
+  echo "$total"
+}
+
+wait_for() {
+  local what=$1 check=$2
+  for ((tries = 0; tries < TIMEOUT_S * 10; tries++)); do
+    if eval "$check"; then
+      return 0
+    fi
+    sleep 0.1
+  done
+  echo "shard_scaling: timed out waiting for $what" >&2
+  exit 1
+}
+
+echo "nproc $(nproc), $KEYS keys x $TRADES trades"
+printf '%3s %10s %10s %10s %8s\n' N load_s fetch_s keys/s speedup
+base_rate=""
+for ((n = 1; n <= MAX_N; n++)); do
+  generate_load "$n"
+
+  for ((i = 0; i < n; i++)); do
+    port=$((PORT_BASE + i))
+    mkdir -p "$WORK/redis_$port"
+    "$REDIS_SERVER" --port "$port" --dir "$WORK/redis_$port" \
+      --cluster-enabled yes --cluster-config-file nodes.conf \
+      --save "" --appendonly no --notify-keyspace-events Kzgx \
+      --logfile "$WORK/redis_$port.log" &
+    PIDS+=($!)
+  done
+  for ((i = 0; i < n; i++)); do
+    wait_for "redis on $((PORT_BASE + i))" \
+      "$REDIS_CLI -p $((PORT_BASE + i)) ping >/dev/null 2>&1"
+    first=$((16384 * i / n))
+    last=$((16384 * (i + 1) / n - 1))
+    "$REDIS_CLI" -p $((PORT_BASE + i)) cluster addslotsrange "$first" "$last" \
+      >/dev/null
+    if ((i > 0)); then
+      "$REDIS_CLI" -p $((PORT_BASE + i)) cluster meet 127.0.0.1 "$PORT_BASE" \
+        >/dev/null
+    fi
+  done
+  for ((i = 0; i < n; i++)); do
+    wait_for "cluster state on $((PORT_BASE + i))" \
+      "$REDIS_CLI -p $((PORT_BASE + i)) cluster info | grep -q 'cluster_state:ok'"
+  done
+
+  for ((i = 0; i < n; i++)); do
+    "$BIN" --live "redis://127.0.0.1:$PORT_BASE" --cluster \
+      --shard-id "scale-$i" --metrics-port $((METRICS_PORT_BASE + i)) \
+      >"$WORK/monitor_$i.log" 2>&1 &
+    PIDS+=($!)
+  done
+  # Load only once every monitor sees the whole group, so no key is
+  # fetched by a member that is about to hand it over
+  wait_for "$n shard members" \
+    "[ \"\$(metric_sum $n rugpull_shard_members)\" -eq $((n * n)) ]"
+  before=$(metric_sum "$n" rugpull_keys_fetched_total)
+
+  start=$(date +%s.%N)
+  load_pids=()
+  for ((i = 0; i < n; i++)); do
+    "$REDIS_CLI" -p $((PORT_BASE + i)) --pipe \
+      <"$WORK/load_${n}_$i.resp" >/dev/null &
+    load_pids+=($!)
+  done
+  wait "${load_pids[@]}"
+  loaded=$(date +%s.%N)
+  wait_for "$KEYS keys fetched" \
+    "[ \"\$(metric_sum $n rugpull_keys_fetched_total)\" -ge $((before + KEYS)) ]"
+  done_at=$(date +%s.%N)
+
+  read -r load_s fetch_s rate speedup < <(python3 -c "
+load = $loaded - $start
+fetch = $done_at - $start
+rate = $KEYS / fetch
+base = float('${base_rate:-0}') or rate
+print(f'{load:.2f} {fetch:.2f} {rate:.0f} {rate / base:.2f}')")
+  base_rate=${base_rate:-$rate}
+  printf '%3d %10s %10s %10s %8s\n' "$n" "$load_s" "$fetch_s" "$rate" "$speedup"
+
+  for pid in "${PIDS[@]}"; do
+    kill "$pid" 2>/dev/null || true
+  done
+  wait 2>/dev/null || true
+  PIDS=()
+  rm -rf "$WORK"/redis_* "$WORK"/load_*
+done
@@ -0,0 +1,98 @@
+#pragma once
+#include <chrono>
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "trade.hpp"
+
+// Random-walk market cap with trades 0-2 s apart; with dumping set the
+// second half drifts down about 0.4% per trade
+inline std::vector<Trade> makeRandomWalkTrades(uint32_t seed, size_t count,
+                                               bool dumping) {
+  std::mt19937 rng(seed);
+  std::normal_distribution<double> step(0.0, 0.01);
+  std::uniform_real_distribution<double> amount(0.01, 3.0);
+  std::uniform_int_distribution<int64_t> gap_us(1, 2'000'000);
+
+  std::vector<Trade> trades;
+  trades.reserve(count);
+  auto timestamp = std::chrono::system_clock::from_time_t(1739184338);
+  double market_cap = 50.0;
+  for (size_t i = 0; i < count; ++i) {
+    const bool falling = dumping && i > count / 2;
+    market_cap *= 1.0 + step(rng) - (falling ? 0.004 : 0.0);
+    trades.push_back({timestamp, market_cap, amount(rng)});
+    timestamp += std::chrono::microseconds(gap_us(rng));
+  }
+  return trades;
+}
+
+// Price paths the detector sees in practice
+enum class MintShape { PumpAndDump, SlowBleed, Flat, HighFrequency };
+
+inline constexpr MintShape ALL_MINT_SHAPES[] = {
+    MintShape::PumpAndDump, MintShape::SlowBleed, MintShape::Flat,
+    MintShape::HighFrequency};
+
+inline const char *shapeName(MintShape shape) {
+  switch (shape) {
+  case MintShape::PumpAndDump:
+    return "pump_and_dump";
+  case MintShape::SlowBleed:
+    return "slow_bleed";
+  case MintShape::Flat:
+    return "flat";
+  case MintShape::HighFrequency:
+    return "high_frequency";
+  }
+  return "";
+}
+
+// - PumpAndDump: doubles over the first 40% of trades, loses 70% over the
+//   next 5%, then drifts
+// - SlowBleed: loses half its value evenly over the whole run
+// - Flat: 1% noise around a constant
+// - HighFrequency: flat, but trades 0-20 ms apart, so windows hold
+//   thousands of trades
+inline std::vector<Trade> makeSyntheticTrades(MintShape shape, size_t count,
+                                              uint32_t seed = 1) {
+  std::mt19937 rng(seed);
+  std::normal_distribution<double> noise(0.0, 0.01);
+  std::uniform_real_distribution<double> amount(0.01, 3.0);
+  std::uniform_int_distribution<int64_t> gap_us(
+      1, shape == MintShape::HighFrequency ? 20'000 : 2'000'000);
+
+  const double n = static_cast<double>(std::max<size_t>(count, 1));
+  const double pump_end = 0.4 * n;
+  const double dump_end = 0.45 * n;
+
+  std::vector<Trade> trades;
+  trades.reserve(count);
+  auto timestamp = std::chrono::system_clock::from_time_t(1739184338);
+  for (size_t i = 0; i < count; ++i) {
+    const double x = static_cast<double>(i);
+    double level = 1.0;
+    switch (shape) {
+    case MintShape::PumpAndDump:
+      if (x < pump_end)
+        level = 1.0 + x / pump_end;
+      else if (x < dump_end)
+        level = 2.0 - 1.4 * (x - pump_end) / (dump_end - pump_end);
+      else
+        level = 0.6;
+      break;
+    case MintShape::SlowBleed:
+      level = 1.0 - 0.5 * x / n;
+      break;
+    case MintShape::Flat:
+    case MintShape::HighFrequency:
+      break;
+    }
+    trades.push_back({timestamp, 30.0 * level * (1.0 + noise(rng)),
+                      amount(rng)});
+    timestamp += std::chrono::microseconds(gap_us(rng));
+  }
+  return trades;
+}
@@ -0,0 +1,28 @@
+#pragma once
+#include <string>
+
+#include <nlohmann/json.hpp>
+
+// Record shaped like the example in docs/REDIS_SPEC.md (all 14 fields) so
+// decode cost is representative of production members
+inline std::string makeTradeMember(size_t i, double timestamp,
+                                   double market_cap, double sol_amount) {
+  nlohmann::json record = {
+      {"signature", "5PEnuUTTiqyEoeXtSdFPC38pY1bFCXFAFXKq52WQBCUPzC8sJLhxNDx"
+                    "PDB9YBrQWZDxB6GTzJcPKH399Zp" +
+                        std::to_string(i)},
+      {"mint", "14k7LpDRKvyVuMWfGe1vB5ByoQh1yUQPetApMBLuzw1f"},
+      {"traderPublicKey", "3c6KJRkWtYoGHokK1x1YrYUsNUT672J3RHRgsodhC6KJ"},
+      {"txType", i % 3 == 0 ? "sell" : "buy"},
+      {"tokenAmount", 36189.104326},
+      {"solAmount", sol_amount},
+      {"newTokenBalance", 0},
+      {"bondingCurveKey", "2bQpbWV1FYiddhyEceQf3FuviVPd4JQKYnptHnCEGKR5"},
+      {"vTokensInBondingCurve", 1071666285.328535},
+      {"vSolInBondingCurve", 30.03733572726111},
+      {"marketCapSol", market_cap},
+      {"pool", "pump"},
+      {"timestamp", timestamp},
+      {"human_readable_time", "2025-02-10T10:45:38.633337+00:00"}};
+  return record.dump();
+}
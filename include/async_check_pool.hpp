@@ -0,0 +1,63 @@
+#pragma once
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include "async_redis_client.hpp"
+#include "detection_config.hpp"
+#include "key_worker.hpp"
+
+// One-shot checks over AsyncRedisClient, with decoding and detection on a
+// few threads of the pool's own. The client's loop thread only hands each
+// reply over and goes back to polling, so a slow check (or a slow done
+// callback) never holds up the replies behind it.
+class AsyncCheckPool {
+public:
+  // Called once per check, on a pool thread, with the result or what went
+  // wrong. Runs while the thread's next check waits, so keep it short;
+  // it may start further checks.
+  using Done =
+      std::function<void(const KeyWorker::Check &check, std::string_view error)>;
+
+  explicit AsyncCheckPool(size_t threads);
+  // Waits for every check already started to call its done
+  ~AsyncCheckPool();
+
+  AsyncCheckPool(const AsyncCheckPool &) = delete;
+  AsyncCheckPool &operator=(const AsyncCheckPool &) = delete;
+
+  // Fetch key with ZRANGE ... WITHSCORES on redis, then check it with
+  // params on a pool thread. Thread-safe and never blocks.
+  void check(AsyncRedisClient &redis, const std::string &key,
+             const DetectionParams &params, Done done);
+
+  // Block until every check started so far has called its done. Not from
+  // a done callback.
+  void wait();
+
+  size_t threadCount() const { return threads_.size(); }
+
+private:
+  struct Job {
+    AsyncRedisClient::ReplyPtr reply;
+    std::string error;
+    DetectionParams params;
+    Done done;
+  };
+
+  void run();
+
+  std::mutex mutex_;
+  std::condition_variable ready_;
+  std::condition_variable idle_;
+  std::deque<Job> jobs_;
+  // Checks started whose done has not returned yet
+  size_t in_flight_ = 0;
+  bool stopping_ = false;
+  std::vector<std::thread> threads_;
+};
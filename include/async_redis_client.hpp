@@ -0,0 +1,105 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include <hiredis/hiredis.h>
+#include <sw/redis++/redis++.h>
+#include "redis_client.hpp"
+
+// Redis client on hiredis's non-blocking API, driven by an event loop of
+// its own: one background thread polls a handful of connections, writes
+// queued commands to them round-robin (pipelined, no waiting for replies)
+// and completes each command from the reply. Thousands of commands can be
+// in flight at once without a thread, or even a connection, per command.
+class AsyncRedisClient {
+public:
+  // Called exactly once per command, on the loop thread, with either the
+  // reply or a description of what went wrong (a Redis error reply, a
+  // lost connection, a timeout, shutdown). The reply is freed when the
+  // callback returns. Callbacks hold up every other reply, so keep them
+  // short and never block in one.
+  using ReplyCallback =
+      std::function<void(const redisReply *reply, std::string_view error)>;
+
+  struct ReplyDeleter {
+    void operator()(redisReply *reply) const { freeReplyObject(reply); }
+  };
+  using ReplyPtr = std::unique_ptr<redisReply, ReplyDeleter>;
+  // Same contract, except the callback takes the reply over. Hand it to
+  // another thread to work on rather than holding up the loop.
+  using OwnedReplyCallback =
+      std::function<void(ReplyPtr reply, std::string_view error)>;
+
+  // options.pool_size is the number of connections, socket_timeout the
+  // per-command timeout (0 = none) and connect_timeout bounds connecting.
+  // Connections are opened lazily and reopened after a failure.
+  explicit AsyncRedisClient(const std::string &url,
+                            const RedisClientOptions &options = {});
+  // Fails every command still queued or awaiting a reply, then stops
+  ~AsyncRedisClient();
+
+  AsyncRedisClient(const AsyncRedisClient &) = delete;
+  AsyncRedisClient &operator=(const AsyncRedisClient &) = delete;
+
+  // Queue a command. Thread-safe and never blocks on Redis; may be called
+  // from a callback.
+  void command(std::vector<std::string> args, ReplyCallback callback);
+  void command(std::vector<std::string> args, OwnedReplyCallback callback);
+
+  // Commands queued or awaiting a reply
+  size_t pending() const { return pending_.load(std::memory_order_relaxed); }
+
+private:
+  struct Request;
+  struct Connection;
+
+  void run();
+  void dispatch(std::unique_ptr<Request> request);
+  Connection *nextConnection();
+  void enqueue(std::unique_ptr<Request> request);
+  void complete(Request &request, ReplyPtr reply, std::string_view error);
+  void wake();
+
+  sw::redis::ConnectionOptions endpoint_;
+  RedisClientOptions options_;
+  std::vector<std::unique_ptr<Connection>> connections_;
+  size_t next_connection_ = 0;
+
+  // argv scratch for redisAsyncCommandArgv, loop thread only
+  std::vector<const char *> argv_;
+  std::vector<size_t> argv_len_;
+
+  std::mutex mutex_;
+  std::vector<std::unique_ptr<Request>> queue_;
+  bool stopping_ = false;
+  std::atomic<size_t> pending_{0};
+
+  // Self-pipe that wakes the loop out of poll()
+  int wake_read_ = -1;
+  int wake_write_ = -1;
+  std::thread loop_;
+};
+
+// Process-wide async clients keyed by URL, created on first use with the
+// options RedisClientRegistry currently holds
+class AsyncRedisClientRegistry {
+public:
+  static AsyncRedisClientRegistry &instance();
+
+  std::shared_ptr<AsyncRedisClient> get(const std::string &url);
+
+  // Drop every cached client; each stops once its last user lets go,
+  // failing whatever it still had in flight
+  void shutdown();
+
+private:
+  std::mutex mutex_;
+  std::unordered_map<std::string, std::shared_ptr<AsyncRedisClient>> clients_;
+};
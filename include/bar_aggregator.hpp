@@ -0,0 +1,106 @@
+#pragma once
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+#include "trade_columns.hpp"
+
+// OHLCV bar in market cap (SOL) over [start_us, start_us + resolution)
+struct Bar {
+  int64_t start_us = 0;
+  // Timestamps of the first trade, the first one at the high, and the last
+  int64_t open_time_us = 0;
+  int64_t high_time_us = 0;
+  int64_t close_time_us = 0;
+  double open = 0.0;
+  double high = 0.0;
+  double low = 0.0;
+  double close = 0.0;
+  // SOL traded, and by the closing trade
+  double volume = 0.0;
+  double close_amount = 0.0;
+  uint32_t trades = 0;
+};
+
+// Resolutions the detector is run at by default; short_window is 1 second
+inline constexpr std::array<std::chrono::seconds, 3> BAR_RESOLUTIONS = {
+    std::chrono::seconds(1), std::chrono::seconds(5), std::chrono::seconds(15)};
+
+// Rolls trades into bars of one resolution as they arrive, in O(1) per
+// trade. Bars are aligned to the Unix epoch, so bars of different mints
+// (and of a 1s and a 5s builder) share boundaries. Trades must come in
+// timestamp order; a late one is folded into the open bar.
+class BarBuilder {
+public:
+  // Throws std::invalid_argument unless resolution is positive
+  explicit BarBuilder(std::chrono::seconds resolution);
+
+  // Returns the open bar if this trade falls past its end; the trade then
+  // opens the next one. Empty intervals produce no bar.
+  std::optional<Bar> add(int64_t timestamp_us, double market_cap_sol,
+                         double sol_amount);
+
+  // The open bar, once now_us has reached its end
+  std::optional<Bar> closeDue(int64_t now_us);
+
+  // The open bar whatever the time (end of a replay, say)
+  std::optional<Bar> flush();
+
+  bool hasOpenBar() const { return open_.trades > 0; }
+  const Bar &openBar() const { return open_; }
+  std::chrono::seconds resolution() const {
+    return std::chrono::seconds(resolution_us_ / MICROS_PER_SECOND);
+  }
+
+private:
+  int64_t bucketStart(int64_t timestamp_us) const;
+
+  int64_t resolution_us_;
+  Bar open_;
+};
+
+// One BarBuilder per resolution, fed from the same trade stream
+class MultiResolutionBars {
+public:
+  explicit MultiResolutionBars(
+      std::span<const std::chrono::seconds> resolutions = BAR_RESOLUTIONS);
+
+  // Calls on_close(level, bar) for every bar the trade closes, finest
+  // resolution first
+  template <typename OnClose>
+  void add(int64_t timestamp_us, double market_cap_sol, double sol_amount,
+           OnClose &&on_close) {
+    for (size_t level = 0; level < builders_.size(); ++level) {
+      if (auto bar = builders_[level].add(timestamp_us, market_cap_sol,
+                                          sol_amount))
+        on_close(level, *bar);
+    }
+  }
+
+  template <typename OnClose>
+  void closeDue(int64_t now_us, OnClose &&on_close) {
+    for (size_t level = 0; level < builders_.size(); ++level) {
+      if (auto bar = builders_[level].closeDue(now_us))
+        on_close(level, *bar);
+    }
+  }
+
+  size_t levels() const { return builders_.size(); }
+  std::chrono::seconds resolution(size_t level) const {
+    return builders_[level].resolution();
+  }
+  const BarBuilder &level(size_t level) const { return builders_[level]; }
+
+private:
+  std::vector<BarBuilder> builders_;
+};
+
+// Every bar of a series, the last one closed at the end of the data
+std::vector<Bar> aggregateBars(const TradeSeries &trades,
+                               std::chrono::seconds resolution);
+
+// How many bars aggregateBars would return, without building them
+size_t countBars(const TradeSeries &trades, std::chrono::seconds resolution);
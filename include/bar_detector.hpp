@@ -0,0 +1,74 @@
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include "bar_aggregator.hpp"
+#include "detection_config.hpp"
+#include "detection_result.hpp"
+#include "trade.hpp"
+#include "trade_columns.hpp"
+#include "window_stats.hpp"
+
+// Detection on bar close instead of per trade. Trades are rolled into bars
+// of one resolution and the usual rule is evaluated once per closed bar, on
+// one sample per bar: the closing trade's timestamp, market cap and SOL
+// amount. Sampling a trade rather than averaging the bar keeps
+// volume_trend on the trade-to-trade scale volume_spike_threshold was tuned
+// for. The peak comes from the bar highs. A busy mint then costs one
+// evaluation per elapsed bar however many trades it sees; a dip that
+// recovers within a bar goes unseen, which compareBarDetection
+// (batch_detector.hpp) measures.
+//
+// Bars only hold what the window can still reach, as StreamingDetector
+// does with trades.
+//
+// Bar mode is offline only: replay (--replay --bars) goes through detect,
+// and the live monitor always scores per trade. addTrade, closeDue and
+// MultiResolutionBars are the incremental form a live bar mode would feed,
+// and only the tests drive them so far.
+class BarDetector {
+public:
+  explicit BarDetector(
+      std::chrono::seconds resolution = BAR_RESOLUTIONS.front())
+      : builder_(resolution) {}
+
+  // Trades in timestamp order. Scores the bar this trade closes, if any.
+  DetectionResult addTrade(int64_t timestamp_us, double market_cap_sol,
+                           double sol_amount, const DetectionParams &config);
+  DetectionResult addTrade(const Trade &trade, const DetectionParams &config) {
+    return addTrade(toMicros(trade.timestamp), trade.market_cap_sol,
+                    trade.sol_amount, config);
+  }
+
+  // Close and score the open bar once now_us is past its end, for a mint
+  // that stopped trading
+  DetectionResult closeDue(int64_t now_us, const DetectionParams &config);
+
+  // Close and score the open bar whatever the time
+  DetectionResult flush(const DetectionParams &config);
+
+  // Bars closed so far, and those still held for the window
+  size_t closedBars() const { return closed_; }
+  size_t retainedBars() const { return samples_.size(); }
+
+  std::chrono::seconds resolution() const { return builder_.resolution(); }
+
+  // One-shot counterpart of RugPullDetector::detect: every bar of trades,
+  // the last one closed at the end of the data, scored in one pass
+  static DetectionResult detect(const TradeSeries &trades,
+                                std::chrono::seconds resolution,
+                                const DetectionParams &config);
+
+private:
+  DetectionResult score(const Bar &bar, const DetectionParams &config);
+
+  BarBuilder builder_;
+  // One sample per closed bar, from samples_[0]
+  TradeColumns samples_;
+  size_t closed_ = 0;
+  size_t current_idx_ = 0;
+  double peak_mc_ = 0.0;
+  int64_t peak_time_us_ = 0;
+  int64_t analysis_start_us_ = 0;
+  SlidingWindowStats window_;
+};
@@ -0,0 +1,84 @@
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+#include "detection_config.hpp"
+#include "detection_result.hpp"
+#include "redis_client.hpp"
+#include "trade_corpus.hpp"
+
+// Keys per pipelined fetch; also the unit of work a thread claims
+constexpr size_t BATCH_CHUNK_SIZE = 64;
+
+// Per-key outcome of a batch run
+struct BatchDetection {
+    DetectionResult result;
+    size_t trade_count = 0;  // 0 when the key is missing or unreadable
+};
+
+// Fetch and score many keys at once. Keys are taken in chunks of
+// BATCH_CHUNK_SIZE; each chunk is fetched in one pipelined round trip and
+// scored by whichever of up to max_threads threads claimed it (0 means
+// hardware concurrency). Results come back in key order.
+std::vector<BatchDetection> detectBatch(RedisClient& redis,
+                                        const std::vector<std::string>& keys,
+                                        const DetectionParams& config,
+                                        size_t max_threads = 0);
+
+// Score many mints whose trades are already in memory (columns handed over
+// from Python, say), reading them in place. Mints are claimed in chunks of
+// BATCH_CHUNK_SIZE by up to max_threads threads (0 means hardware
+// concurrency). Results come back in input order.
+std::vector<DetectionResult> detectSeries(std::span<const TradeSeries> mints,
+                                          const DetectionParams& config,
+                                          size_t max_threads = 0);
+
+// detectSeries scoring on bar close at resolution (bar_detector.hpp)
+// instead of on every trade
+std::vector<DetectionResult> detectSeriesOnBars(
+    std::span<const TradeSeries> mints, std::chrono::seconds resolution,
+    const DetectionParams& config, size_t max_threads = 0);
+
+// How far bar-close detection strays from per-trade detection
+struct BarToleranceReport {
+    std::chrono::seconds resolution{0};
+    size_t mints = 0;
+    size_t both = 0;          // flagged either way
+    size_t trade_only = 0;    // missed on bars
+    size_t bar_only = 0;      // flagged on bars only
+    size_t same_trigger = 0;  // of both
+    // Bar detection time minus per-trade detection time, over both
+    double mean_lag_s = 0.0;
+    double p95_lag_s = 0.0;
+    double max_lag_s = 0.0;
+    // Mean absolute confidence difference, over both
+    double mean_confidence_diff = 0.0;
+    // Points the rule is evaluated at, at most, per trade and on bars
+    uint64_t trades = 0;
+    uint64_t bars = 0;
+
+    // Share of mints with the same verdict both ways
+    double agreement() const {
+        return mints == 0 ? 1.0
+                          : static_cast<double>(mints - trade_only - bar_only) /
+                                static_cast<double>(mints);
+    }
+};
+
+// Compare detectSeries and detectSeriesOnBars results for the same mints.
+// Throws std::invalid_argument if the three spans differ in length.
+BarToleranceReport compareBarDetection(
+    std::span<const TradeSeries> mints,
+    std::span<const DetectionResult> per_trade,
+    std::span<const DetectionResult> on_bars, std::chrono::seconds resolution);
+
+// Score every mint of a memory-mapped corpus, reading trades in place.
+// Mints are claimed in chunks of BATCH_CHUNK_SIZE by up to max_threads
+// threads (0 means hardware concurrency). Results come back in corpus
+// order.
+std::vector<DetectionResult> detectCorpus(const TradeCorpus& corpus,
+                                          const DetectionParams& config,
+                                          size_t max_threads = 0);
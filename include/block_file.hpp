@@ -0,0 +1,123 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include "trade_columns.hpp"
+
+// Plumbing shared by the trade corpus and the registry snapshot, which
+// use one layout: a header with magic, version and byte-order mark, one
+// block of trade columns per mint, an index of fixed-size entries and a
+// names section. Offsets and counts read back from a file are only used
+// after the checks here. Errors are std::runtime_error reading
+// "<kind> <path>: <what>".
+
+inline constexpr uint32_t BLOCK_FILE_BYTE_ORDER = 0x01020304;
+
+// Appends to a new file, tracking the offset. A file that was not
+// finished, or whose finish failed, is removed.
+class BlockFileWriter {
+public:
+  BlockFileWriter(std::string path, std::string kind);
+  ~BlockFileWriter();
+
+  BlockFileWriter(const BlockFileWriter &) = delete;
+  BlockFileWriter &operator=(const BlockFileWriter &) = delete;
+
+  bool isOpen() const { return file_ != nullptr; }
+  uint64_t offset() const { return offset_; }
+
+  void write(const void *data, size_t size);
+
+  // Block of trade columns, as TradeCorpus and the snapshot read them
+  void writeTrades(const TradeSeries &trades);
+
+  // Rewrite the header written first and close the file
+  void finish(const void *header, size_t size);
+
+  // finish, then flush to disk, move the file over target and sync the
+  // directory, so a crash leaves either the old target or the new one
+  void commit(const void *header, size_t size, const std::string &target);
+
+  std::runtime_error error(const std::string &what) const;
+
+private:
+  // Closes the file; false if the header could not be rewritten or the
+  // file not closed
+  bool close(const void *header, size_t size, bool sync);
+
+  std::string path_;
+  std::string kind_;
+  std::FILE *file_;
+  uint64_t offset_ = 0;
+};
+
+// Read-only mapping of a whole block file
+class MappedBlockFile {
+public:
+  // How the caller walks the file, passed on to madvise
+  enum class Access { Sequential, WillNeed };
+
+  // Throws if the file is shorter than header_size
+  MappedBlockFile(const std::string &path, std::string kind,
+                  size_t header_size, Access access);
+  ~MappedBlockFile();
+
+  MappedBlockFile(const MappedBlockFile &) = delete;
+  MappedBlockFile &operator=(const MappedBlockFile &) = delete;
+
+  std::runtime_error error(const std::string &what) const;
+
+  // The header, once magic, byte order and version match
+  template <typename Header>
+  const Header &header(const char (&magic)[8], uint32_t version) const {
+    const auto &header = *reinterpret_cast<const Header *>(data_);
+    if (std::memcmp(header.magic, magic, sizeof(header.magic)) != 0)
+      throw error("not a " + kind_);
+    if (header.byte_order != BLOCK_FILE_BYTE_ORDER)
+      throw error("written on a machine of other endianness");
+    if (header.version != version)
+      throw error("unsupported version " + std::to_string(header.version));
+    return header;
+  }
+
+  // count entries at offset; throws unless aligned and inside the file
+  template <typename Entry>
+  std::span<const Entry> array(uint64_t offset, uint64_t count) const {
+    if (offset % alignof(Entry) != 0 ||
+        !fits(offset, count, sizeof(Entry), size_))
+      throw error("truncated or corrupt");
+    return {reinterpret_cast<const Entry *>(data_ + offset),
+            static_cast<size_t>(count)};
+  }
+
+  // size bytes at offset; throws unless inside the file
+  std::string_view text(uint64_t offset, uint64_t size) const;
+
+  // The block of count trades at offset, if it is aligned and ends by
+  // limit (the start of the index)
+  std::optional<TradeSeries> trades(uint64_t offset, uint64_t count,
+                                    uint64_t limit) const;
+
+  // length bytes at offset into section, if they fit
+  static std::optional<std::string_view>
+  slice(std::string_view section, uint64_t offset, uint64_t length);
+
+private:
+  // Whether count items of item_size at offset end by limit, without
+  // overflowing on values read from the file
+  static bool fits(uint64_t offset, uint64_t count, uint64_t item_size,
+                   uint64_t limit) {
+    return offset <= limit && count <= (limit - offset) / item_size;
+  }
+
+  std::string path_;
+  std::string kind_;
+  const std::byte *data_ = nullptr;
+  size_t size_ = 0;
+};
@@ -0,0 +1,26 @@
+#pragma once
+#include <vector>
+
+// Where a CPU sits, as Linux reports it under /sys/devices/system
+struct CpuSlot {
+  int cpu = -1;
+  // NUMA node, 0 where the kernel has no NUMA information
+  int node = 0;
+  // Physical core id within its package, shared by SMT siblings
+  int core = -1;
+  // 0 for the first hardware thread of its core, 1 for the next...
+  int smt_index = 0;
+};
+
+// The CPUs this process is allowed to run on (its affinity mask), in the
+// order workers should be pinned to them: one hardware thread per physical
+// core before any SMT sibling, and within that node by node, so that a
+// pool smaller than the machine stays on as few nodes as possible and
+// never shares a core while a free one is left. Empty where unsupported.
+std::vector<CpuSlot> pinningOrder();
+
+// Bind the calling thread to one CPU. False where unsupported or refused.
+bool pinCurrentThread(int cpu);
+
+// CPU the calling thread is running on now, -1 where unknown
+int currentCpu();
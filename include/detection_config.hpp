@@ -15,3 +15,26 @@ struct DetectionConfig {
   static constexpr double stop_loss_threshold = 0.40; // 40% drop
   static constexpr int max_detection_time = 60;
 };
+
+// Runtime counterpart of DetectionConfig for tuning and backtests: the same
+// thresholds as plain members, defaulting to the compiled-in values. A
+// DetectionConfig converts to the defaults, so anything taking
+// DetectionParams also accepts DetectionConfig{}.
+struct DetectionParams {
+  DetectionParams() = default;
+  DetectionParams(const DetectionConfig &) {}
+
+  double peak_drop_threshold = DetectionConfig::peak_drop_threshold;
+  int time_from_peak_threshold = DetectionConfig::time_from_peak_threshold;
+  double volume_spike_threshold = DetectionConfig::volume_spike_threshold;
+  double min_confidence_score = DetectionConfig::min_confidence_score;
+  double early_warning_threshold = DetectionConfig::early_warning_threshold;
+  int consecutive_drops_threshold =
+      DetectionConfig::consecutive_drops_threshold;
+  double price_velocity_threshold = DetectionConfig::price_velocity_threshold;
+  double pattern_strength_threshold =
+      DetectionConfig::pattern_strength_threshold;
+  int short_window = DetectionConfig::short_window;
+  double stop_loss_threshold = DetectionConfig::stop_loss_threshold;
+  int max_detection_time = DetectionConfig::max_detection_time;
+};
@@ -1,8 +1,12 @@
 #pragma once
+#include <cstdint>
 #include <string>
 #include <optional>
 #include <chrono>
 
+// Which decision rule fired; trigger_type in DetectionResult is its name
+enum class SweepTrigger : uint8_t { None, StopLoss, Pattern };
+
 struct DetectionResult {
     bool rug_pulled = false;
     std::optional<std::chrono::system_clock::time_point> timestamp;
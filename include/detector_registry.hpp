@@ -0,0 +1,171 @@
+#pragma once
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string_view>
+#include "detection_config.hpp"
+#include "detection_result.hpp"
+#include "risk_priority.hpp"
+#include "trade.hpp"
+#include "trade_columns.hpp"
+
+struct RegistryOptions {
+  // Rounded up to a power of two
+  size_t shard_count = 64;
+  // Hard cap on bytes held by all mints, split evenly across shards. When a
+  // shard goes over, its least recently updated mints are evicted.
+  size_t memory_budget_bytes = size_t{1} << 30;
+  // Mints with no update for this long are dropped, matching the TTL on
+  // the recent_trades:* keys
+  std::chrono::seconds idle_ttl = std::chrono::hours(24);
+};
+
+// Members a cursor remembers at its boundary score
+inline constexpr size_t MAX_CURSOR_TIES = 4;
+
+// Where a mint's feed left off
+struct MintCursor {
+  double last_score = -std::numeric_limits<double>::infinity();
+  // memberHash() of each member scored exactly last_score, so one added
+  // later with the same score is still fetched. Empty when unknown (more
+  // than MAX_CURSOR_TIES ties); the next fetch then starts strictly above
+  // last_score.
+  std::array<uint64_t, MAX_CURSOR_TIES> last_members{};
+  uint8_t last_member_count = 0;
+  bool reported = false;
+
+  std::span<const uint64_t> lastMembers() const {
+    return {last_members.data(), last_member_count};
+  }
+};
+
+// Everything the registry holds for one mint, for saving and restoring it
+// across restarts. mint and trades point into memory owned by whoever made
+// the snapshot and are only valid for the call they are passed to.
+struct MintSnapshot {
+  std::string_view mint;
+  // The tail still reachable by the detection window; empty once reported
+  TradeSeries trades;
+  double peak_mc = 0.0;
+  int64_t peak_time_us = 0;
+  int64_t analysis_start_us = 0;
+  size_t current_idx = 0;
+  // SlidingWindowStats edges, indices into trades
+  size_t window_begin = 0;
+  size_t window_end = 0;
+  MintCursor cursor;
+  // Wall-clock time of the last update, so idle expiry carries over
+  int64_t last_update_us = 0;
+};
+
+struct RegistryStats {
+  size_t mints = 0;
+  // Resident trades; only the tail still reachable by the detection window
+  // is kept
+  size_t trades = 0;
+  // Reported mints evicted for the budget, remembered by name only
+  size_t tombstones = 0;
+  // Bytes handed out by the shard arenas, tables included
+  size_t bytes = 0;
+  uint64_t evicted_idle = 0;
+  uint64_t evicted_budget = 0;
+
+  double bytesPerMint() const {
+    return mints ? static_cast<double>(bytes) / static_cast<double>(mints)
+                 : 0.0;
+  }
+};
+
+// Detector state for many concurrently tracked mints.
+//
+// Mints are sharded by hash; each shard has its own lock, an open-addressing
+// index and a pool arena that every allocation for its mints comes from, so
+// the per-trade cost is one hash, one probe sequence and the detection step,
+// whatever the number of mints. A mint keeps the scalars processTrades
+// carries between calls plus the trades still reachable by its detection
+// window; older trades are compacted away, and once a mint is reported its
+// trades are freed and only the verdict is kept. A reported mint evicted
+// for the memory budget leaves its name behind, so it is never reported
+// twice; only idle expiry or erase() forgets it.
+//
+// Thread-safe. Updates for mints in different shards run in parallel;
+// updates for one mint must come in timestamp order.
+class DetectorRegistry {
+public:
+  using Clock = std::chrono::steady_clock;
+
+  explicit DetectorRegistry(RegistryOptions options = {});
+  ~DetectorRegistry();
+
+  DetectorRegistry(const DetectorRegistry &) = delete;
+  DetectorRegistry &operator=(const DetectorRegistry &) = delete;
+
+  // Defaults for an untracked mint
+  MintCursor cursor(std::string_view mint) const;
+
+  // Scheduling signals from the trades a mint still holds, as of its last
+  // trade: the rate is over those trades (about the detection window).
+  // Empty for an untracked or already reported mint.
+  std::optional<RiskSignals> riskSignals(std::string_view mint) const;
+
+  // Append trades (in timestamp order, none older than those already added)
+  // and run detection over them, tracking the mint if it is new. A mint is
+  // reported once; trades for it after that are ignored. last_score and
+  // last_members are stored for cursor(). max_detection_time should not
+  // change between calls for the same mint.
+  DetectionResult update(std::string_view mint, std::span<const Trade> trades,
+                         double last_score,
+                         std::span<const uint64_t> last_members,
+                         const DetectionParams &params,
+                         Clock::time_point now = Clock::now());
+  DetectionResult update(std::string_view mint, std::span<const Trade> trades,
+                         double last_score, const DetectionParams &params,
+                         Clock::time_point now = Clock::now()) {
+    return update(mint, trades, last_score, {}, params, now);
+  }
+
+  // Forget a mint whose key expired or was deleted
+  bool erase(std::string_view mint);
+
+  // Forget every mint pred holds for, such as those another process took
+  // over; returns how many. pred runs under a shard lock.
+  size_t eraseIf(const std::function<bool(std::string_view)> &pred);
+
+  // Call f with every tracked mint, tombstones included (as reported mints
+  // with no trades). Each shard is copied under its lock and f runs on the
+  // copy with the lock released, so f may block (on disk I/O, say) without
+  // stalling updates. Each mint's state matches its cursor, so a restored
+  // mint resumes exactly where its feed left off, even though mints in
+  // different shards are seen at slightly different times.
+  void forEachMint(const std::function<void(const MintSnapshot &)> &f) const;
+
+  // Track a mint as forEachMint saw it. Returns false, leaving the registry
+  // unchanged, if the mint is already tracked, has been idle for longer than
+  // idle_ttl, or its indices do not fit its trades. Restore mints oldest
+  // update first so eviction order is kept.
+  bool restore(const MintSnapshot &mint, Clock::time_point now = Clock::now());
+
+  // Drop every mint idle for longer than idle_ttl. update() already does
+  // this incrementally for the shard it touches; call it periodically so
+  // shards that stop receiving trades are cleaned up too. Also publishes
+  // the registry_bytes gauge, as stats() does.
+  size_t evictIdle(Clock::time_point now = Clock::now());
+
+  size_t size() const;
+  RegistryStats stats() const;
+
+private:
+  struct Shard;
+
+  Shard &shardFor(uint64_t hash) const;
+
+  RegistryOptions options_;
+  size_t shard_mask_;
+  std::unique_ptr<Shard[]> shards_;
+};
@@ -0,0 +1,48 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+
+// Lets idle workers sleep without losing wakeups. A waiter announces itself
+// with prepareWait(), re-checks for work, then either cancelWait()s or
+// wait()s on the key it got. A notifier that publishes work first and then
+// calls notify*() either sees the waiter and bumps the epoch (so wait()
+// returns at once), or the waiter's re-check sees the work. Sleeping uses
+// std::atomic::wait, which is a futex on Linux, and notify costs a single
+// load when nobody is waiting.
+class EventCount {
+public:
+  using Key = uint32_t;
+
+  Key prepareWait() {
+    waiters_.fetch_add(1, std::memory_order_seq_cst);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    return epoch_.load(std::memory_order_seq_cst);
+  }
+
+  void cancelWait() { waiters_.fetch_sub(1, std::memory_order_seq_cst); }
+
+  void wait(Key key) {
+    epoch_.wait(key, std::memory_order_seq_cst);
+    waiters_.fetch_sub(1, std::memory_order_seq_cst);
+  }
+
+  void notifyOne() {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (waiters_.load(std::memory_order_seq_cst) != 0) {
+      epoch_.fetch_add(1, std::memory_order_seq_cst);
+      epoch_.notify_one();
+    }
+  }
+
+  void notifyAll() {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (waiters_.load(std::memory_order_seq_cst) != 0) {
+      epoch_.fetch_add(1, std::memory_order_seq_cst);
+      epoch_.notify_all();
+    }
+  }
+
+private:
+  alignas(64) std::atomic<Key> epoch_{0};
+  alignas(64) std::atomic<Key> waiters_{0};
+};
@@ -0,0 +1,54 @@
+#pragma once
+#include <cstddef>
+#include <string>
+#include <hiredis/hiredis.h>
+#include "detection_config.hpp"
+#include "detection_result.hpp"
+#include "redis_client.hpp"
+#include "trade_columns.hpp"
+#include "worker_arena.hpp"
+
+// Trades per ZRANGEBYSCORE ... LIMIT page in KeyWorker::checkWindowed
+constexpr size_t WINDOWED_PAGE_SIZE = 512;
+
+// One-shot checks of whole keys, one at a time, from a single thread (a
+// TradeProcessor worker). Trades are decoded straight from the Redis reply
+// into columns in the worker's arena, and detection runs over those in
+// place, so once the arena has grown to fit the largest key, a check makes
+// no heap allocations of its own.
+class KeyWorker {
+public:
+  struct Check {
+    size_t trade_count = 0;
+    DetectionResult result;
+  };
+
+  explicit KeyWorker(size_t arena_bytes = WorkerArena::DEFAULT_BYTES);
+
+  // Fetch key with ZRANGE ... WITHSCORES and run detection over it
+  Check check(RedisClient &redis, const std::string &key,
+              const DetectionParams &params);
+
+  // Same result as check(redis, key, params), fetching only what detection
+  // can reach. A server-side script finds the peak and the first trade
+  // either trigger could fire on, by its drop and time from the peak.
+  // Nothing before that trade can fire, so only max_detection_time seconds
+  // of history ahead of it are fetched, then pages of WINDOWED_PAGE_SIZE
+  // trades until a detection or the end of the key. trade_count is still
+  // the whole key's. Falls back to check() when params let the pattern
+  // trigger fire with no drop.
+  Check checkWindowed(RedisClient &redis, const std::string &key,
+                      const DetectionParams &params);
+
+  // Same for a reply fetched elsewhere (a pipeline, say). Throws
+  // std::runtime_error if it is not WITHSCORES output.
+  Check check(const redisReply &reply, const DetectionParams &params);
+
+  size_t arenaCapacity() const { return arena_.capacity(); }
+
+private:
+  static Check detect(const TradeColumns &columns,
+                      const DetectionParams &params);
+
+  WorkerArena arena_;
+};
@@ -0,0 +1,86 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <optional>
+#include <string>
+#include <unordered_set>
+#include "detection_config.hpp"
+#include "detection_result.hpp"
+#include "detector_registry.hpp"
+#include "redis_client.hpp"
+#include "shard_membership.hpp"
+
+// Result of feeding one key's new trades to its resident detector
+struct LiveUpdate {
+    size_t new_trades = 0;
+    std::optional<DetectionResult> detection;
+};
+
+// Where and how often the monitor saves its per-mint state
+struct SnapshotOptions {
+    std::string path;
+    std::chrono::seconds interval{60};
+};
+
+// Long-running monitor that keeps detector state per mint in memory, in a
+// DetectorRegistry. Each update fetches only the trades scored after the
+// last one seen for that key, so the cost of a check follows the number of
+// new trades rather than the length of the key's history. Not thread-safe:
+// run() drives all updates from the calling thread.
+//
+// Connection settings, cluster mode included, come from the
+// RedisClientRegistry options. With sharding, several monitors split the
+// mints between them (see ShardMembership) and each only tracks its own.
+//
+// With snapshots, per-mint state is saved periodically and restored on
+// start, so after a restart each mint resumes from its saved cursor and
+// only the trades written while the monitor was down are fetched.
+class LiveMonitor {
+public:
+    using DetectionCallback =
+        std::function<void(const std::string& key, const DetectionResult&)>;
+
+    explicit LiveMonitor(const std::string& redis_url,
+                         DetectionParams config = {},
+                         RegistryOptions registry_options = {},
+                         std::optional<MembershipOptions> sharding = {},
+                         std::optional<SnapshotOptions> snapshots = {});
+
+    // Pull new trades for key into its detector and run detection over them.
+    // A mint is reported at most once; later updates for it are ignored.
+    LiveUpdate onTradesAdded(const std::string& key);
+
+    // Forget a key that expired or was deleted
+    void onKeyRemoved(const std::string& key);
+
+    // Subscribe to keyspace notifications for recent_trades:* (on every
+    // master of a cluster) and process updates until stop is set. Existing
+    // keys are primed via SCAN first so nothing written before the
+    // subscription is missed. With sharding, keys owned by other members
+    // are skipped, and when membership changes, mints that moved away are
+    // dropped and keys are scanned again for the ones that moved here.
+    // With snapshots, state is also saved every interval on a worker
+    // thread and once more on the way out.
+    void run(const std::atomic<bool>& stop, DetectionCallback on_detection);
+
+    // Write the snapshot now; returns the mints saved. Throws
+    // std::runtime_error on I/O failure or when snapshots are off.
+    size_t saveSnapshot() const;
+
+    size_t trackedMints() const { return registry_.size(); }
+    RegistryStats registryStats() const { return registry_.stats(); }
+
+private:
+    static void enableKeyspaceEvents(sw::redis::Redis& redis);
+    static void primeExistingKeys(sw::redis::Redis& redis,
+                                  std::unordered_set<std::string>& pending);
+    void loadSnapshot();
+    void saveSnapshotLogged() const;
+
+    DetectionParams config_;
+    RedisClient redis_;
+    DetectorRegistry registry_;
+    std::optional<ShardMembership> membership_;
+    std::optional<SnapshotOptions> snapshots_;
+};
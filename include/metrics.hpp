@@ -0,0 +1,151 @@
+#pragma once
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Process-wide counters and per-stage latency histograms.
+//
+// Every thread records into its own shard, so the hot path costs a clock
+// read and a couple of uncontended relaxed stores. Readers merge the shards
+// on demand. Histograms are log-linear (HDR style): 16 linear sub-buckets
+// per power of two, i.e. values are kept to within 1/16 (about 6%), from
+// 1 ns up to 2^48 ns (about 78 hours).
+namespace metrics {
+
+enum class Stage : uint8_t {
+  RedisFetch,   // Redis round trip(s) for one key or batch
+  Decode,       // turning members into Trades
+  Detect,       // RugPullDetector::processTrades
+  QueueWait,    // TradeProcessor: submitted until a worker picks it up
+  Task,         // TradeProcessor: handler run time
+  DetectionLag, // wall clock at detection minus the triggering trade's time
+};
+inline constexpr size_t STAGE_COUNT = 6;
+
+enum class Counter : uint8_t {
+  KeysFetched,
+  TradesDecoded,
+  ParseErrors,
+  RedisErrors,
+  Detections,
+  TasksCompleted,
+  MintsEvicted,
+  TradesDropped, // StreamingDetector ring full
+  // TradeProcessor tasks finished after their class's deadline, in
+  // RiskClass order
+  DeadlineMissesHigh,
+  DeadlineMissesMedium,
+  DeadlineMissesLow,
+  TasksShed, // low-risk tasks dropped under overload
+};
+inline constexpr size_t COUNTER_COUNT = 12;
+
+// Levels rather than totals; shared by every thread, so only for values
+// that change far less often than once per trade
+enum class Gauge : uint8_t {
+  TrackedMints, // mints resident in DetectorRegistry instances
+  RegistryBytes, // bytes those mints hold in the registry arenas, as of
+                 // the last idle sweep or stats() call
+  ShardMembers,  // live processes in this process's shard group
+};
+inline constexpr size_t GAUGE_COUNT = 3;
+
+// snake_case names used in every export
+const char *stageName(Stage stage);
+const char *counterName(Counter counter);
+const char *gaugeName(Gauge gauge);
+
+inline constexpr unsigned SUB_BUCKET_BITS = 4;
+inline constexpr unsigned MAX_VALUE_BITS = 48;
+inline constexpr size_t BUCKET_COUNT =
+    (MAX_VALUE_BITS - SUB_BUCKET_BITS + 1) << SUB_BUCKET_BITS;
+
+size_t bucketIndex(uint64_t value_ns);
+// Largest value that lands in bucket i
+uint64_t bucketUpperBound(size_t index);
+
+struct HistogramSnapshot {
+  std::vector<uint64_t> buckets = std::vector<uint64_t>(BUCKET_COUNT);
+  uint64_t count = 0;
+  uint64_t sum_ns = 0;
+  uint64_t max_ns = 0;
+
+  // Upper bound of the bucket holding the q-th quantile (0 <= q <= 1),
+  // capped at the largest value seen. 0 when empty.
+  uint64_t percentile(double q) const;
+  // Values <= limit_ns, at bucket resolution
+  uint64_t countAtOrBelow(uint64_t limit_ns) const;
+  double meanNs() const {
+    return count ? static_cast<double>(sum_ns) / static_cast<double>(count)
+                 : 0.0;
+  }
+};
+
+struct Snapshot {
+  std::array<uint64_t, COUNTER_COUNT> counters{};
+  std::array<int64_t, GAUGE_COUNT> gauges{};
+  std::array<HistogramSnapshot, STAGE_COUNT> stages;
+
+  uint64_t counter(Counter c) const {
+    return counters[static_cast<size_t>(c)];
+  }
+  int64_t gauge(Gauge g) const { return gauges[static_cast<size_t>(g)]; }
+  const HistogramSnapshot &stage(Stage s) const {
+    return stages[static_cast<size_t>(s)];
+  }
+};
+
+void add(Counter counter, uint64_t amount = 1);
+void record(Stage stage, std::chrono::nanoseconds duration);
+void adjust(Gauge gauge, int64_t delta);
+
+// Counts a detection and records how far behind the triggering trade it
+// came (DetectionLag). Online paths only: replayed trades are old by design.
+inline void recordDetection(std::chrono::system_clock::time_point trade_time) {
+  add(Counter::Detections);
+  record(Stage::DetectionLag, std::chrono::system_clock::now() - trade_time);
+}
+
+// Merge of every thread's shard, including threads that have exited
+Snapshot snapshot();
+
+// Zero counters and histograms. Best effort while other threads are
+// recording: a value recorded at the same moment may survive the reset.
+// Gauges track live state and are left alone.
+void reset();
+
+// Prometheus text exposition format (version 0.0.4): counters as
+// rugpull_<name>_total, gauges as rugpull_<name>, stages as the rugpull_stage_seconds histogram
+// labelled by stage
+std::string renderPrometheus(const Snapshot &snapshot);
+
+// One line per non-empty stage plus the counters, for the periodic log dump
+std::string renderSummary(const Snapshot &snapshot);
+
+// Records the time from construction to destruction, or to stop()
+class StageTimer {
+public:
+  explicit StageTimer(Stage stage)
+      : stage_(stage), started_(std::chrono::steady_clock::now()) {}
+  ~StageTimer() { stop(); }
+
+  StageTimer(const StageTimer &) = delete;
+  StageTimer &operator=(const StageTimer &) = delete;
+
+  void stop() {
+    if (running_) {
+      record(stage_, std::chrono::steady_clock::now() - started_);
+      running_ = false;
+    }
+  }
+
+private:
+  Stage stage_;
+  bool running_ = true;
+  std::chrono::steady_clock::time_point started_;
+};
+
+} // namespace metrics
@@ -0,0 +1,30 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <thread>
+
+// Minimal HTTP endpoint for Prometheus scrapes: GET /metrics returns
+// metrics::renderPrometheus(metrics::snapshot()), anything else 404.
+// One connection at a time on a background thread, which is plenty for a
+// scraper every few seconds. Throws std::runtime_error if the port cannot
+// be bound.
+class MetricsServer {
+public:
+  // Port 0 picks a free port; see port()
+  explicit MetricsServer(uint16_t port);
+  ~MetricsServer();
+
+  MetricsServer(const MetricsServer &) = delete;
+  MetricsServer &operator=(const MetricsServer &) = delete;
+
+  uint16_t port() const { return port_; }
+
+private:
+  void serve();
+  void handle(int client);
+
+  int listen_fd_;
+  uint16_t port_;
+  std::atomic<bool> stop_{false};
+  std::thread thread_;
+};
@@ -0,0 +1,46 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+#include "detection_config.hpp"
+#include "detection_result.hpp"
+
+// The latest decision-rule inputs of many mints, one column per feature, for
+// scoring them all at once under one config. Row i is the trade a detector
+// would look at next for mint i, with the values RugPullDetector::scan
+// computes for it.
+struct MintFeatureColumns {
+  std::vector<double> drop;            // fraction below the peak
+  std::vector<double> time_since_peak; // whole seconds
+  // Window stats where the pattern rule can fire (2+ trades in the window,
+  // 5+ seconds after the peak); NaN elsewhere, as in TradeFeatures
+  std::vector<double> pattern_strength;
+  std::vector<double> volume_trend;
+
+  size_t size() const { return drop.size(); }
+
+  void resize(size_t count);
+  void set(size_t i, double drop_fraction, double seconds_since_peak,
+           double pattern, double volume);
+};
+
+// Per-mint outcome of scoreMints, in row order
+struct MintScores {
+  // 1.0 on a stop loss, as in DetectionResult; otherwise the pattern score,
+  // whether or not it reached min_confidence_score
+  std::vector<double> confidence;
+  std::vector<SweepTrigger> trigger;
+
+  size_t size() const { return confidence.size(); }
+};
+
+// Score every row without per-mint branches, four mints per AVX2 vector
+// where the CPU has it. Same confidence and trigger as the detector's rule
+// applied to each row on its own. scores is resized to match and may be
+// reused across ticks without reallocating.
+void scoreMints(const MintFeatureColumns &features,
+                const DetectionParams &config, MintScores &scores);
+
+// Same, for rows [begin, end) only; scores[i] is row begin + i
+void scoreMints(const MintFeatureColumns &features, size_t begin,
+                size_t end, const DetectionParams &config,
+                MintScores &scores);
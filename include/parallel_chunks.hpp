@@ -0,0 +1,40 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+// Run chunk(begin, end) over [0, count) in chunks of chunk_size. Up to
+// max_threads threads (0 means hardware concurrency), the caller's among
+// them, claim chunks until none are left, so one slow chunk only holds up
+// its own thread. Each thread calls its own copy of chunk: state captured
+// by value (scratch buffers, say) is per thread.
+template <typename Chunk>
+void parallelChunks(size_t count, size_t chunk_size, size_t max_threads,
+                    const Chunk &chunk) {
+  if (count == 0)
+    return;
+
+  const size_t num_chunks = (count + chunk_size - 1) / chunk_size;
+  if (max_threads == 0)
+    max_threads = std::max(1u, std::thread::hardware_concurrency());
+  const size_t num_threads = std::min(max_threads, num_chunks);
+
+  std::atomic<size_t> next_chunk{0};
+  auto worker = [&]() {
+    Chunk local = chunk;
+    for (size_t c = next_chunk++; c < num_chunks; c = next_chunk++) {
+      const size_t begin = c * chunk_size;
+      local(begin, std::min(begin + chunk_size, count));
+    }
+  };
+
+  std::vector<std::thread> threads;
+  threads.reserve(num_threads - 1);
+  for (size_t i = 1; i < num_threads; ++i)
+    threads.emplace_back(worker);
+  worker();
+  for (auto &thread : threads)
+    thread.join();
+}
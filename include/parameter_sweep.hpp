@@ -0,0 +1,78 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+#include "detection_config.hpp"
+#include "detection_result.hpp"
+#include "mint_scorer.hpp"
+#include "trade_columns.hpp"
+
+// "stop_loss" / "pattern" as in DetectionResult, "" for None
+const char *triggerName(SweepTrigger trigger);
+
+// Outcome of one config on one mint; matches what
+// RugPullDetector::processTrades would return for it
+struct SweepHit {
+  SweepTrigger trigger = SweepTrigger::None;
+  int64_t timestamp_us = 0;     // first triggering trade
+  double confidence = 0.0;      // 1.0 for stop_loss, as in DetectionResult
+  double drop_percentage = 0.0;
+
+  bool detected() const { return trigger != SweepTrigger::None; }
+};
+
+// The config-independent part of a detection pass over one mint: for every
+// trade that has a non-empty window, the inputs the decision rule looks
+// at, one row per trade so scoreMints can score them in one pass. Depends
+// on max_detection_time only through the window.
+struct TradeFeatures : MintFeatureColumns {
+  std::vector<int64_t> timestamp_us;
+  std::vector<double> max_drop;           // running max of drop
+
+  size_t size() const { return timestamp_us.size(); }
+};
+
+TradeFeatures computeTradeFeatures(const TradeSeries &trades,
+                                   int max_detection_time);
+
+// Apply one config to precomputed features. The stop-loss hit is found by
+// binary search on max_drop; only trades before it are scored for the
+// pattern rule, with scoreMints. scores is scratch space that may be
+// reused across calls.
+SweepHit evaluateFeatures(const TradeFeatures &features,
+                          const DetectionParams &config, MintScores &scores);
+SweepHit evaluateFeatures(const TradeFeatures &features,
+                          const DetectionParams &config);
+
+// Hits for every (config, mint) pair, row-major by config
+class SweepResults {
+public:
+  SweepResults() = default;
+  SweepResults(size_t config_count, size_t mint_count)
+      : config_count_(config_count), mint_count_(mint_count),
+        hits_(config_count * mint_count) {}
+
+  size_t configCount() const { return config_count_; }
+  size_t mintCount() const { return mint_count_; }
+
+  SweepHit &at(size_t config, size_t mint) {
+    return hits_[config * mint_count_ + mint];
+  }
+  const SweepHit &at(size_t config, size_t mint) const {
+    return hits_[config * mint_count_ + mint];
+  }
+
+private:
+  size_t config_count_ = 0;
+  size_t mint_count_ = 0;
+  std::vector<SweepHit> hits_;
+};
+
+// Backtest a grid of configs over a corpus. Features are computed once per
+// mint (once per distinct max_detection_time in the grid) and every config
+// is evaluated against them. Mints are spread over up to max_threads
+// threads (0 means hardware concurrency).
+SweepResults runParameterSweep(std::span<const TradeSeries> mints,
+                               std::span<const DetectionParams> configs,
+                               size_t max_threads = 0);
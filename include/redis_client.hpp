@@ -1,27 +1,226 @@
 #pragma once
 #include "trade.hpp"
-#include <atomic>
+#include "trade_columns.hpp"
+#include <chrono>
+#include <cstdint>
 #include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
 #include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <variant>
 #include <sw/redis++/redis++.h>
 #include <vector>
 
+// Connection settings for a RedisClient. Zero timeouts mean "block".
+struct RedisClientOptions {
+    size_t pool_size = 8;
+    std::chrono::milliseconds connect_timeout{0};
+    std::chrono::milliseconds socket_timeout{0};
+    // How long a caller waits for a free pooled connection
+    std::chrono::milliseconds wait_timeout{0};
+    // Treat the URL as a seed node of a Redis Cluster; keys are routed to
+    // the master owning their hash slot, with a pool per master
+    bool cluster = false;
+};
+
+inline constexpr uint16_t CLUSTER_SLOTS = 16384;
+
+// Redis Cluster hash slot of a key (CRC16 mod CLUSTER_SLOTS), honouring
+// hash tags: if the key contains a non-empty {...}, only that part is hashed
+uint16_t clusterSlot(std::string_view key);
+
+// Thread-safe client over a redis++ connection pool, or one pool per master
+// of a Redis Cluster. Connections are opened lazily, the first time a
+// caller needs one, and reused after that.
 class RedisClient {
 public:
-    // Add connection pooling
-    explicit RedisClient(const std::string& url, size_t pool_size = 8)
-        : pool_size_(pool_size) {
-        connection_pool_.reserve(pool_size);
-        for (size_t i = 0; i < pool_size; ++i) {
-            connection_pool_.emplace_back(std::make_unique<sw::redis::Redis>(url));
-        }
-    }
+    explicit RedisClient(const std::string& url, size_t pool_size = 8);
+    RedisClient(const std::string& url, const RedisClientOptions& options);
+
+    // Trades newer than a score cursor, plus the cursor for the next call
+    struct TradeBatch {
+        std::vector<Trade> trades;
+        double last_score;
+        // memberHash() of every member scored exactly last_score
+        std::vector<uint64_t> last_members;
+    };
 
     // Use connection pooling for better concurrent performance
     std::vector<Trade> getTrades(const std::string& key);
 
+    // Same, appending to caller-owned columns (arena-backed, say). Members
+    // are decoded straight out of the reply buffer.
+    void getTrades(const std::string& key, TradeColumns& columns);
+
+    // Only the trades not seen yet, in score order: those scored above
+    // after_score, and those scored exactly after_score whose member is not
+    // in seen (a previous batch's last_members). With seen empty the bound
+    // is exclusive, so ties added later at after_score are missed. The
+    // cursor is unchanged when nothing new has arrived.
+    TradeBatch getTradesAfter(const std::string& key, double after_score,
+                              std::span<const uint64_t> seen = {});
+
+    // What a windowed check needs to know about a key, computed by a Lua
+    // script on the server so that no members cross the wire. Members the
+    // client could not decode are skipped, as appendReplyTrades does.
+    struct TradeSummary {
+        size_t count = 0;
+        double first_score = 0.0;
+        double peak_market_cap = 0.0;
+        // Earliest trade at the peak; 0 when no trade is above zero
+        double peak_score = 0.0;
+        // Earliest trade at least stop_drop below the peak (a fraction),
+        // or at least pattern_drop below it and pattern_delay seconds or
+        // more after it
+        std::optional<double> candidate_score;
+    };
+
+    // Empty when the key is missing or Redis failed
+    std::optional<TradeSummary> summarizeTrades(const std::string& key,
+                                                double stop_drop,
+                                                double pattern_drop,
+                                                double pattern_delay);
+
+    // One page of ZRANGEBYSCORE key min_score +inf WITHSCORES
+    // LIMIT offset count, appended to columns
+    struct TradePage {
+        // Pairs in the reply, decodable or not; 0 after a Redis error
+        size_t pairs = 0;
+        double last_score = 0.0;
+        // Pairs at the end of the page scored exactly last_score, to skip
+        // when the next page starts from last_score
+        size_t ties = 0;
+    };
+    TradePage getTradesPage(const std::string& key, double min_score,
+                            size_t offset, size_t count,
+                            TradeColumns& columns);
+
+    // Trades for many keys in one pipelined round trip, in key order.
+    // Missing keys, keys whose round trip failed, and keys whose reply is
+    // an error (WRONGTYPE, say) or does not decode yield an empty vector;
+    // the other keys are unaffected. On a cluster the keys are grouped by the master owning their
+    // slot, and the per-master pipelines run concurrently.
+    std::vector<std::vector<Trade>> getTradesBatch(
+        std::span<const std::string> keys);
+
+    // Outcome of convertToBinary for one key
+    struct Conversion {
+        size_t converted = 0;
+        size_t already_binary = 0;
+        // Members that do not decode, left as JSON
+        size_t skipped = 0;
+        // Sizes of the members rewritten, before and after
+        size_t bytes_before = 0;
+        size_t bytes_after = 0;
+    };
+
+    // Rewrite the key's JSON members as binary records (trade_record.hpp),
+    // in place. Fields the detector does not read are dropped. Each member
+    // is swapped atomically, and only if still present, so concurrent
+    // writers and the key's TTL are unaffected; readers handle both
+    // formats meanwhile. Redis errors propagate.
+    Conversion convertToBinary(const std::string& key);
+
+    // Every key matching a glob pattern, via SCAN (never KEYS), on every
+    // master of a cluster. Unlike the fetches above, Redis errors
+    // propagate: a partial listing is not something callers can detect.
+    std::vector<std::string> scanKeys(const std::string& pattern);
+
+    // Where to reach each server holding keys: the one server, or every
+    // master of a cluster as CLUSTER SLOTS lists them. Credentials and
+    // timeouts are those of the client. Redis errors propagate.
+    std::vector<sw::redis::ConnectionOptions> nodes();
+
+    // Renew member's lease in a group (a sorted set scored by lease expiry
+    // in server milliseconds), drop expired members, and return the live
+    // ones in name order. Redis errors propagate.
+    std::vector<std::string> renewMember(const std::string& group,
+                                         const std::string& member,
+                                         std::chrono::milliseconds lease);
+
+    // Leave a group ahead of the lease running out. Redis errors propagate.
+    void removeMember(const std::string& group, const std::string& member);
+
+    bool isCluster() const {
+        return std::holds_alternative<sw::redis::RedisCluster>(redis_);
+    }
+
+    // Blocking pop from a list of keys to process (BLPOP). Empty when
+    // nothing arrived within the timeout or Redis failed; holds a pooled
+    // connection while it waits.
+    std::optional<std::string> popKey(const std::string& list,
+                                      std::chrono::seconds timeout);
+
+private:
+    // A cluster's masters and which of them owns each hash slot, as
+    // CLUSTER SLOTS lists them
+    struct ClusterLayout {
+        std::vector<sw::redis::ConnectionOptions> masters;
+        // Index into masters per slot; NO_MASTER while a slot is unassigned
+        std::vector<uint16_t> slot_master;
+        static constexpr uint16_t NO_MASTER = UINT16_MAX;
+    };
+
+    ClusterLayout queryLayout(sw::redis::RedisCluster& cluster);
+
+    // Cached; refreshed on the next call after invalidateLayout()
+    std::shared_ptr<const ClusterLayout> layout(
+        sw::redis::RedisCluster& cluster);
+    void invalidateLayout();
+
+    // ZRANGE key 0 -1 WITHSCORES; null when the key is missing. Throws on
+    // Redis errors.
+    sw::redis::ReplyUPtr fetchAll(const std::string& key);
+
+    // getTradesBatch on a cluster
+    void fetchBatchFromCluster(sw::redis::RedisCluster& cluster,
+                               std::span<const std::string> keys,
+                               std::vector<std::vector<Trade>>& trades);
+
+    // Calls f with a sw::redis::Redis that reaches the server holding key:
+    // the client itself, or for a cluster a pooled connection to the master
+    // owning the key's slot. For commands redis++ cannot route, such as
+    // EVAL, whose key comes after other arguments.
+    template <typename F>
+    decltype(auto) withNodeFor(const std::string& key, F&& f) {
+        if (auto* cluster = std::get_if<sw::redis::RedisCluster>(&redis_)) {
+            auto node = cluster->redis(key, false);
+            return f(node);
+        }
+        return f(std::get<sw::redis::Redis>(redis_));
+    }
+
+    sw::redis::ConnectionOptions connection_;
+    std::variant<sw::redis::Redis, sw::redis::RedisCluster> redis_;
+
+    // SHA1 of the summary script once loaded; reloaded after NOSCRIPT
+    std::mutex script_mutex_;
+    std::string summary_sha_;
+
+    std::mutex layout_mutex_;
+    std::shared_ptr<const ClusterLayout> layout_;
+};
+
+// Process-wide clients keyed by URL, created on first use and shared by
+// every caller and thread in the process (the Python module, the
+// TradeProcessor workers)
+class RedisClientRegistry {
+public:
+    static RedisClientRegistry& instance();
+
+    std::shared_ptr<RedisClient> get(const std::string& url);
+
+    // Options for clients created from now on. Cached clients are dropped;
+    // callers still holding one keep using it until they let go.
+    void configure(const RedisClientOptions& options);
+    RedisClientOptions options() const;
+
 private:
-    size_t pool_size_;
-    std::vector<std::unique_ptr<sw::redis::Redis>> connection_pool_;
-    static std::atomic<size_t> counter;
+    mutable std::mutex mutex_;
+    RedisClientOptions options_;
+    std::unordered_map<std::string, std::shared_ptr<RedisClient>> clients_;
 };
@@ -0,0 +1,85 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include "detector_registry.hpp"
+
+// On-disk snapshot of a DetectorRegistry, for warm restarts of the live
+// monitor.
+//
+//   header     SnapshotHeader, 64 bytes
+//   blocks     one per mint, the trades it still holds, laid out like a
+//              corpus block: int64 timestamp_us[n], double market_cap_sol[n],
+//              double sol_amount[n]
+//   index      SnapshotMintEntry[mint_count]
+//   names      mint keys, concatenated
+//
+// Byte order and alignment follow the trade corpus (block_file.hpp).
+struct SnapshotHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t byte_order;
+  uint64_t mint_count;
+  uint64_t trade_count;
+  uint64_t index_offset;
+  uint64_t names_offset;
+  uint64_t names_size;
+  // The windows were built for this max_detection_time
+  int32_t max_detection_time;
+  uint32_t reserved;
+};
+static_assert(sizeof(SnapshotHeader) == 64);
+
+// MintSnapshot, flattened
+struct SnapshotMintEntry {
+  uint64_t block_offset;
+  uint64_t trade_count;
+  uint64_t name_offset; // into the names section
+  uint64_t name_length;
+  double peak_mc;
+  int64_t peak_time_us;
+  int64_t analysis_start_us;
+  uint64_t current_idx;
+  uint64_t window_begin;
+  uint64_t window_end;
+  double last_score;
+  // MintCursor::last_members, so ties at last_score resume as they were
+  uint64_t last_members[MAX_CURSOR_TIES];
+  uint32_t last_member_count;
+  uint32_t flags; // SNAPSHOT_REPORTED
+  int64_t last_update_us;
+};
+static_assert(sizeof(SnapshotMintEntry) == 136);
+
+inline constexpr char SNAPSHOT_MAGIC[8] = {'R', 'U', 'G', 'S',
+                                           'N', 'A', 'P', 'S'};
+// 2 added the cursor's tie members and dropped the window's volume sum
+inline constexpr uint32_t SNAPSHOT_VERSION = 2;
+inline constexpr uint32_t SNAPSHOT_REPORTED = 1;
+
+// Write every mint of registry to path. The file is built next to path,
+// synced, and renamed over it (the directory is synced after), so a crash
+// at any point leaves either the previous snapshot or the new one, never a
+// torn file. No shard lock is held while writing. Returns the number of
+// mints written. Throws std::runtime_error on I/O failure.
+size_t saveRegistrySnapshot(const DetectorRegistry &registry,
+                            const std::string &path, int max_detection_time);
+
+struct SnapshotLoad {
+  size_t restored = 0;
+  // Already tracked, idle past the TTL, rejected by keep, or inconsistent
+  size_t skipped = 0;
+  // Trades copied into the registry
+  uint64_t trades = 0;
+};
+
+// Memory-map a snapshot and restore its mints into registry, oldest update
+// first, skipping those keep rejects (when given). Throws
+// std::runtime_error if the file is missing, truncated or corrupt, or was
+// saved for another max_detection_time.
+SnapshotLoad
+loadRegistrySnapshot(DetectorRegistry &registry, const std::string &path,
+                     int max_detection_time,
+                     const std::function<bool(std::string_view)> &keep = {});
@@ -0,0 +1,43 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include "detection_config.hpp"
+
+// Scheduling class of a mint, most urgent first
+enum class RiskClass : uint8_t {
+  High,   // within reach of the stop loss, or dumping while busy
+  Medium, // off its peak or trading briskly; also mints with no signals
+  Low,    // quiet
+};
+inline constexpr size_t RISK_CLASS_COUNT = 3;
+
+// snake_case, as in metric names
+const char *riskClassName(RiskClass risk);
+
+// What is known about a mint before its key is fetched, from its resident
+// state (DetectorRegistry::riskSignals) or from whoever queued it
+struct RiskSignals {
+  double drop_from_peak = 0.0; // (peak - last) / peak
+  double seconds_since_peak = 0.0;
+  double trades_per_second = 0.0; // over the detection window
+};
+
+struct RiskPolicy {
+  // Drop at which a mint is High whatever else it does: most of the way to
+  // stop_loss_threshold, so the next few trades may trigger it
+  double high_drop = 0.30;
+  // Drop at which a mint is at least Medium, and High if it is also busy
+  // and still close enough to its peak for the pattern trigger
+  double medium_drop = DetectionConfig::peak_drop_threshold;
+  double pattern_seconds = DetectionConfig::time_from_peak_threshold;
+  // Trade rate at which a mint is at least Medium
+  double busy_trades_per_second = 2.0;
+};
+
+RiskClass classify(const RiskSignals &signals, const RiskPolicy &policy = {});
+
+// Parse "DROP SECONDS_SINCE_PEAK TRADES_PER_SECOND" (space separated), as a
+// producer may append to a queued key. Empty when malformed.
+std::optional<RiskSignals> parseRiskSignals(std::string_view text);
@@ -5,10 +5,11 @@
 #include <deque>
 #include <memory>
 #include <span>
-#include <map>
 #include "detection_config.hpp"
 #include "trade.hpp"
+#include "trade_columns.hpp"
 #include "detection_result.hpp"
+#include "window_stats.hpp"
 
 // Pre-allocated buffer size for trades
 constexpr size_t INITIAL_TRADE_BUFFER = 1024;
@@ -19,59 +20,62 @@ public:
         : data_mutex_()
         , trades_()
         , peak_mc_(0.0)
-        , peak_time_(std::chrono::system_clock::now())
-        , analysis_start_time_(peak_time_)
-        , current_idx_(0) {
+        , peak_time_us_(toMicros(std::chrono::system_clock::now()))
+        , analysis_start_us_(peak_time_us_)
+        , current_idx_(0)
+        , window_() {
         trades_.reserve(INITIAL_TRADE_BUFFER);
     }
 
     // Public interface
     void addTrade(Trade&& trade);
-    DetectionResult processTrades(const DetectionConfig& config);
 
-private:
-    // Cache frequently computed values
-    struct WindowStats {
-        double volume_trend;        // Equivalent to volume_changes.mean()
-        double price_velocity;      // Equivalent to price_changes.mean()
-        int consecutive_drops;      // Equivalent to sum(price_drops[-3:])
-        double pattern_strength;    // Pattern strength calculation
-
-        WindowStats() 
-            : volume_trend(0)
-            , price_velocity(0)
-            , consecutive_drops(0)
-            , pattern_strength(0) {}
-    };
-
-    // Private member functions
-    std::span<const Trade> getRecentTrades(
-        const std::chrono::system_clock::time_point& current_time) const;
+    // Thresholds may change between calls, but max_detection_time should
+    // not: the window resumes where the previous call left it
+    DetectionResult processTrades(const DetectionParams& config);
 
-    WindowStats computeWindowStats(std::span<const Trade> window_trades) const;
+    // One-shot detection over trades stored elsewhere (a memory-mapped
+    // corpus, say), without copying them. Same result as adding them all
+    // to a fresh detector and calling processTrades once.
+    static DetectionResult detect(const TradeSeries& trades,
+                                  const DetectionParams& config);
 
-    double calculateConfidence(
+    // Pattern-trigger score; shared with the parameter sweep
+    static double calculateConfidence(
         double drop,
         double time_diff,
         double pattern,
         double volume,
-        const DetectionConfig& config) const;
+        const DetectionParams& config);
 
-    DetectionResult buildResult(
-        bool detected,
+    // The detection loop, resuming at current_idx and advancing window.
+    // Public for callers that keep trades in their own storage
+    // (DetectorRegistry); peak_* must cover every trade in the series.
+    static DetectionResult scan(
+        const TradeSeries& trades,
+        double peak_mc,
+        int64_t peak_time_us,
+        int64_t analysis_start_us,
+        size_t& current_idx,
+        SlidingWindowStats& window,
+        const DetectionParams& config);
+
+private:
+    // A positive result; the stop-loss trigger reports confidence 1.0
+    static DetectionResult buildResult(
         const std::chrono::system_clock::time_point& timestamp,
-        const std::string& trigger,
-        const std::map<std::string, double>& metrics) const;
+        const char* trigger,
+        double confidence,
+        double drop_percentage,
+        double peak_market_cap,
+        double current_market_cap);
 
     // Member variables - order must match initialization order in constructor
     mutable std::shared_mutex data_mutex_;
-    std::vector<Trade> trades_;
+    TradeColumns trades_;
     double peak_mc_;
-    std::chrono::system_clock::time_point peak_time_;
-    std::chrono::system_clock::time_point analysis_start_time_;
+    int64_t peak_time_us_;
+    int64_t analysis_start_us_;
     size_t current_idx_;
-
-    // Thread-local storage for temporary calculations
-    static thread_local std::vector<double> price_changes_;
-    static thread_local std::vector<double> volume_changes_;
+    SlidingWindowStats window_;
 };
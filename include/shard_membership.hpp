@@ -0,0 +1,55 @@
+#pragma once
+#include <chrono>
+#include <string>
+#include <string_view>
+#include "redis_client.hpp"
+#include "shard_ring.hpp"
+
+struct MembershipOptions {
+  // This process's name in the group, unique among its live members
+  std::string id;
+  // Sorted set holding the group's leases
+  std::string group_key = "rugpull:shards";
+  // A member that has not renewed for this long is dropped by the others
+  std::chrono::milliseconds lease{10'000};
+  size_t virtual_nodes = ShardRing::DEFAULT_VIRTUAL_NODES;
+};
+
+// One process's seat in a group of detector processes that split the mints
+// between them on a ShardRing. Members hold leases in Redis and renew them
+// from refresh(); whenever the live member list changes, every member
+// rebuilds the same ring and hands over or picks up the mints that moved.
+//
+// A member that cannot reach Redis keeps its last ring: for at most one
+// lease the others may also cover its mints, so a mint can be checked
+// twice around a change, but none is left unowned. Not thread-safe.
+class ShardMembership {
+public:
+  // Joins right away; if Redis is unreachable the member starts out alone
+  // and owns every key until a refresh gets through
+  ShardMembership(RedisClient &redis, MembershipOptions options);
+  // Leaves the group, so the others take over without waiting for the
+  // lease to lapse
+  ~ShardMembership();
+
+  ShardMembership(const ShardMembership &) = delete;
+  ShardMembership &operator=(const ShardMembership &) = delete;
+
+  // Renew the lease and reload the member list. True when the ring changed.
+  bool refresh();
+
+  // How often refresh() should run: well inside the lease
+  std::chrono::milliseconds refreshInterval() const {
+    return options_.lease / 3;
+  }
+
+  bool owns(std::string_view key) const { return ring_.owns(options_.id, key); }
+
+  const ShardRing &ring() const { return ring_; }
+  const std::string &id() const { return options_.id; }
+
+private:
+  RedisClient &redis_;
+  MembershipOptions options_;
+  ShardRing ring_;
+};
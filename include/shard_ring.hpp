@@ -0,0 +1,49 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// 64-bit hash of a key that every process and build agrees on, unlike
+// std::hash. FNV-1a with a murmur finalizer so that keys differing only in
+// their last characters still spread across the ring.
+uint64_t shardHash(std::string_view key);
+
+// Consistent-hash assignment of keys to a set of members (detector
+// processes). Each member is placed on a 64-bit ring at virtual_nodes
+// points and a key belongs to the first point at or after its hash. When a
+// member joins or leaves, only the keys it gains or loses change owner,
+// about 1/N of them, and every process that sees the same member list
+// computes the same assignment.
+class ShardRing {
+public:
+  static constexpr size_t DEFAULT_VIRTUAL_NODES = 160;
+
+  ShardRing() = default;
+  // Duplicates are ignored; member order does not matter
+  explicit ShardRing(std::vector<std::string> members,
+                     size_t virtual_nodes = DEFAULT_VIRTUAL_NODES);
+
+  // Null on an empty ring
+  const std::string *owner(std::string_view key) const;
+
+  bool owns(std::string_view member, std::string_view key) const {
+    const std::string *found = owner(key);
+    return found && *found == member;
+  }
+
+  // Sorted
+  const std::vector<std::string> &members() const { return members_; }
+  bool empty() const { return members_.empty(); }
+
+private:
+  struct Point {
+    uint64_t hash;
+    uint32_t member;
+  };
+
+  std::vector<std::string> members_;
+  // Sorted by hash
+  std::vector<Point> points_;
+};
@@ -0,0 +1,55 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// Vector kernels for the window reductions and batch mint scoring. The
+// implementation is picked once at runtime from what the CPU supports
+// (AVX2, else portable scalar code), independent of the -march the binary
+// was built with.
+namespace simd {
+
+// Latest decision-rule inputs of n mints, one array per feature
+struct MintScoreInputs {
+  const double *drop;            // fraction below the peak
+  const double *time_since_peak; // seconds
+  // NaN where the pattern rule cannot fire
+  const double *pattern_strength;
+  const double *volume_trend;
+  size_t n;
+};
+
+// The DetectionParams fields the decision rule reads
+struct ScoreThresholds {
+  double peak_drop;
+  double time_from_peak;
+  double volume_spike;
+  double pattern_strength;
+  double min_confidence;
+  double stop_loss;
+};
+
+struct KernelTable {
+  // deltas and abs_deltas serve computeWindowStats, the full-scan
+  // reference for SlidingWindowStats; detection does not call them. The
+  // volume sum is fixed point, so it has no vector kernel.
+  //
+  // out[i] = in[i + 1] - in[i] for i < n - 1
+  void (*deltas)(const double *in, size_t n, double *out);
+  // out[i] = |in[i + 1] - in[i]| for i < n - 1
+  void (*abs_deltas)(const double *in, size_t n, double *out);
+  // Per mint: confidence (1.0 on a stop loss) and the trigger that fires,
+  // as a SweepTrigger value; the stop loss wins over the pattern rule
+  void (*score_mints)(const MintScoreInputs &in, const ScoreThresholds &t,
+                      double *confidence, uint8_t *trigger);
+  const char *name;
+};
+
+const KernelTable &scalarKernels();
+
+// nullptr when the CPU (or compiler) has no AVX2
+const KernelTable *avx2Kernels();
+
+// Best table for this CPU, resolved on first use
+const KernelTable &kernels();
+
+} // namespace simd
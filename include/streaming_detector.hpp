@@ -0,0 +1,60 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include "detection_config.hpp"
+#include "detection_result.hpp"
+#include "trade.hpp"
+#include "trade_ring.hpp"
+#include "window_stats.hpp"
+
+// Live-ingestion counterpart of RugPullDetector for one feeder thread and
+// one scoring thread. Trades go into a fixed-size TradeRing, and each
+// processTrades call releases the trades the detection window can no
+// longer reach, so memory stays constant however long the token trades.
+// The peak, cursor and window belong to the scoring thread alone; the
+// feeder only appends. Neither thread ever blocks the other.
+//
+// Results match RugPullDetector fed the same trades with processTrades
+// called at the same points, as long as nothing is dropped: size capacity
+// for the most trades expected within max_detection_time + 1 seconds, plus
+// whatever arrives between two processTrades calls.
+class StreamingDetector {
+public:
+  static constexpr size_t DEFAULT_CAPACITY = 4096;
+
+  explicit StreamingDetector(size_t capacity = DEFAULT_CAPACITY)
+      : ring_(capacity) {}
+
+  // Feeder thread only. Trades must arrive in timestamp order. False when
+  // the ring is full: the trade is dropped and counted.
+  bool addTrade(const Trade &trade);
+
+  // Scoring thread only. Scans every trade added since the last call.
+  DetectionResult processTrades(const DetectionParams &config);
+
+  // Trades the feeder had to drop because the ring was full
+  size_t droppedTrades() const {
+    return dropped_.load(std::memory_order_relaxed);
+  }
+
+  // Scoring thread only: trades still held for the window
+  size_t retainedTrades() const { return ring_.published() - base_; }
+
+  size_t capacity() const { return ring_.capacity(); }
+  size_t bytes() const { return sizeof(*this) + ring_.bytes(); }
+
+private:
+  TradeRing ring_;
+  std::atomic<size_t> dropped_{0};
+
+  // Scoring thread state. Indexes are arrival numbers in the ring; the
+  // window indexes from base_, the oldest trade still held.
+  size_t base_ = 0;
+  size_t seen_ = 0;
+  size_t current_idx_ = 0;
+  double peak_mc_ = 0.0;
+  int64_t peak_time_us_ = 0;
+  int64_t analysis_start_us_ = 0;
+  SlidingWindowStats window_;
+};
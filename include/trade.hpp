@@ -1,10 +1,36 @@
 #pragma once
 #include <chrono>
+#include <cmath>
+#include <cstdint>
 #include <string>
 
-// Added memory alignment for better cache performance
-struct alignas(32) Trade {
+// Interchange record between the Redis reader and the detector. The
+// detector stores trades column-wise (see trade_columns.hpp), so this is
+// no longer padded for cache alignment.
+struct Trade {
   std::chrono::system_clock::time_point timestamp;
   double market_cap_sol;
   double sol_amount;
 };
+
+// Timestamps are carried as integer microseconds since the epoch inside
+// the detector, matching the microsecond ordering the Redis scores promise
+constexpr int64_t MICROS_PER_SECOND = 1'000'000;
+
+inline int64_t toMicros(const std::chrono::system_clock::time_point &time) {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             time.time_since_epoch())
+      .count();
+}
+
+inline std::chrono::system_clock::time_point fromMicros(int64_t micros) {
+  return std::chrono::system_clock::time_point(
+      std::chrono::duration_cast<std::chrono::system_clock::duration>(
+          std::chrono::microseconds(micros)));
+}
+
+// Sorted-set score (Unix seconds with a microsecond fraction) to time_point,
+// without truncating to whole seconds
+inline std::chrono::system_clock::time_point scoreToTimePoint(double score) {
+  return fromMicros(std::llround(score * 1e6));
+}
@@ -0,0 +1,82 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <span>
+#include <vector>
+#include "trade.hpp"
+
+// Read-only column view over a run of trades in timestamp order. Window
+// code works on these so it only touches the columns it needs.
+struct TradeSeries {
+  std::span<const int64_t> timestamp_us;
+  std::span<const double> market_cap_sol;
+  std::span<const double> sol_amount;
+
+  size_t size() const { return timestamp_us.size(); }
+  bool empty() const { return timestamp_us.empty(); }
+
+  TradeSeries subspan(size_t offset, size_t count) const {
+    return {timestamp_us.subspan(offset, count),
+            market_cap_sol.subspan(offset, count),
+            sol_amount.subspan(offset, count)};
+  }
+};
+
+// Owning structure-of-arrays trade store. Allocates from the default heap
+// unless given a memory resource (a worker's WorkerArena, say).
+class TradeColumns {
+public:
+  explicit TradeColumns(
+      std::pmr::memory_resource *resource = std::pmr::get_default_resource())
+      : timestamp_us_(resource), market_cap_sol_(resource),
+        sol_amount_(resource) {}
+
+  void reserve(size_t capacity) {
+    timestamp_us_.reserve(capacity);
+    market_cap_sol_.reserve(capacity);
+    sol_amount_.reserve(capacity);
+  }
+
+  void push_back(const Trade &trade) {
+    push_back(toMicros(trade.timestamp), trade.market_cap_sol,
+              trade.sol_amount);
+  }
+
+  void push_back(int64_t timestamp_us, double market_cap_sol,
+                 double sol_amount) {
+    timestamp_us_.push_back(timestamp_us);
+    market_cap_sol_.push_back(market_cap_sol);
+    sol_amount_.push_back(sol_amount);
+  }
+
+  // Drop the oldest count trades (ones a detection window has passed)
+  void eraseFront(size_t count) {
+    timestamp_us_.erase(timestamp_us_.begin(), timestamp_us_.begin() + count);
+    market_cap_sol_.erase(market_cap_sol_.begin(),
+                          market_cap_sol_.begin() + count);
+    sol_amount_.erase(sol_amount_.begin(), sol_amount_.begin() + count);
+  }
+
+  void clear() {
+    timestamp_us_.clear();
+    market_cap_sol_.clear();
+    sol_amount_.clear();
+  }
+
+  size_t size() const { return timestamp_us_.size(); }
+  bool empty() const { return timestamp_us_.empty(); }
+
+  int64_t timestamp_us(size_t i) const { return timestamp_us_[i]; }
+  double market_cap_sol(size_t i) const { return market_cap_sol_[i]; }
+  double sol_amount(size_t i) const { return sol_amount_[i]; }
+
+  TradeSeries view() const {
+    return {timestamp_us_, market_cap_sol_, sol_amount_};
+  }
+
+private:
+  std::pmr::vector<int64_t> timestamp_us_;
+  std::pmr::vector<double> market_cap_sol_;
+  std::pmr::vector<double> sol_amount_;
+};
@@ -0,0 +1,101 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "block_file.hpp"
+#include "trade.hpp"
+#include "trade_columns.hpp"
+
+// On-disk trade corpus for offline replay.
+//
+//   header     CorpusHeader, 64 bytes
+//   blocks     one per mint: int64 timestamp_us[n], double market_cap_sol[n],
+//              double sol_amount[n]
+//   index      CorpusIndexEntry[mint_count]
+//   names      mint keys, concatenated
+//
+// Integers and doubles are stored in host byte order; the header carries a
+// byte-order mark and readers reject files from the other endianness.
+// Blocks start on 8-byte boundaries, so a mapped file can be read in place.
+struct CorpusHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t byte_order;
+  uint64_t mint_count;
+  uint64_t trade_count;
+  uint64_t index_offset;
+  uint64_t names_offset;
+  uint64_t names_size;
+  uint64_t reserved;
+};
+static_assert(sizeof(CorpusHeader) == 64);
+
+struct CorpusIndexEntry {
+  uint64_t block_offset;
+  uint64_t trade_count;
+  uint64_t name_offset; // into the names section
+  uint64_t name_length;
+};
+static_assert(sizeof(CorpusIndexEntry) == 32);
+
+inline constexpr char CORPUS_MAGIC[8] = {'R', 'U', 'G', 'C', 'O', 'R', 'P', 'S'};
+inline constexpr uint32_t CORPUS_VERSION = 1;
+
+// Streams mints to a corpus file one block at a time; only the index is
+// kept in memory. Throws std::runtime_error on I/O failure.
+class TradeCorpusWriter {
+public:
+  explicit TradeCorpusWriter(const std::string &path);
+  ~TradeCorpusWriter();
+
+  TradeCorpusWriter(const TradeCorpusWriter &) = delete;
+  TradeCorpusWriter &operator=(const TradeCorpusWriter &) = delete;
+
+  // Trades in timestamp order, as getTrades returns them
+  void addMint(std::string_view name, std::span<const Trade> trades);
+
+  // Writes index and names and fixes up the header. Called by the
+  // destructor if not called explicitly (errors are then only logged).
+  void finish();
+
+  size_t mintCount() const { return index_.size(); }
+  uint64_t tradeCount() const { return trade_count_; }
+
+private:
+  BlockFileWriter file_;
+  uint64_t trade_count_;
+  std::vector<CorpusIndexEntry> index_;
+  std::string names_;
+};
+
+// Read-only memory-mapped corpus. Series point straight into the mapping;
+// they stay valid for the corpus's lifetime. Throws std::runtime_error if
+// the file is missing, truncated or not a corpus.
+class TradeCorpus {
+public:
+  explicit TradeCorpus(const std::string &path);
+
+  TradeCorpus(const TradeCorpus &) = delete;
+  TradeCorpus &operator=(const TradeCorpus &) = delete;
+
+  size_t mintCount() const { return index_.size(); }
+  uint64_t tradeCount() const { return header_->trade_count; }
+
+  std::string_view mintName(size_t i) const;
+  TradeSeries series(size_t i) const;
+
+  // Index of a mint by key, if present
+  std::optional<size_t> find(std::string_view name) const;
+
+private:
+  MappedBlockFile file_;
+  const CorpusHeader *header_;
+  std::span<const CorpusIndexEntry> index_;
+  std::string_view names_;
+  std::unordered_map<std::string_view, size_t> by_name_;
+};
@@ -0,0 +1,22 @@
+#pragma once
+#include <string_view>
+
+// The only fields the detector reads from a sorted-set member
+struct TradeFields {
+  double market_cap_sol = 0.0;
+  double sol_amount = 0.0;
+};
+
+// Pull marketCapSol and solAmount straight out of a JSON member without
+// building a DOM or allocating. Other fields are skipped without being
+// decoded. Returns false when the member is not a JSON object with both
+// fields as plain numbers, or uses something the scanner does not handle
+// (escaped key names); callers should then fall back to a full parser.
+bool decodeTradeFields(std::string_view member, TradeFields &fields);
+
+// Any member a key may hold: a binary record (trade_record.hpp), else JSON
+// through decodeTradeFields with a nlohmann::json fallback for anything the
+// fast path rejects. Malformed JSON throws nlohmann::json::exception,
+// exactly as a full parse would; a malformed binary record throws
+// std::invalid_argument.
+TradeFields decodeTradeMember(std::string_view member);
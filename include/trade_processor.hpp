@@ -0,0 +1,139 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "cpu_topology.hpp"
+#include "event_count.hpp"
+#include "mpmc_queue.hpp"
+#include "risk_priority.hpp"
+#include "work_stealing_deque.hpp"
+
+struct TradeProcessorOptions {
+  // Per RiskClass
+  size_t injection_capacity = 4096;
+  // Pin worker i to the i-th CPU of pinningOrder(), wrapping around when
+  // there are more workers than CPUs
+  bool pin_workers = false;
+  // Runs on each worker thread, after pinning and before its first task.
+  // Per-worker state built here is first touched by its worker, so on a
+  // NUMA machine its memory lands on the worker's node.
+  std::function<void(size_t worker_id)> on_worker_start;
+  // Submission to completion each RiskClass is allowed; a task finishing
+  // later counts as a deadline miss for its class
+  std::array<std::chrono::milliseconds, RISK_CLASS_COUNT> deadlines = {
+      std::chrono::milliseconds(100), std::chrono::milliseconds(1000),
+      std::chrono::milliseconds(10000)};
+  // Under overload, drop Low tasks rather than run them late: those whose
+  // deadline has passed by the time a worker reaches them, and those
+  // submitted while the Low queue is full (instead of waiting for room)
+  bool shed_low_risk = false;
+};
+
+// What one worker has done since the pool started
+struct WorkerStats {
+  size_t worker_id = 0;
+  // CPU and NUMA node the worker is pinned to; -1 when not pinned
+  int cpu = -1;
+  int node = -1;
+  uint64_t tasks = 0;
+  std::chrono::nanoseconds busy{0};
+  // busy as a share of the pool's lifetime so far
+  double utilization = 0.0;
+};
+
+// Fixed pool of workers that run a handler for each submitted key.
+//
+// Producers push into one lock-free injection queue per RiskClass. A worker
+// takes a High task first, one at a time so none sits in a deque behind
+// other work; then runs tasks from its own Chase-Lev deque; then moves a
+// small batch from the Medium queue, or failing that the Low one, into
+// that deque; then steals from the other workers starting at a random
+// victim. Low tasks thus wait while anything more urgent is queued, and
+// Medium ones at most behind a batch already taken. Idle workers park on
+// an EventCount, so an idle pool does not spin and a submission never gets
+// stuck while a worker sleeps. Each worker keeps its own task and
+// busy-time counts, written only by itself, for workerStats().
+class TradeProcessor {
+public:
+  using TaskHandler =
+      std::function<void(size_t worker_id, const std::string &key)>;
+
+  // Most tasks a worker moves from the injection queue in one go
+  static constexpr size_t INJECTION_BATCH = 16;
+  // Empty passes (each followed by a yield) before an idle worker parks
+  static constexpr size_t IDLE_SPIN_ROUNDS = 32;
+
+  TradeProcessor(size_t num_threads, TaskHandler handler,
+                 size_t injection_capacity = 4096);
+  TradeProcessor(size_t num_threads, TaskHandler handler,
+                 TradeProcessorOptions options);
+
+  // Runs every task already submitted, then joins the workers
+  ~TradeProcessor();
+
+  TradeProcessor(const TradeProcessor &) = delete;
+  TradeProcessor &operator=(const TradeProcessor &) = delete;
+
+  // Safe from any thread. Waits (yielding) while the class's injection
+  // queue is full, so a fast producer is throttled to the pool's pace.
+  // False if the task was shed instead (Low, with shed_low_risk).
+  bool addTask(std::string key, RiskClass risk = RiskClass::Medium);
+
+  size_t workerCount() const { return workers_.size(); }
+
+  // Safe from any thread; counts are at most a task behind
+  std::vector<WorkerStats> workerStats() const;
+
+  // Tasks shed so far, at submission or by a worker; they never run
+  uint64_t shedTasks() const { return shed_.load(std::memory_order_relaxed); }
+
+private:
+  struct Task {
+    std::string key;
+    RiskClass risk;
+    std::chrono::steady_clock::time_point submitted;
+  };
+
+  // Cache-line aligned so one worker's counters never share a line with
+  // another's
+  struct alignas(64) Worker {
+    WorkStealingDeque<Task *> deque;
+    uint64_t rng_state;
+    // Set before the thread starts
+    int cpu = -1;
+    int node = -1;
+    // Written by the worker only, read by workerStats()
+    std::atomic<uint64_t> tasks{0};
+    std::atomic<uint64_t> busy_ns{0};
+  };
+
+  void workerLoop(size_t worker_id);
+  MpmcQueue<Task *> &injector(RiskClass risk) {
+    return injectors_[static_cast<size_t>(risk)];
+  }
+  Task *takeFromInjector(Worker &self, RiskClass risk);
+  Task *steal(size_t worker_id);
+  bool hasQueuedWork() const;
+  void run(size_t worker_id, Task *task);
+  void shed(Task *task);
+
+  TaskHandler handler_;
+  std::function<void(size_t)> on_worker_start_;
+  std::chrono::steady_clock::time_point started_;
+  std::array<std::chrono::milliseconds, RISK_CLASS_COUNT> deadlines_;
+  bool shed_low_risk_;
+  std::array<MpmcQueue<Task *>, RISK_CLASS_COUNT> injectors_;
+  std::atomic<uint64_t> shed_{0};
+  std::vector<std::unique_ptr<Worker>> workers_;
+  EventCount idle_;
+  std::atomic<bool> stopping_{false};
+  std::vector<std::thread> threads_;
+};
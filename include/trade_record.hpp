@@ -0,0 +1,39 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include "trade_decoder.hpp"
+
+// Compact binary sorted-set member, an alternative to the JSON record in
+// docs/REDIS_SPEC.md that keeps only what the detector reads. Fixed layout,
+// little-endian:
+//
+//   offset  size  field
+//        0     1  tag, TRADE_RECORD_TAG (never '{' or JSON whitespace)
+//        1     1  version, TRADE_RECORD_VERSION
+//        2     8  int64 timestamp, microseconds since the epoch
+//       10     8  float64 marketCapSol
+//       18     8  float64 solAmount
+//
+// The timestamp duplicates the score, as the JSON "timestamp" field does,
+// and keeps members unique: the spec rules out two trades of a key sharing
+// a timestamp, while two trades can easily share both amounts.
+constexpr uint8_t TRADE_RECORD_TAG = 0xB7;
+constexpr uint8_t TRADE_RECORD_VERSION = 1;
+constexpr size_t TRADE_RECORD_SIZE = 26;
+
+std::string encodeTradeRecord(int64_t timestamp_us, double market_cap_sol,
+                              double sol_amount);
+
+// True for anything carrying the binary tag, well-formed or not
+inline bool isTradeRecord(std::string_view member) {
+  return !member.empty() &&
+         static_cast<uint8_t>(member.front()) == TRADE_RECORD_TAG;
+}
+
+// False unless member is a complete record of a version this build reads
+bool decodeTradeRecord(std::string_view member, TradeFields &fields);
+
+// The timestamp field of a record decodeTradeRecord accepts
+int64_t tradeRecordTimestamp(std::string_view member);
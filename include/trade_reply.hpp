@@ -0,0 +1,45 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <vector>
+#include <hiredis/hiredis.h>
+#include "trade.hpp"
+#include "trade_columns.hpp"
+
+// Decoding of ZRANGE / ZRANGEBYSCORE ... WITHSCORES replies in place:
+// members are read out of hiredis's reply buffers as string_views and never
+// copied into std::strings. Accepts both the RESP2 shape (flat member,
+// score, member, score ...) and the RESP3 one (an array of [member, score]
+// pairs). Anything else throws std::runtime_error.
+
+// Number of (member, score) pairs in the reply
+size_t replyTradeCount(const redisReply &reply);
+
+// Score of the last pair; empty for an empty reply
+std::optional<double> replyLastScore(const redisReply &reply);
+
+// Number of pairs at the end of the reply scored exactly the same as the
+// last one; 0 for an empty reply
+size_t replyTrailingTies(const redisReply &reply);
+
+// Identifies a member among others with the same score. Only meaningful
+// within one process.
+uint64_t memberHash(std::string_view member);
+
+// memberHash() of each pair replyTrailingTies counts
+std::vector<uint64_t> replyTrailingMembers(const redisReply &reply);
+
+// Append every pair in score order. Members that fail to decode are logged,
+// counted as parse errors and skipped. Reserves exactly the room needed up
+// front, so arena-backed columns allocate once per column.
+void appendReplyTrades(const redisReply &reply, TradeColumns &columns);
+void appendReplyTrades(const redisReply &reply, std::vector<Trade> &trades);
+
+// Same, skipping pairs scored exactly skip_score whose memberHash() is in
+// skip_members: those a previous fetch already returned
+void appendReplyTrades(const redisReply &reply, std::vector<Trade> &trades,
+                       double skip_score,
+                       std::span<const uint64_t> skip_members);
@@ -0,0 +1,86 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include "trade_columns.hpp"
+
+// Fixed-capacity single-producer single-consumer ring of trades, stored
+// column-wise. Every trade is written twice, at slot i and i + capacity, so
+// any run of up to capacity consecutive trades is contiguous in memory and
+// can be handed to the window code as a plain TradeSeries.
+//
+// Trades are numbered by arrival, starting from 0. The producer appends at
+// published(); the consumer reads any range between its own release point
+// and published(), and release()s trades it no longer needs. Neither side
+// takes a lock or waits for the other.
+class TradeRing {
+public:
+  explicit TradeRing(size_t capacity)
+      : capacity_(capacity), timestamp_us_(new int64_t[2 * capacity]),
+        market_cap_sol_(new double[2 * capacity]),
+        sol_amount_(new double[2 * capacity]) {}
+
+  TradeRing(const TradeRing &) = delete;
+  TradeRing &operator=(const TradeRing &) = delete;
+
+  size_t capacity() const { return capacity_; }
+
+  // Producer only. False, and the trade is not stored, when capacity trades
+  // are already waiting to be released.
+  bool tryPush(int64_t timestamp_us, double market_cap_sol, double sol_amount) {
+    const size_t head = head_.load(std::memory_order_relaxed);
+    if (head - released_cache_ >= capacity_) {
+      released_cache_ = released_.load(std::memory_order_acquire);
+      if (head - released_cache_ >= capacity_)
+        return false;
+    }
+
+    const size_t slot = head % capacity_;
+    for (size_t i : {slot, slot + capacity_}) {
+      timestamp_us_[i] = timestamp_us;
+      market_cap_sol_[i] = market_cap_sol;
+      sol_amount_[i] = sol_amount;
+    }
+    head_.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Consumer only: trades appended so far; everything below is readable
+  size_t published() const { return head_.load(std::memory_order_acquire); }
+
+  // Consumer only: trades [begin, end), with released() <= begin,
+  // end <= published()
+  TradeSeries view(size_t begin, size_t end) const {
+    const size_t offset = begin % capacity_;
+    const size_t count = end - begin;
+    return {{timestamp_us_.get() + offset, count},
+            {market_cap_sol_.get() + offset, count},
+            {sol_amount_.get() + offset, count}};
+  }
+
+  // Consumer only: hand every trade below upto back to the producer
+  void release(size_t upto) {
+    released_.store(upto, std::memory_order_release);
+  }
+
+  size_t released() const { return released_.load(std::memory_order_relaxed); }
+
+  // Bytes of trade storage, fixed at construction
+  size_t bytes() const {
+    return 2 * capacity_ *
+           (sizeof(int64_t) + sizeof(double) + sizeof(double));
+  }
+
+private:
+  const size_t capacity_;
+  const std::unique_ptr<int64_t[]> timestamp_us_;
+  const std::unique_ptr<double[]> market_cap_sol_;
+  const std::unique_ptr<double[]> sol_amount_;
+
+  // Producer side: its write index and last seen release point
+  alignas(64) std::atomic<size_t> head_{0};
+  size_t released_cache_ = 0;
+  // Consumer side
+  alignas(64) std::atomic<size_t> released_{0};
+};
@@ -0,0 +1,86 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include "trade_columns.hpp"
+
+// Cache frequently computed values
+struct WindowStats {
+  double volume_trend = 0;     // Equivalent to volume_changes.mean()
+  double price_velocity = 0;   // Equivalent to price_changes.mean()
+  int consecutive_drops = 0;   // Equivalent to sum(price_drops[-3:])
+  double pattern_strength = 0; // Pattern strength calculation
+};
+
+// Trades inside the detection window ending at current_us. The window
+// starts at 10 seconds and expands up to max_detection_time.
+TradeSeries getRecentTrades(const TradeSeries &trades, int64_t analysis_start_us,
+                            int64_t current_us, int max_detection_time);
+
+// Volume changes are summed in fixed point (see window_stats.cpp), so
+// adding and removing edge trades is exact and the running sum of
+// SlidingWindowStats never drifts from a full rescan
+__extension__ using VolumeSum = __int128;
+
+// Full-scan statistics for one window, using the SIMD kernels. O(window)
+// per call; kept as the reference the incremental engine below is tested
+// against, bit for bit. Detection itself (RugPullDetector::scan) only uses
+// SlidingWindowStats, so the kernels speed up this reference and the
+// benchmarks, not production scoring.
+WindowStats computeWindowStats(const TradeSeries &window_trades);
+
+// Incremental version of getRecentTrades + computeWindowStats for a cursor
+// that walks a trade series in timestamp order. The right edge only moves
+// forward. The left edge mostly does too, but while the window grows from
+// 10 s to max_detection_time its start is analysis_start plus the
+// sub-second part of the elapsed time: each time the elapsed time crosses
+// a whole second, the edge steps back by up to one second's worth of
+// trades. That happens at most max_detection_time - 10 times, and the sums
+// are updated per edge move, so a full pass over N trades is still O(N)
+// instead of O(N * W).
+class SlidingWindowStats {
+public:
+  // Move the window to the one ending at current_us
+  void advance(const TradeSeries &trades, int64_t analysis_start_us,
+               int64_t current_us, int max_detection_time);
+
+  // Same values as computeWindowStats(window(trades)), bit for bit, in O(1)
+  WindowStats stats(const TradeSeries &trades) const;
+
+  TradeSeries window(const TradeSeries &trades) const {
+    return trades.subspan(begin_, end_ - begin_);
+  }
+
+  size_t size() const { return end_ - begin_; }
+
+  // Index of the window's first trade
+  size_t start() const { return begin_; }
+
+  // One past the window's last trade
+  size_t end() const { return end_; }
+
+  // Resume a window saved from start() and end(); O(window), as the
+  // running sum is rebuilt from trades
+  void restore(const TradeSeries &trades, size_t begin, size_t end);
+
+  // Re-index after the first count trades of the series were dropped. They
+  // must lie before the window and never re-enter it: the left edge steps
+  // back by at most one second, so trades more than
+  // max_detection_time + 1 seconds older than the last advance are safe.
+  void dropFront(size_t count) {
+    begin_ -= count;
+    end_ -= count;
+  }
+
+  void reset() {
+    begin_ = 0;
+    end_ = 0;
+    volume_change_sum_ = 0;
+  }
+
+private:
+  // Window is trades[begin_, end_)
+  size_t begin_ = 0;
+  size_t end_ = 0;
+  // Sum of |sol_amount[j] - sol_amount[j - 1]| for begin_ < j < end_
+  VolumeSum volume_change_sum_ = 0;
+};
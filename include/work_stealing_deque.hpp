@@ -0,0 +1,129 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <vector>
+
+// Chase-Lev work-stealing deque (Le, Pop, Cohen, Zappa Nardelli, "Correct
+// and Efficient Work-Stealing for Weak Memory Models", PPoPP 2013).
+// The owning thread pushes and pops at the bottom; any thread may steal
+// from the top. Lock-free; the ring grows when full, and retired rings are
+// kept alive until destruction because a thief may still be reading one.
+template <typename T>
+class WorkStealingDeque {
+  static_assert(std::is_trivially_copyable_v<T>,
+                "slots are std::atomic<T>; store pointers or indices");
+
+public:
+  explicit WorkStealingDeque(size_t capacity = 256)
+      : top_(0), bottom_(0), buffer_(nullptr) {
+    size_t rounded = 1;
+    while (rounded < capacity)
+      rounded <<= 1;
+    rings_.push_back(std::make_unique<Ring>(rounded));
+    buffer_.store(rings_.back().get(), std::memory_order_relaxed);
+  }
+
+  WorkStealingDeque(const WorkStealingDeque &) = delete;
+  WorkStealingDeque &operator=(const WorkStealingDeque &) = delete;
+
+  // Owner thread only
+  void push(T item) {
+    const int64_t b = bottom_.load(std::memory_order_relaxed);
+    const int64_t t = top_.load(std::memory_order_acquire);
+    Ring *ring = buffer_.load(std::memory_order_relaxed);
+    if (b - t > static_cast<int64_t>(ring->capacity) - 1) {
+      ring = grow(ring, t, b);
+    }
+    ring->put(b, item);
+    // Publishes the slot (and whatever item points to) to thieves
+    bottom_.store(b + 1, std::memory_order_release);
+  }
+
+  // Owner thread only; LIFO end
+  std::optional<T> pop() {
+    const int64_t b = bottom_.load(std::memory_order_relaxed) - 1;
+    Ring *ring = buffer_.load(std::memory_order_relaxed);
+    bottom_.store(b, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t t = top_.load(std::memory_order_relaxed);
+
+    if (t > b) {
+      bottom_.store(b + 1, std::memory_order_relaxed);
+      return std::nullopt;
+    }
+
+    T item = ring->get(b);
+    if (t == b) {
+      // Last item: race thieves for it
+      const bool won = top_.compare_exchange_strong(
+          t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+      bottom_.store(b + 1, std::memory_order_relaxed);
+      if (!won)
+        return std::nullopt;
+    }
+    return item;
+  }
+
+  // Any thread; FIFO end. Empty result on an empty deque or a lost race.
+  std::optional<T> steal() {
+    int64_t t = top_.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const int64_t b = bottom_.load(std::memory_order_acquire);
+    if (t >= b)
+      return std::nullopt;
+
+    Ring *ring = buffer_.load(std::memory_order_acquire);
+    T item = ring->get(t);
+    if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                      std::memory_order_relaxed))
+      return std::nullopt;
+    return item;
+  }
+
+  // May be stale by the time the caller looks at it
+  size_t sizeApprox() const {
+    const int64_t b = bottom_.load(std::memory_order_relaxed);
+    const int64_t t = top_.load(std::memory_order_relaxed);
+    return b > t ? static_cast<size_t>(b - t) : 0;
+  }
+
+private:
+  struct Ring {
+    explicit Ring(size_t size)
+        : capacity(size), mask(size - 1),
+          slots(std::make_unique<std::atomic<T>[]>(size)) {}
+
+    T get(int64_t index) const {
+      return slots[static_cast<size_t>(index) & mask].load(
+          std::memory_order_relaxed);
+    }
+    void put(int64_t index, T item) {
+      slots[static_cast<size_t>(index) & mask].store(
+          item, std::memory_order_relaxed);
+    }
+
+    size_t capacity;
+    size_t mask;
+    std::unique_ptr<std::atomic<T>[]> slots;
+  };
+
+  // Owner thread only
+  Ring *grow(Ring *old_ring, int64_t t, int64_t b) {
+    auto ring = std::make_unique<Ring>(old_ring->capacity * 2);
+    for (int64_t i = t; i < b; ++i)
+      ring->put(i, old_ring->get(i));
+    Ring *raw = ring.get();
+    rings_.push_back(std::move(ring));
+    buffer_.store(raw, std::memory_order_release);
+    return raw;
+  }
+
+  alignas(64) std::atomic<int64_t> top_;
+  alignas(64) std::atomic<int64_t> bottom_;
+  alignas(64) std::atomic<Ring *> buffer_;
+  std::vector<std::unique_ptr<Ring>> rings_; // owner-only
+};
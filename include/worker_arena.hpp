@@ -0,0 +1,47 @@
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+
+// Bump allocator for one unit of work at a time (one key, say), reset in
+// between. Allocations bump a pointer through a single owned block and
+// deallocation is a no-op. A unit that needs more spills to the heap, and
+// the next reset() grows the block to cover it, so once warmed up a
+// steady workload never touches the heap. Not thread-safe: one per worker.
+class WorkerArena {
+public:
+  static constexpr size_t DEFAULT_BYTES = 64 * 1024;
+
+  explicit WorkerArena(size_t initial_bytes = DEFAULT_BYTES);
+
+  WorkerArena(const WorkerArena &) = delete;
+  WorkerArena &operator=(const WorkerArena &) = delete;
+
+  std::pmr::memory_resource *resource() { return &*resource_; }
+
+  // Invalidates everything allocated since the last reset
+  void reset();
+
+  size_t capacity() const { return capacity_; }
+
+private:
+  // Heap upstream that remembers how much went past the block
+  class Spill : public std::pmr::memory_resource {
+  public:
+    size_t bytes = 0;
+
+  private:
+    void *do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void *p, size_t bytes, size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource &other) const
+        noexcept override {
+      return this == &other;
+    }
+  };
+
+  size_t capacity_;
+  std::unique_ptr<std::byte[]> block_;
+  Spill spill_;
+  std::optional<std::pmr::monotonic_buffer_resource> resource_;
+};
@@ -0,0 +1,93 @@
+#include "async_check_pool.hpp"
+#include <algorithm>
+#include <exception>
+#include <utility>
+#include <spdlog/spdlog.h>
+#include "metrics.hpp"
+
+AsyncCheckPool::AsyncCheckPool(size_t threads) {
+  threads = std::max<size_t>(1, threads);
+  threads_.reserve(threads);
+  for (size_t i = 0; i < threads; ++i) {
+    threads_.emplace_back([this] { run(); });
+  }
+}
+
+AsyncCheckPool::~AsyncCheckPool() {
+  wait();
+  {
+    std::lock_guard lock(mutex_);
+    stopping_ = true;
+  }
+  ready_.notify_all();
+  for (auto &thread : threads_) {
+    thread.join();
+  }
+}
+
+void AsyncCheckPool::wait() {
+  std::unique_lock lock(mutex_);
+  idle_.wait(lock, [this] { return in_flight_ == 0; });
+}
+
+void AsyncCheckPool::check(AsyncRedisClient &redis, const std::string &key,
+                           const DetectionParams &params, Done done) {
+  {
+    std::lock_guard lock(mutex_);
+    ++in_flight_;
+  }
+  metrics::add(metrics::Counter::KeysFetched);
+  redis.command(
+      {"ZRANGE", key, "0", "-1", "WITHSCORES"},
+      [this, params, done = std::move(done)](
+          AsyncRedisClient::ReplyPtr reply, std::string_view error) mutable {
+        // On the client's loop thread: queue and return
+        {
+          std::lock_guard lock(mutex_);
+          jobs_.push_back(Job{std::move(reply), std::string(error), params,
+                              std::move(done)});
+        }
+        ready_.notify_one();
+      });
+}
+
+void AsyncCheckPool::run() {
+  KeyWorker worker;
+  while (true) {
+    Job job;
+    {
+      std::unique_lock lock(mutex_);
+      ready_.wait(lock, [this] { return stopping_ || !jobs_.empty(); });
+      if (jobs_.empty()) {
+        return;
+      }
+      job = std::move(jobs_.front());
+      jobs_.pop_front();
+    }
+
+    KeyWorker::Check check;
+    if (job.reply && job.error.empty()) {
+      try {
+        check = worker.check(*job.reply, job.params);
+      } catch (const std::exception &e) {
+        job.error = e.what();
+      }
+    }
+    // Freed here rather than on the loop thread
+    job.reply.reset();
+    try {
+      job.done(check, job.error);
+    } catch (const std::exception &e) {
+      spdlog::error("Async check callback threw: {}", e.what());
+    }
+
+    bool last;
+    {
+      std::lock_guard lock(mutex_);
+      last = --in_flight_ == 0;
+    }
+    if (last) {
+      idle_.notify_all();
+    }
+  }
+}
@@ -0,0 +1,503 @@
+#include "async_redis_client.hpp"
+#include "metrics.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <deque>
+#include <fcntl.h>
+#include <optional>
+#include <hiredis/async.h>
+#include <poll.h>
+#include <spdlog/spdlog.h>
+#include <stdexcept>
+#include <system_error>
+#include <unistd.h>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr std::string_view SHUTDOWN_ERROR = "Client shut down";
+constexpr std::string_view TIMEOUT_ERROR = "Timeout waiting for Redis";
+constexpr std::string_view CONNECT_TIMEOUT_ERROR = "Timeout connecting to Redis";
+constexpr std::string_view NO_CONNECTION_ERROR = "No Redis connection";
+
+std::optional<Clock::time_point> deadlineAfter(std::chrono::milliseconds timeout) {
+  if (timeout.count() <= 0) {
+    return std::nullopt;
+  }
+  return Clock::now() + timeout;
+}
+
+} // namespace
+
+struct AsyncRedisClient::Request {
+  std::vector<std::string> args;
+  // One of the two is set
+  ReplyCallback callback;
+  OwnedReplyCallback owned_callback;
+  Clock::time_point sent;
+};
+
+// One hiredis async context plus the bookkeeping poll() needs. Replies come
+// back in the order commands were written, so a FIFO of deadlines is enough
+// to time out whichever command has waited longest.
+struct AsyncRedisClient::Connection {
+  AsyncRedisClient *owner = nullptr;
+  redisAsyncContext *context = nullptr;
+  bool connected = false;
+  bool reading = false;
+  bool writing = false;
+  std::optional<Clock::time_point> connect_deadline;
+  std::deque<std::optional<Clock::time_point>> in_flight;
+  // Reported to callbacks failed by close(); empty means "ask hiredis"
+  std::string_view failure;
+
+  bool open(const sw::redis::ConnectionOptions &endpoint,
+            const RedisClientOptions &options);
+  void close(std::string_view reason);
+  // Earliest moment something on this connection times out
+  std::optional<Clock::time_point> nextDeadline() const;
+  std::string_view lostReason() const;
+
+  // hiredis event-loop adapter: record interest, the loop polls for it
+  static void addRead(void *data) { self(data)->reading = true; }
+  static void delRead(void *data) { self(data)->reading = false; }
+  static void addWrite(void *data) { self(data)->writing = true; }
+  static void delWrite(void *data) { self(data)->writing = false; }
+  static void cleanup(void *data) {
+    self(data)->reading = false;
+    self(data)->writing = false;
+  }
+
+  static void onConnect(const redisAsyncContext *context, int status);
+  static void onDisconnect(const redisAsyncContext *context, int status);
+  static void onReply(redisAsyncContext *context, void *reply, void *data);
+  static void onSetupReply(redisAsyncContext *context, void *reply, void *data);
+
+private:
+  static Connection *self(void *data) { return static_cast<Connection *>(data); }
+  static Connection *owning(const redisAsyncContext *context) {
+    return static_cast<Connection *>(context->data);
+  }
+  void detach();
+};
+
+bool AsyncRedisClient::Connection::open(
+    const sw::redis::ConnectionOptions &endpoint,
+    const RedisClientOptions &options) {
+  redisOptions redis_options{};
+  // Replies are freed by their ReplyPtr, which an OwnedReplyCallback keeps
+  redis_options.options |= REDIS_OPT_NOAUTOFREEREPLIES;
+  if (endpoint.type == sw::redis::ConnectionType::UNIX) {
+    REDIS_OPTIONS_SET_UNIX(&redis_options, endpoint.path.c_str());
+  } else {
+    REDIS_OPTIONS_SET_TCP(&redis_options, endpoint.host.c_str(), endpoint.port);
+  }
+
+  redisAsyncContext *ctx = redisAsyncConnectWithOptions(&redis_options);
+  if (!ctx) {
+    spdlog::error("Async Redis connect failed: out of memory");
+    return false;
+  }
+  if (ctx->err) {
+    spdlog::error("Async Redis connect failed: {}", ctx->errstr);
+    redisAsyncFree(ctx);
+    return false;
+  }
+
+  context = ctx;
+  connected = false;
+  failure = {};
+  connect_deadline = deadlineAfter(options.connect_timeout);
+  ctx->data = this;
+  ctx->ev.data = this;
+  ctx->ev.addRead = addRead;
+  ctx->ev.delRead = delRead;
+  ctx->ev.addWrite = addWrite;
+  ctx->ev.delWrite = delWrite;
+  ctx->ev.cleanup = cleanup;
+  redisAsyncSetConnectCallback(ctx, onConnect);
+  redisAsyncSetDisconnectCallback(ctx, onDisconnect);
+  // The socket becomes writable once the non-blocking connect completes
+  writing = true;
+
+  // Queued ahead of everything else, so every later command runs
+  // authenticated and on the right database
+  const auto setup = [&](std::vector<const char *> argv) {
+    if (redisAsyncCommandArgv(ctx, onSetupReply, nullptr,
+                              static_cast<int>(argv.size()), argv.data(),
+                              nullptr) == REDIS_OK) {
+      in_flight.push_back(deadlineAfter(options.socket_timeout));
+    }
+  };
+  if (!endpoint.password.empty()) {
+    if (endpoint.user.empty() || endpoint.user == "default") {
+      setup({"AUTH", endpoint.password.c_str()});
+    } else {
+      setup({"AUTH", endpoint.user.c_str(), endpoint.password.c_str()});
+    }
+  }
+  if (endpoint.db != 0) {
+    const auto db = std::to_string(endpoint.db);
+    setup({"SELECT", db.c_str()});
+  }
+  return true;
+}
+
+void AsyncRedisClient::Connection::close(std::string_view reason) {
+  if (!context) {
+    return;
+  }
+  // Fails every command awaiting a reply on this connection
+  failure = reason;
+  redisAsyncContext *ctx = context;
+  detach();
+  redisAsyncFree(ctx);
+  failure = {};
+}
+
+void AsyncRedisClient::Connection::detach() {
+  context = nullptr;
+  connected = false;
+  reading = false;
+  writing = false;
+  connect_deadline.reset();
+}
+
+std::optional<Clock::time_point>
+AsyncRedisClient::Connection::nextDeadline() const {
+  if (!context) {
+    return std::nullopt;
+  }
+  if (!connected) {
+    return connect_deadline;
+  }
+  return in_flight.empty() ? std::nullopt : in_flight.front();
+}
+
+std::string_view AsyncRedisClient::Connection::lostReason() const {
+  if (!failure.empty()) {
+    return failure;
+  }
+  return "Redis connection lost";
+}
+
+void AsyncRedisClient::Connection::onConnect(const redisAsyncContext *context,
+                                             int status) {
+  auto *conn = owning(context);
+  if (status != REDIS_OK) {
+    // hiredis frees the context after this returns, failing what was queued
+    spdlog::error("Async Redis connect failed: {}", context->errstr);
+    conn->failure = NO_CONNECTION_ERROR;
+    conn->detach();
+    return;
+  }
+  conn->connected = true;
+  conn->connect_deadline.reset();
+}
+
+void AsyncRedisClient::Connection::onDisconnect(
+    const redisAsyncContext *context, int status) {
+  auto *conn = owning(context);
+  if (status != REDIS_OK && conn->failure.empty()) {
+    spdlog::error("Async Redis connection lost: {}", context->errstr);
+  }
+  conn->detach();
+}
+
+void AsyncRedisClient::Connection::onReply(redisAsyncContext *context,
+                                           void *reply, void *data) {
+  auto *conn = owning(context);
+  std::unique_ptr<Request> request(static_cast<Request *>(data));
+  if (!conn->in_flight.empty()) {
+    conn->in_flight.pop_front();
+  }
+
+  ReplyPtr r(static_cast<redisReply *>(reply));
+  if (!r) {
+    conn->owner->complete(*request, nullptr,
+                          context->err ? std::string_view(context->errstr)
+                                       : conn->lostReason());
+  } else if (r->type == REDIS_REPLY_ERROR) {
+    conn->owner->complete(*request, nullptr, std::string_view(r->str, r->len));
+  } else {
+    metrics::record(metrics::Stage::RedisFetch, Clock::now() - request->sent);
+    conn->owner->complete(*request, std::move(r), {});
+  }
+}
+
+void AsyncRedisClient::Connection::onSetupReply(redisAsyncContext *context,
+                                                void *reply, void *) {
+  auto *conn = owning(context);
+  if (!conn->in_flight.empty()) {
+    conn->in_flight.pop_front();
+  }
+  const ReplyPtr r(static_cast<redisReply *>(reply));
+  if (r && r->type == REDIS_REPLY_ERROR) {
+    // Commands after it fail with NOAUTH or hit the wrong database; say why
+    spdlog::error("Async Redis connection setup failed: {}",
+                  std::string_view(r->str, r->len));
+    metrics::add(metrics::Counter::RedisErrors);
+  }
+}
+
+AsyncRedisClient::AsyncRedisClient(const std::string &url,
+                                   const RedisClientOptions &options)
+    : endpoint_(url), options_(options) {
+  const size_t count = std::max<size_t>(1, options_.pool_size);
+  connections_.reserve(count);
+  for (size_t i = 0; i < count; ++i) {
+    auto conn = std::make_unique<Connection>();
+    conn->owner = this;
+    connections_.push_back(std::move(conn));
+  }
+
+  int fds[2];
+  if (::pipe2(fds, O_NONBLOCK | O_CLOEXEC) != 0) {
+    throw std::system_error(errno, std::generic_category(),
+                            "AsyncRedisClient wake pipe");
+  }
+  wake_read_ = fds[0];
+  wake_write_ = fds[1];
+  loop_ = std::thread([this] { run(); });
+}
+
+AsyncRedisClient::~AsyncRedisClient() {
+  {
+    std::lock_guard lock(mutex_);
+    stopping_ = true;
+  }
+  wake();
+  loop_.join();
+  ::close(wake_read_);
+  ::close(wake_write_);
+}
+
+void AsyncRedisClient::command(std::vector<std::string> args,
+                               ReplyCallback callback) {
+  auto request = std::make_unique<Request>();
+  request->args = std::move(args);
+  request->callback = std::move(callback);
+  enqueue(std::move(request));
+}
+
+void AsyncRedisClient::command(std::vector<std::string> args,
+                               OwnedReplyCallback callback) {
+  auto request = std::make_unique<Request>();
+  request->args = std::move(args);
+  request->owned_callback = std::move(callback);
+  enqueue(std::move(request));
+}
+
+void AsyncRedisClient::enqueue(std::unique_ptr<Request> request) {
+  pending_.fetch_add(1, std::memory_order_relaxed);
+
+  bool was_empty;
+  {
+    std::lock_guard lock(mutex_);
+    was_empty = queue_.empty();
+    queue_.push_back(std::move(request));
+  }
+  // One wake-up per batch: the loop drains the whole queue at once
+  if (was_empty) {
+    wake();
+  }
+}
+
+void AsyncRedisClient::wake() {
+  const char byte = 1;
+  // A full pipe already guarantees a wake-up
+  [[maybe_unused]] auto written = ::write(wake_write_, &byte, 1);
+}
+
+void AsyncRedisClient::complete(Request &request, ReplyPtr reply,
+                                std::string_view error) {
+  if (!error.empty()) {
+    metrics::add(metrics::Counter::RedisErrors);
+  }
+  try {
+    if (request.owned_callback) {
+      request.owned_callback(std::move(reply), error);
+    } else {
+      request.callback(reply.get(), error);
+    }
+  } catch (const std::exception &e) {
+    spdlog::error("Async Redis callback threw: {}", e.what());
+  }
+  pending_.fetch_sub(1, std::memory_order_relaxed);
+}
+
+AsyncRedisClient::Connection *AsyncRedisClient::nextConnection() {
+  const size_t count = connections_.size();
+  for (size_t i = 0; i < count; ++i) {
+    const size_t index = (next_connection_ + i) % count;
+    auto &conn = *connections_[index];
+    if (conn.context || conn.open(endpoint_, options_)) {
+      next_connection_ = (index + 1) % count;
+      return &conn;
+    }
+  }
+  return nullptr;
+}
+
+void AsyncRedisClient::dispatch(std::unique_ptr<Request> request) {
+  Connection *conn = nextConnection();
+  if (!conn) {
+    complete(*request, nullptr, NO_CONNECTION_ERROR);
+    return;
+  }
+
+  argv_.clear();
+  argv_len_.clear();
+  for (const auto &arg : request->args) {
+    argv_.push_back(arg.data());
+    argv_len_.push_back(arg.size());
+  }
+
+  // hiredis copies the arguments into its output buffer; the request rides
+  // along as privdata and comes back in onReply
+  Request *raw = request.get();
+  if (redisAsyncCommandArgv(conn->context, Connection::onReply, raw,
+                            static_cast<int>(argv_.size()), argv_.data(),
+                            argv_len_.data()) != REDIS_OK) {
+    complete(*request, nullptr,
+             conn->context->errstr[0] ? std::string_view(conn->context->errstr)
+                                      : NO_CONNECTION_ERROR);
+    return;
+  }
+  raw->sent = Clock::now();
+  request.release();
+  conn->in_flight.push_back(deadlineAfter(options_.socket_timeout));
+}
+
+void AsyncRedisClient::run() {
+  std::vector<std::unique_ptr<Request>> batch;
+  std::vector<pollfd> fds;
+  std::vector<Connection *> polled;
+
+  while (true) {
+    {
+      std::lock_guard lock(mutex_);
+      if (stopping_) {
+        break;
+      }
+      batch.swap(queue_);
+    }
+    for (auto &request : batch) {
+      dispatch(std::move(request));
+    }
+    batch.clear();
+
+    fds.clear();
+    polled.clear();
+    fds.push_back({wake_read_, POLLIN, 0});
+    std::optional<Clock::time_point> deadline;
+    for (auto &conn : connections_) {
+      if (auto next = conn->nextDeadline()) {
+        deadline = deadline ? std::min(*deadline, *next) : *next;
+      }
+      if (!conn->context || !(conn->reading || conn->writing)) {
+        continue;
+      }
+      short events = 0;
+      if (conn->reading) {
+        events |= POLLIN;
+      }
+      if (conn->writing) {
+        events |= POLLOUT;
+      }
+      fds.push_back({conn->context->c.fd, events, 0});
+      polled.push_back(conn.get());
+    }
+
+    int timeout_ms = -1;
+    if (deadline) {
+      const auto wait = std::chrono::ceil<std::chrono::milliseconds>(
+          *deadline - Clock::now());
+      timeout_ms = static_cast<int>(std::max<int64_t>(0, wait.count()));
+    }
+
+    if (::poll(fds.data(), fds.size(), timeout_ms) < 0 && errno != EINTR) {
+      spdlog::error("AsyncRedisClient poll failed: {}",
+                    std::generic_category().message(errno));
+    }
+
+    if (fds[0].revents & POLLIN) {
+      char drain[64];
+      while (::read(wake_read_, drain, sizeof(drain)) > 0) {
+      }
+    }
+
+    for (size_t i = 0; i < polled.size(); ++i) {
+      auto *conn = polled[i];
+      const short revents = fds[i + 1].revents;
+      if (conn->context && conn->reading &&
+          (revents & (POLLIN | POLLERR | POLLHUP))) {
+        redisAsyncHandleRead(conn->context);
+      }
+      // A read may have dropped the connection
+      if (conn->context && conn->writing &&
+          (revents & (POLLOUT | POLLERR | POLLHUP))) {
+        redisAsyncHandleWrite(conn->context);
+      }
+    }
+
+    const auto now = Clock::now();
+    for (auto &conn : connections_) {
+      auto next = conn->nextDeadline();
+      if (next && *next <= now) {
+        spdlog::warn("Async Redis {}; dropping connection with {} in flight",
+                     conn->connected ? "command timed out" : "connect timed out",
+                     conn->in_flight.size());
+        conn->close(conn->connected ? TIMEOUT_ERROR : CONNECT_TIMEOUT_ERROR);
+        conn->in_flight.clear();
+      }
+    }
+  }
+
+  // Shutdown: fail whatever is queued or in flight. Callbacks may still
+  // queue follow-ups, which are failed in turn.
+  for (auto &conn : connections_) {
+    conn->close(SHUTDOWN_ERROR);
+    conn->in_flight.clear();
+  }
+  while (true) {
+    {
+      std::lock_guard lock(mutex_);
+      batch.swap(queue_);
+    }
+    if (batch.empty()) {
+      break;
+    }
+    for (auto &request : batch) {
+      complete(*request, nullptr, SHUTDOWN_ERROR);
+    }
+    batch.clear();
+  }
+}
+
+AsyncRedisClientRegistry &AsyncRedisClientRegistry::instance() {
+  static AsyncRedisClientRegistry registry;
+  return registry;
+}
+
+std::shared_ptr<AsyncRedisClient>
+AsyncRedisClientRegistry::get(const std::string &url) {
+  std::lock_guard lock(mutex_);
+  auto &client = clients_[url];
+  if (!client) {
+    client = std::make_shared<AsyncRedisClient>(
+        url, RedisClientRegistry::instance().options());
+  }
+  return client;
+}
+
+void AsyncRedisClientRegistry::shutdown() {
+  std::unordered_map<std::string, std::shared_ptr<AsyncRedisClient>> clients;
+  {
+    std::lock_guard lock(mutex_);
+    clients.swap(clients_);
+  }
+  // Destroyed here, outside the lock, so failing callbacks may call get()
+}
@@ -0,0 +1,110 @@
+#include "bar_aggregator.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+BarBuilder::BarBuilder(std::chrono::seconds resolution)
+    : resolution_us_(resolution.count() * MICROS_PER_SECOND) {
+  if (resolution.count() <= 0)
+    throw std::invalid_argument("bar resolution must be positive");
+}
+
+int64_t BarBuilder::bucketStart(int64_t timestamp_us) const {
+  // Floor division, so pre-epoch timestamps land in the right bucket too
+  int64_t bucket = timestamp_us / resolution_us_;
+  if (timestamp_us % resolution_us_ < 0)
+    --bucket;
+  return bucket * resolution_us_;
+}
+
+std::optional<Bar> BarBuilder::add(int64_t timestamp_us,
+                                   double market_cap_sol, double sol_amount) {
+  std::optional<Bar> closed;
+  if (hasOpenBar() && timestamp_us >= open_.start_us + resolution_us_) {
+    closed = open_;
+    open_.trades = 0;
+  }
+
+  if (!hasOpenBar()) {
+    open_.start_us = bucketStart(timestamp_us);
+    open_.open_time_us = timestamp_us;
+    open_.high_time_us = timestamp_us;
+    open_.close_time_us = timestamp_us;
+    open_.open = market_cap_sol;
+    open_.high = market_cap_sol;
+    open_.low = market_cap_sol;
+    open_.close = market_cap_sol;
+    open_.volume = sol_amount;
+    open_.close_amount = sol_amount;
+    open_.trades = 1;
+    return closed;
+  }
+
+  // First occurrence of the high, as the per-trade peak is tracked
+  if (market_cap_sol > open_.high) {
+    open_.high = market_cap_sol;
+    open_.high_time_us = timestamp_us;
+  }
+  open_.low = std::min(open_.low, market_cap_sol);
+  open_.close = market_cap_sol;
+  open_.close_time_us = std::max(open_.close_time_us, timestamp_us);
+  open_.volume += sol_amount;
+  open_.close_amount = sol_amount;
+  ++open_.trades;
+  return closed;
+}
+
+std::optional<Bar> BarBuilder::closeDue(int64_t now_us) {
+  if (!hasOpenBar() || now_us < open_.start_us + resolution_us_)
+    return std::nullopt;
+  return flush();
+}
+
+std::optional<Bar> BarBuilder::flush() {
+  if (!hasOpenBar())
+    return std::nullopt;
+  const Bar closed = open_;
+  open_.trades = 0;
+  return closed;
+}
+
+MultiResolutionBars::MultiResolutionBars(
+    std::span<const std::chrono::seconds> resolutions) {
+  builders_.reserve(resolutions.size());
+  for (const auto resolution : resolutions)
+    builders_.emplace_back(resolution);
+}
+
+std::vector<Bar> aggregateBars(const TradeSeries &trades,
+                               std::chrono::seconds resolution) {
+  std::vector<Bar> bars;
+  BarBuilder builder(resolution);
+  for (size_t i = 0; i < trades.size(); ++i) {
+    if (auto bar = builder.add(trades.timestamp_us[i],
+                               trades.market_cap_sol[i], trades.sol_amount[i]))
+      bars.push_back(*bar);
+  }
+  if (auto bar = builder.flush())
+    bars.push_back(*bar);
+  return bars;
+}
+
+size_t countBars(const TradeSeries &trades, std::chrono::seconds resolution) {
+  if (trades.empty())
+    return 0;
+  // Same boundaries as BarBuilder: a bar closes at the first trade past
+  // start + resolution, and the next starts at that trade's bucket
+  const int64_t resolution_us = resolution.count() * MICROS_PER_SECOND;
+  BarBuilder builder(resolution);
+  size_t bars = 1;
+  builder.add(trades.timestamp_us[0], 0.0, 0.0);
+  int64_t end_us = builder.openBar().start_us + resolution_us;
+  for (size_t i = 1; i < trades.size(); ++i) {
+    if (trades.timestamp_us[i] < end_us)
+      continue;
+    ++bars;
+    builder.flush();
+    builder.add(trades.timestamp_us[i], 0.0, 0.0);
+    end_us = builder.openBar().start_us + resolution_us;
+  }
+  return bars;
+}
@@ -0,0 +1,107 @@
+#include "bar_detector.hpp"
+#include "metrics.hpp"
+#include "rug_pull_detector.hpp"
+#include <algorithm>
+
+namespace {
+
+// The one sample a closed bar contributes to the window
+void appendSample(TradeColumns &samples, const Bar &bar) {
+  samples.push_back(bar.close_time_us, bar.close, bar.close_amount);
+}
+
+} // namespace
+
+DetectionResult BarDetector::addTrade(int64_t timestamp_us,
+                                      double market_cap_sol, double sol_amount,
+                                      const DetectionParams &config) {
+  if (auto bar = builder_.add(timestamp_us, market_cap_sol, sol_amount))
+    return score(*bar, config);
+  return DetectionResult{};
+}
+
+DetectionResult BarDetector::closeDue(int64_t now_us,
+                                      const DetectionParams &config) {
+  if (auto bar = builder_.closeDue(now_us))
+    return score(*bar, config);
+  return DetectionResult{};
+}
+
+DetectionResult BarDetector::flush(const DetectionParams &config) {
+  if (auto bar = builder_.flush())
+    return score(*bar, config);
+  return DetectionResult{};
+}
+
+DetectionResult BarDetector::score(const Bar &bar,
+                                   const DetectionParams &config) {
+  if (closed_++ == 0)
+    analysis_start_us_ = bar.open_time_us;
+  if (bar.high > peak_mc_) {
+    peak_mc_ = bar.high;
+    peak_time_us_ = bar.high_time_us;
+  }
+  appendSample(samples_, bar);
+
+  metrics::StageTimer timer(metrics::Stage::Detect);
+  auto result = RugPullDetector::scan(samples_.view(), peak_mc_, peak_time_us_,
+                                      analysis_start_us_, current_idx_,
+                                      window_, config);
+  timer.stop();
+
+  // Drop bars the window can no longer reach (the left edge steps back by
+  // at most one second)
+  if (current_idx_ > 0) {
+    const int64_t cutoff =
+        samples_.timestamp_us(current_idx_ - 1) -
+        (static_cast<int64_t>(config.max_detection_time) + 1) *
+            MICROS_PER_SECOND;
+    const auto timestamps = samples_.view().timestamp_us;
+    const size_t drop = static_cast<size_t>(
+        std::lower_bound(timestamps.begin(),
+                         timestamps.begin() + window_.start(), cutoff) -
+        timestamps.begin());
+    if (drop > 0) {
+      samples_.eraseFront(drop);
+      window_.dropFront(drop);
+      current_idx_ -= drop;
+    }
+  }
+
+  if (result.rug_pulled) {
+    metrics::recordDetection(*result.timestamp);
+  }
+  return result;
+}
+
+DetectionResult BarDetector::detect(const TradeSeries &trades,
+                                    std::chrono::seconds resolution,
+                                    const DetectionParams &config) {
+  if (trades.empty())
+    return DetectionResult{};
+
+  // Samples straight from the builder; no Bar is kept
+  BarBuilder builder(resolution);
+  TradeColumns samples;
+  double peak_mc = 0.0;
+  int64_t peak_time_us = 0;
+  auto take = [&](const Bar &bar) {
+    if (bar.high > peak_mc) {
+      peak_mc = bar.high;
+      peak_time_us = bar.high_time_us;
+    }
+    appendSample(samples, bar);
+  };
+  for (size_t i = 0; i < trades.size(); ++i) {
+    if (auto bar = builder.add(trades.timestamp_us[i],
+                               trades.market_cap_sol[i], trades.sol_amount[i]))
+      take(*bar);
+  }
+  take(*builder.flush());
+
+  size_t current_idx = 0;
+  SlidingWindowStats window;
+  return RugPullDetector::scan(samples.view(), peak_mc, peak_time_us,
+                               trades.timestamp_us.front(), current_idx,
+                               window, config);
+}
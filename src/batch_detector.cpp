@@ -0,0 +1,140 @@
+#include "batch_detector.hpp"
+#include <algorithm>
+#include <cmath>
+#include <span>
+#include <stdexcept>
+#include "bar_detector.hpp"
+#include "parallel_chunks.hpp"
+#include "rug_pull_detector.hpp"
+
+namespace {
+
+// Score every mint with detect, in chunks of BATCH_CHUNK_SIZE claimed by up
+// to max_threads threads
+template <typename Detect>
+std::vector<DetectionResult> scoreSeries(std::span<const TradeSeries> mints,
+                                         size_t max_threads, Detect detect) {
+    std::vector<DetectionResult> results(mints.size());
+    parallelChunks(mints.size(), BATCH_CHUNK_SIZE, max_threads,
+                   [&](size_t begin, size_t end) {
+                       for (size_t i = begin; i < end; ++i) {
+                           results[i] = detect(mints[i]);
+                       }
+                   });
+    return results;
+}
+
+} // namespace
+
+std::vector<BatchDetection> detectBatch(RedisClient& redis,
+                                        const std::vector<std::string>& keys,
+                                        const DetectionParams& config,
+                                        size_t max_threads) {
+    std::vector<BatchDetection> detections(keys.size());
+    const std::span<const std::string> all_keys(keys);
+
+    // Each chunk is one pipelined round trip, so one slow key (or one slow
+    // round trip) only holds up its own chunk
+    parallelChunks(keys.size(), BATCH_CHUNK_SIZE, max_threads,
+                   [&](size_t begin, size_t end) {
+        auto chunk_trades =
+            redis.getTradesBatch(all_keys.subspan(begin, end - begin));
+
+        for (size_t i = 0; i < chunk_trades.size(); ++i) {
+            auto& trades = chunk_trades[i];
+            auto& detection = detections[begin + i];
+            detection.trade_count = trades.size();
+            if (trades.empty()) {
+                continue;
+            }
+
+            RugPullDetector detector;
+            for (auto&& trade : trades) {
+                detector.addTrade(std::move(trade));
+            }
+            detection.result = detector.processTrades(config);
+        }
+    });
+
+    return detections;
+}
+
+std::vector<DetectionResult> detectSeries(std::span<const TradeSeries> mints,
+                                          const DetectionParams& config,
+                                          size_t max_threads) {
+    return scoreSeries(mints, max_threads, [&config](const TradeSeries& trades) {
+        return RugPullDetector::detect(trades, config);
+    });
+}
+
+std::vector<DetectionResult> detectSeriesOnBars(
+    std::span<const TradeSeries> mints, std::chrono::seconds resolution,
+    const DetectionParams& config, size_t max_threads) {
+    return scoreSeries(
+        mints, max_threads, [resolution, &config](const TradeSeries& trades) {
+            return BarDetector::detect(trades, resolution, config);
+        });
+}
+
+std::vector<DetectionResult> detectCorpus(const TradeCorpus& corpus,
+                                          const DetectionParams& config,
+                                          size_t max_threads) {
+    // Views into the mapping, three spans per mint
+    std::vector<TradeSeries> mints;
+    mints.reserve(corpus.mintCount());
+    for (size_t i = 0; i < corpus.mintCount(); ++i) {
+        mints.push_back(corpus.series(i));
+    }
+    return detectSeries(mints, config, max_threads);
+}
+
+BarToleranceReport compareBarDetection(
+    std::span<const TradeSeries> mints,
+    std::span<const DetectionResult> per_trade,
+    std::span<const DetectionResult> on_bars, std::chrono::seconds resolution) {
+    if (per_trade.size() != mints.size() || on_bars.size() != mints.size()) {
+        throw std::invalid_argument("one result per mint expected");
+    }
+
+    BarToleranceReport report;
+    report.resolution = resolution;
+    report.mints = mints.size();
+    std::vector<double> lags;
+    double confidence_diff = 0.0;
+    for (size_t i = 0; i < mints.size(); ++i) {
+        report.trades += mints[i].size();
+        report.bars += countBars(mints[i], resolution);
+
+        const auto& trade = per_trade[i];
+        const auto& bar = on_bars[i];
+        if (trade.rug_pulled && !bar.rug_pulled) {
+            ++report.trade_only;
+        } else if (!trade.rug_pulled && bar.rug_pulled) {
+            ++report.bar_only;
+        } else if (trade.rug_pulled) {
+            ++report.both;
+            if (trade.debug_info.trigger_type == bar.debug_info.trigger_type) {
+                ++report.same_trigger;
+            }
+            const std::chrono::duration<double> lag =
+                *bar.timestamp - *trade.timestamp;
+            lags.push_back(lag.count());
+            confidence_diff += std::abs(bar.debug_info.confidence -
+                                        trade.debug_info.confidence);
+        }
+    }
+
+    if (!lags.empty()) {
+        std::sort(lags.begin(), lags.end());
+        double sum = 0.0;
+        for (const double lag : lags) {
+            sum += lag;
+        }
+        const auto count = static_cast<double>(lags.size());
+        report.mean_lag_s = sum / count;
+        report.p95_lag_s = lags[(lags.size() - 1) * 95 / 100];
+        report.max_lag_s = lags.back();
+        report.mean_confidence_diff = confidence_diff / count;
+    }
+    return report;
+}
@@ -0,0 +1,152 @@
+#include "block_file.hpp"
+#include <cerrno>
+#include <filesystem>
+#include <utility>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+std::string systemError() { return std::strerror(errno); }
+
+// Trade blocks are int64 timestamps then two double columns
+constexpr uint64_t TRADE_SIZE = sizeof(int64_t) + 2 * sizeof(double);
+
+} // namespace
+
+BlockFileWriter::BlockFileWriter(std::string path, std::string kind)
+    : path_(std::move(path)), kind_(std::move(kind)),
+      file_(std::fopen(path_.c_str(), "wb")) {
+  if (file_ == nullptr)
+    throw error(systemError());
+}
+
+BlockFileWriter::~BlockFileWriter() {
+  if (file_ == nullptr)
+    return;
+  std::fclose(file_);
+  std::remove(path_.c_str());
+}
+
+std::runtime_error BlockFileWriter::error(const std::string &what) const {
+  return std::runtime_error(kind_ + " " + path_ + ": " + what);
+}
+
+void BlockFileWriter::write(const void *data, size_t size) {
+  if (size == 0)
+    return;
+  if (std::fwrite(data, 1, size, file_) != size)
+    throw error(systemError());
+  offset_ += size;
+}
+
+void BlockFileWriter::writeTrades(const TradeSeries &trades) {
+  const size_t count = trades.size();
+  write(trades.timestamp_us.data(), count * sizeof(int64_t));
+  write(trades.market_cap_sol.data(), count * sizeof(double));
+  write(trades.sol_amount.data(), count * sizeof(double));
+}
+
+bool BlockFileWriter::close(const void *header, size_t size, bool sync) {
+  const bool ok = std::fseek(file_, 0, SEEK_SET) == 0 &&
+                  std::fwrite(header, size, 1, file_) == 1 &&
+                  std::fflush(file_) == 0 &&
+                  (!sync || ::fsync(::fileno(file_)) == 0);
+  std::FILE *file = file_;
+  file_ = nullptr;
+  return std::fclose(file) == 0 && ok;
+}
+
+void BlockFileWriter::finish(const void *header, size_t size) {
+  if (!close(header, size, false)) {
+    const auto failure = error(systemError());
+    std::remove(path_.c_str());
+    throw failure;
+  }
+}
+
+void BlockFileWriter::commit(const void *header, size_t size,
+                             const std::string &target) {
+  if (!close(header, size, true) ||
+      std::rename(path_.c_str(), target.c_str()) != 0) {
+    const auto reason = systemError();
+    std::remove(path_.c_str());
+    throw std::runtime_error(kind_ + " " + target + ": " + reason);
+  }
+
+  // Without this a crash could lose the rename itself
+  auto dir = std::filesystem::path(target).parent_path();
+  if (dir.empty())
+    dir = ".";
+  const int fd = ::open(dir.c_str(), O_RDONLY | O_DIRECTORY);
+  const bool ok = fd >= 0 && ::fsync(fd) == 0;
+  const auto reason = systemError();
+  if (fd >= 0)
+    ::close(fd);
+  if (!ok)
+    throw std::runtime_error(kind_ + " " + dir.string() + ": " + reason);
+}
+
+MappedBlockFile::MappedBlockFile(const std::string &path, std::string kind,
+                                 size_t header_size, Access access)
+    : path_(path), kind_(std::move(kind)) {
+  const int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0)
+    throw error(systemError());
+  struct stat info {};
+  if (::fstat(fd, &info) != 0) {
+    const auto failure = error(systemError());
+    ::close(fd);
+    throw failure;
+  }
+  size_ = static_cast<size_t>(info.st_size);
+  if (size_ < header_size) {
+    ::close(fd);
+    throw error("too short for a header");
+  }
+  void *mapped = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+  if (mapped == MAP_FAILED)
+    throw error(systemError());
+  data_ = static_cast<const std::byte *>(mapped);
+  ::madvise(mapped, size_,
+            access == Access::Sequential ? MADV_SEQUENTIAL : MADV_WILLNEED);
+}
+
+MappedBlockFile::~MappedBlockFile() {
+  ::munmap(const_cast<std::byte *>(data_), size_);
+}
+
+std::runtime_error MappedBlockFile::error(const std::string &what) const {
+  return std::runtime_error(kind_ + " " + path_ + ": " + what);
+}
+
+std::string_view MappedBlockFile::text(uint64_t offset, uint64_t size) const {
+  if (!fits(offset, size, 1, size_))
+    throw error("truncated or corrupt");
+  return {reinterpret_cast<const char *>(data_ + offset),
+          static_cast<size_t>(size)};
+}
+
+std::optional<TradeSeries> MappedBlockFile::trades(uint64_t offset,
+                                                   uint64_t count,
+                                                   uint64_t limit) const {
+  if (offset % alignof(int64_t) != 0 || limit > size_ ||
+      !fits(offset, count, TRADE_SIZE, limit))
+    return std::nullopt;
+  const auto n = static_cast<size_t>(count);
+  const auto *timestamps = reinterpret_cast<const int64_t *>(data_ + offset);
+  const auto *market_caps = reinterpret_cast<const double *>(timestamps + n);
+  return TradeSeries{{timestamps, n}, {market_caps, n}, {market_caps + n, n}};
+}
+
+std::optional<std::string_view>
+MappedBlockFile::slice(std::string_view section, uint64_t offset,
+                       uint64_t length) {
+  if (!fits(offset, length, 1, section.size()))
+    return std::nullopt;
+  return section.substr(static_cast<size_t>(offset),
+                        static_cast<size_t>(length));
+}
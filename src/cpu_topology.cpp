@@ -0,0 +1,130 @@
+#include "cpu_topology.hpp"
+#include <algorithm>
+#include <fstream>
+#include <map>
+#include <string>
+#include <tuple>
+#include <utility>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace {
+
+#ifdef __linux__
+
+const char *const SYS_CPU = "/sys/devices/system/cpu/cpu";
+const char *const SYS_NODE = "/sys/devices/system/node/node";
+
+// A single integer from a sysfs file; fallback if it cannot be read
+int readInt(const std::string &path, int fallback) {
+  std::ifstream in(path);
+  int value = fallback;
+  if (!(in >> value))
+    return fallback;
+  return value;
+}
+
+// Parse a sysfs CPU (or node) list such as "0-3,8,10-11"
+std::vector<int> parseCpuList(const std::string &list) {
+  std::vector<int> cpus;
+  size_t pos = 0;
+  while (pos < list.size()) {
+    size_t end = list.find(',', pos);
+    if (end == std::string::npos)
+      end = list.size();
+    const std::string range = list.substr(pos, end - pos);
+    const size_t dash = range.find('-');
+    try {
+      const int first = std::stoi(range.substr(0, dash));
+      const int last =
+          dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+      for (int cpu = first; cpu <= last; ++cpu)
+        cpus.push_back(cpu);
+    } catch (const std::exception &) {
+      // Trailing newline or an empty list
+    }
+    pos = end + 1;
+  }
+  return cpus;
+}
+
+// NUMA node of every CPU, from node*/cpulist; empty without NUMA support
+std::map<int, int> cpuNodes() {
+  std::map<int, int> nodes;
+  std::ifstream online("/sys/devices/system/node/online");
+  std::string list;
+  if (!std::getline(online, list))
+    return nodes;
+  for (const int node : parseCpuList(list)) {
+    std::ifstream in(SYS_NODE + std::to_string(node) + "/cpulist");
+    std::string cpus;
+    std::getline(in, cpus);
+    for (const int cpu : parseCpuList(cpus))
+      nodes[cpu] = node;
+  }
+  return nodes;
+}
+
+#endif
+
+} // namespace
+
+std::vector<CpuSlot> pinningOrder() {
+  std::vector<CpuSlot> slots;
+#ifdef __linux__
+  cpu_set_t allowed;
+  CPU_ZERO(&allowed);
+  if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0)
+    return slots;
+
+  const auto nodes = cpuNodes();
+  // Hardware threads seen so far per (node, package, core)
+  std::map<std::tuple<int, int, int>, int> threads_per_core;
+  for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+    if (!CPU_ISSET(cpu, &allowed))
+      continue;
+    const std::string topology =
+        SYS_CPU + std::to_string(cpu) + "/topology/";
+    CpuSlot slot;
+    slot.cpu = cpu;
+    const auto node = nodes.find(cpu);
+    slot.node = node == nodes.end() ? 0 : node->second;
+    slot.core = readInt(topology + "core_id", cpu);
+    const int package = readInt(topology + "physical_package_id", 0);
+    slot.smt_index = threads_per_core[{slot.node, package, slot.core}]++;
+    slots.push_back(slot);
+  }
+
+  std::stable_sort(slots.begin(), slots.end(),
+                   [](const CpuSlot &a, const CpuSlot &b) {
+                     return std::tie(a.smt_index, a.node, a.cpu) <
+                            std::tie(b.smt_index, b.node, b.cpu);
+                   });
+#endif
+  return slots;
+}
+
+bool pinCurrentThread(int cpu) {
+#ifdef __linux__
+  if (cpu < 0 || cpu >= CPU_SETSIZE)
+    return false;
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(cpu, &set);
+  return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+  (void)cpu;
+  return false;
+#endif
+}
+
+int currentCpu() {
+#ifdef __linux__
+  return sched_getcpu();
+#else
+  return -1;
+#endif
+}
@@ -0,0 +1,639 @@
+#include "detector_registry.hpp"
+#include <algorithm>
+#include <bit>
+#include <functional>
+#include <memory_resource>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "metrics.hpp"
+#include "rug_pull_detector.hpp"
+#include "trade_columns.hpp"
+#include "window_stats.hpp"
+
+namespace {
+
+constexpr uint32_t NIL = std::numeric_limits<uint32_t>::max();
+constexpr size_t MIN_INDEX_CAPACITY = 16;
+constexpr size_t MAX_SHARDS = size_t{1} << 16;
+// Compact a mint once at least this many of its trades are out of reach,
+// and they are at least half of what it holds, so the move is amortized
+constexpr size_t MIN_COMPACTION = 64;
+
+// Sits in front of a shard's pool and tracks live bytes, for the budget
+// and the registry_bytes gauge. Only touched under the shard lock; the
+// gauge is published from the sweep, not per allocation.
+class CountingResource : public std::pmr::memory_resource {
+public:
+  explicit CountingResource(std::pmr::memory_resource *upstream)
+      : upstream_(upstream) {}
+
+  size_t bytes() const { return bytes_; }
+
+private:
+  void *do_allocate(size_t bytes, size_t alignment) override {
+    void *p = upstream_->allocate(bytes, alignment);
+    bytes_ += bytes;
+    return p;
+  }
+
+  void do_deallocate(void *p, size_t bytes, size_t alignment) override {
+    upstream_->deallocate(p, bytes, alignment);
+    bytes_ -= bytes;
+  }
+
+  bool do_is_equal(const std::pmr::memory_resource &other) const
+      noexcept override {
+    return this == &other;
+  }
+
+  std::pmr::memory_resource *upstream_;
+  size_t bytes_ = 0;
+};
+
+// What RugPullDetector keeps between processTrades calls, with the columns
+// in the shard arena
+struct MintState {
+  explicit MintState(std::pmr::memory_resource *arena)
+      : mint(arena), timestamp_us(arena), market_cap_sol(arena),
+        sol_amount(arena) {}
+
+  void reset(std::string_view key, uint64_t key_hash) {
+    mint.assign(key);
+    hash = key_hash;
+    peak_mc = 0.0;
+    peak_time_us = 0;
+    analysis_start_us = 0;
+    current_idx = 0;
+    window.reset();
+    cursor = MintCursor{};
+  }
+
+  void append(std::span<const Trade> trades) {
+    for (const auto &trade : trades) {
+      const int64_t ts = toMicros(trade.timestamp);
+      // Compaction always leaves the window, so empty means first trade
+      if (timestamp_us.empty()) {
+        analysis_start_us = ts;
+      }
+      if (trade.market_cap_sol > peak_mc) {
+        peak_mc = trade.market_cap_sol;
+        peak_time_us = ts;
+      }
+      timestamp_us.push_back(ts);
+      market_cap_sol.push_back(trade.market_cap_sol);
+      sol_amount.push_back(trade.sol_amount);
+    }
+  }
+
+  TradeSeries view() const {
+    return {timestamp_us, market_cap_sol, sol_amount};
+  }
+
+  // Drop trades the window can no longer reach
+  void compact(int max_detection_time) {
+    if (current_idx == 0)
+      return;
+    const int64_t cutoff =
+        timestamp_us[current_idx - 1] -
+        (static_cast<int64_t>(max_detection_time) + 1) * MICROS_PER_SECOND;
+    const auto first = timestamp_us.begin();
+    const size_t drop = static_cast<size_t>(
+        std::lower_bound(first, first + window.start(), cutoff) - first);
+    if (drop < MIN_COMPACTION || drop * 2 < timestamp_us.size())
+      return;
+
+    timestamp_us.erase(first, first + drop);
+    market_cap_sol.erase(market_cap_sol.begin(), market_cap_sol.begin() + drop);
+    sol_amount.erase(sol_amount.begin(), sol_amount.begin() + drop);
+    current_idx -= drop;
+    window.dropFront(drop);
+  }
+
+  void shrink() {
+    timestamp_us.shrink_to_fit();
+    market_cap_sol.shrink_to_fit();
+    sol_amount.shrink_to_fit();
+  }
+
+  void releaseTrades() {
+    timestamp_us.clear();
+    market_cap_sol.clear();
+    sol_amount.clear();
+    shrink();
+    current_idx = 0;
+    window.reset();
+  }
+
+  std::pmr::string mint;
+  uint64_t hash = 0;
+  std::pmr::vector<int64_t> timestamp_us;
+  std::pmr::vector<double> market_cap_sol;
+  std::pmr::vector<double> sol_amount;
+  double peak_mc = 0.0;
+  int64_t peak_time_us = 0;
+  int64_t analysis_start_us = 0;
+  size_t current_idx = 0;
+  SlidingWindowStats window;
+  MintCursor cursor;
+  DetectorRegistry::Clock::time_point last_update;
+  // Recency list, most recently updated first
+  uint32_t prev = NIL;
+  uint32_t next = NIL;
+};
+
+// Lets the tombstone map be probed with a string_view
+struct NameHash {
+  using is_transparent = void;
+  size_t operator()(std::string_view name) const {
+    return std::hash<std::string_view>{}(name);
+  }
+};
+
+} // namespace
+
+struct alignas(64) DetectorRegistry::Shard {
+  // Index slot: high hash bits as a cheap pre-filter, and the state index
+  struct Slot {
+    uint32_t tag = 0;
+    uint32_t state = NIL;
+  };
+
+  Shard()
+      : arena(&pool), slots(&arena), states(&arena), free_states(&arena),
+        tombstones(&arena) {}
+
+  ~Shard() {
+    metrics::adjust(metrics::Gauge::TrackedMints,
+                    -static_cast<int64_t>(mints));
+    metrics::adjust(metrics::Gauge::RegistryBytes, -published_bytes);
+  }
+
+  // Bring the registry_bytes gauge up to date with the arena
+  void publishBytes() {
+    const auto bytes = static_cast<int64_t>(arena.bytes());
+    metrics::adjust(metrics::Gauge::RegistryBytes, bytes - published_bytes);
+    published_bytes = bytes;
+  }
+
+  static uint32_t tagOf(uint64_t hash) {
+    return static_cast<uint32_t>(hash >> 32);
+  }
+
+  uint32_t find(std::string_view mint, uint64_t hash) const {
+    if (slots.empty())
+      return NIL;
+    const size_t mask = slots.size() - 1;
+    const uint32_t tag = tagOf(hash);
+    for (size_t i = hash & mask;; i = (i + 1) & mask) {
+      const Slot &slot = slots[i];
+      if (slot.state == NIL)
+        return NIL;
+      if (slot.tag == tag && states[slot.state].mint == mint)
+        return slot.state;
+    }
+  }
+
+  // insert() keeps the load factor at or below one half, so a free slot
+  // is always found
+  void placeSlot(uint64_t hash, uint32_t state) {
+    const size_t mask = slots.size() - 1;
+    size_t i = hash & mask;
+    while (slots[i].state != NIL)
+      i = (i + 1) & mask;
+    slots[i] = Slot{tagOf(hash), state};
+  }
+
+  void grow() {
+    std::pmr::vector<Slot> old(
+        std::max(MIN_INDEX_CAPACITY, slots.size() * 2), Slot{}, &arena);
+    old.swap(slots);
+    for (const Slot &slot : old) {
+      if (slot.state != NIL)
+        placeSlot(states[slot.state].hash, slot.state);
+    }
+  }
+
+  uint32_t insert(std::string_view mint, uint64_t hash) {
+    if ((mints + 1) * 2 > slots.size())
+      grow();
+
+    uint32_t id;
+    if (!free_states.empty()) {
+      id = free_states.back();
+      free_states.pop_back();
+    } else {
+      id = static_cast<uint32_t>(states.size());
+      states.emplace_back(&arena);
+    }
+    states[id].reset(mint, hash);
+    placeSlot(hash, id);
+    ++mints;
+    metrics::adjust(metrics::Gauge::TrackedMints, 1);
+    return id;
+  }
+
+  // Backward-shift deletion, so lookups never see tombstones
+  void unindex(uint32_t id) {
+    const size_t mask = slots.size() - 1;
+    size_t hole = states[id].hash & mask;
+    while (slots[hole].state != id)
+      hole = (hole + 1) & mask;
+
+    for (size_t j = (hole + 1) & mask; slots[j].state != NIL;
+         j = (j + 1) & mask) {
+      const size_t home = states[slots[j].state].hash & mask;
+      // Move j into the hole unless its home lies cyclically in (hole, j]
+      if (((j - home) & mask) >= ((j - hole) & mask)) {
+        slots[hole] = slots[j];
+        hole = j;
+      }
+    }
+    slots[hole] = Slot{};
+  }
+
+  void unlink(uint32_t id) {
+    auto &state = states[id];
+    (state.prev == NIL ? lru_head : states[state.prev].next) = state.next;
+    (state.next == NIL ? lru_tail : states[state.next].prev) = state.prev;
+    state.prev = state.next = NIL;
+  }
+
+  void touch(uint32_t id, Clock::time_point now) {
+    auto &state = states[id];
+    state.last_update = now;
+    if (lru_head == id)
+      return;
+    if (state.prev != NIL || state.next != NIL || lru_tail == id)
+      unlink(id);
+    state.next = lru_head;
+    if (lru_head != NIL)
+      states[lru_head].prev = id;
+    lru_head = id;
+    if (lru_tail == NIL)
+      lru_tail = id;
+  }
+
+  void remove(uint32_t id) {
+    unindex(id);
+    unlink(id);
+    auto &state = states[id];
+    state.releaseTrades();
+    state.mint.clear();
+    state.mint.shrink_to_fit();
+    free_states.push_back(id);
+    --mints;
+    metrics::adjust(metrics::Gauge::TrackedMints, -1);
+  }
+
+  void evict(uint32_t id, uint64_t &reason) {
+    remove(id);
+    ++reason;
+    metrics::add(metrics::Counter::MintsEvicted);
+  }
+
+  size_t evictIdle(Clock::time_point cutoff) {
+    size_t evicted = 0;
+    while (lru_tail != NIL && states[lru_tail].last_update < cutoff) {
+      evict(lru_tail, evicted_idle);
+      ++evicted;
+    }
+    return evicted;
+  }
+
+  // Evict least recently updated mints, sparing keep, until under budget.
+  // A reported mint leaves a tombstone so it is not fetched and reported
+  // again.
+  void enforceBudget(uint32_t keep) {
+    while (arena.bytes() > budget && lru_tail != NIL && lru_tail != keep) {
+      const auto &state = states[lru_tail];
+      if (state.cursor.reported)
+        tombstones.insert_or_assign(state.mint, state.last_update);
+      evict(lru_tail, evicted_budget);
+    }
+    if (arena.bytes() > budget)
+      states[keep].shrink();
+  }
+
+  bool isTombstone(std::string_view mint) const {
+    return tombstones.find(mint) != tombstones.end();
+  }
+
+  // Tombstones expire with the keys they stand for
+  void expireTombstones(Clock::time_point cutoff) {
+    std::erase_if(tombstones,
+                  [&](const auto &entry) { return entry.second < cutoff; });
+  }
+
+  mutable std::mutex mutex;
+  std::pmr::unsynchronized_pool_resource pool;
+  CountingResource arena;
+  // Open addressing with linear probing; capacity is a power of two
+  std::pmr::vector<Slot> slots;
+  // Stable per-mint indices; removed ones are recycled via free_states
+  std::pmr::vector<MintState> states;
+  std::pmr::vector<uint32_t> free_states;
+  uint32_t lru_head = NIL;
+  uint32_t lru_tail = NIL;
+  // Reported mints evicted for the budget, with their last update
+  std::pmr::unordered_map<std::pmr::string, Clock::time_point, NameHash,
+                          std::equal_to<>>
+      tombstones;
+  size_t mints = 0;
+  size_t budget = 0;
+  int64_t published_bytes = 0;
+  uint64_t evicted_idle = 0;
+  uint64_t evicted_budget = 0;
+};
+
+DetectorRegistry::DetectorRegistry(RegistryOptions options)
+    : options_(options) {
+  const size_t shard_count =
+      std::bit_ceil(std::clamp<size_t>(options_.shard_count, 1, MAX_SHARDS));
+  shard_mask_ = shard_count - 1;
+  shards_ = std::make_unique<Shard[]>(shard_count);
+  for (size_t i = 0; i < shard_count; ++i) {
+    shards_[i].budget = options_.memory_budget_bytes / shard_count;
+  }
+}
+
+DetectorRegistry::~DetectorRegistry() = default;
+
+DetectorRegistry::Shard &DetectorRegistry::shardFor(uint64_t hash) const {
+  // Top bits pick the shard, low bits the slot within it
+  return shards_[(hash >> 48) & shard_mask_];
+}
+
+MintCursor DetectorRegistry::cursor(std::string_view mint) const {
+  const uint64_t hash = std::hash<std::string_view>{}(mint);
+  Shard &shard = shardFor(hash);
+  std::lock_guard lock(shard.mutex);
+  const uint32_t id = shard.find(mint, hash);
+  if (id != NIL)
+    return shard.states[id].cursor;
+  return MintCursor{.reported = shard.isTombstone(mint)};
+}
+
+std::optional<RiskSignals>
+DetectorRegistry::riskSignals(std::string_view mint) const {
+  const uint64_t hash = std::hash<std::string_view>{}(mint);
+  Shard &shard = shardFor(hash);
+  std::lock_guard lock(shard.mutex);
+  const uint32_t id = shard.find(mint, hash);
+  if (id == NIL)
+    return std::nullopt;
+  const MintState &state = shard.states[id];
+  if (state.cursor.reported || state.timestamp_us.empty())
+    return std::nullopt;
+
+  const int64_t last_us = state.timestamp_us.back();
+  const double held_seconds =
+      static_cast<double>(last_us - state.timestamp_us.front()) /
+      MICROS_PER_SECOND;
+  RiskSignals signals;
+  if (state.peak_mc > 0)
+    signals.drop_from_peak =
+        (state.peak_mc - state.market_cap_sol.back()) / state.peak_mc;
+  signals.seconds_since_peak =
+      static_cast<double>(last_us - state.peak_time_us) / MICROS_PER_SECOND;
+  signals.trades_per_second = static_cast<double>(state.timestamp_us.size()) /
+                              std::max(1.0, held_seconds);
+  return signals;
+}
+
+DetectionResult DetectorRegistry::update(std::string_view mint,
+                                         std::span<const Trade> trades,
+                                         double last_score,
+                                         std::span<const uint64_t> last_members,
+                                         const DetectionParams &params,
+                                         Clock::time_point now) {
+  const uint64_t hash = std::hash<std::string_view>{}(mint);
+  Shard &shard = shardFor(hash);
+  std::lock_guard lock(shard.mutex);
+
+  shard.evictIdle(now - options_.idle_ttl);
+
+  uint32_t id = shard.find(mint, hash);
+  if (id == NIL) {
+    if (auto tombstone = shard.tombstones.find(mint);
+        tombstone != shard.tombstones.end()) {
+      tombstone->second = now;
+      return DetectionResult{};
+    }
+    id = shard.insert(mint, hash);
+  }
+  shard.touch(id, now);
+
+  auto &state = shard.states[id];
+  auto &cursor = state.cursor;
+  cursor.last_score = last_score;
+  cursor.last_member_count = 0;
+  if (last_members.size() <= MAX_CURSOR_TIES) {
+    std::copy(last_members.begin(), last_members.end(),
+              cursor.last_members.begin());
+    cursor.last_member_count = static_cast<uint8_t>(last_members.size());
+  }
+  if (cursor.reported || trades.empty()) {
+    return DetectionResult{};
+  }
+
+  state.append(trades);
+
+  metrics::StageTimer timer(metrics::Stage::Detect);
+  auto result = RugPullDetector::scan(state.view(), state.peak_mc,
+                                      state.peak_time_us,
+                                      state.analysis_start_us,
+                                      state.current_idx, state.window, params);
+  timer.stop();
+
+  if (result.rug_pulled) {
+    metrics::recordDetection(*result.timestamp);
+    // The verdict is all that is needed from here on
+    cursor.reported = true;
+    state.releaseTrades();
+  } else {
+    state.compact(params.max_detection_time);
+  }
+
+  shard.enforceBudget(id);
+  return result;
+}
+
+bool DetectorRegistry::erase(std::string_view mint) {
+  const uint64_t hash = std::hash<std::string_view>{}(mint);
+  Shard &shard = shardFor(hash);
+  std::lock_guard lock(shard.mutex);
+  const uint32_t id = shard.find(mint, hash);
+  if (id == NIL) {
+    const auto tombstone = shard.tombstones.find(mint);
+    if (tombstone == shard.tombstones.end())
+      return false;
+    shard.tombstones.erase(tombstone);
+    return true;
+  }
+  shard.remove(id);
+  return true;
+}
+
+size_t DetectorRegistry::eraseIf(
+    const std::function<bool(std::string_view)> &pred) {
+  size_t erased = 0;
+  for (size_t i = 0; i <= shard_mask_; ++i) {
+    Shard &shard = shards_[i];
+    std::lock_guard lock(shard.mutex);
+    // Every tracked mint is on the LRU list
+    for (uint32_t id = shard.lru_head; id != NIL;) {
+      const uint32_t next = shard.states[id].next;
+      if (pred(shard.states[id].mint)) {
+        shard.remove(id);
+        ++erased;
+      }
+      id = next;
+    }
+    erased += std::erase_if(shard.tombstones, [&](const auto &entry) {
+      return pred(entry.first);
+    });
+  }
+  return erased;
+}
+
+void DetectorRegistry::forEachMint(
+    const std::function<void(const MintSnapshot &)> &f) const {
+  // A copy of one shard's mints, so f runs (and may block on I/O) without
+  // holding the shard lock
+  struct OwnedMint {
+    std::string mint;
+    TradeColumns trades;
+    MintSnapshot snapshot;
+  };
+  std::vector<OwnedMint> copies;
+  // Steady-clock update times mean nothing to another process
+  const auto steady_now = Clock::now();
+  const int64_t wall_now_us = toMicros(std::chrono::system_clock::now());
+  const auto wallTime = [&](Clock::time_point last_update) {
+    return wall_now_us - std::chrono::duration_cast<std::chrono::microseconds>(
+                             steady_now - last_update)
+                             .count();
+  };
+  for (size_t i = 0; i <= shard_mask_; ++i) {
+    const Shard &shard = shards_[i];
+    copies.clear();
+    {
+      std::lock_guard lock(shard.mutex);
+      copies.reserve(shard.mints + shard.tombstones.size());
+      for (uint32_t id = shard.lru_head; id != NIL;
+           id = shard.states[id].next) {
+        const auto &state = shard.states[id];
+        OwnedMint &copy = copies.emplace_back();
+        copy.mint = state.mint;
+        const TradeSeries trades = state.view();
+        copy.trades.reserve(trades.size());
+        for (size_t t = 0; t < trades.size(); ++t)
+          copy.trades.push_back(trades.timestamp_us[t],
+                                trades.market_cap_sol[t],
+                                trades.sol_amount[t]);
+        MintSnapshot &mint = copy.snapshot;
+        mint.peak_mc = state.peak_mc;
+        mint.peak_time_us = state.peak_time_us;
+        mint.analysis_start_us = state.analysis_start_us;
+        mint.current_idx = state.current_idx;
+        mint.window_begin = state.window.start();
+        mint.window_end = state.window.end();
+        mint.cursor = state.cursor;
+        mint.last_update_us = wallTime(state.last_update);
+      }
+      for (const auto &[name, last_update] : shard.tombstones) {
+        OwnedMint &copy = copies.emplace_back();
+        copy.mint = name;
+        copy.snapshot.cursor.reported = true;
+        copy.snapshot.last_update_us = wallTime(last_update);
+      }
+    }
+    for (OwnedMint &copy : copies) {
+      copy.snapshot.mint = copy.mint;
+      copy.snapshot.trades = copy.trades.view();
+      f(copy.snapshot);
+    }
+  }
+}
+
+bool DetectorRegistry::restore(const MintSnapshot &mint,
+                               Clock::time_point now) {
+  const size_t count = mint.trades.size();
+  if (mint.trades.market_cap_sol.size() != count ||
+      mint.trades.sol_amount.size() != count || mint.current_idx > count ||
+      mint.window_begin > mint.window_end || mint.window_end > count) {
+    return false;
+  }
+
+  const auto idle = std::chrono::microseconds(std::max<int64_t>(
+      0, toMicros(std::chrono::system_clock::now()) - mint.last_update_us));
+  if (idle > options_.idle_ttl) {
+    return false;
+  }
+
+  const uint64_t hash = std::hash<std::string_view>{}(mint.mint);
+  Shard &shard = shardFor(hash);
+  std::lock_guard lock(shard.mutex);
+  if (shard.find(mint.mint, hash) != NIL || shard.isTombstone(mint.mint)) {
+    return false;
+  }
+
+  const uint32_t id = shard.insert(mint.mint, hash);
+  auto &state = shard.states[id];
+  state.timestamp_us.assign(mint.trades.timestamp_us.begin(),
+                            mint.trades.timestamp_us.end());
+  state.market_cap_sol.assign(mint.trades.market_cap_sol.begin(),
+                              mint.trades.market_cap_sol.end());
+  state.sol_amount.assign(mint.trades.sol_amount.begin(),
+                          mint.trades.sol_amount.end());
+  state.peak_mc = mint.peak_mc;
+  state.peak_time_us = mint.peak_time_us;
+  state.analysis_start_us = mint.analysis_start_us;
+  state.current_idx = mint.current_idx;
+  state.window.restore(state.view(), mint.window_begin, mint.window_end);
+  state.cursor = mint.cursor;
+  shard.touch(id, now - std::chrono::duration_cast<Clock::duration>(idle));
+  shard.enforceBudget(id);
+  return true;
+}
+
+size_t DetectorRegistry::evictIdle(Clock::time_point now) {
+  size_t evicted = 0;
+  for (size_t i = 0; i <= shard_mask_; ++i) {
+    Shard &shard = shards_[i];
+    std::lock_guard lock(shard.mutex);
+    evicted += shard.evictIdle(now - options_.idle_ttl);
+    shard.expireTombstones(now - options_.idle_ttl);
+    shard.publishBytes();
+  }
+  return evicted;
+}
+
+size_t DetectorRegistry::size() const {
+  size_t total = 0;
+  for (size_t i = 0; i <= shard_mask_; ++i) {
+    std::lock_guard lock(shards_[i].mutex);
+    total += shards_[i].mints;
+  }
+  return total;
+}
+
+RegistryStats DetectorRegistry::stats() const {
+  RegistryStats stats;
+  for (size_t i = 0; i <= shard_mask_; ++i) {
+    Shard &shard = shards_[i];
+    std::lock_guard lock(shard.mutex);
+    shard.publishBytes();
+    stats.mints += shard.mints;
+    stats.tombstones += shard.tombstones.size();
+    stats.bytes += shard.arena.bytes();
+    stats.evicted_idle += shard.evicted_idle;
+    stats.evicted_budget += shard.evicted_budget;
+    for (uint32_t id = shard.lru_head; id != NIL; id = shard.states[id].next) {
+      stats.trades += shard.states[id].timestamp_us.size();
+    }
+  }
+  return stats;
+}
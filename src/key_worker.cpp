@@ -0,0 +1,140 @@
+#include "key_worker.hpp"
+#include "metrics.hpp"
+#include "rug_pull_detector.hpp"
+#include "trade_reply.hpp"
+#include "window_stats.hpp"
+#include <algorithm>
+#include <optional>
+
+namespace {
+
+// Without its price term a pattern score tops out at 0.3 + 0.3, so above
+// that the pattern trigger needs a peak_drop_threshold drop, and scan()
+// only scores patterns 5 s or more after the peak. A millisecond of slack
+// covers score rounding: an early candidate costs a few trades, a late one
+// a wrong answer.
+bool patternNeedsDrop(const DetectionParams &params) {
+  return params.min_confidence_score > 0.6;
+}
+constexpr double PATTERN_DELAY_SECONDS = 5.0 - 0.001;
+
+int64_t scoreMicros(double score) { return toMicros(scoreToTimePoint(score)); }
+
+} // namespace
+
+KeyWorker::KeyWorker(size_t arena_bytes) : arena_(arena_bytes) {}
+
+KeyWorker::Check KeyWorker::check(RedisClient &redis, const std::string &key,
+                                  const DetectionParams &params) {
+  arena_.reset();
+  TradeColumns columns(arena_.resource());
+  redis.getTrades(key, columns);
+  return detect(columns, params);
+}
+
+KeyWorker::Check KeyWorker::checkWindowed(RedisClient &redis,
+                                          const std::string &key,
+                                          const DetectionParams &params) {
+  if (!patternNeedsDrop(params)) {
+    return check(redis, key, params);
+  }
+
+  Check check;
+  const auto summary =
+      redis.summarizeTrades(key, params.stop_loss_threshold,
+                            params.peak_drop_threshold, PATTERN_DELAY_SECONDS);
+  if (!summary) {
+    return check;
+  }
+  check.trade_count = summary->count;
+  if (!summary->candidate_score) {
+    return check;
+  }
+
+  arena_.reset();
+  TradeColumns columns(arena_.resource());
+  columns.reserve(2 * WINDOWED_PAGE_SIZE);
+
+  // No window reaches further back than max_detection_time seconds; the
+  // extra seconds absorb score rounding
+  const double lookback = params.max_detection_time + 2.0;
+  auto page = redis.getTradesPage(key, *summary->candidate_score - lookback,
+                                  0, WINDOWED_PAGE_SIZE, columns);
+
+  // Start at the candidate, with the window built from the history above
+  const auto timestamps = columns.view().timestamp_us;
+  size_t idx = static_cast<size_t>(
+      std::lower_bound(timestamps.begin(), timestamps.end(),
+                       scoreMicros(*summary->candidate_score)) -
+      timestamps.begin());
+  SlidingWindowStats window;
+  const int64_t peak_time_us = scoreMicros(summary->peak_score);
+  const int64_t analysis_start_us = scoreMicros(summary->first_score);
+
+  while (true) {
+    metrics::StageTimer timer(metrics::Stage::Detect);
+    check.result = RugPullDetector::scan(
+        columns.view(), summary->peak_market_cap, peak_time_us,
+        analysis_start_us, idx, window, params);
+    timer.stop();
+    if (check.result.rug_pulled || page.pairs < WINDOWED_PAGE_SIZE) {
+      break;
+    }
+
+    // Keep only what the window can still reach, then fetch the next page.
+    // Trades scored exactly last_score are skipped by offset, not by an
+    // exclusive bound, so ties straddling pages are neither lost nor
+    // fetched twice.
+    if (idx > 0) {
+      const auto series = columns.view();
+      const int64_t cutoff =
+          series.timestamp_us[idx - 1] -
+          (static_cast<int64_t>(params.max_detection_time) + 1) *
+              MICROS_PER_SECOND;
+      const auto first = series.timestamp_us.begin();
+      const size_t drop = static_cast<size_t>(
+          std::lower_bound(first, first + window.start(), cutoff) - first);
+      columns.eraseFront(drop);
+      idx -= drop;
+      window.dropFront(drop);
+    }
+    const double last_score = page.last_score;
+    const size_t skip = page.ties;
+    page = redis.getTradesPage(key, last_score, skip, WINDOWED_PAGE_SIZE,
+                               columns);
+    if (page.pairs > 0 && page.last_score == last_score) {
+      page.ties += skip;
+    }
+  }
+
+  if (check.result.rug_pulled) {
+    metrics::recordDetection(*check.result.timestamp);
+  }
+  return check;
+}
+
+KeyWorker::Check KeyWorker::check(const redisReply &reply,
+                                  const DetectionParams &params) {
+  arena_.reset();
+  TradeColumns columns(arena_.resource());
+  appendReplyTrades(reply, columns);
+  return detect(columns, params);
+}
+
+KeyWorker::Check KeyWorker::detect(const TradeColumns &columns,
+                                   const DetectionParams &params) {
+  Check check;
+  check.trade_count = columns.size();
+  if (columns.empty()) {
+    return check;
+  }
+
+  metrics::StageTimer timer(metrics::Stage::Detect);
+  check.result = RugPullDetector::detect(columns.view(), params);
+  timer.stop();
+
+  if (check.result.rug_pulled) {
+    metrics::recordDetection(*check.result.timestamp);
+  }
+  return check;
+}
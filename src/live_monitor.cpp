@@ -0,0 +1,316 @@
+#include "live_monitor.hpp"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <filesystem>
+#include <future>
+#include <iterator>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include <spdlog/spdlog.h>
+#include "registry_snapshot.hpp"
+#include "risk_priority.hpp"
+
+namespace {
+
+constexpr const char* TRADE_KEY_PATTERN = "recent_trades:*";
+constexpr const char* KEYSPACE_PATTERN = "__keyspace@*__:recent_trades:*";
+
+// Keyspace events (K) for sorted-set (z), generic (g) and expiry (x) commands
+constexpr const char* REQUIRED_EVENT_FLAGS = "Kzgx";
+
+// How often run() sweeps every registry shard for idle mints
+constexpr auto IDLE_SWEEP_INTERVAL = std::chrono::minutes(1);
+
+// Longest a pass over the subscriptions blocks, so stop is seen promptly
+constexpr auto CONSUME_TIMEOUT = std::chrono::milliseconds(200);
+
+// Registry settings with a single connection (per master): run() drives
+// every fetch from one thread
+RedisClientOptions monitorOptions() {
+    auto options = RedisClientRegistry::instance().options();
+    options.pool_size = 1;
+    return options;
+}
+
+} // namespace
+
+LiveMonitor::LiveMonitor(const std::string& redis_url, DetectionParams config,
+                         RegistryOptions registry_options,
+                         std::optional<MembershipOptions> sharding,
+                         std::optional<SnapshotOptions> snapshots)
+    : config_(config)
+    , redis_(redis_url, monitorOptions())
+    , registry_(registry_options)
+    , snapshots_(std::move(snapshots)) {
+    if (sharding) {
+        membership_.emplace(redis_, std::move(*sharding));
+    }
+    if (snapshots_) {
+        loadSnapshot();
+    }
+}
+
+void LiveMonitor::loadSnapshot() {
+    const auto& path = snapshots_->path;
+    if (!std::filesystem::exists(path)) {
+        spdlog::info("No snapshot at {}, starting cold", path);
+        return;
+    }
+    try {
+        const auto started = std::chrono::steady_clock::now();
+        // With sharding, only mints this member owns right now
+        std::function<bool(std::string_view)> keep;
+        if (membership_) {
+            keep = [this](std::string_view key) {
+                return membership_->owns(key);
+            };
+        }
+        const auto load = loadRegistrySnapshot(
+            registry_, path, config_.max_detection_time, keep);
+        spdlog::info("Restored {} mints ({} trades) from {} in {} ms, "
+                     "skipped {}", load.restored, load.trades, path,
+                     std::chrono::duration_cast<std::chrono::milliseconds>(
+                         std::chrono::steady_clock::now() - started).count(),
+                     load.skipped);
+    } catch (const std::exception& e) {
+        spdlog::warn("Could not load snapshot, starting cold: {}", e.what());
+    }
+}
+
+size_t LiveMonitor::saveSnapshot() const {
+    if (!snapshots_) {
+        throw std::runtime_error("snapshots are not enabled");
+    }
+    return saveRegistrySnapshot(registry_, snapshots_->path,
+                                config_.max_detection_time);
+}
+
+void LiveMonitor::saveSnapshotLogged() const {
+    try {
+        const auto started = std::chrono::steady_clock::now();
+        const size_t mints = saveSnapshot();
+        spdlog::debug("Saved {} mints to {} in {} ms", mints,
+                      snapshots_->path,
+                      std::chrono::duration_cast<std::chrono::milliseconds>(
+                          std::chrono::steady_clock::now() - started).count());
+    } catch (const std::exception& e) {
+        spdlog::error("Snapshot failed: {}", e.what());
+    }
+}
+
+LiveUpdate LiveMonitor::onTradesAdded(const std::string& key) {
+    LiveUpdate update;
+
+    const auto cursor = registry_.cursor(key);
+    if (cursor.reported) {
+        return update;
+    }
+
+    auto batch = redis_.getTradesAfter(key, cursor.last_score,
+                                       cursor.lastMembers());
+    update.new_trades = batch.trades.size();
+    if (batch.trades.empty()) {
+        return update;
+    }
+
+    // The registry resumes where the mint's last update stopped, so only
+    // the new trades are scanned
+    auto result = registry_.update(key, batch.trades, batch.last_score,
+                                   batch.last_members, config_);
+    if (result.rug_pulled) {
+        update.detection = std::move(result);
+    }
+
+    return update;
+}
+
+void LiveMonitor::onKeyRemoved(const std::string& key) {
+    registry_.erase(key);
+}
+
+void LiveMonitor::enableKeyspaceEvents(sw::redis::Redis& redis) {
+    try {
+        std::vector<std::string> config;
+        redis.command("CONFIG", "GET", "notify-keyspace-events",
+                      std::back_inserter(config));
+        std::string flags = config.size() == 2 ? config[1] : "";
+
+        // 'A' is an alias for every event class except key-miss and new
+        bool changed = false;
+        for (const char* flag = REQUIRED_EVENT_FLAGS; *flag; ++flag) {
+            const bool covered = flags.find(*flag) != std::string::npos ||
+                (*flag != 'K' && flags.find('A') != std::string::npos);
+            if (!covered) {
+                flags += *flag;
+                changed = true;
+            }
+        }
+
+        if (changed) {
+            redis.command("CONFIG", "SET", "notify-keyspace-events", flags);
+            spdlog::info("Enabled keyspace notifications: {}", flags);
+        }
+    } catch (const sw::redis::Error& e) {
+        spdlog::warn("Could not enable keyspace notifications ({}); set "
+                     "notify-keyspace-events to include {} on the server",
+                     e.what(), REQUIRED_EVENT_FLAGS);
+    }
+}
+
+void LiveMonitor::primeExistingKeys(sw::redis::Redis& redis,
+                                    std::unordered_set<std::string>& pending) {
+    long long cursor = 0;
+    do {
+        std::vector<std::string> keys;
+        cursor = redis.scan(cursor, TRADE_KEY_PATTERN, 1000,
+                            std::back_inserter(keys));
+        pending.insert(keys.begin(), keys.end());
+    } while (cursor != 0);
+}
+
+void LiveMonitor::run(const std::atomic<bool>& stop,
+                      DetectionCallback on_detection) {
+    std::unordered_set<std::string> pending;
+    std::unordered_set<std::string> removed;
+    // Pending keys by RiskClass, reused across rounds
+    std::array<std::vector<const std::string*>, RISK_CLASS_COUNT> by_risk;
+    auto next_idle_sweep = DetectorRegistry::Clock::now();
+    auto next_refresh = next_idle_sweep;
+    auto next_snapshot = next_idle_sweep +
+        (snapshots_ ? snapshots_->interval : std::chrono::seconds(0));
+    std::future<void> pending_save;
+
+    const auto on_event = [&pending, &removed](std::string,
+                                               std::string channel,
+                                               std::string event) {
+        // Channel is __keyspace@<db>__:<key>, payload the command
+        auto key = channel.substr(channel.find(':') + 1);
+        if (event == "zadd" || event == "zincr") {
+            pending.insert(std::move(key));
+        } else if (event == "del" || event == "expired" ||
+                   event == "evicted") {
+            pending.erase(key);
+            removed.insert(std::move(key));
+        }
+    };
+
+    while (!stop) {
+        try {
+            // Keyspace notifications only cover the server they come from,
+            // so a cluster needs a subscription on every master. They are
+            // polled in turn, splitting the timeout between them.
+            const auto nodes = redis_.nodes();
+            std::vector<sw::redis::Redis> servers;
+            std::vector<sw::redis::Subscriber> subscribers;
+            servers.reserve(nodes.size());
+            subscribers.reserve(nodes.size());
+            for (auto options : nodes) {
+                options.socket_timeout = std::max(
+                    std::chrono::milliseconds(10),
+                    CONSUME_TIMEOUT / static_cast<long>(nodes.size()));
+                servers.emplace_back(options);
+                enableKeyspaceEvents(servers.back());
+                subscribers.push_back(servers.back().subscriber());
+                subscribers.back().on_pmessage(on_event);
+                subscribers.back().psubscribe(KEYSPACE_PATTERN);
+            }
+
+            // Anything written before (re)subscribing only shows up via SCAN
+            for (auto& server : servers) {
+                primeExistingKeys(server, pending);
+            }
+            spdlog::info("Live monitor subscribed to {} server(s), {} keys "
+                         "to prime", servers.size(), pending.size());
+
+            while (!stop) {
+                for (auto& subscriber : subscribers) {
+                    try {
+                        subscriber.consume();
+                    } catch (const sw::redis::TimeoutError&) {
+                        // Idle; fall through to the stop check
+                    }
+                }
+
+                for (const auto& key : removed) {
+                    onKeyRemoved(key);
+                }
+                removed.clear();
+
+                const auto now = DetectorRegistry::Clock::now();
+                if (membership_ && now >= next_refresh) {
+                    next_refresh = now + membership_->refreshInterval();
+                    if (membership_->refresh()) {
+                        // Mints that moved here are found by SCAN and
+                        // fetched in full on first sight
+                        const size_t handed_over = registry_.eraseIf(
+                            [this](std::string_view key) {
+                                return !membership_->owns(key);
+                            });
+                        for (auto& server : servers) {
+                            primeExistingKeys(server, pending);
+                        }
+                        spdlog::info("Rebalanced across {} members: handed "
+                                     "over {} mints", membership_->ring()
+                                         .members().size(), handed_over);
+                    }
+                }
+
+                // Most urgent first, so a mint near its stop loss is not
+                // stuck behind a burst of quiet ones. New mints have no
+                // signals yet and go in the middle.
+                for (const auto& key : pending) {
+                    if (membership_ && !membership_->owns(key)) {
+                        continue;
+                    }
+                    const auto signals = registry_.riskSignals(key);
+                    const auto risk =
+                        signals ? classify(*signals) : RiskClass::Medium;
+                    by_risk[static_cast<size_t>(risk)].push_back(&key);
+                }
+                for (auto& keys : by_risk) {
+                    for (const auto* key : keys) {
+                        auto update = onTradesAdded(*key);
+                        if (update.detection && on_detection) {
+                            on_detection(*key, *update.detection);
+                        }
+                    }
+                    keys.clear();
+                }
+                pending.clear();
+
+                // Keys normally expire with a notification, but one can be
+                // missed while resubscribing
+                if (now >= next_idle_sweep) {
+                    registry_.evictIdle(now);
+                    next_idle_sweep = now + IDLE_SWEEP_INTERVAL;
+                }
+
+                // Saved on a worker so disk I/O does not hold up the
+                // feed; a save still running when the next is due is
+                // left to finish rather than doubled up
+                if (snapshots_ && now >= next_snapshot) {
+                    if (!pending_save.valid() ||
+                        pending_save.wait_for(std::chrono::seconds(0)) ==
+                            std::future_status::ready) {
+                        pending_save = std::async(
+                            std::launch::async,
+                            [this] { saveSnapshotLogged(); });
+                    }
+                    next_snapshot = now + snapshots_->interval;
+                }
+            }
+        } catch (const sw::redis::Error& e) {
+            spdlog::error("Keyspace subscription failed: {}", e.what());
+            std::this_thread::sleep_for(std::chrono::seconds(1));
+        }
+    }
+
+    if (pending_save.valid()) {
+        pending_save.wait();
+    }
+    if (snapshots_) {
+        saveSnapshotLogged();
+    }
+}
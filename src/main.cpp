@@ -1,159 +1,287 @@
+#include <algorithm>
 #include <atomic>
+#include <charconv>
+#include <chrono>
 #include <condition_variable>
+#include <csignal>
 #include <iostream>
 #include <mutex>
-#include <queue>
+#include <optional>
+#include <span>
+#include <stdexcept>
 #include <string>
+#include <string_view>
 #include <thread>
 #include <vector>
 
 #include <spdlog/sinks/stdout_color_sinks.h>
 #include <spdlog/spdlog.h>
 
+#include "batch_detector.hpp"
 #include "detection_config.hpp"
+#include "key_worker.hpp"
+#include "live_monitor.hpp"
+#include "metrics.hpp"
+#include "metrics_server.hpp"
 #include "redis_client.hpp"
+#include "risk_priority.hpp"
 #include "rug_pull_detector.hpp"
+#include "trade_corpus.hpp"
+#include "trade_processor.hpp"
+#include "trade_record.hpp"
 
-class TradeProcessor {
-public:
-  explicit TradeProcessor(size_t num_threads)
-      : workers_(), work_queues_(num_threads), queue_mutexes_(num_threads),
-        queue_mutex_(), queue_cv_(), should_stop_(false) {
+std::atomic<bool> g_stop{false};
 
-    // Create threads
-    for (size_t i = 0; i < num_threads; ++i) {
-      workers_.emplace_back([this, i] { processTradesWorker(i); });
-    }
+void logDetection(const std::string &key, const DetectionResult &result) {
+  spdlog::warn("⚠️  RUG PULL DETECTED: {}", key);
+  if (result.timestamp) {
+    spdlog::warn("Time: {}", std::chrono::system_clock::to_time_t(
+                                 result.timestamp.value()));
   }
+  spdlog::warn("Trigger: {}", result.debug_info.trigger_type);
+  spdlog::warn("Confidence: {:.3f}", result.debug_info.confidence);
+  spdlog::warn("Drop: {:.2f}%", result.debug_info.drop_percentage);
+  spdlog::warn("Peak MC: {:.3f} SOL", result.debug_info.peak_market_cap);
+  spdlog::warn("Final MC: {:.3f} SOL", result.debug_info.current_market_cap);
+}
 
-  ~TradeProcessor() {
-    {
-      std::unique_lock<std::mutex> lock(queue_mutex_);
-      should_stop_ = true;
+// What one TradeProcessor worker checks keys with, built on the worker's
+// own thread
+struct WorkerContext {
+  KeyWorker worker;
+  // The process-wide client, or with --pin-workers one of the worker's own
+  std::shared_ptr<RedisClient> redis;
+};
+
+void processRedisKey(WorkerContext &context, const std::string &key,
+                     bool windowed) {
+  try {
+    auto &redis = *context.redis;
+    auto &worker = context.worker;
+    const auto check =
+        windowed ? worker.checkWindowed(redis, key, DetectionConfig{})
+                 : worker.check(redis, key, DetectionConfig{});
+
+    if (check.trade_count == 0) {
+      spdlog::warn("No trades found for key: {}", key);
+      return;
     }
-    queue_cv_.notify_all();
-    for (auto &worker : workers_) {
-      worker.join();
+
+    if (check.result.rug_pulled) {
+      logDetection(key, check.result);
+    } else {
+      spdlog::info("No rug pull pattern detected in {} trades for key: {}",
+                   check.trade_count, key);
     }
-  }
 
-  // Made public since it's called from main
-  void addTask(const std::string &redis_key) {
-    static std::atomic<size_t> round_robin{0};
-    size_t queue_index = round_robin++ % work_queues_.size();
+  } catch (const std::exception &e) {
+    spdlog::error("Error processing key {}: {}", key, e.what());
+  }
+}
 
-    {
-      std::unique_lock<std::mutex> lock(queue_mutexes_[queue_index]);
-      work_queues_[queue_index].push(redis_key);
+// A queued key, optionally followed by "DROP SECONDS_SINCE_PEAK
+// TRADES_PER_SECOND" from its producer to set its RiskClass; keys without
+// signals are Medium
+void submitKey(TradeProcessor &processor, std::string line) {
+  RiskClass risk = RiskClass::Medium;
+  const size_t space = line.find(' ');
+  if (space != std::string::npos) {
+    const auto signals =
+        parseRiskSignals(std::string_view(line).substr(space + 1));
+    line.resize(space);
+    if (signals) {
+      risk = classify(*signals);
+    } else {
+      spdlog::warn("Ignoring malformed risk signals for key: {}", line);
     }
-    queue_cv_.notify_one();
   }
+  processor.addTask(std::move(line), risk);
+}
 
-private:
-  void processTradesWorker(size_t worker_id) {
-    while (true) {
-      std::string task;
-      bool found_task = false;
-
-      // Try to get task from own queue first
-      {
-        std::unique_lock<std::mutex> lock(queue_mutexes_[worker_id]);
-        if (!work_queues_[worker_id].empty()) {
-          task = work_queues_[worker_id].front();
-          work_queues_[worker_id].pop();
-          found_task = true;
-        }
-      }
+// Keys one per line until EOF
+size_t feedFromStdin(TradeProcessor &processor) {
+  size_t count = 0;
+  std::string line;
+  while (std::getline(std::cin, line)) {
+    if (line.empty())
+      continue;
+    submitKey(processor, std::move(line));
+    ++count;
+  }
+  return count;
+}
 
-      // If no task in own queue, try work stealing
-      if (!found_task) {
-        for (size_t i = 0; i < work_queues_.size(); ++i) {
-          if (i == worker_id)
-            continue;
-
-          {
-            std::unique_lock<std::mutex> lock(queue_mutexes_[i]);
-            if (!work_queues_[i].empty()) {
-              task = work_queues_[i].front();
-              work_queues_[i].pop();
-              found_task = true;
-              break;
-            }
-          }
-        }
-      }
+// Keys popped from a Redis list until SIGINT/SIGTERM
+size_t feedFromRedisList(TradeProcessor &processor, const std::string &url,
+                         const std::string &list) {
+  auto redis = RedisClientRegistry::instance().get(url);
+  size_t count = 0;
+  while (!g_stop) {
+    if (auto key = redis->popKey(list, std::chrono::seconds(1))) {
+      submitKey(processor, std::move(*key));
+      ++count;
+    }
+  }
+  return count;
+}
 
-      if (!found_task) {
-        std::unique_lock<std::mutex> lock(queue_mutex_);
-        if (should_stop_ && allQueuesEmpty()) {
-          return;
-        }
-        queue_cv_.wait(lock);
-        continue;
-      }
+// Dump every recent_trades:* key into a corpus file for offline replay
+void exportCorpus(const std::string &url, const std::string &path) {
+  const auto started = std::chrono::steady_clock::now();
+  auto redis = RedisClientRegistry::instance().get(url);
+  auto keys = redis->scanKeys("recent_trades:*");
+  std::sort(keys.begin(), keys.end());
+  spdlog::info("Exporting {} keys to {}", keys.size(), path);
 
-      processRedisKey(task);
+  TradeCorpusWriter writer(path);
+  const std::span<const std::string> all_keys(keys);
+  for (size_t begin = 0; begin < keys.size(); begin += BATCH_CHUNK_SIZE) {
+    const size_t count = std::min(BATCH_CHUNK_SIZE, keys.size() - begin);
+    auto chunk = redis->getTradesBatch(all_keys.subspan(begin, count));
+    for (size_t i = 0; i < count; ++i) {
+      // Keys can expire between SCAN and the fetch
+      if (!chunk[i].empty())
+        writer.addMint(keys[begin + i], chunk[i]);
     }
   }
+  writer.finish();
 
-  bool allQueuesEmpty() const {
-    for (size_t i = 0; i < work_queues_.size(); ++i) {
-      std::unique_lock<std::mutex> lock(queue_mutexes_[i]);
-      if (!work_queues_[i].empty())
-        return false;
-    }
-    return true;
+  const std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - started;
+  spdlog::info("Exported {} mints, {} trades in {:.2f}s", writer.mintCount(),
+               writer.tradeCount(), elapsed.count());
+}
+
+// Rewrite every recent_trades:* key's JSON members as binary records
+void convertToBinary(const std::string &url) {
+  const auto started = std::chrono::steady_clock::now();
+  auto redis = RedisClientRegistry::instance().get(url);
+  const auto keys = redis->scanKeys("recent_trades:*");
+  spdlog::info("Converting {} keys to binary trade records", keys.size());
+
+  RedisClient::Conversion total;
+  for (const auto &key : keys) {
+    const auto conversion = redis->convertToBinary(key);
+    total.converted += conversion.converted;
+    total.already_binary += conversion.already_binary;
+    total.skipped += conversion.skipped;
+    total.bytes_before += conversion.bytes_before;
+    total.bytes_after += conversion.bytes_after;
   }
 
-  void processRedisKey(const std::string &key) {
-    try {
-      static RedisClient redis("redis://localhost");
-      auto trades = redis.getTrades(key);
+  const std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - started;
+  const size_t rewritten = total.bytes_after / TRADE_RECORD_SIZE;
+  const double per_trade = static_cast<double>(total.bytes_before) /
+                           static_cast<double>(std::max<size_t>(1, rewritten));
+  spdlog::info("Converted {} trades in {:.2f}s ({:.0f} -> {} bytes per "
+               "trade), {} already binary, {} unreadable left as JSON",
+               total.converted, elapsed.count(), per_trade, TRADE_RECORD_SIZE,
+               total.already_binary, total.skipped);
+}
 
-      if (trades.empty()) {
-        spdlog::warn("No trades found for key: {}", key);
-        return;
-      }
+// Run detection over a corpus file straight from the mapping. With bars
+// set, mints are scored on bar close and compared with per-trade detection.
+void replayCorpus(const std::string &path, size_t threads,
+                  std::chrono::seconds bars) {
+  TradeCorpus corpus(path);
+  spdlog::info("Replaying {} mints, {} trades from {}", corpus.mintCount(),
+               corpus.tradeCount(), path);
 
-      spdlog::info("Processing {} trades for key: {}", trades.size(), key);
+  std::vector<TradeSeries> mints;
+  mints.reserve(corpus.mintCount());
+  for (size_t i = 0; i < corpus.mintCount(); ++i)
+    mints.push_back(corpus.series(i));
 
-      RugPullDetector detector;
-      // Move trades instead of copying
-      for (auto &&trade : trades) {
-        detector.addTrade(std::move(trade));
-      }
+  auto started = std::chrono::steady_clock::now();
+  auto results = detectSeries(mints, DetectionParams{}, threads);
+  std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - started;
 
-      DetectionConfig config;
-      auto result = detector.processTrades(config);
+  if (bars.count() > 0) {
+    const auto per_trade = std::move(results);
+    const double per_trade_s = elapsed.count();
+    started = std::chrono::steady_clock::now();
+    results = detectSeriesOnBars(mints, bars, DetectionParams{}, threads);
+    elapsed = std::chrono::steady_clock::now() - started;
 
-      if (result.rug_pulled) {
-        spdlog::warn("⚠️  RUG PULL DETECTED:");
-        if (result.timestamp) {
-          spdlog::warn("Time: {}", std::chrono::system_clock::to_time_t(
-                                       result.timestamp.value()));
-        }
-        spdlog::warn("Trigger: {}", result.debug_info.trigger_type);
-        spdlog::warn("Confidence: {:.3f}", result.debug_info.confidence);
-        spdlog::warn("Drop: {:.2f}%", result.debug_info.drop_percentage);
-        spdlog::warn("Peak MC: {:.3f} SOL", result.debug_info.peak_market_cap);
-        spdlog::warn("Final MC: {:.3f} SOL",
-                     result.debug_info.current_market_cap);
-      } else {
-        spdlog::info("No rug pull pattern detected for key: {}", key);
-      }
+    const auto report =
+        compareBarDetection(mints, per_trade, results, bars);
+    spdlog::info("{}s bars: {} evaluations for {} trades, {:.3f}s against "
+                 "{:.3f}s per trade",
+                 bars.count(), report.bars, report.trades, elapsed.count(),
+                 per_trade_s);
+    spdlog::info("{}s bars: {:.1f}% same verdict, {} flagged both ways ({} "
+                 "same trigger), {} per trade only, {} on bars only",
+                 bars.count(), 100.0 * report.agreement(), report.both,
+                 report.same_trigger, report.trade_only, report.bar_only);
+    spdlog::info("{}s bars: detection lag mean {:.2f}s, p95 {:.2f}s, max "
+                 "{:.2f}s; confidence off by {:.3f} on average",
+                 bars.count(), report.mean_lag_s, report.p95_lag_s,
+                 report.max_lag_s, report.mean_confidence_diff);
+  }
+
+  size_t detections = 0;
+  for (size_t i = 0; i < results.size(); ++i) {
+    if (results[i].rug_pulled) {
+      logDetection(std::string(corpus.mintName(i)), results[i]);
+      ++detections;
+    }
+  }
+  spdlog::info("Replayed {} mints in {:.3f}s ({:.0f} trades/s), {} rug pulls",
+               corpus.mintCount(), elapsed.count(),
+               static_cast<double>(corpus.tradeCount()) /
+                   std::max(elapsed.count(), 1e-9),
+               detections);
+}
+
+size_t completedTasks(const std::vector<WorkerStats> &stats) {
+  size_t tasks = 0;
+  for (const auto &worker : stats) {
+    tasks += worker.tasks;
+  }
+  return tasks;
+}
+
+// Busy share per worker and per core
+void logWorkerStats(const std::vector<WorkerStats> &stats) {
+  for (const auto &worker : stats) {
+    spdlog::info("Worker {} on CPU {} (node {}): {} keys, {:.1f}% busy",
+                 worker.worker_id, worker.cpu, worker.node, worker.tasks,
+                 100.0 * worker.utilization);
+  }
+}
+
+// Logs the metrics summary every interval, and once more on the way out
+class StatsDumper {
+public:
+  explicit StatsDumper(std::chrono::seconds interval)
+      : interval_(interval), thread_([this] { run(); }) {}
+
+  ~StatsDumper() {
+    {
+      std::lock_guard lock(mutex_);
+      stop_ = true;
+    }
+    cv_.notify_all();
+    thread_.join();
+    spdlog::info("Final stats: {}",
+                 metrics::renderSummary(metrics::snapshot()));
+  }
 
-    } catch (const std::exception &e) {
-      spdlog::error("Error processing key {}: {}", key, e.what());
+private:
+  void run() {
+    std::unique_lock lock(mutex_);
+    while (!cv_.wait_for(lock, interval_, [this] { return stop_; })) {
+      spdlog::info("Stats: {}", metrics::renderSummary(metrics::snapshot()));
     }
   }
 
-  // Member variables - now only declared once
-  std::vector<std::thread> workers_;
-  std::vector<std::queue<std::string>> work_queues_;
-  mutable std::vector<std::mutex> queue_mutexes_;
-  std::mutex queue_mutex_;
-  std::condition_variable queue_cv_;
-  bool should_stop_;
+  std::chrono::seconds interval_;
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  bool stop_ = false;
+  std::thread thread_;
 };
 
 void setupLogger(bool debug_mode) {
@@ -163,29 +291,393 @@ void setupLogger(bool debug_mode) {
   spdlog::set_pattern("[%Y-%m-%d %H:%M:%S.%e] [%^%l%$] %v");
 }
 
+struct Options {
+  std::vector<std::string> redis_keys;
+  std::string redis_list;
+  std::string export_path;
+  std::string replay_path;
+  bool read_stdin = false;
+  std::optional<uint16_t> metrics_port;
+  std::chrono::seconds stats_interval{0};
+  std::chrono::seconds bars{0};
+  size_t threads = std::thread::hardware_concurrency();
+  std::string redis_url = "redis://localhost";
+  RedisClientOptions redis_options;
+  RegistryOptions registry_options;
+  std::optional<MembershipOptions> sharding;
+  std::optional<SnapshotOptions> snapshots;
+  bool live_mode = false;
+  bool convert_binary = false;
+  bool windowed = false;
+  bool pin_workers = false;
+  bool shed_low_risk = false;
+  bool debug_mode = false;
+};
+
+void printUsage(const char *program) {
+  std::cerr << "Usage: " << program << " <redis_key>... [options]\n"
+            << "       " << program << " --stdin [options]\n"
+            << "       " << program << " --redis-list LIST [options]\n"
+            << "       " << program << " --live [redis_url] [options]\n"
+            << "       " << program << " --export FILE [options]\n"
+            << "       " << program << " --replay FILE [options]\n"
+            << "       " << program << " --convert-to-binary [options]\n"
+            << "Options:\n"
+            << "  --stdin                  Read keys from stdin, one per line\n"
+            << "  --redis-list LIST        Pop keys from a Redis list (BLPOP)\n"
+            << "  --export FILE            Dump recent_trades:* to a corpus file\n"
+            << "  --replay FILE            Run detection over a corpus file\n"
+            << "  --bars S                 Replay only: score on S-second bar "
+               "close and compare with per-trade detection\n"
+            << "  --convert-to-binary      Rewrite recent_trades:* members as "
+               "binary records\n"
+            << "  --windowed               Fetch only the trades detection "
+               "can reach\n"
+            << "  --threads N              Worker threads (default: all cores)\n"
+            << "  --pin-workers            Pin each worker to a core, with "
+               "its own Redis\n"
+            << "                           connection, and report per-core "
+               "utilization\n"
+            << "  --shed-low-risk          Drop low-risk keys that would run "
+               "past their deadline;\n"
+            << "                           keys from --stdin or "
+               "--redis-list may be followed by\n"
+            << "                           \"DROP SECONDS_SINCE_PEAK "
+               "TRADES_PER_SECOND\" to set their risk\n"
+            << "  --metrics-port PORT      Serve Prometheus metrics on "
+               "http://*:PORT/metrics\n"
+            << "  --stats-interval S       Log per-stage latency stats every "
+               "S seconds\n"
+            << "  --memory-budget-mb MB    Live mode: cap on per-mint state "
+               "(default 1024)\n"
+            << "  --shard-id ID            Live mode: split mints with the "
+               "other processes\n"
+            << "                           of the shard group, as member ID\n"
+            << "  --shard-group KEY        Live mode: shard group key "
+               "(default rugpull:shards)\n"
+            << "  --snapshot FILE          Live mode: save per-mint state to "
+               "FILE and resume\n"
+            << "                           from it on start\n"
+            << "  --snapshot-interval S    Live mode: seconds between "
+               "snapshots (default 60)\n"
+            << "  --redis-url URL          Redis to read from "
+               "(default redis://localhost)\n"
+            << "  --cluster                The Redis URL is a Redis Cluster "
+               "seed node\n"
+            << "  --pool-size N            Max pooled connections (default 8)\n"
+            << "  --connect-timeout-ms MS  Connect timeout (default: block)\n"
+            << "  --socket-timeout-ms MS   Socket timeout (default: block)\n"
+            << "  --debug                  Debug logging" << std::endl;
+}
+
+// The whole of text as an integer in [min, max]; reports the flag and its
+// range otherwise
+std::optional<long> parseBounded(const std::string &flag,
+                                 const std::string &text, long min,
+                                 long max) {
+  long parsed = 0;
+  const char *end = text.data() + text.size();
+  const auto [next, error] = std::from_chars(text.data(), end, parsed);
+  if (error != std::errc() || next != end || parsed < min || parsed > max) {
+    std::cerr << flag << " must be an integer from " << min << " to " << max
+              << ", not " << text << std::endl;
+    return std::nullopt;
+  }
+  return parsed;
+}
+
+std::optional<Options> parseOptions(int argc, char *argv[]) {
+  Options options;
+  std::vector<std::string> positional;
+
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    auto value = [&]() -> std::optional<std::string> {
+      if (i + 1 >= argc) {
+        std::cerr << arg << " needs a value" << std::endl;
+        return std::nullopt;
+      }
+      return std::string(argv[++i]);
+    };
+
+    if (arg == "--debug") {
+      options.debug_mode = true;
+    } else if (arg == "--live") {
+      options.live_mode = true;
+    } else if (arg == "--stdin") {
+      options.read_stdin = true;
+    } else if (arg == "--windowed") {
+      options.windowed = true;
+    } else if (arg == "--shed-low-risk") {
+      options.shed_low_risk = true;
+    } else if (arg == "--pin-workers") {
+      options.pin_workers = true;
+    } else if (arg == "--convert-to-binary") {
+      options.convert_binary = true;
+    } else if (arg == "--cluster") {
+      options.redis_options.cluster = true;
+    } else if (arg == "--shard-id" || arg == "--shard-group") {
+      auto name = value();
+      if (!name)
+        return std::nullopt;
+      if (!options.sharding)
+        options.sharding.emplace();
+      (arg == "--shard-id" ? options.sharding->id
+                           : options.sharding->group_key) = *name;
+    } else if (arg == "--snapshot") {
+      auto path = value();
+      if (!path)
+        return std::nullopt;
+      if (!options.snapshots)
+        options.snapshots.emplace();
+      options.snapshots->path = *path;
+    } else if (arg == "--redis-list") {
+      auto list = value();
+      if (!list)
+        return std::nullopt;
+      options.redis_list = *list;
+    } else if (arg == "--export" || arg == "--replay") {
+      auto path = value();
+      if (!path)
+        return std::nullopt;
+      (arg == "--export" ? options.export_path : options.replay_path) = *path;
+    } else if (arg == "--redis-url") {
+      auto url = value();
+      if (!url)
+        return std::nullopt;
+      options.redis_url = *url;
+    } else if (arg == "--pool-size" || arg == "--connect-timeout-ms" ||
+               arg == "--socket-timeout-ms" || arg == "--threads" ||
+               arg == "--metrics-port" || arg == "--stats-interval" ||
+               arg == "--memory-budget-mb" || arg == "--snapshot-interval" ||
+               arg == "--bars") {
+      auto number = value();
+      if (!number)
+        return std::nullopt;
+      // At least 1, except the timeouts, where 0 means "block"
+      long min = 1;
+      long max = 4096;
+      if (arg == "--metrics-port") {
+        max = 65535;
+      } else if (arg == "--connect-timeout-ms" ||
+                 arg == "--socket-timeout-ms") {
+        min = 0;
+        max = 86'400'000;
+      } else if (arg == "--stats-interval" || arg == "--snapshot-interval" ||
+                 arg == "--bars") {
+        max = 86'400;
+      } else if (arg == "--memory-budget-mb") {
+        max = 1L << 24;
+      }
+      const auto bounded = parseBounded(arg, *number, min, max);
+      if (!bounded)
+        return std::nullopt;
+      const long parsed = *bounded;
+      if (arg == "--metrics-port") {
+        options.metrics_port = static_cast<uint16_t>(parsed);
+      } else if (arg == "--memory-budget-mb") {
+        options.registry_options.memory_budget_bytes =
+            static_cast<size_t>(parsed) << 20;
+      } else if (arg == "--snapshot-interval") {
+        if (!options.snapshots)
+          options.snapshots.emplace();
+        options.snapshots->interval = std::chrono::seconds(parsed);
+      } else if (arg == "--bars") {
+        options.bars = std::chrono::seconds(parsed);
+      } else if (arg == "--stats-interval") {
+        options.stats_interval = std::chrono::seconds(parsed);
+      } else if (arg == "--threads") {
+        options.threads = static_cast<size_t>(parsed);
+      } else if (arg == "--pool-size") {
+        options.redis_options.pool_size = static_cast<size_t>(parsed);
+      } else if (arg == "--connect-timeout-ms") {
+        options.redis_options.connect_timeout =
+            std::chrono::milliseconds(parsed);
+      } else {
+        options.redis_options.socket_timeout =
+            std::chrono::milliseconds(parsed);
+      }
+    } else if (arg.starts_with("--")) {
+      std::cerr << "Unknown option: " << arg << std::endl;
+      return std::nullopt;
+    } else {
+      positional.push_back(arg);
+    }
+  }
+
+  // Live mode takes the Redis URL positionally; otherwise they're keys
+  if (options.live_mode) {
+    if (!positional.empty())
+      options.redis_url = positional.front();
+  } else {
+    if (positional.empty() && !options.read_stdin &&
+        options.redis_list.empty() && options.export_path.empty() &&
+        options.replay_path.empty() && !options.convert_binary)
+      return std::nullopt;
+    options.redis_keys = std::move(positional);
+  }
+  if (options.sharding && options.sharding->id.empty()) {
+    std::cerr << "--shard-group needs --shard-id" << std::endl;
+    return std::nullopt;
+  }
+  // Other modes take work from a list or a key set and share it already
+  if (options.sharding && !options.live_mode) {
+    std::cerr << "--shard-id only applies to --live" << std::endl;
+    return std::nullopt;
+  }
+  if (options.snapshots && options.snapshots->path.empty()) {
+    std::cerr << "--snapshot-interval needs --snapshot" << std::endl;
+    return std::nullopt;
+  }
+  if (options.snapshots && !options.live_mode) {
+    std::cerr << "--snapshot only applies to --live" << std::endl;
+    return std::nullopt;
+  }
+  if (options.bars.count() != 0 && options.replay_path.empty()) {
+    std::cerr << "--bars only applies to --replay" << std::endl;
+    return std::nullopt;
+  }
+  if (options.shed_low_risk &&
+      (options.live_mode || !options.replay_path.empty() ||
+       !options.export_path.empty() || options.convert_binary)) {
+    std::cerr << "--shed-low-risk only applies to keys checked by the worker "
+                 "pool" << std::endl;
+    return std::nullopt;
+  }
+  if (options.threads == 0)
+    options.threads = 1;
+  return options;
+}
+
 int main(int argc, char *argv[]) {
-  if (argc < 2) {
-    std::cerr << "Usage: " << argv[0] << " <redis_key> [--debug]" << std::endl;
+  std::optional<Options> options;
+  try {
+    options = parseOptions(argc, argv);
+  } catch (const std::exception &e) {
+    std::cerr << "Invalid argument: " << e.what() << std::endl;
+  }
+  if (!options) {
+    printUsage(argv[0]);
     return 1;
   }
 
-  std::string redis_key = argv[1];
-  bool debug_mode = (argc > 2 && std::string(argv[2]) == "--debug");
-
   try {
-    setupLogger(debug_mode);
+    setupLogger(options->debug_mode);
+    RedisClientRegistry::instance().configure(options->redis_options);
+
+    std::optional<MetricsServer> metrics_server;
+    if (options->metrics_port) {
+      metrics_server.emplace(*options->metrics_port);
+      spdlog::info("Serving metrics on port {}", metrics_server->port());
+    }
+    std::optional<StatsDumper> stats_dumper;
+    if (options->stats_interval.count() > 0) {
+      stats_dumper.emplace(options->stats_interval);
+    }
+
+    // Modes that run until interrupted stop cleanly on SIGINT/SIGTERM
+    if (options->live_mode || !options->redis_list.empty()) {
+      std::signal(SIGINT, [](int) { g_stop = true; });
+      std::signal(SIGTERM, [](int) { g_stop = true; });
+    }
+
+    if (options->live_mode) {
+      spdlog::info("Starting live monitor on {}", options->redis_url);
+      if (options->sharding) {
+        spdlog::info("Sharding mints as {} in group {}",
+                     options->sharding->id, options->sharding->group_key);
+      }
+      LiveMonitor monitor(options->redis_url, DetectionParams{},
+                          options->registry_options, options->sharding,
+                          options->snapshots);
+      monitor.run(g_stop, logDetection);
+      const auto stats = monitor.registryStats();
+      spdlog::info("Live monitor stopped, {} mints tracked ({:.0f} bytes "
+                   "each), {} evicted idle, {} evicted over budget",
+                   stats.mints, stats.bytesPerMint(), stats.evicted_idle,
+                   stats.evicted_budget);
+      return 0;
+    }
 
-    // Create a thread pool with number of threads equal to hardware concurrency
-    spdlog::info("Starting rug pull detector with {} threads",
-                 std::thread::hardware_concurrency());
-    TradeProcessor processor(std::thread::hardware_concurrency());
+    if (!options->export_path.empty()) {
+      exportCorpus(options->redis_url, options->export_path);
+      return 0;
+    }
+    if (!options->replay_path.empty()) {
+      replayCorpus(options->replay_path, options->threads, options->bars);
+      return 0;
+    }
+    if (options->convert_binary) {
+      convertToBinary(options->redis_url);
+      return 0;
+    }
 
-    spdlog::info("Processing trades for key: {}", redis_key);
-    processor.addTask(redis_key);
+    spdlog::info("Starting rug pull detector with {} threads{}",
+                 options->threads,
+                 options->pin_workers ? ", pinned" : "");
+    const std::string redis_url = options->redis_url;
+    const bool windowed = options->windowed;
+    size_t submitted = 0;
+    uint64_t shed = 0;
+    {
+      // Reusable per-worker buffers and clients, indexed by worker id
+      std::vector<std::unique_ptr<WorkerContext>> contexts(
+          std::max<size_t>(1, options->threads));
+      TradeProcessorOptions processor_options;
+      processor_options.pin_workers = options->pin_workers;
+      processor_options.shed_low_risk = options->shed_low_risk;
+      processor_options.on_worker_start = [&](size_t worker_id) {
+        auto context = std::make_unique<WorkerContext>();
+        if (options->pin_workers) {
+          // No pool to share: the worker's connections are its own
+          auto redis_options = options->redis_options;
+          redis_options.pool_size = 1;
+          context->redis =
+              std::make_shared<RedisClient>(redis_url, redis_options);
+        } else {
+          // Shared by all workers; connections open on first use
+          context->redis = RedisClientRegistry::instance().get(redis_url);
+        }
+        contexts[worker_id] = std::move(context);
+      };
+      TradeProcessor processor(
+          contexts.size(),
+          [&contexts, windowed](size_t worker_id, const std::string &key) {
+            if (!contexts[worker_id]) {
+              throw std::runtime_error("worker was not set up");
+            }
+            processRedisKey(*contexts[worker_id], key, windowed);
+          },
+          std::move(processor_options));
 
-    // Wait for user input to exit
-    std::string input;
-    std::getline(std::cin, input);
+      for (auto &key : options->redis_keys) {
+        processor.addTask(std::move(key));
+        ++submitted;
+      }
+      if (options->read_stdin) {
+        submitted += feedFromStdin(processor);
+      }
+      if (!options->redis_list.empty()) {
+        spdlog::info("Reading keys from Redis list {}", options->redis_list);
+        submitted +=
+            feedFromRedisList(processor, redis_url, options->redis_list);
+      }
+      if (options->pin_workers) {
+        // Report once the pool has drained, so every key is counted
+        while (completedTasks(processor.workerStats()) +
+                   processor.shedTasks() <
+               submitted) {
+          std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        logWorkerStats(processor.workerStats());
+      }
+      // Leaving the scope finishes every submitted key
+      shed = processor.shedTasks();
+    }
+    spdlog::info("Processed {} keys", submitted - shed);
+    if (shed > 0) {
+      spdlog::info("Shed {} low-risk keys under load", shed);
+    }
 
   } catch (const std::exception &e) {
     spdlog::error("Fatal error: {}", e.what());
@@ -0,0 +1,323 @@
+#include "metrics.hpp"
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <memory>
+#include <mutex>
+#include <fmt/format.h>
+
+namespace metrics {
+
+namespace {
+
+// Written only by the owning thread; atomics so snapshot() can read them
+// concurrently. Owner updates are load + store, not read-modify-write,
+// since nobody else writes (reset() aside).
+struct Shard {
+  struct Histogram {
+    std::array<std::atomic<uint64_t>, BUCKET_COUNT> buckets{};
+    std::atomic<uint64_t> count{0};
+    std::atomic<uint64_t> sum_ns{0};
+    std::atomic<uint64_t> max_ns{0};
+  };
+
+  std::array<std::atomic<uint64_t>, COUNTER_COUNT> counters{};
+  std::array<Histogram, STAGE_COUNT> stages;
+};
+
+void bump(std::atomic<uint64_t> &value, uint64_t amount) {
+  value.store(value.load(std::memory_order_relaxed) + amount,
+              std::memory_order_relaxed);
+}
+
+// Shards outlive their threads: an exiting thread hands its shard back for
+// reuse, so its counts stay in the totals and the shard count is bounded by
+// the peak number of live threads
+class Registry {
+public:
+  Shard *acquire() {
+    std::lock_guard lock(mutex_);
+    if (!free_.empty()) {
+      Shard *shard = free_.back();
+      free_.pop_back();
+      return shard;
+    }
+    shards_.push_back(std::make_unique<Shard>());
+    return shards_.back().get();
+  }
+
+  void release(Shard *shard) {
+    std::lock_guard lock(mutex_);
+    free_.push_back(shard);
+  }
+
+  template <typename Fn> void forEach(Fn &&fn) {
+    std::lock_guard lock(mutex_);
+    for (auto &shard : shards_)
+      fn(*shard);
+  }
+
+private:
+  std::mutex mutex_;
+  std::vector<std::unique_ptr<Shard>> shards_;
+  std::vector<Shard *> free_;
+};
+
+// Never destroyed, so threads still running during static destruction can
+// keep recording
+Registry &registry() {
+  static auto *instance = new Registry();
+  return *instance;
+}
+
+struct ShardHandle {
+  ShardHandle() : shard(registry().acquire()) {}
+  ~ShardHandle() { registry().release(shard); }
+  Shard *shard;
+};
+
+Shard &localShard() {
+  thread_local ShardHandle handle;
+  return *handle.shard;
+}
+
+std::array<std::atomic<int64_t>, GAUGE_COUNT> &gauges() {
+  static auto *instance = new std::array<std::atomic<int64_t>, GAUGE_COUNT>();
+  return *instance;
+}
+
+// Bucket boundaries for the Prometheus histogram, in seconds
+constexpr double PROMETHEUS_BUCKETS[] = {
+    1e-6, 5e-6, 1e-5, 5e-5, 1e-4, 5e-4, 1e-3, 5e-3, 1e-2,
+    5e-2, 0.1,  0.5,  1.0,  5.0,  10.0, 60.0, 300.0};
+
+} // namespace
+
+const char *stageName(Stage stage) {
+  switch (stage) {
+  case Stage::RedisFetch:
+    return "redis_fetch";
+  case Stage::Decode:
+    return "decode";
+  case Stage::Detect:
+    return "detect";
+  case Stage::QueueWait:
+    return "queue_wait";
+  case Stage::Task:
+    return "task";
+  case Stage::DetectionLag:
+    return "detection_lag";
+  }
+  return "unknown";
+}
+
+const char *counterName(Counter counter) {
+  switch (counter) {
+  case Counter::KeysFetched:
+    return "keys_fetched";
+  case Counter::TradesDecoded:
+    return "trades_decoded";
+  case Counter::ParseErrors:
+    return "parse_errors";
+  case Counter::RedisErrors:
+    return "redis_errors";
+  case Counter::Detections:
+    return "detections";
+  case Counter::TasksCompleted:
+    return "tasks_completed";
+  case Counter::MintsEvicted:
+    return "mints_evicted";
+  case Counter::TradesDropped:
+    return "trades_dropped";
+  case Counter::DeadlineMissesHigh:
+    return "deadline_misses_high";
+  case Counter::DeadlineMissesMedium:
+    return "deadline_misses_medium";
+  case Counter::DeadlineMissesLow:
+    return "deadline_misses_low";
+  case Counter::TasksShed:
+    return "tasks_shed";
+  }
+  return "unknown";
+}
+
+const char *gaugeName(Gauge gauge) {
+  switch (gauge) {
+  case Gauge::TrackedMints:
+    return "tracked_mints";
+  case Gauge::RegistryBytes:
+    return "registry_bytes";
+  case Gauge::ShardMembers:
+    return "shard_members";
+  }
+  return "unknown";
+}
+
+size_t bucketIndex(uint64_t value_ns) {
+  constexpr uint64_t SUB_BUCKETS = uint64_t{1} << SUB_BUCKET_BITS;
+  value_ns = std::min(value_ns, (uint64_t{1} << MAX_VALUE_BITS) - 1);
+  if (value_ns < SUB_BUCKETS)
+    return static_cast<size_t>(value_ns);
+
+  const unsigned magnitude = std::bit_width(value_ns) - 1;
+  const unsigned shift = magnitude - SUB_BUCKET_BITS;
+  return ((magnitude - SUB_BUCKET_BITS + 1) << SUB_BUCKET_BITS) +
+         static_cast<size_t>((value_ns >> shift) - SUB_BUCKETS);
+}
+
+uint64_t bucketUpperBound(size_t index) {
+  constexpr uint64_t SUB_BUCKETS = uint64_t{1} << SUB_BUCKET_BITS;
+  if (index < SUB_BUCKETS)
+    return index;
+
+  const unsigned magnitude =
+      static_cast<unsigned>(index >> SUB_BUCKET_BITS) + SUB_BUCKET_BITS - 1;
+  const unsigned shift = magnitude - SUB_BUCKET_BITS;
+  const uint64_t sub = index & (SUB_BUCKETS - 1);
+  return ((SUB_BUCKETS + sub + 1) << shift) - 1;
+}
+
+uint64_t HistogramSnapshot::percentile(double q) const {
+  if (count == 0)
+    return 0;
+  const auto rank = static_cast<uint64_t>(
+      std::max(1.0, std::clamp(q, 0.0, 1.0) * static_cast<double>(count)));
+  uint64_t seen = 0;
+  for (size_t i = 0; i < buckets.size(); ++i) {
+    seen += buckets[i];
+    if (seen >= rank)
+      return std::min(bucketUpperBound(i), max_ns);
+  }
+  return max_ns;
+}
+
+uint64_t HistogramSnapshot::countAtOrBelow(uint64_t limit_ns) const {
+  uint64_t total = 0;
+  for (size_t i = 0; i < buckets.size() && bucketUpperBound(i) <= limit_ns;
+       ++i)
+    total += buckets[i];
+  return total;
+}
+
+void add(Counter counter, uint64_t amount) {
+  bump(localShard().counters[static_cast<size_t>(counter)], amount);
+}
+
+void record(Stage stage, std::chrono::nanoseconds duration) {
+  const auto value =
+      static_cast<uint64_t>(std::max<int64_t>(0, duration.count()));
+  auto &histogram = localShard().stages[static_cast<size_t>(stage)];
+  bump(histogram.buckets[bucketIndex(value)], 1);
+  bump(histogram.count, 1);
+  bump(histogram.sum_ns, value);
+  if (value > histogram.max_ns.load(std::memory_order_relaxed))
+    histogram.max_ns.store(value, std::memory_order_relaxed);
+}
+
+void adjust(Gauge gauge, int64_t delta) {
+  gauges()[static_cast<size_t>(gauge)].fetch_add(delta,
+                                                 std::memory_order_relaxed);
+}
+
+Snapshot snapshot() {
+  Snapshot result;
+  for (size_t g = 0; g < GAUGE_COUNT; ++g)
+    result.gauges[g] = gauges()[g].load(std::memory_order_relaxed);
+  registry().forEach([&](Shard &shard) {
+    for (size_t c = 0; c < COUNTER_COUNT; ++c)
+      result.counters[c] += shard.counters[c].load(std::memory_order_relaxed);
+    for (size_t s = 0; s < STAGE_COUNT; ++s) {
+      auto &from = shard.stages[s];
+      auto &into = result.stages[s];
+      for (size_t b = 0; b < BUCKET_COUNT; ++b)
+        into.buckets[b] += from.buckets[b].load(std::memory_order_relaxed);
+      into.count += from.count.load(std::memory_order_relaxed);
+      into.sum_ns += from.sum_ns.load(std::memory_order_relaxed);
+      into.max_ns =
+          std::max(into.max_ns, from.max_ns.load(std::memory_order_relaxed));
+    }
+  });
+  return result;
+}
+
+void reset() {
+  registry().forEach([](Shard &shard) {
+    for (auto &counter : shard.counters)
+      counter.store(0, std::memory_order_relaxed);
+    for (auto &histogram : shard.stages) {
+      for (auto &bucket : histogram.buckets)
+        bucket.store(0, std::memory_order_relaxed);
+      histogram.count.store(0, std::memory_order_relaxed);
+      histogram.sum_ns.store(0, std::memory_order_relaxed);
+      histogram.max_ns.store(0, std::memory_order_relaxed);
+    }
+  });
+}
+
+std::string renderPrometheus(const Snapshot &snapshot) {
+  std::string out;
+  auto line = std::back_inserter(out);
+
+  for (size_t c = 0; c < COUNTER_COUNT; ++c) {
+    const char *name = counterName(static_cast<Counter>(c));
+    fmt::format_to(line, "# TYPE rugpull_{}_total counter\n", name);
+    fmt::format_to(line, "rugpull_{}_total {}\n", name, snapshot.counters[c]);
+  }
+  for (size_t g = 0; g < GAUGE_COUNT; ++g) {
+    const char *name = gaugeName(static_cast<Gauge>(g));
+    fmt::format_to(line, "# TYPE rugpull_{} gauge\n", name);
+    fmt::format_to(line, "rugpull_{} {}\n", name, snapshot.gauges[g]);
+  }
+
+  fmt::format_to(line, "# TYPE rugpull_stage_seconds histogram\n");
+  for (size_t s = 0; s < STAGE_COUNT; ++s) {
+    const char *name = stageName(static_cast<Stage>(s));
+    const auto &histogram = snapshot.stages[s];
+    for (double le : PROMETHEUS_BUCKETS) {
+      const auto limit_ns = static_cast<uint64_t>(le * 1e9);
+      fmt::format_to(line,
+                     "rugpull_stage_seconds_bucket{{stage=\"{}\",le=\"{}\"}} "
+                     "{}\n",
+                     name, le, histogram.countAtOrBelow(limit_ns));
+    }
+    fmt::format_to(line,
+                   "rugpull_stage_seconds_bucket{{stage=\"{}\",le=\"+Inf\"}} "
+                   "{}\n",
+                   name, histogram.count);
+    fmt::format_to(line, "rugpull_stage_seconds_sum{{stage=\"{}\"}} {}\n",
+                   name, static_cast<double>(histogram.sum_ns) / 1e9);
+    fmt::format_to(line, "rugpull_stage_seconds_count{{stage=\"{}\"}} {}\n",
+                   name, histogram.count);
+  }
+  return out;
+}
+
+std::string renderSummary(const Snapshot &snapshot) {
+  std::string out;
+  auto line = std::back_inserter(out);
+  for (size_t c = 0; c < COUNTER_COUNT; ++c) {
+    fmt::format_to(line, "{}{}={}", c ? " " : "",
+                   counterName(static_cast<Counter>(c)), snapshot.counters[c]);
+  }
+  if (const auto mints = snapshot.gauge(Gauge::TrackedMints); mints > 0) {
+    const auto bytes = snapshot.gauge(Gauge::RegistryBytes);
+    fmt::format_to(line, " tracked_mints={} registry_bytes={} bytes_per_mint={}",
+                   mints, bytes, bytes / mints);
+  }
+  for (size_t s = 0; s < STAGE_COUNT; ++s) {
+    const auto &histogram = snapshot.stages[s];
+    if (histogram.count == 0)
+      continue;
+    const auto ms = [](uint64_t ns) { return static_cast<double>(ns) / 1e6; };
+    fmt::format_to(line,
+                   "\n  {:<13} n={} mean={:.3f}ms p50={:.3f}ms p99={:.3f}ms "
+                   "p99.9={:.3f}ms max={:.3f}ms",
+                   stageName(static_cast<Stage>(s)), histogram.count,
+                   histogram.meanNs() / 1e6, ms(histogram.percentile(0.5)),
+                   ms(histogram.percentile(0.99)),
+                   ms(histogram.percentile(0.999)), ms(histogram.max_ns));
+  }
+  return out;
+}
+
+} // namespace metrics
@@ -0,0 +1,114 @@
+#include "metrics_server.hpp"
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <arpa/inet.h>
+#include <fmt/format.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <spdlog/spdlog.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include "metrics.hpp"
+
+namespace {
+
+// How often the accept loop checks for shutdown
+constexpr int POLL_INTERVAL_MS = 200;
+constexpr size_t MAX_REQUEST_BYTES = 8192;
+
+void sendAll(int fd, std::string_view data) {
+  while (!data.empty()) {
+    const ssize_t sent = ::send(fd, data.data(), data.size(), MSG_NOSIGNAL);
+    if (sent <= 0)
+      return;
+    data.remove_prefix(static_cast<size_t>(sent));
+  }
+}
+
+} // namespace
+
+MetricsServer::MetricsServer(uint16_t port)
+    : listen_fd_(::socket(AF_INET, SOCK_STREAM, 0)), port_(port) {
+  if (listen_fd_ < 0)
+    throw std::runtime_error(std::string("metrics socket: ") +
+                             std::strerror(errno));
+
+  const int yes = 1;
+  ::setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes));
+
+  sockaddr_in address{};
+  address.sin_family = AF_INET;
+  address.sin_addr.s_addr = htonl(INADDR_ANY);
+  address.sin_port = htons(port);
+  if (::bind(listen_fd_, reinterpret_cast<sockaddr *>(&address),
+             sizeof(address)) != 0 ||
+      ::listen(listen_fd_, 16) != 0) {
+    const std::string error = std::strerror(errno);
+    ::close(listen_fd_);
+    throw std::runtime_error(
+        fmt::format("metrics port {}: {}", port, error));
+  }
+
+  socklen_t length = sizeof(address);
+  ::getsockname(listen_fd_, reinterpret_cast<sockaddr *>(&address), &length);
+  port_ = ntohs(address.sin_port);
+
+  thread_ = std::thread([this] { serve(); });
+}
+
+MetricsServer::~MetricsServer() {
+  stop_ = true;
+  thread_.join();
+  ::close(listen_fd_);
+}
+
+void MetricsServer::serve() {
+  while (!stop_) {
+    pollfd listener{listen_fd_, POLLIN, 0};
+    if (::poll(&listener, 1, POLL_INTERVAL_MS) <= 0)
+      continue;
+
+    const int client = ::accept(listen_fd_, nullptr, nullptr);
+    if (client < 0)
+      continue;
+    try {
+      handle(client);
+    } catch (const std::exception &e) {
+      spdlog::error("Metrics request failed: {}", e.what());
+    }
+    ::close(client);
+  }
+}
+
+void MetricsServer::handle(int client) {
+  // Only the request line matters; read until the end of the headers
+  std::string request;
+  char buffer[1024];
+  while (request.find("\r\n\r\n") == std::string::npos &&
+         request.size() < MAX_REQUEST_BYTES) {
+    pollfd readable{client, POLLIN, 0};
+    if (::poll(&readable, 1, POLL_INTERVAL_MS) <= 0)
+      return;
+    const ssize_t received = ::recv(client, buffer, sizeof(buffer), 0);
+    if (received <= 0)
+      return;
+    request.append(buffer, static_cast<size_t>(received));
+  }
+
+  const bool is_metrics = request.starts_with("GET /metrics ") ||
+                          request.starts_with("GET /metrics?");
+  const std::string body =
+      is_metrics ? metrics::renderPrometheus(metrics::snapshot())
+                 : "not found\n";
+  const std::string header = fmt::format(
+      "HTTP/1.1 {}\r\n"
+      "Content-Type: text/plain; version=0.0.4; charset=utf-8\r\n"
+      "Content-Length: {}\r\n"
+      "Connection: close\r\n\r\n",
+      is_metrics ? "200 OK" : "404 Not Found", body.size());
+  sendAll(client, header);
+  sendAll(client, body);
+}
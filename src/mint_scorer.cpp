@@ -0,0 +1,62 @@
+#include "mint_scorer.hpp"
+#include <cstdint>
+#include <stdexcept>
+#include "simd_kernels.hpp"
+
+void MintFeatureColumns::resize(size_t count) {
+  drop.resize(count);
+  time_since_peak.resize(count);
+  pattern_strength.resize(count);
+  volume_trend.resize(count);
+}
+
+void MintFeatureColumns::set(size_t i, double drop_fraction,
+                             double seconds_since_peak, double pattern,
+                             double volume) {
+  drop[i] = drop_fraction;
+  time_since_peak[i] = seconds_since_peak;
+  pattern_strength[i] = pattern;
+  volume_trend[i] = volume;
+}
+
+void scoreMints(const MintFeatureColumns &features,
+                const DetectionParams &config, MintScores &scores) {
+  scoreMints(features, 0, features.size(), config, scores);
+}
+
+void scoreMints(const MintFeatureColumns &features, size_t begin,
+                size_t end, const DetectionParams &config,
+                MintScores &scores) {
+  const size_t rows = features.size();
+  if (features.time_since_peak.size() != rows ||
+      features.pattern_strength.size() != rows ||
+      features.volume_trend.size() != rows)
+    throw std::invalid_argument("feature columns differ in length");
+  if (begin > end || end > rows)
+    throw std::invalid_argument("rows to score are out of range");
+  const size_t count = end - begin;
+
+  scores.confidence.resize(count);
+  scores.trigger.resize(count);
+  if (count == 0)
+    return;
+
+  const simd::MintScoreInputs in{features.drop.data() + begin,
+                                 features.time_since_peak.data() + begin,
+                                 features.pattern_strength.data() + begin,
+                                 features.volume_trend.data() + begin, count};
+  const simd::ScoreThresholds thresholds{
+      config.peak_drop_threshold,
+      static_cast<double>(config.time_from_peak_threshold),
+      config.volume_spike_threshold,
+      config.pattern_strength_threshold,
+      config.min_confidence_score,
+      config.stop_loss_threshold};
+  // The kernels write SweepTrigger values as bytes
+  static_assert(sizeof(SweepTrigger) == sizeof(uint8_t));
+  static_assert(static_cast<uint8_t>(SweepTrigger::StopLoss) == 1 &&
+                static_cast<uint8_t>(SweepTrigger::Pattern) == 2);
+  simd::kernels().score_mints(
+      in, thresholds, scores.confidence.data(),
+      reinterpret_cast<uint8_t *>(scores.trigger.data()));
+}
@@ -0,0 +1,177 @@
+#include "parameter_sweep.hpp"
+#include <algorithm>
+#include <limits>
+#include "parallel_chunks.hpp"
+#include "rug_pull_detector.hpp"
+#include "window_stats.hpp"
+
+namespace {
+
+// Mints a thread claims at a time
+constexpr size_t SWEEP_CHUNK_SIZE = 16;
+
+// Trades scored per scoreMints call; the pattern rule tends to fire early,
+// so blocks stop the scan soon after the first hit
+constexpr size_t SCORE_BLOCK_SIZE = 32;
+
+// Same gate as RugPullDetector::processTrades
+constexpr int64_t MIN_SECONDS_AFTER_PEAK = 5;
+
+} // namespace
+
+const char *triggerName(SweepTrigger trigger) {
+  switch (trigger) {
+  case SweepTrigger::StopLoss:
+    return "stop_loss";
+  case SweepTrigger::Pattern:
+    return "pattern";
+  case SweepTrigger::None:
+    break;
+  }
+  return "";
+}
+
+TradeFeatures computeTradeFeatures(const TradeSeries &trades,
+                                   int max_detection_time) {
+  TradeFeatures features;
+  if (trades.empty())
+    return features;
+
+  // Peak over every trade, first occurrence, as RugPullDetector::addTrade
+  // tracks it
+  double peak_mc = 0.0;
+  int64_t peak_time_us = 0;
+  for (size_t i = 0; i < trades.size(); ++i) {
+    if (trades.market_cap_sol[i] > peak_mc) {
+      peak_mc = trades.market_cap_sol[i];
+      peak_time_us = trades.timestamp_us[i];
+    }
+  }
+  const int64_t analysis_start_us = trades.timestamp_us.front();
+  const double nan = std::numeric_limits<double>::quiet_NaN();
+
+  features.timestamp_us.reserve(trades.size());
+  features.drop.reserve(trades.size());
+  features.max_drop.reserve(trades.size());
+  features.time_since_peak.reserve(trades.size());
+  features.pattern_strength.reserve(trades.size());
+  features.volume_trend.reserve(trades.size());
+
+  SlidingWindowStats window;
+  double max_drop = -std::numeric_limits<double>::infinity();
+  for (size_t i = 0; i < trades.size(); ++i) {
+    const int64_t timestamp_us = trades.timestamp_us[i];
+    window.advance(trades, analysis_start_us, timestamp_us,
+                   max_detection_time);
+    if (window.size() == 0)
+      continue;
+
+    const int64_t time_since_peak =
+        (timestamp_us - peak_time_us) / MICROS_PER_SECOND;
+    const double drop =
+        (peak_mc > 0) ? (peak_mc - trades.market_cap_sol[i]) / peak_mc : 0;
+    max_drop = std::max(max_drop, drop);
+
+    double pattern = nan;
+    double volume = nan;
+    if (window.size() > 1 && time_since_peak >= MIN_SECONDS_AFTER_PEAK) {
+      const auto stats = window.stats(trades);
+      pattern = stats.pattern_strength;
+      volume = stats.volume_trend;
+    }
+
+    features.timestamp_us.push_back(timestamp_us);
+    features.drop.push_back(drop);
+    features.max_drop.push_back(max_drop);
+    features.time_since_peak.push_back(static_cast<double>(time_since_peak));
+    features.pattern_strength.push_back(pattern);
+    features.volume_trend.push_back(volume);
+  }
+  return features;
+}
+
+SweepHit evaluateFeatures(const TradeFeatures &features,
+                          const DetectionParams &config) {
+  MintScores scores;
+  return evaluateFeatures(features, config, scores);
+}
+
+SweepHit evaluateFeatures(const TradeFeatures &features,
+                          const DetectionParams &config, MintScores &scores) {
+  SweepHit hit;
+
+  // First trade at or past the stop loss; the pattern rule can only win
+  // before it
+  const auto stop_it =
+      std::lower_bound(features.max_drop.begin(), features.max_drop.end(),
+                       config.stop_loss_threshold);
+  const size_t stop_idx =
+      static_cast<size_t>(stop_it - features.max_drop.begin());
+
+  // No trade before the stop loss is past it, so every row that fires
+  // fires on the pattern rule
+  for (size_t begin = 0; begin < stop_idx; begin += SCORE_BLOCK_SIZE) {
+    const size_t end = std::min(begin + SCORE_BLOCK_SIZE, stop_idx);
+    scoreMints(features, begin, end, config, scores);
+    const auto fired = std::find(scores.trigger.begin(), scores.trigger.end(),
+                                 SweepTrigger::Pattern);
+    if (fired == scores.trigger.end())
+      continue;
+    const size_t i =
+        begin + static_cast<size_t>(fired - scores.trigger.begin());
+    hit.trigger = SweepTrigger::Pattern;
+    hit.timestamp_us = features.timestamp_us[i];
+    hit.confidence = scores.confidence[i - begin];
+    hit.drop_percentage = features.drop[i] * 100;
+    return hit;
+  }
+
+  if (stop_idx < features.size()) {
+    hit.trigger = SweepTrigger::StopLoss;
+    hit.timestamp_us = features.timestamp_us[stop_idx];
+    hit.confidence = 1.0;
+    hit.drop_percentage = features.drop[stop_idx] * 100;
+  }
+  return hit;
+}
+
+SweepResults runParameterSweep(std::span<const TradeSeries> mints,
+                               std::span<const DetectionParams> configs,
+                               size_t max_threads) {
+  SweepResults results(configs.size(), mints.size());
+  if (mints.empty() || configs.empty())
+    return results;
+
+  // Window length is the only config field the features depend on
+  std::vector<int> detection_times;
+  for (const auto &config : configs)
+    detection_times.push_back(config.max_detection_time);
+  std::sort(detection_times.begin(), detection_times.end());
+  detection_times.erase(
+      std::unique(detection_times.begin(), detection_times.end()),
+      detection_times.end());
+
+  std::vector<size_t> config_group(configs.size());
+  for (size_t c = 0; c < configs.size(); ++c) {
+    config_group[c] = static_cast<size_t>(
+        std::lower_bound(detection_times.begin(), detection_times.end(),
+                         configs[c].max_detection_time) -
+        detection_times.begin());
+  }
+
+  // Feature and score buffers are per thread and reused across mints
+  parallelChunks(
+      mints.size(), SWEEP_CHUNK_SIZE, max_threads,
+      [&, features = std::vector<TradeFeatures>(detection_times.size()),
+       scores = MintScores{}](size_t begin, size_t end) mutable {
+        for (size_t mint = begin; mint < end; ++mint) {
+          for (size_t g = 0; g < detection_times.size(); ++g)
+            features[g] = computeTradeFeatures(mints[mint], detection_times[g]);
+          for (size_t c = 0; c < configs.size(); ++c)
+            results.at(c, mint) = evaluateFeatures(features[config_group[c]],
+                                                   configs[c], scores);
+        }
+      });
+
+  return results;
+}
@@ -1,23 +1,212 @@
+#include "async_check_pool.hpp"
+#include "async_redis_client.hpp"
+#include "batch_detector.hpp"
+#include "key_worker.hpp"
+#include "metrics.hpp"
+#include "parameter_sweep.hpp"
 #include "redis_client.hpp"
 #include "rug_pull_detector.hpp"
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <memory>
+#include <mutex>
 #include <pybind11/chrono.h>
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
+#include <span>
+#include <stdexcept>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 namespace py = pybind11;
 using namespace pybind11::literals;
 
+py::dict errorDict(std::string_view error) {
+  return py::dict("rug_pulled"_a = false, "timestamp"_a = py::none(),
+                  "debug_info"_a = py::dict("error"_a = error));
+}
+
+py::dict resultDict(const DetectionResult &result) {
+  if (result.rug_pulled) {
+    return py::dict(
+        "rug_pulled"_a = true,
+        "timestamp"_a = result.timestamp.has_value()
+                            ? py::cast(result.timestamp.value())
+                            : py::none(),
+        "debug_info"_a = py::dict(
+            "trigger_type"_a = result.debug_info.trigger_type,
+            "confidence"_a = result.debug_info.confidence,
+            "drop_percentage"_a = result.debug_info.drop_percentage,
+            "peak_market_cap"_a = result.debug_info.peak_market_cap,
+            "current_market_cap"_a = result.debug_info.current_market_cap));
+  }
+
+  return py::dict("rug_pulled"_a = false, "timestamp"_a = py::none(),
+                  "debug_info"_a = py::dict());
+}
+
+// Columnar output: one list per field, one row per detection, so the result
+// drops straight into pandas.DataFrame
+py::dict resultColumns(std::span<const BatchDetection> detections) {
+  const double nan = std::numeric_limits<double>::quiet_NaN();
+  py::list rug_pulled, timestamp, trigger_type, confidence, drop_percentage,
+      peak_market_cap, current_market_cap, trade_count;
+  for (const auto &detection : detections) {
+    const auto &result = detection.result;
+    rug_pulled.append(result.rug_pulled);
+    timestamp.append(result.timestamp
+                         ? std::chrono::duration<double>(
+                               result.timestamp->time_since_epoch())
+                               .count()
+                         : nan);
+    trigger_type.append(result.debug_info.trigger_type);
+    confidence.append(result.rug_pulled ? result.debug_info.confidence : nan);
+    drop_percentage.append(result.debug_info.drop_percentage);
+    peak_market_cap.append(result.debug_info.peak_market_cap);
+    current_market_cap.append(result.debug_info.current_market_cap);
+    trade_count.append(detection.trade_count);
+  }
+
+  return py::dict("rug_pulled"_a = rug_pulled, "timestamp"_a = timestamp,
+                  "trigger_type"_a = trigger_type,
+                  "confidence"_a = confidence,
+                  "drop_percentage"_a = drop_percentage,
+                  "peak_market_cap"_a = peak_market_cap,
+                  "current_market_cap"_a = current_market_cap,
+                  "trade_count"_a = trade_count);
+}
+
+// A 1-D, contiguous buffer of T, viewed in place. info must outlive the
+// span; it holds the exporter's buffer for as long as it lives.
+template <typename T>
+std::span<const T> columnView(const py::buffer_info &info, const char *name) {
+  if (!info.item_type_is_equivalent_to<T>()) {
+    throw py::type_error(std::string(name) + " must be an array of " +
+                         (std::is_same_v<T, double> ? "float64" : "int64") +
+                         ", got format '" + info.format + "'");
+  }
+  if (info.ndim != 1 ||
+      (info.shape[0] > 1 &&
+       info.strides[0] != static_cast<py::ssize_t>(sizeof(T)))) {
+    throw py::value_error(std::string(name) +
+                          " must be one-dimensional and contiguous");
+  }
+  return {static_cast<const T *>(info.ptr), static_cast<size_t>(info.shape[0])};
+}
+
+// Trade columns of one or many mints, borrowed from Python buffers.
+// Timestamps are int64 Unix microseconds, read in place, or float64 Unix
+// seconds (Redis scores), converted into a copy.
+struct BufferTrades {
+  BufferTrades(const py::buffer &timestamps, const py::buffer &market_caps,
+               const py::buffer &sol_amounts)
+      : timestamp_info(timestamps.request()),
+        market_cap_info(market_caps.request()),
+        sol_amount_info(sol_amounts.request()) {
+    std::span<const int64_t> timestamp_us;
+    if (timestamp_info.item_type_is_equivalent_to<double>()) {
+      const auto seconds = columnView<double>(timestamp_info, "timestamps");
+      converted.reserve(seconds.size());
+      for (const double score : seconds) {
+        converted.push_back(toMicros(scoreToTimePoint(score)));
+      }
+      timestamp_us = converted;
+    } else {
+      timestamp_us = columnView<int64_t>(timestamp_info, "timestamps");
+    }
+    series = {timestamp_us, columnView<double>(market_cap_info, "market_caps"),
+              columnView<double>(sol_amount_info, "sol_amounts")};
+    if (series.market_cap_sol.size() != series.size() ||
+        series.sol_amount.size() != series.size()) {
+      throw py::value_error("timestamps, market_caps and sol_amounts must "
+                            "have the same length");
+    }
+  }
+
+  py::buffer_info timestamp_info;
+  py::buffer_info market_cap_info;
+  py::buffer_info sol_amount_info;
+  std::vector<int64_t> converted;
+  TradeSeries series;
+};
+
+// The detector scans in timestamp order
+void requireSorted(const TradeSeries &trades, size_t mint) {
+  if (!std::is_sorted(trades.timestamp_us.begin(),
+                      trades.timestamp_us.end())) {
+    throw std::invalid_argument("timestamps of mint " + std::to_string(mint) +
+                                " are not in ascending order");
+  }
+}
+
+py::dict detect_buffers(const py::buffer &timestamps,
+                        const py::buffer &market_caps,
+                        const py::buffer &sol_amounts,
+                        const DetectionParams &config) {
+  const BufferTrades trades(timestamps, market_caps, sol_amounts);
+  DetectionResult result;
+  {
+    // Only the borrowed buffers are read; don't resize them meanwhile
+    py::gil_scoped_release release;
+    requireSorted(trades.series, 0);
+    result = RugPullDetector::detect(trades.series, config);
+  }
+  return resultDict(result);
+}
+
+py::dict detect_batch_buffers(const py::buffer &timestamps,
+                              const py::buffer &market_caps,
+                              const py::buffer &sol_amounts,
+                              const py::buffer &offsets,
+                              const DetectionParams &config,
+                              size_t max_threads) {
+  const BufferTrades trades(timestamps, market_caps, sol_amounts);
+  const py::buffer_info offset_info = offsets.request();
+  const auto bounds = columnView<int64_t>(offset_info, "offsets");
+
+  std::vector<BatchDetection> detections;
+  {
+    py::gil_scoped_release release;
+    // Mint i is rows [offsets[i], offsets[i + 1])
+    std::vector<TradeSeries> mints;
+    mints.reserve(bounds.empty() ? 0 : bounds.size() - 1);
+    for (size_t i = 0; i + 1 < bounds.size(); ++i) {
+      if (bounds[i] < 0 || bounds[i] > bounds[i + 1] ||
+          static_cast<uint64_t>(bounds[i + 1]) > trades.series.size()) {
+        throw std::invalid_argument(
+            "offsets must be non-decreasing and within the columns");
+      }
+      mints.push_back(trades.series.subspan(
+          static_cast<size_t>(bounds[i]),
+          static_cast<size_t>(bounds[i + 1] - bounds[i])));
+      requireSorted(mints.back(), i);
+    }
+
+    const auto results = detectSeries(mints, config, max_threads);
+    detections.resize(results.size());
+    for (size_t i = 0; i < results.size(); ++i) {
+      detections[i].result = results[i];
+      detections[i].trade_count = mints[i].size();
+    }
+  }
+  return resultColumns(detections);
+}
+
 py::dict
 check_rug_pull_sync(const std::string &mint_address,
                     const std::string &redis_url = "redis://localhost") {
   try {
-    RedisClient redis(redis_url);
-    auto trades = redis.getTrades("recent_trades:" + mint_address);
+    // Shared, lazily-connected client: repeated checks reuse its connections
+    auto redis = RedisClientRegistry::instance().get(redis_url);
+    auto trades = redis->getTrades("recent_trades:" + mint_address);
 
     if (trades.empty()) {
-      return py::dict("rug_pulled"_a = false, "timestamp"_a = py::none(),
-                      "debug_info"_a =
-                          py::dict("error"_a = "No trade data found"));
+      return errorDict("No trade data found");
     }
 
     RugPullDetector detector;
@@ -26,28 +215,295 @@ check_rug_pull_sync(const std::string &mint_address,
     }
 
     DetectionConfig config;
-    auto result = detector.processTrades(config);
-
-    if (result.rug_pulled) {
-      return py::dict(
-          "rug_pulled"_a = true,
-          "timestamp"_a = result.timestamp.has_value()
-                              ? py::cast(result.timestamp.value())
-                              : py::none(),
-          "debug_info"_a = py::dict(
-              "trigger_type"_a = result.debug_info.trigger_type,
-              "confidence"_a = result.debug_info.confidence,
-              "drop_percentage"_a = result.debug_info.drop_percentage,
-              "peak_market_cap"_a = result.debug_info.peak_market_cap,
-              "current_market_cap"_a = result.debug_info.current_market_cap));
+    return resultDict(detector.processTrades(config));
+  } catch (const std::exception &e) {
+    return errorDict(e.what());
+  }
+}
+
+// Decoding and detection threads behind check_rug_pull_async
+constexpr size_t MAX_ASYNC_CHECK_THREADS = 4;
+
+struct PendingCheck;
+
+// A finished check waiting to be handed back to its loop
+struct FinishedCheck {
+  PendingCheck *pending;
+  KeyWorker::Check check;
+  std::string error;
+};
+
+// Finished checks of one event loop. The first to finish schedules a drain
+// on the loop; everything finished by the time it runs is resolved in that
+// one call. loop is only touched, and this only destroyed, with the GIL.
+struct LoopCompletions {
+  py::object loop;
+  std::mutex mutex;
+  std::vector<FinishedCheck> finished;
+  bool scheduled = false;
+};
+
+// Future of one check_rug_pull_async call, held until its check finishes.
+// Only touched, and only destroyed, with the GIL held.
+struct PendingCheck {
+  std::shared_ptr<LoopCompletions> completions;
+  py::object future;
+};
+
+// Under the GIL: the completion queue of loop, shared by its pending checks
+std::shared_ptr<LoopCompletions> loopCompletions(const py::object &loop) {
+  // A queue keeps its loop alive, so a live entry's key is never reused
+  static auto *queues =
+      new std::unordered_map<PyObject *, std::weak_ptr<LoopCompletions>>();
+  auto &entry = (*queues)[loop.ptr()];
+  if (auto queue = entry.lock()) {
+    return queue;
+  }
+  auto queue = std::make_shared<LoopCompletions>();
+  queue->loop = loop;
+  entry = queue;
+  std::erase_if(*queues, [](const auto &q) { return q.second.expired(); });
+  return queue;
+}
+
+// Runs on the loop's thread: resolves every check that has finished,
+// leaving futures the caller has cancelled alone
+void drainCompletions(LoopCompletions &completions) {
+  std::vector<FinishedCheck> batch;
+  {
+    std::lock_guard lock(completions.mutex);
+    batch.swap(completions.finished);
+    completions.scheduled = false;
+  }
+  for (auto &finished : batch) {
+    std::unique_ptr<PendingCheck> owned(finished.pending);
+    try {
+      if (owned->future.attr("done")().cast<bool>()) {
+        continue;
+      }
+      owned->future.attr("set_result")(
+          !finished.error.empty() ? errorDict(finished.error)
+          : finished.check.trade_count == 0
+              ? errorDict("No trade data found")
+              : resultDict(finished.check.result));
+    } catch (py::error_already_set &e) {
+      e.discard_as_unraisable("check_rug_pull_async");
     }
+  }
+}
 
-    return py::dict("rug_pulled"_a = false, "timestamp"_a = py::none(),
-                    "debug_info"_a = py::dict());
-  } catch (const std::exception &e) {
-    return py::dict("rug_pulled"_a = false, "timestamp"_a = py::none(),
-                    "debug_info"_a = py::dict("error"_a = e.what()));
+// On an AsyncCheckPool thread, without the GIL. Only the thread that
+// schedules a drain takes the GIL, and the Redis I/O thread never does.
+void finishCheck(PendingCheck *pending, const KeyWorker::Check &check,
+                 std::string_view error) {
+  LoopCompletions &completions = *pending->completions;
+  bool schedule;
+  {
+    std::lock_guard lock(completions.mutex);
+    completions.finished.push_back({pending, check, std::string(error)});
+    schedule = !std::exchange(completions.scheduled, true);
+  }
+  if (!schedule) {
+    return;
+  }
+
+  py::gil_scoped_acquire gil;
+  try {
+    completions.loop.attr("call_soon_threadsafe")(
+        py::cpp_function([queue = pending->completions] {
+          drainCompletions(*queue);
+        }));
+  } catch (py::error_already_set &e) {
+    // The loop was closed before the replies came back; nothing is left
+    // to await them
+    e.discard_as_unraisable("check_rug_pull_async");
+    std::vector<FinishedCheck> batch;
+    {
+      std::lock_guard lock(completions.mutex);
+      batch.swap(completions.finished);
+      completions.scheduled = false;
+    }
+    for (auto &finished : batch) {
+      delete finished.pending;
+    }
+  }
+}
+
+AsyncCheckPool &asyncCheckPool() {
+  // Never destroyed: the atexit hook waits for it to go idle instead
+  static auto *pool = new AsyncCheckPool(std::clamp<size_t>(
+      std::thread::hardware_concurrency(), 1, MAX_ASYNC_CHECK_THREADS));
+  return *pool;
+}
+
+// Returns an asyncio.Future on the running loop and issues the fetch on the
+// shared AsyncRedisClient; no thread waits for the reply. The client's I/O
+// thread hands each reply to AsyncCheckPool, whose threads decode and
+// detect without the GIL, and results come back to the loop in batches.
+py::object check_rug_pull_async(const std::string &mint_address,
+                                const std::string &redis_url =
+                                    "redis://localhost") {
+  py::object loop = py::module_::import("asyncio").attr("get_running_loop")();
+  // The event-loop client talks to a single server and cannot follow
+  // cluster redirects; run the cluster-aware sync check off the loop
+  if (RedisClientRegistry::instance().options().cluster) {
+    return loop.attr("run_in_executor")(
+        py::none(), py::cpp_function([mint_address, redis_url] {
+          return check_rug_pull_sync(mint_address, redis_url);
+        }));
+  }
+  py::object future = loop.attr("create_future")();
+  auto *pending = new PendingCheck{loopCompletions(loop), future};
+  AsyncCheckPool &pool = asyncCheckPool();
+
+  {
+    py::gil_scoped_release release;
+    auto redis = AsyncRedisClientRegistry::instance().get(redis_url);
+    pool.check(*redis, "recent_trades:" + mint_address, DetectionConfig{},
+               [pending](const KeyWorker::Check &check,
+                         std::string_view error) {
+                 finishCheck(pending, check, error);
+               });
+  }
+  return future;
+}
+
+py::dict check_rug_pull_batch(const std::vector<std::string> &mint_addresses,
+                              const std::string &redis_url = "redis://localhost",
+                              size_t max_threads = 0) {
+  std::vector<BatchDetection> detections;
+  {
+    // Fetching and scoring never touch Python objects
+    py::gil_scoped_release release;
+
+    std::vector<std::string> keys;
+    keys.reserve(mint_addresses.size());
+    for (const auto &mint : mint_addresses) {
+      keys.push_back("recent_trades:" + mint);
+    }
+
+    // Fetches beyond the shared client's pool size wait for a connection
+    auto redis = RedisClientRegistry::instance().get(redis_url);
+    DetectionConfig config;
+    detections = detectBatch(*redis, keys, config, max_threads);
   }
+
+  py::dict columns("mint"_a = mint_addresses);
+  for (const auto &[name, column] : resultColumns(detections)) {
+    columns[name] = column;
+  }
+  return columns;
+}
+
+py::dict backtest_sweep(const std::vector<std::string> &mint_addresses,
+                        const std::vector<DetectionParams> &configs,
+                        const std::string &redis_url = "redis://localhost",
+                        size_t max_threads = 0) {
+  SweepResults results;
+  {
+    py::gil_scoped_release release;
+
+    // Load the corpus once, a pipelined chunk at a time
+    std::vector<std::string> keys;
+    keys.reserve(mint_addresses.size());
+    for (const auto &mint : mint_addresses) {
+      keys.push_back("recent_trades:" + mint);
+    }
+    auto redis = RedisClientRegistry::instance().get(redis_url);
+    std::vector<TradeColumns> corpus(keys.size());
+    const std::span<const std::string> all_keys(keys);
+    for (size_t begin = 0; begin < keys.size(); begin += BATCH_CHUNK_SIZE) {
+      const size_t count = std::min(BATCH_CHUNK_SIZE, keys.size() - begin);
+      auto chunk = redis->getTradesBatch(all_keys.subspan(begin, count));
+      for (size_t i = 0; i < count; ++i) {
+        corpus[begin + i].reserve(chunk[i].size());
+        for (const auto &trade : chunk[i]) {
+          corpus[begin + i].push_back(trade);
+        }
+      }
+    }
+
+    std::vector<TradeSeries> mints;
+    mints.reserve(corpus.size());
+    for (const auto &columns : corpus) {
+      mints.push_back(columns.view());
+    }
+    results = runParameterSweep(mints, configs, max_threads);
+  }
+
+  // Long format, one row per (config, mint), config-major
+  const double nan = std::numeric_limits<double>::quiet_NaN();
+  py::list config_index, mint, rug_pulled, timestamp, trigger_type,
+      confidence, drop_percentage;
+  for (size_t c = 0; c < results.configCount(); ++c) {
+    for (size_t m = 0; m < results.mintCount(); ++m) {
+      const auto &hit = results.at(c, m);
+      config_index.append(c);
+      mint.append(mint_addresses[m]);
+      rug_pulled.append(hit.detected());
+      timestamp.append(hit.detected()
+                           ? static_cast<double>(hit.timestamp_us) /
+                                 MICROS_PER_SECOND
+                           : nan);
+      trigger_type.append(triggerName(hit.trigger));
+      confidence.append(hit.detected() ? hit.confidence : nan);
+      drop_percentage.append(hit.detected() ? hit.drop_percentage : nan);
+    }
+  }
+
+  return py::dict("config_index"_a = config_index, "mint"_a = mint,
+                  "rug_pulled"_a = rug_pulled, "timestamp"_a = timestamp,
+                  "trigger_type"_a = trigger_type,
+                  "confidence"_a = confidence,
+                  "drop_percentage"_a = drop_percentage);
+}
+
+void configure_redis(size_t pool_size, long connect_timeout_ms,
+                     long socket_timeout_ms, long wait_timeout_ms,
+                     bool cluster) {
+  RedisClientOptions options;
+  options.pool_size = pool_size;
+  options.cluster = cluster;
+  options.connect_timeout = std::chrono::milliseconds(connect_timeout_ms);
+  options.socket_timeout = std::chrono::milliseconds(socket_timeout_ms);
+  options.wait_timeout = std::chrono::milliseconds(wait_timeout_ms);
+  RedisClientRegistry::instance().configure(options);
+
+  // Async clients pick the options up when next created. Dropping them
+  // fails whatever they still have in flight, which the check pool hands
+  // back under the GIL.
+  py::gil_scoped_release release;
+  AsyncRedisClientRegistry::instance().shutdown();
+}
+
+py::dict stats() {
+  const auto snap = metrics::snapshot();
+  const auto to_ms = [](double ns) { return ns / 1e6; };
+
+  py::dict counters;
+  for (size_t i = 0; i < metrics::COUNTER_COUNT; ++i) {
+    counters[metrics::counterName(static_cast<metrics::Counter>(i))] =
+        snap.counters[i];
+  }
+  py::dict gauges;
+  for (size_t i = 0; i < metrics::GAUGE_COUNT; ++i) {
+    gauges[metrics::gaugeName(static_cast<metrics::Gauge>(i))] =
+        snap.gauges[i];
+  }
+  py::dict stages;
+  for (size_t i = 0; i < metrics::STAGE_COUNT; ++i) {
+    const auto &hist = snap.stages[i];
+    const auto pct = [&](double q) {
+      return to_ms(static_cast<double>(hist.percentile(q)));
+    };
+    stages[metrics::stageName(static_cast<metrics::Stage>(i))] = py::dict(
+        "count"_a = hist.count, "mean_ms"_a = to_ms(hist.meanNs()),
+        "p50_ms"_a = pct(0.50), "p90_ms"_a = pct(0.90), "p99_ms"_a = pct(0.99),
+        "p999_ms"_a = pct(0.999),
+        "max_ms"_a = to_ms(static_cast<double>(hist.max_ns)));
+  }
+  return py::dict("counters"_a = counters, "gauges"_a = gauges,
+                  "stages"_a = stages);
 }
 
 PYBIND11_MODULE(rugpull_detector, m) {
@@ -57,6 +513,118 @@ PYBIND11_MODULE(rugpull_detector, m) {
         "Synchronously check if a token has been rug pulled",
         py::arg("mint_address"), py::arg("redis_url") = "redis://localhost");
 
+  m.def("check_rug_pull_async", &check_rug_pull_async,
+        "Check a token without blocking a thread: returns an asyncio.Future "
+        "on the running loop, completed from C++ once Redis replies. "
+        "Checks from any number of coroutines share a few pipelined "
+        "connections per URL.",
+        py::arg("mint_address"), py::arg("redis_url") = "redis://localhost");
+
+  // Fail in-flight async checks while the interpreter can still take them,
+  // with the GIL free for the pool threads that hand them back
+  py::module_::import("atexit").attr("register")(py::cpp_function([] {
+    py::gil_scoped_release release;
+    AsyncRedisClientRegistry::instance().shutdown();
+    asyncCheckPool().wait();
+  }));
+
+  m.def("check_rug_pull_batch", &check_rug_pull_batch,
+        "Check many tokens in one call. Releases the GIL, fetches with "
+        "pipelining and scores in parallel. Returns a dict of equal-length "
+        "lists (timestamp as Unix seconds, NaN when not detected; "
+        "trade_count 0 when no trade data was found)",
+        py::arg("mint_addresses"), py::arg("redis_url") = "redis://localhost",
+        py::arg("max_threads") = 0);
+
+  m.def("configure_redis", &configure_redis,
+        "Set pool size and timeouts (milliseconds, 0 = block) for the "
+        "shared Redis clients. Clients are created lazily per URL on first "
+        "use and reused by every later call and thread. For the async "
+        "client, pool_size is the number of pipelined connections. With "
+        "cluster=True the URL is a Redis Cluster seed node, and async checks "
+        "run on the loop's default executor.",
+        py::arg("pool_size") = 8, py::arg("connect_timeout_ms") = 0,
+        py::arg("socket_timeout_ms") = 0, py::arg("wait_timeout_ms") = 0,
+        py::arg("cluster") = false);
+
+  m.def("backtest_sweep", &backtest_sweep,
+        "Backtest a list of DetectionParams against stored trades for many "
+        "tokens. Window features are computed once per token and every "
+        "config is scored against them, in parallel with the GIL released. "
+        "Returns a dict of equal-length lists with one row per (config, "
+        "mint); timestamp is Unix seconds, NaN when not detected",
+        py::arg("mint_addresses"), py::arg("configs"),
+        py::arg("redis_url") = "redis://localhost", py::arg("max_threads") = 0);
+
+  m.def("stats", &stats,
+        "Process-wide counters and per-stage latency percentiles (ms) "
+        "recorded by every call so far");
+
+  m.def(
+      "metrics_text",
+      [] { return metrics::renderPrometheus(metrics::snapshot()); },
+      "The same counters and histograms in Prometheus text format");
+
+  m.def("reset_stats", &metrics::reset, "Zero all counters and histograms");
+
+  py::class_<DetectionParams>(m, "DetectionParams")
+      .def(py::init([](const py::kwargs &kwargs) {
+             // DetectionParams(min_confidence_score=0.6, ...); unknown
+             // names raise AttributeError
+             DetectionParams params;
+             py::object self =
+                 py::cast(&params, py::return_value_policy::reference);
+             for (const auto &item : kwargs) {
+               py::setattr(self, item.first, item.second);
+             }
+             return params;
+           }))
+      .def_readwrite("peak_drop_threshold",
+                     &DetectionParams::peak_drop_threshold)
+      .def_readwrite("time_from_peak_threshold",
+                     &DetectionParams::time_from_peak_threshold)
+      .def_readwrite("volume_spike_threshold",
+                     &DetectionParams::volume_spike_threshold)
+      .def_readwrite("min_confidence_score",
+                     &DetectionParams::min_confidence_score)
+      .def_readwrite("early_warning_threshold",
+                     &DetectionParams::early_warning_threshold)
+      .def_readwrite("consecutive_drops_threshold",
+                     &DetectionParams::consecutive_drops_threshold)
+      .def_readwrite("price_velocity_threshold",
+                     &DetectionParams::price_velocity_threshold)
+      .def_readwrite("pattern_strength_threshold",
+                     &DetectionParams::pattern_strength_threshold)
+      .def_readwrite("short_window", &DetectionParams::short_window)
+      .def_readwrite("stop_loss_threshold",
+                     &DetectionParams::stop_loss_threshold)
+      .def_readwrite("max_detection_time",
+                     &DetectionParams::max_detection_time);
+
+  // Scores trades held in Python (NumPy arrays, Arrow buffers, pandas
+  // columns' .values) without going through Redis
+  py::class_<RugPullDetector>(m, "RugPullDetector")
+      .def_static(
+          "detect", &detect_buffers,
+          "Score one mint's trades, given as equal-length 1-D contiguous "
+          "buffers in timestamp order: timestamps as int64 Unix "
+          "microseconds (read in place) or float64 Unix seconds (copied), "
+          "market caps and SOL amounts as float64 (read in place). The GIL "
+          "is released while scoring. Returns the same dict as "
+          "check_rug_pull_sync",
+          py::arg("timestamps"), py::arg("market_caps"),
+          py::arg("sol_amounts"), py::arg("config") = DetectionParams{})
+      .def_static(
+          "detect_batch", &detect_batch_buffers,
+          "Score many mints stored back to back in the same columns as "
+          "detect; mint i is rows offsets[i] to offsets[i + 1] (int64, one "
+          "more entry than mints). Read in place and scored in parallel with "
+          "the GIL released. Returns a dict of equal-length lists as "
+          "check_rug_pull_batch does, one row per mint",
+          py::arg("timestamps"), py::arg("market_caps"),
+          py::arg("sol_amounts"), py::arg("offsets"),
+          py::arg("config") = DetectionParams{}, py::arg("max_threads") = 0);
+
   py::class_<DetectionConfig>(m, "DetectionConfig")
       .def(py::init<>())
       .def_readonly_static("peak_drop_threshold",
@@ -1,97 +1,498 @@
 #include "redis_client.hpp"
+#include "metrics.hpp"
+#include "trade_decoder.hpp"
+#include "trade_record.hpp"
+#include "trade_reply.hpp"
+#include <algorithm>
+#include <charconv>
 #include <chrono>
-#include <nlohmann/json.hpp>
+#include <functional>
+#include <future>
+#include <iterator>
+#include <map>
 #include <spdlog/spdlog.h>
+#include <stdexcept>
+#include <thread>
 
-using json = nlohmann::json;
-std::atomic<size_t> RedisClient::counter{0};
+namespace {
+
+sw::redis::ConnectionOptions connectionOptions(
+    const std::string& url, const RedisClientOptions& options) {
+    sw::redis::ConnectionOptions connection(url);
+    connection.connect_timeout = options.connect_timeout;
+    connection.socket_timeout = options.socket_timeout;
+    return connection;
+}
+
+sw::redis::ConnectionPoolOptions poolOptions(
+    const RedisClientOptions& options) {
+    sw::redis::ConnectionPoolOptions pool;
+    pool.size = std::max<size_t>(1, options.pool_size);
+    pool.wait_timeout = options.wait_timeout;
+    return pool;
+}
+
+std::variant<sw::redis::Redis, sw::redis::RedisCluster> makeClient(
+    const sw::redis::ConnectionOptions& connection,
+    const RedisClientOptions& options) {
+    if (options.cluster) {
+        return std::variant<sw::redis::Redis, sw::redis::RedisCluster>(
+            std::in_place_index<1>, connection, poolOptions(options));
+    }
+    return std::variant<sw::redis::Redis, sw::redis::RedisCluster>(
+        std::in_place_index<0>, connection, poolOptions(options));
+}
+
+// KEYS[1] a trade sorted set; ARGV stop_drop, pattern_drop, pattern_delay.
+// Returns {count, first_score, peak_market_cap, peak_score,
+// candidate_score}: the peak is the first strict maximum, as the detector
+// tracks it, and the candidate the first trade that either trigger could
+// fire on (nil if none). Scores are passed through as Redis formatted them
+// and the peak as %.17g, so both parse back exactly; Lua numbers would be
+// truncated to integers on the way out.
+constexpr const char* SUMMARY_SCRIPT = R"lua(
+local pairs_ = redis.call('ZRANGE', KEYS[1], 0, -1, 'WITHSCORES')
+local stop_drop = tonumber(ARGV[1])
+local pattern_drop = tonumber(ARGV[2])
+local pattern_delay = tonumber(ARGV[3])
+-- marketCapSol of a member, or nil where the client would skip it. 183
+-- (0xB7) tags a binary record, see trade_record.hpp.
+local function market_cap(member)
+  if string.byte(member, 1) == 183 then
+    if #member == 26 and string.byte(member, 2) == 1 then
+      return (struct.unpack('<d', member, 11))
+    end
+    return nil
+  end
+  local ok, trade = pcall(cjson.decode, member)
+  if ok and type(trade) == 'table' and type(trade.marketCapSol) == 'number'
+      and type(trade.solAmount) == 'number' then
+    return trade.marketCapSol
+  end
+  return nil
+end
+local caps, scores = {}, {}
+local peak, peak_score = 0, '0'
+for i = 1, #pairs_, 2 do
+  local cap = market_cap(pairs_[i])
+  if cap then
+    caps[#caps + 1] = cap
+    scores[#scores + 1] = pairs_[i + 1]
+    if cap > peak then
+      peak = cap
+      peak_score = pairs_[i + 1]
+    end
+  end
+end
+if #caps == 0 then
+  return {0}
+end
+local candidate = false
+local peak_time = tonumber(peak_score)
+for i = 1, #caps do
+  local drop = 0
+  if peak > 0 then
+    drop = (peak - caps[i]) / peak
+  end
+  if drop >= stop_drop or (drop >= pattern_drop and
+      tonumber(scores[i]) - peak_time >= pattern_delay) then
+    candidate = scores[i]
+    break
+  end
+end
+return {#caps, scores[1], string.format('%.17g', peak), peak_score,
+        candidate}
+)lua";
+
+// KEYS[1] a trade sorted set; ARGV (old member, new member, score)
+// triples. Swaps each old member still in the set for the new one, so
+// trades trimmed or added meanwhile are left alone and the TTL is kept.
+constexpr const char* REPLACE_SCRIPT = R"lua(
+local replaced = 0
+for i = 1, #ARGV, 3 do
+  if redis.call('ZREM', KEYS[1], ARGV[i]) == 1 then
+    redis.call('ZADD', KEYS[1], ARGV[i + 2], ARGV[i + 1])
+    replaced = replaced + 1
+  end
+end
+return replaced
+)lua";
+
+// Members per REPLACE_SCRIPT call, so one big key does not stall Redis
+constexpr size_t CONVERT_CHUNK_SIZE = 1000;
+
+// KEYS[1] a group sorted set; ARGV member, lease in milliseconds. Server
+// time, so that the processes sharing a group need not agree on a clock.
+constexpr const char* RENEW_SCRIPT = R"lua(
+redis.replicate_commands()
+local now = redis.call('TIME')
+local now_ms = tonumber(now[1]) * 1000 + math.floor(tonumber(now[2]) / 1000)
+redis.call('ZREMRANGEBYSCORE', KEYS[1], '-inf', now_ms)
+redis.call('ZADD', KEYS[1], now_ms + tonumber(ARGV[2]), ARGV[1])
+redis.call('PEXPIRE', KEYS[1], tonumber(ARGV[2]) * 2)
+return redis.call('ZRANGE', KEYS[1], 0, -1)
+)lua";
+
+double parseDouble(const redisReply& reply) {
+    if (reply.type != REDIS_REPLY_STRING) {
+        throw std::runtime_error("expected a number string in script reply");
+    }
+    double value = 0.0;
+    const auto [end, error] =
+        std::from_chars(reply.str, reply.str + reply.len, value);
+    if (error != std::errc() || end != reply.str + reply.len) {
+        throw std::runtime_error("unparseable number in script reply");
+    }
+    return value;
+}
+
+void logSummary(size_t count, int64_t first_us, int64_t last_us,
+                double first_mc, double last_mc) {
+    if (count < 2) {
+        return;
+    }
+    spdlog::info("Analysis summary:\n"
+                 "  Total trades: {}\n"
+                 "  Time span: {:.1f} seconds\n"
+                 "  Initial MC: {:.3f} SOL\n"
+                 "  Latest MC: {:.3f} SOL",
+                 count,
+                 static_cast<double>((last_us - first_us) / MICROS_PER_SECOND),
+                 first_mc, last_mc);
+}
+
+} // namespace
+
+uint16_t clusterSlot(std::string_view key) {
+    const auto open = key.find('{');
+    if (open != std::string_view::npos) {
+        const auto close = key.find('}', open + 1);
+        if (close != std::string_view::npos && close > open + 1) {
+            key = key.substr(open + 1, close - open - 1);
+        }
+    }
+    // CRC16-CCITT (XMODEM), as in the Redis Cluster specification
+    uint16_t crc = 0;
+    for (const char c : key) {
+        crc ^= static_cast<uint16_t>(static_cast<uint8_t>(c) << 8);
+        for (int bit = 0; bit < 8; ++bit) {
+            crc = (crc & 0x8000) ? static_cast<uint16_t>((crc << 1) ^ 0x1021)
+                                 : static_cast<uint16_t>(crc << 1);
+        }
+    }
+    return crc & (CLUSTER_SLOTS - 1);
+}
+
+RedisClient::RedisClient(const std::string& url, size_t pool_size)
+    : RedisClient(url, RedisClientOptions{pool_size}) {}
+
+RedisClient::RedisClient(const std::string& url,
+                         const RedisClientOptions& options)
+    : connection_(connectionOptions(url, options))
+    , redis_(makeClient(connection_, options)) {}
+
+RedisClientRegistry& RedisClientRegistry::instance() {
+    static RedisClientRegistry registry;
+    return registry;
+}
+
+std::shared_ptr<RedisClient> RedisClientRegistry::get(const std::string& url) {
+    std::lock_guard lock(mutex_);
+    auto& client = clients_[url];
+    if (!client) {
+        client = std::make_shared<RedisClient>(url, options_);
+    }
+    return client;
+}
+
+void RedisClientRegistry::configure(const RedisClientOptions& options) {
+    std::lock_guard lock(mutex_);
+    options_ = options;
+    clients_.clear();
+}
+
+RedisClientOptions RedisClientRegistry::options() const {
+    std::lock_guard lock(mutex_);
+    return options_;
+}
+
+sw::redis::ReplyUPtr RedisClient::fetchAll(const std::string& key) {
+    // Key diagnostics cost three extra round trips, so only pay for them
+    // when someone is actually going to read the output
+    if (spdlog::should_log(spdlog::level::debug)) {
+        std::visit([&](auto& redis) {
+            auto key_type = redis.type(key);
+            auto ttl = redis.ttl(key);
+            spdlog::debug("Key type: {}, TTL: {}s", key_type, ttl);
+        }, redis_);
+    }
+
+    // Members and scores in a single ZRANGE ... WITHSCORES round trip.
+    // Sorted sets come back in score order, so no re-sort is needed.
+    metrics::StageTimer timer(metrics::Stage::RedisFetch);
+    auto reply = std::visit([&](auto& redis) {
+        return redis.command("ZRANGE", key, "0", "-1", "WITHSCORES");
+    }, redis_);
+    timer.stop();
+    metrics::add(metrics::Counter::KeysFetched);
+
+    // Redis deletes empty sorted sets, so no members means no key
+    if (replyTradeCount(*reply) == 0) {
+        spdlog::error("Key does not exist: {}", key);
+        return nullptr;
+    }
+    return reply;
+}
 
 std::vector<Trade> RedisClient::getTrades(const std::string& key) {
     std::vector<Trade> trades;
     try {
-        size_t index = counter++ % pool_size_;
-        auto& redis = connection_pool_[index];
+        auto reply = fetchAll(key);
+        if (!reply) {
+            return trades;
+        }
 
-        // First check if key exists
-        bool exists = redis->exists(key);
-        if (!exists) {
-            spdlog::error("Key does not exist: {}", key);
+        appendReplyTrades(*reply, trades);
+        if (trades.empty()) {
+            spdlog::error("No valid trades found after parsing");
             return trades;
         }
+        logSummary(trades.size(), toMicros(trades.front().timestamp),
+                   toMicros(trades.back().timestamp),
+                   trades.front().market_cap_sol,
+                   trades.back().market_cap_sol);
 
-        // Get key type and TTL for debugging
-        auto key_type = redis->type(key);
-        auto ttl = redis->ttl(key);
-        spdlog::info("Key type: {}, TTL: {}s", key_type, ttl);
+    } catch (const sw::redis::Error& e) {
+        metrics::add(metrics::Counter::RedisErrors);
+        spdlog::error("Redis error: {}", e.what());
+    } catch (const std::exception& e) {
+        spdlog::error("Error processing trades: {}", e.what());
+    }
 
-        // Get all members with scores
-        std::vector<std::string> members;
-        redis->zrange(key, 0, -1, std::back_inserter(members));
+    return trades;
+}
 
-        trades.reserve(members.size());
-        
-        for (const auto& member : members) {
-            try {
-                // Get score for this member
-                auto score = redis->zscore(key, member);
-                if (!score) {
-                    spdlog::error("Failed to get score for member");
-                    continue;
-                }
+void RedisClient::getTrades(const std::string& key, TradeColumns& columns) {
+    try {
+        auto reply = fetchAll(key);
+        if (!reply) {
+            return;
+        }
+
+        const size_t first = columns.size();
+        appendReplyTrades(*reply, columns);
+        if (columns.size() == first) {
+            spdlog::error("No valid trades found after parsing");
+            return;
+        }
+        const size_t last = columns.size() - 1;
+        logSummary(columns.size() - first, columns.timestamp_us(first),
+                   columns.timestamp_us(last), columns.market_cap_sol(first),
+                   columns.market_cap_sol(last));
+
+    } catch (const sw::redis::Error& e) {
+        metrics::add(metrics::Counter::RedisErrors);
+        spdlog::error("Redis error: {}", e.what());
+    } catch (const std::exception& e) {
+        spdlog::error("Error processing trades: {}", e.what());
+    }
+}
 
-                // Parse JSON data
-                auto trade_json = json::parse(member);
+RedisClient::TradeBatch RedisClient::getTradesAfter(
+    const std::string& key, double after_score,
+    std::span<const uint64_t> seen) {
+    TradeBatch batch;
+    batch.last_score = after_score;
+    batch.last_members.assign(seen.begin(), seen.end());
+    try {
+        // Inclusive lower bound when the members at after_score are known,
+        // so one added later with the same score is not lost; those already
+        // seen are skipped by member. The score is formatted as the shortest
+        // string that parses back to the same double; redis++ intervals go
+        // through std::to_string, which rounds to six decimals and would
+        // break the microsecond cursor.
+        const auto min = seen.empty() ? fmt::format("({}", after_score)
+                                      : fmt::format("{}", after_score);
+        metrics::StageTimer timer(metrics::Stage::RedisFetch);
+        auto reply = std::visit([&](auto& redis) {
+            return redis.command("ZRANGEBYSCORE", key, min, "+inf",
+                                 "WITHSCORES");
+        }, redis_);
+        timer.stop();
+        metrics::add(metrics::Counter::KeysFetched);
 
-                // Create Trade object
-                Trade trade;
+        const auto last_score = replyLastScore(*reply);
+        if (!last_score) {
+            return batch;
+        }
 
-                // Convert score (timestamp) to time_point
-                trade.timestamp = std::chrono::system_clock::from_time_t(
-                    static_cast<std::time_t>(*score));
+        batch.last_score = *last_score;
+        batch.last_members = replyTrailingMembers(*reply);
+        appendReplyTrades(*reply, batch.trades, after_score, seen);
 
-                // Get values from JSON using value() method
-                trade.market_cap_sol = trade_json["marketCapSol"].get<double>();
-                trade.sol_amount = trade_json["solAmount"].get<double>();
+        spdlog::debug("Fetched {} new trades for {} (cursor {})",
+                      batch.trades.size(), key, batch.last_score);
 
-                trades.push_back(std::move(trade));
-            } catch (const json::exception& e) {
-                spdlog::error("Failed to parse trade data: {}\nData: {}", 
-                    e.what(), member);
-                continue;
-            } catch (const std::exception& e) {
-                spdlog::error("Error processing trade: {}", e.what());
-                continue;
+    } catch (const sw::redis::Error& e) {
+        metrics::add(metrics::Counter::RedisErrors);
+        spdlog::error("Redis error: {}", e.what());
+    } catch (const std::exception& e) {
+        spdlog::error("Error processing trades: {}", e.what());
+    }
+
+    return batch;
+}
+
+std::optional<RedisClient::TradeSummary> RedisClient::summarizeTrades(
+    const std::string& key, double stop_drop, double pattern_drop,
+    double pattern_delay) {
+    try {
+        const auto stop = fmt::format("{}", stop_drop);
+        const auto pattern = fmt::format("{}", pattern_drop);
+        const auto delay = fmt::format("{}", pattern_delay);
+        metrics::StageTimer timer(metrics::Stage::RedisFetch);
+        // The SHA is the same on every node, but each node has its own
+        // script cache, so a cluster master may still answer NOSCRIPT
+        auto reply = withNodeFor(key, [&](sw::redis::Redis& node) {
+            const auto evalsha = [&](const std::string& sha) {
+                return node.command("EVALSHA", sha, "1", key, stop, pattern,
+                                    delay);
+            };
+            std::string sha;
+            {
+                std::lock_guard lock(script_mutex_);
+                if (summary_sha_.empty()) {
+                    summary_sha_ = node.script_load(SUMMARY_SCRIPT);
+                }
+                sha = summary_sha_;
             }
+            try {
+                return evalsha(sha);
+            } catch (const sw::redis::Error& e) {
+                // Script cache flushed or server restarted: load it again
+                if (std::string_view(e.what()).find("NOSCRIPT") ==
+                    std::string_view::npos) {
+                    throw;
+                }
+                {
+                    std::lock_guard lock(script_mutex_);
+                    summary_sha_ = node.script_load(SUMMARY_SCRIPT);
+                    sha = summary_sha_;
+                }
+                return evalsha(sha);
+            }
+        });
+        timer.stop();
+        metrics::add(metrics::Counter::KeysFetched);
+
+        if (reply->type != REDIS_REPLY_ARRAY || reply->elements == 0 ||
+            reply->element[0]->type != REDIS_REPLY_INTEGER) {
+            throw std::runtime_error("unexpected summary script reply");
+        }
+        if (reply->element[0]->integer == 0) {
+            spdlog::error("Key does not exist: {}", key);
+            return std::nullopt;
+        }
+        if (reply->elements != 5) {
+            throw std::runtime_error("unexpected summary script reply");
         }
 
-        if (trades.empty()) {
-            spdlog::error("No valid trades found after parsing");
-            return trades;
+        TradeSummary summary;
+        summary.count = static_cast<size_t>(reply->element[0]->integer);
+        summary.first_score = parseDouble(*reply->element[1]);
+        summary.peak_market_cap = parseDouble(*reply->element[2]);
+        summary.peak_score = parseDouble(*reply->element[3]);
+        // Lua false comes back as a nil reply
+        if (reply->element[4]->type != REDIS_REPLY_NIL) {
+            summary.candidate_score = parseDouble(*reply->element[4]);
+        }
+        return summary;
+
+    } catch (const sw::redis::Error& e) {
+        metrics::add(metrics::Counter::RedisErrors);
+        spdlog::error("Redis error: {}", e.what());
+    } catch (const std::exception& e) {
+        spdlog::error("Error summarizing trades: {}", e.what());
+    }
+    return std::nullopt;
+}
+
+RedisClient::TradePage RedisClient::getTradesPage(const std::string& key,
+                                                  double min_score,
+                                                  size_t offset, size_t count,
+                                                  TradeColumns& columns) {
+    TradePage page;
+    try {
+        // Shortest round-trip formatting, as in getTradesAfter
+        metrics::StageTimer timer(metrics::Stage::RedisFetch);
+        auto reply = std::visit([&](auto& redis) {
+            return redis.command("ZRANGEBYSCORE", key,
+                                 fmt::format("{}", min_score), "+inf",
+                                 "WITHSCORES", "LIMIT", std::to_string(offset),
+                                 std::to_string(count));
+        }, redis_);
+        timer.stop();
+
+        page.pairs = replyTradeCount(*reply);
+        if (page.pairs == 0) {
+            return page;
         }
+        page.last_score = *replyLastScore(*reply);
+        page.ties = replyTrailingTies(*reply);
+        appendReplyTrades(*reply, columns);
+
+    } catch (const sw::redis::Error& e) {
+        metrics::add(metrics::Counter::RedisErrors);
+        spdlog::error("Redis error: {}", e.what());
+        page = TradePage{};
+    } catch (const std::exception& e) {
+        spdlog::error("Error processing trades: {}", e.what());
+        page = TradePage{};
+    }
+    return page;
+}
+
+std::vector<std::vector<Trade>> RedisClient::getTradesBatch(
+    std::span<const std::string> keys) {
+    std::vector<std::vector<Trade>> trades(keys.size());
+    if (keys.empty()) {
+        return trades;
+    }
 
-        // Sort trades by timestamp
-        std::sort(trades.begin(), trades.end(), 
-            [](const Trade& a, const Trade& b) {
-                return a.timestamp < b.timestamp;
-            });
-
-        // Print trade summary
-        if (trades.size() >= 2) {
-            auto duration = std::chrono::duration_cast<std::chrono::seconds>(
-                trades.back().timestamp - trades.front().timestamp).count();
-            
-            spdlog::info("Analysis summary:\n"
-                        "  Total trades: {}\n"
-                        "  Time span: {:.1f} seconds\n"
-                        "  Initial MC: {:.3f} SOL\n"
-                        "  Latest MC: {:.3f} SOL",
-                        trades.size(),
-                        static_cast<double>(duration),
-                        trades.back().market_cap_sol,
-                        trades.front().market_cap_sol);
+    try {
+        // Borrow a pooled connection rather than opening a new one
+        metrics::StageTimer fetch_timer(metrics::Stage::RedisFetch);
+        if (auto* redis = std::get_if<sw::redis::Redis>(&redis_)) {
+            auto pipe = redis->pipeline(false);
+            for (const auto& key : keys) {
+                pipe.command("ZRANGE", key, "0", "-1", "WITHSCORES");
+            }
+            auto replies = pipe.exec();
+            fetch_timer.stop();
+            // A bad reply (WRONGTYPE, say) leaves only its own key empty
+            for (size_t i = 0; i < keys.size(); ++i) {
+                try {
+                    appendReplyTrades(replies.get(i), trades[i]);
+                } catch (const sw::redis::Error& e) {
+                    metrics::add(metrics::Counter::RedisErrors);
+                    spdlog::error("Redis error fetching {}: {}", keys[i],
+                                  e.what());
+                    trades[i].clear();
+                } catch (const std::exception& e) {
+                    spdlog::error("Error processing trades for {}: {}",
+                                  keys[i], e.what());
+                    trades[i].clear();
+                }
+            }
+        } else {
+            fetchBatchFromCluster(
+                std::get<sw::redis::RedisCluster>(redis_), keys, trades);
+            fetch_timer.stop();
         }
+        metrics::add(metrics::Counter::KeysFetched, keys.size());
 
     } catch (const sw::redis::Error& e) {
+        metrics::add(metrics::Counter::RedisErrors);
         spdlog::error("Redis error: {}", e.what());
     } catch (const std::exception& e) {
         spdlog::error("Error processing trades: {}", e.what());
@@ -99,3 +500,278 @@ std::vector<Trade> RedisClient::getTrades(const std::string& key) {
 
     return trades;
 }
+
+void RedisClient::fetchBatchFromCluster(
+    sw::redis::RedisCluster& cluster, std::span<const std::string> keys,
+    std::vector<std::vector<Trade>>& trades) {
+    // A pipeline can carry keys of every slot its master serves, so keys
+    // are grouped by master rather than by slot
+    const auto owners = layout(cluster);
+    std::vector<std::vector<size_t>> by_master(owners->masters.size());
+    std::vector<size_t> unowned;
+    for (size_t i = 0; i < keys.size(); ++i) {
+        const uint16_t master = owners->slot_master[clusterSlot(keys[i])];
+        (master == ClusterLayout::NO_MASTER ? unowned : by_master[master])
+            .push_back(i);
+    }
+
+    // One key at a time, letting redis++ follow redirections
+    const auto fetchEach = [&](const std::vector<size_t>& indices) {
+        for (const size_t i : indices) {
+            try {
+                auto reply = cluster.command("ZRANGE", keys[i], "0", "-1",
+                                             "WITHSCORES");
+                appendReplyTrades(*reply, trades[i]);
+            } catch (const sw::redis::Error& e) {
+                metrics::add(metrics::Counter::RedisErrors);
+                spdlog::error("Redis error fetching {}: {}", keys[i], e.what());
+            } catch (const std::exception& e) {
+                spdlog::error("Error processing trades for {}: {}", keys[i],
+                              e.what());
+            }
+        }
+    };
+
+    // A failed round trip leaves only that master's keys empty
+    const auto fetchGroup = [&](const std::vector<size_t>& indices) {
+        std::vector<size_t> moved;
+        try {
+            auto pipe = cluster.pipeline(keys[indices.front()], false);
+            for (const size_t i : indices) {
+                pipe.command("ZRANGE", keys[i], "0", "-1", "WITHSCORES");
+            }
+            auto replies = pipe.exec();
+            for (size_t j = 0; j < indices.size(); ++j) {
+                try {
+                    appendReplyTrades(replies.get(j), trades[indices[j]]);
+                } catch (const sw::redis::RedirectionError&) {
+                    // The slot changed hands since the layout was read
+                    moved.push_back(indices[j]);
+                } catch (const sw::redis::Error& e) {
+                    metrics::add(metrics::Counter::RedisErrors);
+                    spdlog::error("Redis error fetching {}: {}",
+                                  keys[indices[j]], e.what());
+                    trades[indices[j]].clear();
+                } catch (const std::exception& e) {
+                    spdlog::error("Error processing trades for {}: {}",
+                                  keys[indices[j]], e.what());
+                    trades[indices[j]].clear();
+                }
+            }
+        } catch (const sw::redis::Error& e) {
+            metrics::add(metrics::Counter::RedisErrors);
+            spdlog::error("Redis error fetching {} keys from one master: {}",
+                          indices.size(), e.what());
+        }
+        if (!moved.empty()) {
+            invalidateLayout();
+            fetchEach(moved);
+        }
+    };
+
+    // Every master's round trip at once; the first on this thread
+    std::vector<const std::vector<size_t>*> groups;
+    for (const auto& indices : by_master) {
+        if (!indices.empty()) {
+            groups.push_back(&indices);
+        }
+    }
+    std::vector<std::future<void>> others;
+    for (size_t g = 1; g < groups.size(); ++g) {
+        others.push_back(
+            std::async(std::launch::async, fetchGroup, std::cref(*groups[g])));
+    }
+    if (!groups.empty()) {
+        fetchGroup(*groups.front());
+    }
+    for (auto& other : others) {
+        other.get();
+    }
+    fetchEach(unowned);
+}
+
+std::optional<std::string> RedisClient::popKey(const std::string& list,
+                                               std::chrono::seconds timeout) {
+    try {
+        auto item = std::visit(
+            [&](auto& redis) { return redis.blpop(list, timeout); }, redis_);
+        if (item) {
+            return std::move(item->second);
+        }
+    } catch (const sw::redis::TimeoutError&) {
+        // Socket timeout shorter than the BLPOP timeout; same as no item
+    } catch (const sw::redis::Error& e) {
+        metrics::add(metrics::Counter::RedisErrors);
+        spdlog::error("Redis error: {}", e.what());
+        // Don't turn a dead server into a busy loop for the caller
+        std::this_thread::sleep_for(timeout);
+    }
+    return std::nullopt;
+}
+
+RedisClient::Conversion RedisClient::convertToBinary(const std::string& key) {
+    std::vector<std::pair<std::string, double>> members;
+    std::visit([&](auto& redis) {
+        redis.zrange(key, 0, -1, std::back_inserter(members));
+    }, redis_);
+
+    Conversion conversion;
+    // EVAL script 1 key, then the triples; sent as one argument range
+    const std::vector<std::string> header = {"EVAL", REPLACE_SCRIPT, "1", key};
+    std::vector<std::string> args = header;
+    const auto flush = [&] {
+        if (args.size() == header.size()) {
+            return;
+        }
+        auto reply = withNodeFor(key, [&](sw::redis::Redis& node) {
+            return node.command(args.begin(), args.end());
+        });
+        if (reply->type == REDIS_REPLY_INTEGER) {
+            conversion.converted += static_cast<size_t>(reply->integer);
+        }
+        args = header;
+    };
+
+    for (const auto& [member, score] : members) {
+        if (isTradeRecord(member)) {
+            ++conversion.already_binary;
+            continue;
+        }
+        TradeFields fields;
+        try {
+            fields = decodeTradeMember(member);
+        } catch (const std::exception& e) {
+            // Left as it is; readers skip it either way
+            ++conversion.skipped;
+            spdlog::warn("Not converting unreadable member of {}: {}", key,
+                         e.what());
+            continue;
+        }
+        auto record = encodeTradeRecord(toMicros(scoreToTimePoint(score)),
+                                        fields.market_cap_sol,
+                                        fields.sol_amount);
+        conversion.bytes_before += member.size();
+        conversion.bytes_after += record.size();
+        args.push_back(member);
+        args.push_back(std::move(record));
+        args.push_back(fmt::format("{}", score));
+        if (args.size() >= header.size() + 3 * CONVERT_CHUNK_SIZE) {
+            flush();
+        }
+    }
+    flush();
+    return conversion;
+}
+
+std::vector<std::string> RedisClient::scanKeys(const std::string& pattern) {
+    std::vector<std::string> keys;
+    const auto scan = [&](sw::redis::Redis& redis) {
+        long long cursor = 0;
+        do {
+            cursor =
+                redis.scan(cursor, pattern, 1000, std::back_inserter(keys));
+        } while (cursor != 0);
+    };
+    if (auto* redis = std::get_if<sw::redis::Redis>(&redis_)) {
+        scan(*redis);
+        return keys;
+    }
+    // SCAN only covers the node it runs on
+    for (const auto& options : nodes()) {
+        sw::redis::Redis node(options);
+        scan(node);
+    }
+    return keys;
+}
+
+std::vector<sw::redis::ConnectionOptions> RedisClient::nodes() {
+    auto* cluster = std::get_if<sw::redis::RedisCluster>(&redis_);
+    if (!cluster) {
+        return {connection_};
+    }
+    return queryLayout(*cluster).masters;
+}
+
+RedisClient::ClusterLayout RedisClient::queryLayout(
+    sw::redis::RedisCluster& cluster) {
+    // Each entry is {first slot, last slot, {host, port, id}, replicas...};
+    // a master serving several ranges is listed once
+    auto reply = cluster.command("CLUSTER", "SLOTS");
+    ClusterLayout layout;
+    layout.slot_master.assign(CLUSTER_SLOTS, ClusterLayout::NO_MASTER);
+    std::map<std::pair<std::string, long long>, uint16_t> seen;
+    if (reply->type != REDIS_REPLY_ARRAY) {
+        throw std::runtime_error("unexpected CLUSTER SLOTS reply");
+    }
+    for (size_t i = 0; i < reply->elements; ++i) {
+        const redisReply* range = reply->element[i];
+        if (range->type != REDIS_REPLY_ARRAY || range->elements < 3 ||
+            range->element[0]->type != REDIS_REPLY_INTEGER ||
+            range->element[1]->type != REDIS_REPLY_INTEGER ||
+            range->element[2]->type != REDIS_REPLY_ARRAY ||
+            range->element[2]->elements < 2) {
+            throw std::runtime_error("unexpected CLUSTER SLOTS reply");
+        }
+        const redisReply* master = range->element[2];
+        std::string host(master->element[0]->str, master->element[0]->len);
+        const long long port = master->element[1]->integer;
+        // An empty host means "the address you reached me on"
+        if (host.empty() || host == "?") {
+            host = connection_.host;
+        }
+        auto [it, inserted] = seen.try_emplace(
+            {host, port}, static_cast<uint16_t>(layout.masters.size()));
+        if (inserted) {
+            auto options = connection_;
+            options.type = sw::redis::ConnectionType::TCP;
+            options.host = host;
+            options.port = static_cast<int>(port);
+            layout.masters.push_back(std::move(options));
+        }
+        const auto first = std::clamp<long long>(range->element[0]->integer,
+                                                 0, CLUSTER_SLOTS - 1);
+        const auto last = std::clamp<long long>(range->element[1]->integer,
+                                                first, CLUSTER_SLOTS - 1);
+        std::fill(layout.slot_master.begin() + first,
+                  layout.slot_master.begin() + last + 1, it->second);
+    }
+    return layout;
+}
+
+std::shared_ptr<const RedisClient::ClusterLayout> RedisClient::layout(
+    sw::redis::RedisCluster& cluster) {
+    std::lock_guard lock(layout_mutex_);
+    if (!layout_) {
+        layout_ = std::make_shared<const ClusterLayout>(queryLayout(cluster));
+    }
+    return layout_;
+}
+
+void RedisClient::invalidateLayout() {
+    std::lock_guard lock(layout_mutex_);
+    layout_.reset();
+}
+
+std::vector<std::string> RedisClient::renewMember(
+    const std::string& group, const std::string& member,
+    std::chrono::milliseconds lease) {
+    auto reply = withNodeFor(group, [&](sw::redis::Redis& node) {
+        return node.command("EVAL", RENEW_SCRIPT, "1", group, member,
+                            std::to_string(lease.count()));
+    });
+    if (reply->type != REDIS_REPLY_ARRAY) {
+        throw std::runtime_error("unexpected membership script reply");
+    }
+    std::vector<std::string> members;
+    members.reserve(reply->elements);
+    for (size_t i = 0; i < reply->elements; ++i) {
+        const redisReply* element = reply->element[i];
+        members.emplace_back(element->str, element->len);
+    }
+    return members;
+}
+
+void RedisClient::removeMember(const std::string& group,
+                               const std::string& member) {
+    std::visit([&](auto& redis) { redis.zrem(group, member); }, redis_);
+}
@@ -0,0 +1,128 @@
+#include "registry_snapshot.hpp"
+#include <algorithm>
+#include <cstring>
+#include <numeric>
+#include <span>
+#include <stdexcept>
+#include <vector>
+#include "block_file.hpp"
+
+size_t saveRegistrySnapshot(const DetectorRegistry &registry,
+                            const std::string &path, int max_detection_time) {
+  BlockFileWriter file(path + ".tmp", "registry snapshot");
+  // Placeholder; commit() rewrites it once the offsets are known
+  SnapshotHeader header{};
+  file.write(&header, sizeof(header));
+
+  std::vector<SnapshotMintEntry> index;
+  std::string names;
+  uint64_t trade_count = 0;
+  registry.forEachMint([&](const MintSnapshot &mint) {
+    SnapshotMintEntry entry{};
+    entry.block_offset = file.offset();
+    entry.trade_count = mint.trades.size();
+    entry.name_offset = names.size();
+    entry.name_length = mint.mint.size();
+    entry.peak_mc = mint.peak_mc;
+    entry.peak_time_us = mint.peak_time_us;
+    entry.analysis_start_us = mint.analysis_start_us;
+    entry.current_idx = mint.current_idx;
+    entry.window_begin = mint.window_begin;
+    entry.window_end = mint.window_end;
+    entry.last_score = mint.cursor.last_score;
+    const auto members = mint.cursor.lastMembers();
+    std::copy(members.begin(), members.end(), entry.last_members);
+    entry.last_member_count = static_cast<uint32_t>(members.size());
+    entry.last_update_us = mint.last_update_us;
+    entry.flags = mint.cursor.reported ? SNAPSHOT_REPORTED : 0;
+
+    file.writeTrades(mint.trades);
+    names.append(mint.mint);
+    index.push_back(entry);
+    trade_count += mint.trades.size();
+  });
+
+  std::memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+  header.version = SNAPSHOT_VERSION;
+  header.byte_order = BLOCK_FILE_BYTE_ORDER;
+  header.mint_count = index.size();
+  header.trade_count = trade_count;
+  header.max_detection_time = max_detection_time;
+  header.index_offset = file.offset();
+  file.write(index.data(), index.size() * sizeof(SnapshotMintEntry));
+  header.names_offset = file.offset();
+  header.names_size = names.size();
+  file.write(names.data(), names.size());
+  file.commit(&header, sizeof(header), path);
+  return index.size();
+}
+
+SnapshotLoad
+loadRegistrySnapshot(DetectorRegistry &registry, const std::string &path,
+                     int max_detection_time,
+                     const std::function<bool(std::string_view)> &keep) {
+  // Every block is copied out right away
+  const MappedBlockFile file(path, "registry snapshot", sizeof(SnapshotHeader),
+                             MappedBlockFile::Access::WillNeed);
+  const auto &header =
+      file.header<SnapshotHeader>(SNAPSHOT_MAGIC, SNAPSHOT_VERSION);
+  if (header.max_detection_time != max_detection_time)
+    throw file.error("saved for max_detection_time " +
+                     std::to_string(header.max_detection_time));
+
+  const auto index = file.array<SnapshotMintEntry>(header.index_offset,
+                                                   header.mint_count);
+  const auto names = file.text(header.names_offset, header.names_size);
+  for (size_t i = 0; i < index.size(); ++i) {
+    const auto &entry = index[i];
+    if (!file.trades(entry.block_offset, entry.trade_count,
+                     header.index_offset) ||
+        !MappedBlockFile::slice(names, entry.name_offset, entry.name_length) ||
+        entry.last_member_count > MAX_CURSOR_TIES)
+      throw file.error("bad index entry " + std::to_string(i));
+  }
+
+  // Oldest first, so each shard's recency list comes out in order
+  std::vector<size_t> order(index.size());
+  std::iota(order.begin(), order.end(), size_t{0});
+  std::sort(order.begin(), order.end(), [&index](size_t a, size_t b) {
+    return index[a].last_update_us < index[b].last_update_us;
+  });
+
+  SnapshotLoad load;
+  const auto now = DetectorRegistry::Clock::now();
+  for (const size_t i : order) {
+    const auto &entry = index[i];
+    MintSnapshot mint;
+    mint.mint = *MappedBlockFile::slice(names, entry.name_offset,
+                                        entry.name_length);
+    if (keep && !keep(mint.mint)) {
+      ++load.skipped;
+      continue;
+    }
+
+    mint.trades = *file.trades(entry.block_offset, entry.trade_count,
+                               header.index_offset);
+    mint.peak_mc = entry.peak_mc;
+    mint.peak_time_us = entry.peak_time_us;
+    mint.analysis_start_us = entry.analysis_start_us;
+    mint.current_idx = static_cast<size_t>(entry.current_idx);
+    mint.window_begin = static_cast<size_t>(entry.window_begin);
+    mint.window_end = static_cast<size_t>(entry.window_end);
+    mint.cursor.last_score = entry.last_score;
+    std::copy_n(entry.last_members, entry.last_member_count,
+                mint.cursor.last_members.begin());
+    mint.cursor.last_member_count =
+        static_cast<uint8_t>(entry.last_member_count);
+    mint.cursor.reported = (entry.flags & SNAPSHOT_REPORTED) != 0;
+    mint.last_update_us = entry.last_update_us;
+
+    if (registry.restore(mint, now)) {
+      ++load.restored;
+      load.trades += mint.trades.size();
+    } else {
+      ++load.skipped;
+    }
+  }
+  return load;
+}
@@ -0,0 +1,47 @@
+#include "risk_priority.hpp"
+#include <charconv>
+#include <cmath>
+
+const char *riskClassName(RiskClass risk) {
+  switch (risk) {
+  case RiskClass::High:
+    return "high";
+  case RiskClass::Medium:
+    return "medium";
+  case RiskClass::Low:
+    return "low";
+  }
+  return "";
+}
+
+RiskClass classify(const RiskSignals &signals, const RiskPolicy &policy) {
+  const bool busy =
+      signals.trades_per_second >= policy.busy_trades_per_second;
+  if (signals.drop_from_peak >= policy.high_drop)
+    return RiskClass::High;
+  if (signals.drop_from_peak >= policy.medium_drop) {
+    return busy && signals.seconds_since_peak < policy.pattern_seconds
+               ? RiskClass::High
+               : RiskClass::Medium;
+  }
+  return busy ? RiskClass::Medium : RiskClass::Low;
+}
+
+std::optional<RiskSignals> parseRiskSignals(std::string_view text) {
+  double values[3];
+  const char *pos = text.data();
+  const char *const end = text.data() + text.size();
+  for (double &value : values) {
+    while (pos < end && *pos == ' ')
+      ++pos;
+    const auto parsed = std::from_chars(pos, end, value);
+    if (parsed.ec != std::errc() || !std::isfinite(value))
+      return std::nullopt;
+    pos = parsed.ptr;
+  }
+  while (pos < end && *pos == ' ')
+    ++pos;
+  if (pos != end)
+    return std::nullopt;
+  return RiskSignals{values[0], values[1], values[2]};
+}
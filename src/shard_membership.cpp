@@ -0,0 +1,50 @@
+#include "shard_membership.hpp"
+#include <algorithm>
+#include <spdlog/spdlog.h>
+#include "metrics.hpp"
+
+ShardMembership::ShardMembership(RedisClient &redis, MembershipOptions options)
+    : redis_(redis), options_(std::move(options)),
+      ring_({options_.id}, options_.virtual_nodes) {
+  metrics::adjust(metrics::Gauge::ShardMembers, 1);
+  refresh();
+}
+
+ShardMembership::~ShardMembership() {
+  metrics::adjust(metrics::Gauge::ShardMembers,
+                  -static_cast<int64_t>(ring_.members().size()));
+  try {
+    redis_.removeMember(options_.group_key, options_.id);
+  } catch (const std::exception &e) {
+    spdlog::warn("Could not leave shard group {}: {}", options_.group_key,
+                 e.what());
+  }
+}
+
+bool ShardMembership::refresh() {
+  std::vector<std::string> members;
+  try {
+    members =
+        redis_.renewMember(options_.group_key, options_.id, options_.lease);
+  } catch (const std::exception &e) {
+    metrics::add(metrics::Counter::RedisErrors);
+    spdlog::error("Shard lease renewal failed, keeping {} members: {}",
+                  ring_.members().size(), e.what());
+    return false;
+  }
+
+  // Our own lease was just written, but be safe against a racing removal
+  if (std::find(members.begin(), members.end(), options_.id) == members.end())
+    members.push_back(options_.id);
+  std::sort(members.begin(), members.end());
+  if (members == ring_.members())
+    return false;
+
+  spdlog::info("Shard group {} now has {} members (was {})",
+               options_.group_key, members.size(), ring_.members().size());
+  metrics::adjust(metrics::Gauge::ShardMembers,
+                  static_cast<int64_t>(members.size()) -
+                      static_cast<int64_t>(ring_.members().size()));
+  ring_ = ShardRing(std::move(members), options_.virtual_nodes);
+  return true;
+}
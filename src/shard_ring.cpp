@@ -0,0 +1,64 @@
+#include "shard_ring.hpp"
+#include <algorithm>
+#include <string>
+
+namespace {
+
+constexpr uint64_t FNV_OFFSET = 0xcbf29ce484222325ULL;
+constexpr uint64_t FNV_PRIME = 0x100000001b3ULL;
+
+uint64_t fmix64(uint64_t h) {
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdULL;
+  h ^= h >> 33;
+  h *= 0xc4ceb9fe1a85ec53ULL;
+  h ^= h >> 33;
+  return h;
+}
+
+} // namespace
+
+uint64_t shardHash(std::string_view key) {
+  uint64_t h = FNV_OFFSET;
+  for (const char c : key) {
+    h ^= static_cast<uint8_t>(c);
+    h *= FNV_PRIME;
+  }
+  return fmix64(h);
+}
+
+ShardRing::ShardRing(std::vector<std::string> members, size_t virtual_nodes)
+    : members_(std::move(members)) {
+  std::sort(members_.begin(), members_.end());
+  members_.erase(std::unique(members_.begin(), members_.end()),
+                 members_.end());
+
+  virtual_nodes = std::max<size_t>(1, virtual_nodes);
+  points_.reserve(members_.size() * virtual_nodes);
+  for (uint32_t m = 0; m < members_.size(); ++m) {
+    std::string point = members_[m] + '#';
+    const size_t prefix = point.size();
+    for (size_t v = 0; v < virtual_nodes; ++v) {
+      point.resize(prefix);
+      point += std::to_string(v);
+      points_.push_back({shardHash(point), m});
+    }
+  }
+  // Ties (vanishingly rare) go to the smaller member name on every process
+  std::sort(points_.begin(), points_.end(),
+            [](const Point &a, const Point &b) {
+              return a.hash != b.hash ? a.hash < b.hash : a.member < b.member;
+            });
+}
+
+const std::string *ShardRing::owner(std::string_view key) const {
+  if (points_.empty())
+    return nullptr;
+  const uint64_t hash = shardHash(key);
+  auto it = std::lower_bound(
+      points_.begin(), points_.end(), hash,
+      [](const Point &point, uint64_t h) { return point.hash < h; });
+  if (it == points_.end())
+    it = points_.begin();
+  return &members_[it->member];
+}
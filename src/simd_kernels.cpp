@@ -0,0 +1,180 @@
+#include "simd_kernels.hpp"
+#include <algorithm>
+#include <cmath>
+
+#if (defined(__x86_64__) || defined(__i386__)) &&                             \
+    (defined(__GNUC__) || defined(__clang__))
+#define RUGPULL_HAVE_AVX2_KERNELS 1
+#include <immintrin.h>
+#endif
+
+namespace simd {
+namespace {
+
+void deltasScalar(const double *in, size_t n, double *out) {
+  for (size_t i = 0; i + 1 < n; ++i)
+    out[i] = in[i + 1] - in[i];
+}
+
+void absDeltasScalar(const double *in, size_t n, double *out) {
+  for (size_t i = 0; i + 1 < n; ++i)
+    out[i] = std::abs(in[i + 1] - in[i]);
+}
+
+// Weights of RugPullDetector::calculateConfidence
+constexpr double PRICE_WEIGHT = 0.4;
+constexpr double SIGNAL_WEIGHT = 0.3;
+// SweepTrigger values
+constexpr uint8_t TRIGGER_STOP_LOSS = 1;
+constexpr uint8_t TRIGGER_PATTERN = 2;
+
+// Branch-free, so the compiler is free to vectorize it too. Always
+// inlined, so the AVX2 kernel's tail is compiled as AVX code rather than
+// calling into SSE code with the upper halves of the registers dirty.
+__attribute__((always_inline)) inline void
+scoreRow(const MintScoreInputs &in, const ScoreThresholds &t, size_t i,
+         double *confidence, uint8_t *trigger) {
+  const double price_conf = static_cast<double>(in.drop[i] >= t.peak_drop);
+  const double time_conf =
+      std::max(0.0, 1.0 - in.time_since_peak[i] / t.time_from_peak);
+  const double pattern_conf =
+      static_cast<double>(in.pattern_strength[i] >= t.pattern_strength);
+  const double volume_conf =
+      static_cast<double>(in.volume_trend[i] >= t.volume_spike);
+  const double score = PRICE_WEIGHT * price_conf * time_conf +
+                       SIGNAL_WEIGHT * pattern_conf +
+                       SIGNAL_WEIGHT * volume_conf;
+
+  const bool stop = in.drop[i] >= t.stop_loss;
+  const bool fires =
+      !std::isnan(in.pattern_strength[i]) && score >= t.min_confidence;
+  confidence[i] = stop ? 1.0 : score;
+  trigger[i] = static_cast<uint8_t>(stop * TRIGGER_STOP_LOSS +
+                                    (!stop && fires) * TRIGGER_PATTERN);
+}
+
+void scoreMintsScalar(const MintScoreInputs &in, const ScoreThresholds &t,
+                      double *confidence, uint8_t *trigger) {
+  for (size_t i = 0; i < in.n; ++i)
+    scoreRow(in, t, i, confidence, trigger);
+}
+
+#ifdef RUGPULL_HAVE_AVX2_KERNELS
+
+__attribute__((target("avx2"))) void deltasAvx2(const double *in, size_t n,
+                                                double *out) {
+  if (n < 2)
+    return;
+  const size_t count = n - 1;
+  size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    const __m256d next = _mm256_loadu_pd(in + i + 1);
+    const __m256d prev = _mm256_loadu_pd(in + i);
+    _mm256_storeu_pd(out + i, _mm256_sub_pd(next, prev));
+  }
+  for (; i < count; ++i)
+    out[i] = in[i + 1] - in[i];
+}
+
+__attribute__((target("avx2"))) void absDeltasAvx2(const double *in, size_t n,
+                                                   double *out) {
+  if (n < 2)
+    return;
+  const size_t count = n - 1;
+  // Clearing the sign bit is |x| for IEEE doubles
+  const __m256d sign_mask = _mm256_set1_pd(-0.0);
+  size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    const __m256d next = _mm256_loadu_pd(in + i + 1);
+    const __m256d prev = _mm256_loadu_pd(in + i);
+    _mm256_storeu_pd(out + i,
+                     _mm256_andnot_pd(sign_mask, _mm256_sub_pd(next, prev)));
+  }
+  for (; i < count; ++i)
+    out[i] = std::abs(in[i + 1] - in[i]);
+}
+
+__attribute__((target("avx2"))) void
+scoreMintsAvx2(const MintScoreInputs &in, const ScoreThresholds &t,
+               double *confidence, uint8_t *trigger) {
+  const __m256d one = _mm256_set1_pd(1.0);
+  const __m256d zero = _mm256_setzero_pd();
+  const __m256d price_weight = _mm256_set1_pd(PRICE_WEIGHT);
+  const __m256d signal_weight = _mm256_set1_pd(SIGNAL_WEIGHT);
+  const __m256d peak_drop = _mm256_set1_pd(t.peak_drop);
+  const __m256d time_from_peak = _mm256_set1_pd(t.time_from_peak);
+  const __m256d volume_spike = _mm256_set1_pd(t.volume_spike);
+  const __m256d pattern_strength = _mm256_set1_pd(t.pattern_strength);
+  const __m256d min_confidence = _mm256_set1_pd(t.min_confidence);
+  const __m256d stop_loss = _mm256_set1_pd(t.stop_loss);
+
+  size_t i = 0;
+  for (; i + 4 <= in.n; i += 4) {
+    const __m256d drop = _mm256_loadu_pd(in.drop + i);
+    const __m256d time = _mm256_loadu_pd(in.time_since_peak + i);
+    const __m256d pattern = _mm256_loadu_pd(in.pattern_strength + i);
+    const __m256d volume = _mm256_loadu_pd(in.volume_trend + i);
+
+    // Ordered compares are false on NaN, like the scalar >=
+    const __m256d price_conf =
+        _mm256_and_pd(_mm256_cmp_pd(drop, peak_drop, _CMP_GE_OQ), one);
+    const __m256d time_conf = _mm256_max_pd(
+        zero, _mm256_sub_pd(one, _mm256_div_pd(time, time_from_peak)));
+    const __m256d pattern_conf = _mm256_and_pd(
+        _mm256_cmp_pd(pattern, pattern_strength, _CMP_GE_OQ), one);
+    const __m256d volume_conf =
+        _mm256_and_pd(_mm256_cmp_pd(volume, volume_spike, _CMP_GE_OQ), one);
+    // Same operation order as the scalar sum
+    const __m256d score = _mm256_add_pd(
+        _mm256_add_pd(
+            _mm256_mul_pd(_mm256_mul_pd(price_weight, price_conf), time_conf),
+            _mm256_mul_pd(signal_weight, pattern_conf)),
+        _mm256_mul_pd(signal_weight, volume_conf));
+
+    const __m256d stop = _mm256_cmp_pd(drop, stop_loss, _CMP_GE_OQ);
+    const __m256d fires = _mm256_and_pd(
+        _mm256_cmp_pd(pattern, pattern, _CMP_ORD_Q),
+        _mm256_cmp_pd(score, min_confidence, _CMP_GE_OQ));
+    _mm256_storeu_pd(confidence + i, _mm256_blendv_pd(score, one, stop));
+
+    const int stop_bits = _mm256_movemask_pd(stop);
+    const int pattern_bits = _mm256_movemask_pd(fires) & ~stop_bits;
+    for (int lane = 0; lane < 4; ++lane)
+      trigger[i + lane] = static_cast<uint8_t>(
+          (stop_bits >> lane & 1) * TRIGGER_STOP_LOSS +
+          (pattern_bits >> lane & 1) * TRIGGER_PATTERN);
+  }
+  for (; i < in.n; ++i)
+    scoreRow(in, t, i, confidence, trigger);
+}
+
+#endif // RUGPULL_HAVE_AVX2_KERNELS
+
+} // namespace
+
+const KernelTable &scalarKernels() {
+  static const KernelTable table{deltasScalar, absDeltasScalar,
+                                 scoreMintsScalar, "scalar"};
+  return table;
+}
+
+const KernelTable *avx2Kernels() {
+#ifdef RUGPULL_HAVE_AVX2_KERNELS
+  static const KernelTable table{deltasAvx2, absDeltasAvx2, scoreMintsAvx2,
+                                 "avx2"};
+  static const bool supported = __builtin_cpu_supports("avx2");
+  return supported ? &table : nullptr;
+#else
+  return nullptr;
+#endif
+}
+
+const KernelTable &kernels() {
+  static const KernelTable &selected = []() -> const KernelTable & {
+    const KernelTable *avx2 = avx2Kernels();
+    return avx2 ? *avx2 : scalarKernels();
+  }();
+  return selected;
+}
+
+} // namespace simd
@@ -0,0 +1,65 @@
+#include "streaming_detector.hpp"
+#include "metrics.hpp"
+#include "rug_pull_detector.hpp"
+#include <algorithm>
+
+bool StreamingDetector::addTrade(const Trade &trade) {
+  if (ring_.tryPush(toMicros(trade.timestamp), trade.market_cap_sol,
+                    trade.sol_amount)) {
+    return true;
+  }
+  dropped_.fetch_add(1, std::memory_order_relaxed);
+  metrics::add(metrics::Counter::TradesDropped);
+  return false;
+}
+
+DetectionResult StreamingDetector::processTrades(
+    const DetectionParams &config) {
+  const size_t end = ring_.published();
+  if (end == base_)
+    return DetectionResult{};
+
+  // Fold newly published trades into the peak, as addTrade does in
+  // RugPullDetector: the peak covers every trade seen, not just the window
+  const TradeSeries fresh = ring_.view(seen_, end);
+  if (seen_ == 0)
+    analysis_start_us_ = fresh.timestamp_us.front();
+  for (size_t i = 0; i < fresh.size(); ++i) {
+    if (fresh.market_cap_sol[i] > peak_mc_) {
+      peak_mc_ = fresh.market_cap_sol[i];
+      peak_time_us_ = fresh.timestamp_us[i];
+    }
+  }
+  seen_ = end;
+
+  const TradeSeries series = ring_.view(base_, end);
+  size_t idx = current_idx_ - base_;
+
+  metrics::StageTimer timer(metrics::Stage::Detect);
+  auto result = RugPullDetector::scan(series, peak_mc_, peak_time_us_,
+                                      analysis_start_us_, idx, window_, config);
+  timer.stop();
+  current_idx_ = base_ + idx;
+
+  // Hand back trades the window can no longer reach (the left edge steps
+  // back by at most one second)
+  if (idx > 0) {
+    const int64_t cutoff =
+        series.timestamp_us[idx - 1] -
+        (static_cast<int64_t>(config.max_detection_time) + 1) *
+            MICROS_PER_SECOND;
+    const auto first = series.timestamp_us.begin();
+    const size_t drop = static_cast<size_t>(
+        std::lower_bound(first, first + window_.start(), cutoff) - first);
+    if (drop > 0) {
+      base_ += drop;
+      window_.dropFront(drop);
+      ring_.release(base_);
+    }
+  }
+
+  if (result.rug_pulled) {
+    metrics::recordDetection(*result.timestamp);
+  }
+  return result;
+}
@@ -0,0 +1,100 @@
+#include "trade_corpus.hpp"
+#include <cstring>
+#include <spdlog/spdlog.h>
+
+TradeCorpusWriter::TradeCorpusWriter(const std::string &path)
+    : file_(path, "trade corpus"), trade_count_(0) {
+  // Placeholder; finish() rewrites it once the offsets are known
+  CorpusHeader header{};
+  file_.write(&header, sizeof(header));
+}
+
+TradeCorpusWriter::~TradeCorpusWriter() {
+  if (!file_.isOpen())
+    return;
+  try {
+    finish();
+  } catch (const std::exception &e) {
+    spdlog::error("Error finishing trade corpus: {}", e.what());
+  }
+}
+
+void TradeCorpusWriter::addMint(std::string_view name,
+                                std::span<const Trade> trades) {
+  if (!file_.isOpen())
+    throw file_.error("already finished");
+
+  CorpusIndexEntry entry{};
+  entry.block_offset = file_.offset();
+  entry.trade_count = trades.size();
+  entry.name_offset = names_.size();
+  entry.name_length = name.size();
+
+  // Column at a time so the block matches the in-memory TradeSeries layout
+  TradeColumns columns;
+  columns.reserve(trades.size());
+  for (const auto &trade : trades)
+    columns.push_back(trade);
+  file_.writeTrades(columns.view());
+
+  names_.append(name);
+  index_.push_back(entry);
+  trade_count_ += trades.size();
+}
+
+void TradeCorpusWriter::finish() {
+  if (!file_.isOpen())
+    return;
+
+  CorpusHeader header{};
+  std::memcpy(header.magic, CORPUS_MAGIC, sizeof(header.magic));
+  header.version = CORPUS_VERSION;
+  header.byte_order = BLOCK_FILE_BYTE_ORDER;
+  header.mint_count = index_.size();
+  header.trade_count = trade_count_;
+  header.index_offset = file_.offset();
+  file_.write(index_.data(), index_.size() * sizeof(CorpusIndexEntry));
+  header.names_offset = file_.offset();
+  header.names_size = names_.size();
+  file_.write(names_.data(), names_.size());
+  file_.finish(&header, sizeof(header));
+}
+
+TradeCorpus::TradeCorpus(const std::string &path)
+    : file_(path, "trade corpus", sizeof(CorpusHeader),
+            // Replay walks the blocks front to back
+            MappedBlockFile::Access::Sequential),
+      header_(&file_.header<CorpusHeader>(CORPUS_MAGIC, CORPUS_VERSION)),
+      index_(file_.array<CorpusIndexEntry>(header_->index_offset,
+                                           header_->mint_count)),
+      names_(file_.text(header_->names_offset, header_->names_size)) {
+  by_name_.reserve(index_.size());
+  for (size_t i = 0; i < index_.size(); ++i) {
+    const auto &entry = index_[i];
+    if (!file_.trades(entry.block_offset, entry.trade_count,
+                      header_->index_offset) ||
+        !MappedBlockFile::slice(names_, entry.name_offset, entry.name_length))
+      throw file_.error("bad index entry " + std::to_string(i));
+    by_name_.emplace(mintName(i), i);
+  }
+}
+
+std::string_view TradeCorpus::mintName(size_t i) const {
+  const auto &entry = index_[i];
+  return names_.substr(static_cast<size_t>(entry.name_offset),
+                       static_cast<size_t>(entry.name_length));
+}
+
+// Checked when the corpus was opened
+TradeSeries TradeCorpus::series(size_t i) const {
+  const auto &entry = index_[i];
+  return *file_.trades(entry.block_offset, entry.trade_count,
+                       header_->index_offset);
+}
+
+std::optional<size_t> TradeCorpus::find(std::string_view name) const {
+  auto it = by_name_.find(name);
+  if (it == by_name_.end())
+    return std::nullopt;
+  return it->second;
+}
@@ -0,0 +1,250 @@
+#include "trade_decoder.hpp"
+#include <cctype>
+#include <charconv>
+#include <cmath>
+#include <stdexcept>
+#include <string_view>
+#include "trade_record.hpp"
+#include <nlohmann/json.hpp>
+
+namespace {
+
+constexpr std::string_view MARKET_CAP_KEY = "marketCapSol";
+constexpr std::string_view SOL_AMOUNT_KEY = "solAmount";
+constexpr int MAX_SKIP_DEPTH = 64;
+
+// Cursor over the member bytes; every helper returns false on input it
+// cannot handle so the caller can bail out to the full parser
+struct Scanner {
+  const char *pos;
+  const char *end;
+
+  void skipWhitespace() {
+    while (pos < end &&
+           (*pos == ' ' || *pos == '\t' || *pos == '\n' || *pos == '\r'))
+      ++pos;
+  }
+
+  bool consume(char expected) {
+    skipWhitespace();
+    if (pos == end || *pos != expected)
+      return false;
+    ++pos;
+    return true;
+  }
+
+  // Key names in the spec are plain ASCII; an escape means fall back
+  bool readKey(std::string_view &key) {
+    if (!consume('"'))
+      return false;
+    const char *start = pos;
+    while (pos < end && *pos != '"') {
+      if (*pos == '\\' || static_cast<unsigned char>(*pos) < 0x20)
+        return false;
+      ++pos;
+    }
+    if (pos == end)
+      return false;
+    key = std::string_view(start, pos - start);
+    ++pos;
+    return true;
+  }
+
+  // Raw control characters and unknown escapes are not JSON
+  bool skipString() {
+    ++pos; // opening quote
+    while (pos < end) {
+      // Plain bytes first; most string bytes are lowercase letters
+      const unsigned char c = static_cast<unsigned char>(*pos);
+      if (c > '\\' || (c >= 0x20 && c != '"' && c != '\\')) {
+        ++pos;
+        continue;
+      }
+      ++pos;
+      if (c == '"')
+        return true;
+      if (c != '\\' || pos == end)
+        return false;
+      const char escape = *pos++;
+      if (escape == 'u') {
+        if (end - pos < 4)
+          return false;
+        for (int i = 0; i < 4; ++i, ++pos)
+          if (!std::isxdigit(static_cast<unsigned char>(*pos)))
+            return false;
+      } else if (std::string_view(R"("\/bfnrt)").find(escape) ==
+                 std::string_view::npos) {
+        return false;
+      }
+    }
+    return false;
+  }
+
+  // Objects and arrays are walked value by value, so mismatched brackets
+  // and missing ':' or ',' fail here; very deep nesting is left to the
+  // full parser
+  bool skipObject(int depth) {
+    ++pos; // '{'
+    if (consume('}'))
+      return true;
+    do {
+      skipWhitespace();
+      if (pos == end || *pos != '"' || !skipString() || !consume(':') ||
+          !skipValue(depth))
+        return false;
+    } while (consume(','));
+    return consume('}');
+  }
+
+  bool skipArray(int depth) {
+    ++pos; // '['
+    if (consume(']'))
+      return true;
+    do {
+      if (!skipValue(depth))
+        return false;
+    } while (consume(','));
+    return consume(']');
+  }
+
+  // Length of the JSON number at pos, or 0 if there is none: a digit must
+  // follow '-' and '.', and only a lone 0 may start with 0. This also
+  // keeps out the inf, nan and hex forms from_chars would take
+  size_t numberLength() const {
+    const char *p = pos;
+    const auto digits = [&] {
+      const char *first = p;
+      while (p < end && *p >= '0' && *p <= '9')
+        ++p;
+      return p != first;
+    };
+    if (p < end && *p == '-')
+      ++p;
+    if (p < end && *p == '0')
+      ++p;
+    else if (!digits())
+      return 0;
+    if (p < end && *p == '.') {
+      ++p;
+      if (!digits())
+        return 0;
+    }
+    if (p < end && (*p == 'e' || *p == 'E')) {
+      ++p;
+      if (p < end && (*p == '+' || *p == '-'))
+        ++p;
+      if (!digits())
+        return 0;
+    }
+    return static_cast<size_t>(p - pos);
+  }
+
+  // A number, true, false or null; anything else, such as a bare word,
+  // is left to the full parser to reject
+  bool skipScalar() {
+    const std::string_view rest(pos, static_cast<size_t>(end - pos));
+    for (const std::string_view literal : {"true", "false", "null"}) {
+      if (rest.starts_with(literal)) {
+        pos += literal.size();
+        return true;
+      }
+    }
+    const size_t length = numberLength();
+    pos += length;
+    return length != 0;
+  }
+
+  bool skipValue(int depth = 0) {
+    skipWhitespace();
+    if (pos == end)
+      return false;
+    switch (*pos) {
+    case '"':
+      return skipString();
+    case '{':
+      return depth < MAX_SKIP_DEPTH && skipObject(depth + 1);
+    case '[':
+      return depth < MAX_SKIP_DEPTH && skipArray(depth + 1);
+    default:
+      return skipScalar();
+    }
+  }
+
+  bool readNumber(double &value) {
+    skipWhitespace();
+    const size_t length = numberLength();
+    if (length == 0)
+      return false;
+    auto [next, ec] = std::from_chars(pos, pos + length, value);
+    if (ec != std::errc() || next != pos + length || !std::isfinite(value))
+      return false;
+    pos = next;
+    return true;
+  }
+};
+
+} // namespace
+
+bool decodeTradeFields(std::string_view member, TradeFields &fields) {
+  Scanner scanner{member.data(), member.data() + member.size()};
+  bool have_market_cap = false;
+  bool have_sol_amount = false;
+
+  if (!scanner.consume('{'))
+    return false;
+
+  scanner.skipWhitespace();
+  if (scanner.pos < scanner.end && *scanner.pos == '}')
+    return false; // empty object, neither field present
+
+  while (true) {
+    std::string_view key;
+    if (!scanner.readKey(key) || !scanner.consume(':'))
+      return false;
+
+    // Duplicate keys resolve to the last occurrence, as in nlohmann::json
+    bool ok;
+    if (key == MARKET_CAP_KEY) {
+      ok = scanner.readNumber(fields.market_cap_sol);
+      have_market_cap = true;
+    } else if (key == SOL_AMOUNT_KEY) {
+      ok = scanner.readNumber(fields.sol_amount);
+      have_sol_amount = true;
+    } else {
+      ok = scanner.skipValue();
+    }
+    if (!ok)
+      return false;
+
+    scanner.skipWhitespace();
+    if (scanner.pos == scanner.end)
+      return false;
+    if (*scanner.pos == '}') {
+      ++scanner.pos;
+      break;
+    }
+    if (*scanner.pos != ',')
+      return false;
+    ++scanner.pos;
+  }
+
+  // Trailing garbage is malformed JSON; let the full parser report it
+  scanner.skipWhitespace();
+  return scanner.pos == scanner.end && have_market_cap && have_sol_amount;
+}
+
+TradeFields decodeTradeMember(std::string_view member) {
+  TradeFields fields;
+  if (isTradeRecord(member)) {
+    if (!decodeTradeRecord(member, fields))
+      throw std::invalid_argument("malformed or unknown binary trade record");
+    return fields;
+  }
+  if (decodeTradeFields(member, fields))
+    return fields;
+
+  auto trade_json = nlohmann::json::parse(member);
+  fields.market_cap_sol = trade_json["marketCapSol"].get<double>();
+  fields.sol_amount = trade_json["solAmount"].get<double>();
+  return fields;
+}
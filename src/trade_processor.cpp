@@ -0,0 +1,266 @@
+#include "trade_processor.hpp"
+#include "metrics.hpp"
+
+#include <spdlog/spdlog.h>
+
+namespace {
+
+uint64_t nextRandom(uint64_t &state) {
+  // xorshift64*
+  state ^= state >> 12;
+  state ^= state << 25;
+  state ^= state >> 27;
+  return state * 2685821657736338717ULL;
+}
+
+static_assert(static_cast<size_t>(metrics::Counter::DeadlineMissesMedium) ==
+              static_cast<size_t>(metrics::Counter::DeadlineMissesHigh) + 1);
+static_assert(static_cast<size_t>(metrics::Counter::DeadlineMissesLow) ==
+              static_cast<size_t>(metrics::Counter::DeadlineMissesHigh) + 2);
+
+metrics::Counter deadlineMisses(RiskClass risk) {
+  return static_cast<metrics::Counter>(
+      static_cast<size_t>(metrics::Counter::DeadlineMissesHigh) +
+      static_cast<size_t>(risk));
+}
+
+TradeProcessorOptions withCapacity(size_t injection_capacity) {
+  TradeProcessorOptions options;
+  options.injection_capacity = injection_capacity;
+  return options;
+}
+
+} // namespace
+
+TradeProcessor::TradeProcessor(size_t num_threads, TaskHandler handler,
+                               size_t injection_capacity)
+    : TradeProcessor(num_threads, std::move(handler),
+                     withCapacity(injection_capacity)) {}
+
+TradeProcessor::TradeProcessor(size_t num_threads, TaskHandler handler,
+                               TradeProcessorOptions options)
+    : handler_(std::move(handler)),
+      on_worker_start_(std::move(options.on_worker_start)),
+      started_(std::chrono::steady_clock::now()),
+      deadlines_(options.deadlines), shed_low_risk_(options.shed_low_risk),
+      injectors_{MpmcQueue<Task *>(options.injection_capacity),
+                 MpmcQueue<Task *>(options.injection_capacity),
+                 MpmcQueue<Task *>(options.injection_capacity)} {
+  if (num_threads == 0)
+    num_threads = 1;
+
+  std::vector<CpuSlot> cpus;
+  if (options.pin_workers) {
+    cpus = pinningOrder();
+    if (cpus.empty())
+      spdlog::warn("CPU pinning is not supported here; workers float");
+  }
+
+  workers_.reserve(num_threads);
+  for (size_t i = 0; i < num_threads; ++i) {
+    auto worker = std::make_unique<Worker>();
+    worker->rng_state = 0x9E3779B97F4A7C15ULL * (i + 1);
+    if (!cpus.empty()) {
+      const CpuSlot &slot = cpus[i % cpus.size()];
+      worker->cpu = slot.cpu;
+      worker->node = slot.node;
+    }
+    workers_.push_back(std::move(worker));
+  }
+
+  threads_.reserve(num_threads);
+  for (size_t i = 0; i < num_threads; ++i) {
+    threads_.emplace_back([this, i] { workerLoop(i); });
+  }
+}
+
+TradeProcessor::~TradeProcessor() {
+  stopping_.store(true, std::memory_order_seq_cst);
+  idle_.notifyAll();
+  for (auto &thread : threads_) {
+    thread.join();
+  }
+}
+
+bool TradeProcessor::addTask(std::string key, RiskClass risk) {
+  auto *task =
+      new Task{std::move(key), risk, std::chrono::steady_clock::now()};
+  auto &queue = injector(risk);
+  while (!queue.tryPush(task)) {
+    if (risk == RiskClass::Low && shed_low_risk_) {
+      shed(task);
+      return false;
+    }
+    std::this_thread::yield();
+  }
+  idle_.notifyOne();
+  return true;
+}
+
+std::vector<WorkerStats> TradeProcessor::workerStats() const {
+  const auto lifetime = std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now() - started_);
+  std::vector<WorkerStats> stats;
+  stats.reserve(workers_.size());
+  for (size_t i = 0; i < workers_.size(); ++i) {
+    const Worker &worker = *workers_[i];
+    WorkerStats entry;
+    entry.worker_id = i;
+    entry.cpu = worker.cpu;
+    entry.node = worker.node;
+    entry.tasks = worker.tasks.load(std::memory_order_relaxed);
+    entry.busy = std::chrono::nanoseconds(
+        worker.busy_ns.load(std::memory_order_relaxed));
+    entry.utilization =
+        lifetime.count() > 0 ? static_cast<double>(entry.busy.count()) /
+                                   static_cast<double>(lifetime.count())
+                             : 0.0;
+    stats.push_back(entry);
+  }
+  return stats;
+}
+
+void TradeProcessor::workerLoop(size_t worker_id) {
+  Worker &self = *workers_[worker_id];
+  size_t idle_rounds = 0;
+
+  if (self.cpu >= 0 && !pinCurrentThread(self.cpu)) {
+    spdlog::warn("Could not pin worker {} to CPU {}", worker_id, self.cpu);
+  }
+  if (on_worker_start_) {
+    try {
+      on_worker_start_(worker_id);
+    } catch (const std::exception &e) {
+      spdlog::error("Worker {} setup failed: {}", worker_id, e.what());
+    }
+  }
+
+  while (true) {
+    Task *task = nullptr;
+    if (auto urgent = injector(RiskClass::High).tryPop()) {
+      task = *urgent;
+    } else if (auto local = self.deque.pop()) {
+      task = *local;
+    } else if ((task = takeFromInjector(self, RiskClass::Medium)) ==
+                   nullptr &&
+               (task = takeFromInjector(self, RiskClass::Low)) == nullptr) {
+      task = steal(worker_id);
+    }
+
+    if (task != nullptr) {
+      idle_rounds = 0;
+      run(worker_id, task);
+      continue;
+    }
+
+    // A burst usually has more tasks right behind; parking and being woken
+    // costs two futex calls, so look around a few more times first
+    if (idle_rounds++ < IDLE_SPIN_ROUNDS) {
+      std::this_thread::yield();
+      continue;
+    }
+    idle_rounds = 0;
+
+    // Nothing found: announce we're about to sleep, then look once more so
+    // a task published in between is not missed
+    const auto key = idle_.prepareWait();
+    if (hasQueuedWork()) {
+      idle_.cancelWait();
+      continue;
+    }
+    if (stopping_.load(std::memory_order_seq_cst)) {
+      idle_.cancelWait();
+      return;
+    }
+    idle_.wait(key);
+  }
+}
+
+TradeProcessor::Task *TradeProcessor::takeFromInjector(Worker &self,
+                                                      RiskClass risk) {
+  auto &queue = injector(risk);
+  auto first = queue.tryPop();
+  if (!first)
+    return nullptr;
+
+  // Move a few more into our deque so other workers can steal them
+  size_t moved = 0;
+  while (moved + 1 < INJECTION_BATCH) {
+    auto next = queue.tryPop();
+    if (!next)
+      break;
+    self.deque.push(*next);
+    ++moved;
+  }
+  if (moved > 0)
+    idle_.notifyOne();
+  return *first;
+}
+
+TradeProcessor::Task *TradeProcessor::steal(size_t worker_id) {
+  const size_t count = workers_.size();
+  if (count < 2)
+    return nullptr;
+
+  Worker &self = *workers_[worker_id];
+  const size_t start = nextRandom(self.rng_state) % count;
+  for (size_t i = 0; i < count; ++i) {
+    const size_t victim = (start + i) % count;
+    if (victim == worker_id)
+      continue;
+    if (auto task = workers_[victim]->deque.steal())
+      return *task;
+  }
+  return nullptr;
+}
+
+bool TradeProcessor::hasQueuedWork() const {
+  for (const auto &queue : injectors_) {
+    if (queue.sizeApprox() > 0)
+      return true;
+  }
+  for (const auto &worker : workers_) {
+    if (worker->deque.sizeApprox() > 0)
+      return true;
+  }
+  return false;
+}
+
+void TradeProcessor::run(size_t worker_id, Task *task) {
+  std::unique_ptr<Task> owned(task);
+  const auto started = std::chrono::steady_clock::now();
+  metrics::record(metrics::Stage::QueueWait, started - owned->submitted);
+  const auto deadline =
+      owned->submitted + deadlines_[static_cast<size_t>(owned->risk)];
+  if (owned->risk == RiskClass::Low && shed_low_risk_ && started > deadline) {
+    shed(owned.release());
+    return;
+  }
+  try {
+    metrics::StageTimer timer(metrics::Stage::Task);
+    handler_(worker_id, owned->key);
+  } catch (const std::exception &e) {
+    spdlog::error("Task {} failed: {}", owned->key, e.what());
+  }
+  metrics::add(metrics::Counter::TasksCompleted);
+  const auto finished = std::chrono::steady_clock::now();
+  if (finished > deadline)
+    metrics::add(deadlineMisses(owned->risk));
+
+  // Only this thread writes its counters, so no read-modify-write is needed
+  Worker &self = *workers_[worker_id];
+  const auto busy =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(finished - started);
+  self.tasks.store(self.tasks.load(std::memory_order_relaxed) + 1,
+                   std::memory_order_relaxed);
+  self.busy_ns.store(self.busy_ns.load(std::memory_order_relaxed) +
+                         static_cast<uint64_t>(busy.count()),
+                     std::memory_order_relaxed);
+}
+
+void TradeProcessor::shed(Task *task) {
+  std::unique_ptr<Task> owned(task);
+  metrics::add(metrics::Counter::TasksShed);
+  shed_.fetch_add(1, std::memory_order_relaxed);
+  spdlog::debug("Shed low-risk task {}", owned->key);
+}
@@ -0,0 +1,59 @@
+#include "trade_record.hpp"
+#include <bit>
+#include <cstring>
+#include <utility>
+
+namespace {
+
+constexpr size_t TIMESTAMP_OFFSET = 2;
+constexpr size_t MARKET_CAP_OFFSET = 10;
+constexpr size_t SOL_AMOUNT_OFFSET = 18;
+
+template <typename T> void store(char *out, T value) {
+  char bytes[sizeof(T)];
+  std::memcpy(bytes, &value, sizeof(T));
+  if constexpr (std::endian::native == std::endian::big) {
+    for (size_t i = 0; i < sizeof(T) / 2; ++i)
+      std::swap(bytes[i], bytes[sizeof(T) - 1 - i]);
+  }
+  std::memcpy(out, bytes, sizeof(T));
+}
+
+template <typename T> T load(const char *in) {
+  char bytes[sizeof(T)];
+  std::memcpy(bytes, in, sizeof(T));
+  if constexpr (std::endian::native == std::endian::big) {
+    for (size_t i = 0; i < sizeof(T) / 2; ++i)
+      std::swap(bytes[i], bytes[sizeof(T) - 1 - i]);
+  }
+  T value;
+  std::memcpy(&value, bytes, sizeof(T));
+  return value;
+}
+
+} // namespace
+
+std::string encodeTradeRecord(int64_t timestamp_us, double market_cap_sol,
+                              double sol_amount) {
+  std::string record(TRADE_RECORD_SIZE, '\0');
+  record[0] = static_cast<char>(TRADE_RECORD_TAG);
+  record[1] = static_cast<char>(TRADE_RECORD_VERSION);
+  store(record.data() + TIMESTAMP_OFFSET, timestamp_us);
+  store(record.data() + MARKET_CAP_OFFSET, market_cap_sol);
+  store(record.data() + SOL_AMOUNT_OFFSET, sol_amount);
+  return record;
+}
+
+bool decodeTradeRecord(std::string_view member, TradeFields &fields) {
+  if (member.size() != TRADE_RECORD_SIZE || !isTradeRecord(member) ||
+      static_cast<uint8_t>(member[1]) != TRADE_RECORD_VERSION) {
+    return false;
+  }
+  fields.market_cap_sol = load<double>(member.data() + MARKET_CAP_OFFSET);
+  fields.sol_amount = load<double>(member.data() + SOL_AMOUNT_OFFSET);
+  return true;
+}
+
+int64_t tradeRecordTimestamp(std::string_view member) {
+  return load<int64_t>(member.data() + TIMESTAMP_OFFSET);
+}
@@ -0,0 +1,185 @@
+#include "trade_reply.hpp"
+#include <algorithm>
+#include <charconv>
+#include <functional>
+#include <stdexcept>
+#include <string_view>
+#include <nlohmann/json.hpp>
+#include <spdlog/spdlog.h>
+#include "metrics.hpp"
+#include "trade_decoder.hpp"
+
+namespace {
+
+bool isPairArray(const redisReply &reply) {
+  return reply.elements > 0 && reply.element[0]->type == REDIS_REPLY_ARRAY;
+}
+
+void expectArray(const redisReply &reply) {
+  if (reply.type != REDIS_REPLY_ARRAY) {
+    throw std::runtime_error("expected an array reply for WITHSCORES");
+  }
+}
+
+std::string_view stringOf(const redisReply &reply) {
+  if (reply.type != REDIS_REPLY_STRING) {
+    throw std::runtime_error("expected a string member in WITHSCORES reply");
+  }
+  return {reply.str, reply.len};
+}
+
+double scoreOf(const redisReply &reply) {
+  // RESP3 sends a native double
+  if (reply.type == REDIS_REPLY_DOUBLE) {
+    return reply.dval;
+  }
+  const auto text = stringOf(reply);
+  double score = 0.0;
+  const auto [end, error] =
+      std::from_chars(text.data(), text.data() + text.size(), score);
+  if (error != std::errc() || end != text.data() + text.size()) {
+    throw std::runtime_error("unparseable score in WITHSCORES reply");
+  }
+  return score;
+}
+
+// Calls fn(member, score) for each pair in order
+template <typename Fn> void forEachPair(const redisReply &reply, Fn &&fn) {
+  expectArray(reply);
+  if (isPairArray(reply)) {
+    for (size_t i = 0; i < reply.elements; ++i) {
+      const redisReply &pair = *reply.element[i];
+      if (pair.type != REDIS_REPLY_ARRAY || pair.elements != 2) {
+        throw std::runtime_error("malformed [member, score] pair");
+      }
+      fn(stringOf(*pair.element[0]), scoreOf(*pair.element[1]));
+    }
+    return;
+  }
+  if (reply.elements % 2 != 0) {
+    throw std::runtime_error("odd element count in WITHSCORES reply");
+  }
+  for (size_t i = 0; i < reply.elements; i += 2) {
+    fn(stringOf(*reply.element[i]), scoreOf(*reply.element[i + 1]));
+  }
+}
+
+// The member loop shared by both output types; push(score, fields) appends
+// every pair skip(member, score) does not reject
+template <typename Push, typename Skip>
+void decodePairs(const redisReply &reply, Push &&push, Skip &&skip) {
+  metrics::StageTimer timer(metrics::Stage::Decode);
+  size_t decoded = 0;
+
+  forEachPair(reply, [&](std::string_view member, double score) {
+    if (skip(member, score))
+      return;
+    try {
+      // Binary records, or just the two JSON fields we need; falls back
+      // to a full JSON parse for members the fast path does not understand
+      push(score, decodeTradeMember(member));
+      ++decoded;
+    } catch (const nlohmann::json::exception &e) {
+      metrics::add(metrics::Counter::ParseErrors);
+      spdlog::error("Failed to parse trade data: {}\nData: {}", e.what(),
+                    member);
+    } catch (const std::invalid_argument &e) {
+      // Binary member; its bytes are not worth logging
+      metrics::add(metrics::Counter::ParseErrors);
+      spdlog::error("Failed to parse trade data: {} ({} bytes)", e.what(),
+                    member.size());
+    }
+  });
+  metrics::add(metrics::Counter::TradesDecoded, decoded);
+}
+
+template <typename Push>
+void decodePairs(const redisReply &reply, Push &&push) {
+  decodePairs(reply, std::forward<Push>(push),
+              [](std::string_view, double) { return false; });
+}
+
+} // namespace
+
+size_t replyTradeCount(const redisReply &reply) {
+  expectArray(reply);
+  return isPairArray(reply) ? reply.elements : reply.elements / 2;
+}
+
+std::optional<double> replyLastScore(const redisReply &reply) {
+  const size_t count = replyTradeCount(reply);
+  if (count == 0) {
+    return std::nullopt;
+  }
+  if (isPairArray(reply)) {
+    return scoreOf(*reply.element[count - 1]->element[1]);
+  }
+  return scoreOf(*reply.element[reply.elements - 1]);
+}
+
+size_t replyTrailingTies(const redisReply &reply) {
+  const size_t count = replyTradeCount(reply);
+  const bool pairs = isPairArray(reply);
+  const auto score = [&](size_t i) {
+    return pairs ? scoreOf(*reply.element[i]->element[1])
+                 : scoreOf(*reply.element[2 * i + 1]);
+  };
+  size_t ties = 0;
+  if (count > 0) {
+    const double last = score(count - 1);
+    while (ties < count && score(count - 1 - ties) == last)
+      ++ties;
+  }
+  return ties;
+}
+
+uint64_t memberHash(std::string_view member) {
+  return std::hash<std::string_view>{}(member);
+}
+
+std::vector<uint64_t> replyTrailingMembers(const redisReply &reply) {
+  const size_t count = replyTradeCount(reply);
+  const size_t ties = replyTrailingTies(reply);
+  const bool pairs = isPairArray(reply);
+  std::vector<uint64_t> members;
+  members.reserve(ties);
+  for (size_t i = count - ties; i < count; ++i) {
+    members.push_back(memberHash(
+        stringOf(pairs ? *reply.element[i]->element[0] : *reply.element[2 * i])));
+  }
+  return members;
+}
+
+void appendReplyTrades(const redisReply &reply, TradeColumns &columns) {
+  columns.reserve(columns.size() + replyTradeCount(reply));
+  decodePairs(reply, [&columns](double score, const TradeFields &fields) {
+    columns.push_back(toMicros(scoreToTimePoint(score)),
+                      fields.market_cap_sol, fields.sol_amount);
+  });
+}
+
+void appendReplyTrades(const redisReply &reply, std::vector<Trade> &trades) {
+  trades.reserve(trades.size() + replyTradeCount(reply));
+  decodePairs(reply, [&trades](double score, const TradeFields &fields) {
+    // Score is the timestamp in seconds, kept to the microsecond
+    trades.push_back(
+        {scoreToTimePoint(score), fields.market_cap_sol, fields.sol_amount});
+  });
+}
+
+void appendReplyTrades(const redisReply &reply, std::vector<Trade> &trades,
+                       double skip_score,
+                       std::span<const uint64_t> skip_members) {
+  trades.reserve(trades.size() + replyTradeCount(reply));
+  decodePairs(
+      reply,
+      [&trades](double score, const TradeFields &fields) {
+        trades.push_back({scoreToTimePoint(score), fields.market_cap_sol,
+                          fields.sol_amount});
+      },
+      [&](std::string_view member, double score) {
+        return score == skip_score &&
+               std::find(skip_members.begin(), skip_members.end(),
+                         memberHash(member)) != skip_members.end();
+      });
+}
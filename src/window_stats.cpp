@@ -0,0 +1,188 @@
+#include "window_stats.hpp"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include "simd_kernels.hpp"
+
+namespace {
+
+// Thread-local storage for temporary calculations
+thread_local std::vector<double> price_changes;
+thread_local std::vector<double> volume_changes;
+
+int64_t windowStart(int64_t analysis_start_us, int64_t current_us,
+                    int max_detection_time) {
+  // Calculate elapsed whole seconds since analysis started (truncating, as
+  // duration_cast<seconds> does)
+  const int64_t elapsed_seconds =
+      (current_us - analysis_start_us) / MICROS_PER_SECOND;
+
+  // Window starts at 10 seconds and expands up to max_detection_time (60
+  // seconds)
+  const int64_t window_size = std::min<int64_t>(
+      std::max<int64_t>(10, elapsed_seconds), max_detection_time);
+
+  return current_us - window_size * MICROS_PER_SECOND;
+}
+
+// Fixed point at 2^-32 SOL (below one lamport) per unit. Changes are
+// capped at 2^31 SOL, more than the whole supply, so one fits an int64
+// and 2^64 of them fit the sum; NaN takes the cap too. Integer adds and
+// subtracts are exact, so the sum is the same in whatever order trades
+// enter and leave the window.
+constexpr double VOLUME_UNITS_PER_SOL = 4294967296.0;
+constexpr double MAX_VOLUME_CHANGE = 2147483648.0;
+
+int64_t volumeUnits(double change) {
+  const double capped = change < MAX_VOLUME_CHANGE ? change : MAX_VOLUME_CHANGE;
+  return static_cast<int64_t>(capped * VOLUME_UNITS_PER_SOL);
+}
+
+double volumeTrend(VolumeSum sum, size_t changes) {
+  return static_cast<double>(sum) / VOLUME_UNITS_PER_SOL /
+         static_cast<double>(changes);
+}
+
+double patternStrength(int consecutive_drops, size_t window_size,
+                       double volume_trend, double price_velocity) {
+  // Calculate pattern strength using explicit double version of cube root
+  const double strength_base =
+      (static_cast<double>(consecutive_drops) / window_size) *
+      (1.0 + std::min(volume_trend, 2.0)) * (1.0 + std::abs(price_velocity));
+
+  return std::pow(strength_base, 1.0 / 3.0);
+}
+
+} // namespace
+
+TradeSeries getRecentTrades(const TradeSeries &trades, int64_t analysis_start_us,
+                            int64_t current_us, int max_detection_time) {
+
+  const int64_t window_start =
+      windowStart(analysis_start_us, current_us, max_detection_time);
+
+  // Binary search the timestamp column only
+  const auto &timestamps = trades.timestamp_us;
+  auto start_it =
+      std::lower_bound(timestamps.begin(), timestamps.end(), window_start);
+  auto end_it = std::upper_bound(start_it, timestamps.end(), current_us);
+
+  return trades.subspan(start_it - timestamps.begin(), end_it - start_it);
+}
+
+WindowStats computeWindowStats(const TradeSeries &window_trades) {
+
+  WindowStats stats;
+  const size_t window_size = window_trades.size();
+  if (window_size <= 1)
+    return stats;
+
+  // Pre-size vectors to avoid reallocation
+  price_changes.resize(window_size - 1);
+  volume_changes.resize(window_size - 1);
+
+  const auto &kernels = simd::kernels();
+  kernels.deltas(window_trades.market_cap_sol.data(), window_size,
+                 price_changes.data());
+  kernels.abs_deltas(window_trades.sol_amount.data(), window_size,
+                     volume_changes.data());
+
+  // This matches Python's behavior of counting consecutive negative price
+  // changes
+  stats.consecutive_drops = std::count_if(
+      price_changes.rbegin(),
+      std::min(price_changes.rbegin() + 3, price_changes.rend()),
+      [](double change) { return change < 0; });
+
+  VolumeSum volume_sum = 0;
+  for (const double change : volume_changes)
+    volume_sum += volumeUnits(change);
+  stats.volume_trend = volumeTrend(volume_sum, volume_changes.size());
+
+  // The mean of the price changes, telescoped as SlidingWindowStats does;
+  // summing the changes would round differently
+  const auto &market_caps = window_trades.market_cap_sol;
+  stats.price_velocity = (market_caps[window_size - 1] - market_caps[0]) /
+                         static_cast<double>(window_size - 1);
+
+  stats.pattern_strength =
+      patternStrength(stats.consecutive_drops, window_size,
+                      stats.volume_trend, stats.price_velocity);
+
+  return stats;
+}
+
+void SlidingWindowStats::advance(const TradeSeries &trades,
+                                 int64_t analysis_start_us, int64_t current_us,
+                                 int max_detection_time) {
+
+  const int64_t window_start =
+      windowStart(analysis_start_us, current_us, max_detection_time);
+
+  const auto &timestamps = trades.timestamp_us;
+  const auto &amounts = trades.sol_amount;
+  auto volume_change = [&amounts](size_t j) {
+    return volumeUnits(std::abs(amounts[j] - amounts[j - 1]));
+  };
+
+  // Trades entering on the right (upper_bound of current_us)
+  while (end_ < timestamps.size() && timestamps[end_] <= current_us) {
+    if (end_ > begin_)
+      volume_change_sum_ += volume_change(end_);
+    ++end_;
+  }
+
+  // Trades leaving on the left (lower_bound of window_start)
+  while (begin_ < end_ && timestamps[begin_] < window_start) {
+    if (begin_ + 1 < end_)
+      volume_change_sum_ -= volume_change(begin_ + 1);
+    ++begin_;
+  }
+
+  // While elapsed time is between 10s and max_detection_time the window
+  // starts at analysis_start plus the sub-second part of the elapsed time,
+  // so the left edge can step back by up to one second's worth of trades
+  while (begin_ > 0 && timestamps[begin_ - 1] >= window_start) {
+    --begin_;
+    if (begin_ + 1 < end_)
+      volume_change_sum_ += volume_change(begin_ + 1);
+  }
+}
+
+void SlidingWindowStats::restore(const TradeSeries &trades, size_t begin,
+                                 size_t end) {
+  begin_ = begin;
+  end_ = end;
+  volume_change_sum_ = 0;
+  const auto &amounts = trades.sol_amount;
+  for (size_t j = begin + 1; j < end; ++j)
+    volume_change_sum_ += volumeUnits(std::abs(amounts[j] - amounts[j - 1]));
+}
+
+WindowStats SlidingWindowStats::stats(const TradeSeries &trades) const {
+  WindowStats stats;
+  const size_t window_size = end_ - begin_;
+  if (window_size <= 1)
+    return stats;
+
+  const auto &market_caps = trades.market_cap_sol;
+  const double num_changes = static_cast<double>(window_size - 1);
+
+  // Last up-to-three price changes inside the window
+  for (size_t j = end_ - 1; j > begin_ && j + 3 >= end_; --j) {
+    if (market_caps[j] - market_caps[j - 1] < 0)
+      ++stats.consecutive_drops;
+  }
+
+  stats.volume_trend = volumeTrend(volume_change_sum_, window_size - 1);
+
+  // Consecutive price changes telescope, so their sum is last - first
+  stats.price_velocity =
+      (market_caps[end_ - 1] - market_caps[begin_]) / num_changes;
+
+  stats.pattern_strength =
+      patternStrength(stats.consecutive_drops, window_size,
+                      stats.volume_trend, stats.price_velocity);
+
+  return stats;
+}
@@ -0,0 +1,35 @@
+#include "worker_arena.hpp"
+#include <algorithm>
+#include <bit>
+
+WorkerArena::WorkerArena(size_t initial_bytes)
+    : capacity_(std::bit_ceil(std::max<size_t>(initial_bytes, 1024))),
+      block_(std::make_unique_for_overwrite<std::byte[]>(capacity_)) {
+  resource_.emplace(block_.get(), capacity_, &spill_);
+}
+
+void WorkerArena::reset() {
+  const size_t spilled = spill_.bytes;
+  resource_->release();
+  spill_.bytes = 0;
+  if (spilled == 0) {
+    return;
+  }
+
+  // Room for everything the last unit used, rounded up so a slowly growing
+  // workload settles after a few resets
+  capacity_ = std::bit_ceil(capacity_ + spilled);
+  resource_.reset();
+  block_ = std::make_unique_for_overwrite<std::byte[]>(capacity_);
+  resource_.emplace(block_.get(), capacity_, &spill_);
+}
+
+void *WorkerArena::Spill::do_allocate(size_t bytes, size_t alignment) {
+  this->bytes += bytes;
+  return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+}
+
+void WorkerArena::Spill::do_deallocate(void *p, size_t bytes,
+                                       size_t alignment) {
+  std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+}
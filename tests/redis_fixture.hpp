@@ -0,0 +1,87 @@
+#pragma once
+#include <gtest/gtest.h>
+
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+#include <sw/redis++/redis++.h>
+
+#include "trade.hpp"
+
+// Base fixture for tests that need a local redis-server; point them
+// elsewhere with RUGPULL_TEST_REDIS=redis://host:port. Tests are skipped
+// when no server is reachable. Keys written through addTrades are deleted
+// again on teardown.
+class RedisTest : public ::testing::Test {
+protected:
+  static std::string redisUrl() {
+    const char *url = std::getenv("RUGPULL_TEST_REDIS");
+    return url ? url : "redis://localhost";
+  }
+
+  void SetUp() override {
+    redis_ = std::make_unique<sw::redis::Redis>(redisUrl());
+    try {
+      redis_->ping();
+    } catch (const sw::redis::Error &e) {
+      GTEST_SKIP() << "redis-server not reachable: " << e.what();
+    }
+  }
+
+  void TearDown() override {
+    if (!redis_)
+      return;
+    for (const auto &[key, count] : next_trade_) {
+      try {
+        redis_->del(key);
+      } catch (const sw::redis::Error &) {
+      }
+    }
+  }
+
+  // Appends count trades half a second apart with microsecond scores, as in
+  // docs/REDIS_SPEC.md
+  void addTrades(const std::string &key, size_t count, double market_cap) {
+    auto [it, inserted] = next_trade_.try_emplace(key, 0);
+    if (inserted)
+      redis_->del(key);
+    size_t &next = it->second;
+
+    std::vector<std::pair<std::string, double>> members;
+    for (size_t i = 0; i < count; ++i, ++next) {
+      const double score = 1739184338.6333098 + next * 0.5000013;
+      nlohmann::json record = {{"signature", "sig" + std::to_string(next)},
+                               {"mint", key.substr(key.find(':') + 1)},
+                               {"timestamp", score},
+                               {"marketCapSol", market_cap},
+                               {"solAmount", 0.5}};
+      members.emplace_back(record.dump(), score);
+    }
+    redis_->zadd(key, members.begin(), members.end());
+  }
+
+  // Writes the given trades, scored by their timestamps, replacing the key
+  void setTrades(const std::string &key, const std::vector<Trade> &trades) {
+    next_trade_[key] = 0;
+    redis_->del(key);
+    std::vector<std::pair<std::string, double>> members;
+    for (size_t i = 0; i < trades.size(); ++i) {
+      const double score =
+          static_cast<double>(toMicros(trades[i].timestamp)) / 1e6;
+      nlohmann::json record = {{"signature", "sig" + std::to_string(i)},
+                               {"mint", key.substr(key.find(':') + 1)},
+                               {"timestamp", score},
+                               {"marketCapSol", trades[i].market_cap_sol},
+                               {"solAmount", trades[i].sol_amount}};
+      members.emplace_back(record.dump(), score);
+    }
+    redis_->zadd(key, members.begin(), members.end());
+  }
+
+  std::unique_ptr<sw::redis::Redis> redis_;
+  std::unordered_map<std::string, size_t> next_trade_;
+};
@@ -0,0 +1,123 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "async_check_pool.hpp"
+#include "async_redis_client.hpp"
+#include "redis_fixture.hpp"
+
+namespace {
+
+using AsyncCheckPoolTest = RedisTest;
+
+// Counts finished checks and lets the test wait for an expected number
+struct Finished {
+  std::mutex mutex;
+  std::condition_variable done;
+  size_t count = 0;
+
+  void add() {
+    std::lock_guard lock(mutex);
+    ++count;
+    done.notify_all();
+  }
+
+  bool waitFor(size_t expected) {
+    std::unique_lock lock(mutex);
+    return done.wait_for(lock, std::chrono::seconds(30),
+                         [&] { return count >= expected; });
+  }
+};
+
+// Id of the thread that runs client's reply callbacks
+std::thread::id loopThread(AsyncRedisClient &client) {
+  Finished finished;
+  std::thread::id id;
+  client.command({"PING"}, [&](const redisReply *, std::string_view) {
+    id = std::this_thread::get_id();
+    finished.add();
+  });
+  EXPECT_TRUE(finished.waitFor(1));
+  return id;
+}
+
+} // namespace
+
+TEST_F(AsyncCheckPoolTest, ChecksTenThousandKeysOffTheLoopThread) {
+  const std::string rugged = "recent_trades:test_pool_rugged";
+  const std::string flat = "recent_trades:test_pool_flat";
+  addTrades(rugged, 20, 50.0);
+  addTrades(rugged, 3, 20.0);
+  addTrades(flat, 20, 50.0);
+
+  RedisClientOptions options;
+  options.pool_size = 2;
+  AsyncRedisClient client(redisUrl(), options);
+  const auto loop_thread = loopThread(client);
+
+  constexpr size_t CHECKS = 10'000;
+  Finished finished;
+  std::atomic<size_t> detections{0};
+  std::atomic<size_t> failures{0};
+  std::atomic<size_t> on_loop_thread{0};
+  {
+    AsyncCheckPool pool(4);
+    for (size_t i = 0; i < CHECKS; ++i) {
+      pool.check(client, i % 2 ? flat : rugged, DetectionParams{},
+                 [&](const KeyWorker::Check &check, std::string_view error) {
+                   if (std::this_thread::get_id() == loop_thread)
+                     ++on_loop_thread;
+                   if (!error.empty() || check.trade_count == 0)
+                     ++failures;
+                   else if (check.result.rug_pulled)
+                     ++detections;
+                   finished.add();
+                 });
+    }
+    ASSERT_TRUE(finished.waitFor(CHECKS));
+  }
+  EXPECT_EQ(failures, 0u);
+  EXPECT_EQ(on_loop_thread, 0u);
+  EXPECT_EQ(detections, CHECKS / 2);
+  EXPECT_EQ(client.pending(), 0u);
+}
+
+TEST_F(AsyncCheckPoolTest, ReportsMissingKeysAndErrorsPerCheck) {
+  const std::string good = "recent_trades:test_pool_good";
+  const std::string wrong = "recent_trades:test_pool_wrongtype";
+  addTrades(good, 5, 50.0);
+  redis_->del(wrong);
+  redis_->rpush(wrong, "not a sorted set");
+
+  AsyncRedisClient client(redisUrl());
+  std::string wrong_error;
+  size_t good_trades = 0;
+  size_t missing_trades = 1;
+  {
+    AsyncCheckPool pool(2);
+    pool.check(client, wrong, DetectionParams{},
+               [&](const KeyWorker::Check &, std::string_view error) {
+                 wrong_error = error;
+               });
+    pool.check(client, good, DetectionParams{},
+               [&](const KeyWorker::Check &check, std::string_view error) {
+                 EXPECT_TRUE(error.empty());
+                 good_trades = check.trade_count;
+               });
+    pool.check(client, "recent_trades:test_pool_missing", DetectionParams{},
+               [&](const KeyWorker::Check &check, std::string_view error) {
+                 EXPECT_TRUE(error.empty());
+                 missing_trades = check.trade_count;
+               });
+    // The destructor waits for all three
+  }
+  redis_->del(wrong);
+  EXPECT_NE(wrong_error.find("WRONGTYPE"), std::string::npos);
+  EXPECT_EQ(good_trades, 5u);
+  EXPECT_EQ(missing_trades, 0u);
+}
@@ -0,0 +1,123 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "async_redis_client.hpp"
+#include "key_worker.hpp"
+#include "redis_fixture.hpp"
+#include "trade_reply.hpp"
+
+namespace {
+
+using AsyncRedisClientTest = RedisTest;
+
+// Counts callbacks and lets the test wait for an expected number
+struct Completions {
+  std::mutex mutex;
+  std::condition_variable done;
+  size_t count = 0;
+
+  void add() {
+    std::lock_guard lock(mutex);
+    ++count;
+    done.notify_all();
+  }
+
+  bool waitFor(size_t expected) {
+    std::unique_lock lock(mutex);
+    return done.wait_for(lock, std::chrono::seconds(10),
+                         [&] { return count >= expected; });
+  }
+};
+
+} // namespace
+
+TEST_F(AsyncRedisClientTest, KeepsThousandsOfCommandsInFlight) {
+  const std::string rugged = "recent_trades:test_async_rugged";
+  const std::string flat = "recent_trades:test_async_flat";
+  addTrades(rugged, 20, 50.0);
+  addTrades(rugged, 3, 20.0);
+  addTrades(flat, 20, 50.0);
+
+  RedisClientOptions options;
+  options.pool_size = 2;
+  AsyncRedisClient client(redisUrl(), options);
+
+  // Far more commands than connections, all queued before any completes
+  constexpr size_t COMMANDS = 5000;
+  Completions completions;
+  std::atomic<size_t> detections{0};
+  std::atomic<size_t> failures{0};
+  for (size_t i = 0; i < COMMANDS; ++i) {
+    const auto &key = i % 2 ? flat : rugged;
+    client.command({"ZRANGE", key, "0", "-1", "WITHSCORES"},
+                   [&](const redisReply *reply, std::string_view error) {
+                     // Callbacks all run on the one loop thread
+                     thread_local KeyWorker worker;
+                     if (!reply || !error.empty()) {
+                       ++failures;
+                     } else if (worker.check(*reply, DetectionParams{})
+                                    .result.rug_pulled) {
+                       ++detections;
+                     }
+                     completions.add();
+                   });
+  }
+
+  ASSERT_TRUE(completions.waitFor(COMMANDS));
+  EXPECT_EQ(failures, 0u);
+  EXPECT_EQ(detections, COMMANDS / 2);
+  EXPECT_EQ(client.pending(), 0u);
+}
+
+TEST_F(AsyncRedisClientTest, ReportsRedisErrorsPerCommand) {
+  const std::string key = "recent_trades:test_async_error";
+  addTrades(key, 5, 50.0);
+
+  AsyncRedisClient client(redisUrl());
+  Completions completions;
+  std::string error_text;
+  size_t trades = 0;
+
+  // Wrong type for the key: an error reply, then the connection carries on
+  client.command({"LRANGE", key, "0", "-1"},
+                 [&](const redisReply *reply, std::string_view error) {
+                   EXPECT_EQ(reply, nullptr);
+                   error_text = error;
+                   completions.add();
+                 });
+  client.command({"ZRANGE", key, "0", "-1", "WITHSCORES"},
+                 [&](const redisReply *reply, std::string_view error) {
+                   EXPECT_TRUE(error.empty());
+                   if (reply)
+                     trades = replyTradeCount(*reply);
+                   completions.add();
+                 });
+
+  ASSERT_TRUE(completions.waitFor(2));
+  EXPECT_NE(error_text.find("WRONGTYPE"), std::string::npos);
+  EXPECT_EQ(trades, 5u);
+}
+
+TEST_F(AsyncRedisClientTest, ShutdownFailsOutstandingCommands) {
+  // Nothing to connect to: commands are still queued or connecting when the
+  // client goes away, and each callback runs exactly once
+  auto client = std::make_unique<AsyncRedisClient>("redis://127.0.0.1:1");
+  std::atomic<size_t> callbacks{0};
+  for (int i = 0; i < 100; ++i) {
+    client->command({"PING"},
+                    [&](const redisReply *reply, std::string_view error) {
+                      EXPECT_EQ(reply, nullptr);
+                      EXPECT_FALSE(error.empty());
+                      ++callbacks;
+                    });
+  }
+  client.reset();
+  EXPECT_EQ(callbacks, 100u);
+}
@@ -0,0 +1,226 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "bar_aggregator.hpp"
+#include "bar_detector.hpp"
+#include "batch_detector.hpp"
+#include "rug_pull_detector.hpp"
+#include "trade_generators.hpp"
+
+namespace {
+
+using namespace std::chrono_literals;
+
+// Base for hand-built series: a multiple of 15 seconds
+constexpr int64_t T0 = 1'739'184'330 * MICROS_PER_SECOND;
+
+TradeColumns toColumns(const std::vector<Trade> &trades) {
+  TradeColumns columns;
+  for (const auto &trade : trades)
+    columns.push_back(trade);
+  return columns;
+}
+
+// The same trades, one per second at 0.3s past, so each has a 1s bar
+std::vector<Trade> oneTradePerSecond(std::vector<Trade> trades) {
+  for (size_t i = 0; i < trades.size(); ++i)
+    trades[i].timestamp = fromMicros(T0 + static_cast<int64_t>(i) *
+                                              MICROS_PER_SECOND +
+                                     300'000);
+  return trades;
+}
+
+} // namespace
+
+TEST(BarBuilderTest, RollsTradesIntoEpochAlignedBars) {
+  BarBuilder builder(5s);
+  EXPECT_FALSE(builder.add(T0 + 1'000'000, 100.0, 1.0));
+  EXPECT_FALSE(builder.add(T0 + 2'000'000, 120.0, 2.0));
+  EXPECT_FALSE(builder.add(T0 + 3'000'000, 120.0, 0.5));
+  EXPECT_FALSE(builder.add(T0 + 4'999'999, 90.0, 1.5));
+  EXPECT_FALSE(builder.closeDue(T0 + 4'999'999));
+
+  // Skips the empty [5s, 10s) bucket
+  const auto bar = builder.add(T0 + 12'000'000, 95.0, 3.0);
+  ASSERT_TRUE(bar);
+  EXPECT_EQ(bar->start_us, T0);
+  EXPECT_EQ(bar->open_time_us, T0 + 1'000'000);
+  EXPECT_EQ(bar->high_time_us, T0 + 2'000'000);
+  EXPECT_EQ(bar->close_time_us, T0 + 4'999'999);
+  EXPECT_EQ(bar->open, 100.0);
+  EXPECT_EQ(bar->high, 120.0);
+  EXPECT_EQ(bar->low, 90.0);
+  EXPECT_EQ(bar->close, 90.0);
+  EXPECT_EQ(bar->volume, 5.0);
+  EXPECT_EQ(bar->trades, 4u);
+
+  EXPECT_EQ(builder.openBar().start_us, T0 + 10'000'000);
+  const auto due = builder.closeDue(T0 + 15'000'000);
+  ASSERT_TRUE(due);
+  EXPECT_EQ(due->trades, 1u);
+  EXPECT_FALSE(builder.hasOpenBar());
+  EXPECT_FALSE(builder.flush());
+
+  EXPECT_THROW(BarBuilder(0s), std::invalid_argument);
+}
+
+TEST(BarBuilderTest, CoarserResolutionsMergeFinerBars) {
+  const auto columns = toColumns(makeTrades(7, 3000, 0.5, false));
+  const auto trades = columns.view();
+
+  std::vector<std::vector<Bar>> bars(BAR_RESOLUTIONS.size());
+  MultiResolutionBars ladder;
+  ASSERT_EQ(ladder.levels(), 3u);
+  for (size_t i = 0; i < trades.size(); ++i)
+    ladder.add(trades.timestamp_us[i], trades.market_cap_sol[i],
+               trades.sol_amount[i],
+               [&bars](size_t level, const Bar &bar) {
+                 bars[level].push_back(bar);
+               });
+  ladder.closeDue(trades.timestamp_us.back() + 15 * MICROS_PER_SECOND,
+                  [&bars](size_t level, const Bar &bar) {
+                    bars[level].push_back(bar);
+                  });
+
+  for (size_t level = 0; level < bars.size(); ++level) {
+    const auto resolution = ladder.resolution(level);
+    SCOPED_TRACE(resolution.count());
+    EXPECT_EQ(bars[level].size(), aggregateBars(trades, resolution).size());
+    EXPECT_EQ(bars[level].size(), countBars(trades, resolution));
+  }
+
+  // Every 15s bar is its 1s bars folded together
+  const int64_t width = 15 * MICROS_PER_SECOND;
+  size_t fine = 0;
+  for (const auto &coarse : bars[2]) {
+    Bar merged = bars[0][fine];
+    uint32_t trades_seen = 0;
+    double volume = 0.0;
+    for (; fine < bars[0].size() &&
+           bars[0][fine].start_us < coarse.start_us + width;
+         ++fine) {
+      const auto &bar = bars[0][fine];
+      if (bar.high > merged.high) {
+        merged.high = bar.high;
+        merged.high_time_us = bar.high_time_us;
+      }
+      merged.low = std::min(merged.low, bar.low);
+      merged.close = bar.close;
+      merged.close_time_us = bar.close_time_us;
+      volume += bar.volume;
+      trades_seen += bar.trades;
+    }
+    EXPECT_EQ(coarse.open, merged.open);
+    EXPECT_EQ(coarse.high, merged.high);
+    EXPECT_EQ(coarse.high_time_us, merged.high_time_us);
+    EXPECT_EQ(coarse.low, merged.low);
+    EXPECT_EQ(coarse.close, merged.close);
+    EXPECT_EQ(coarse.close_time_us, merged.close_time_us);
+    EXPECT_DOUBLE_EQ(coarse.volume, volume);
+    EXPECT_EQ(coarse.trades, trades_seen);
+  }
+  EXPECT_EQ(fine, bars[0].size());
+}
+
+TEST(BarDetectorTest, OneTradePerBarMatchesPerTradeDetection) {
+  size_t detections = 0;
+  for (uint32_t seed = 0; seed < 12; ++seed) {
+    SCOPED_TRACE(seed);
+    const auto columns =
+        toColumns(oneTradePerSecond(makeTrades(seed, 400, 0.1 * (seed % 7),
+                                               false)));
+    const auto expected =
+        RugPullDetector::detect(columns.view(), DetectionParams{});
+    const auto actual =
+        BarDetector::detect(columns.view(), 1s, DetectionParams{});
+    ASSERT_EQ(actual.rug_pulled, expected.rug_pulled);
+    if (!expected.rug_pulled)
+      continue;
+    ++detections;
+    EXPECT_EQ(actual.timestamp, expected.timestamp);
+    EXPECT_EQ(actual.debug_info.trigger_type,
+              expected.debug_info.trigger_type);
+    EXPECT_EQ(actual.debug_info.confidence, expected.debug_info.confidence);
+  }
+  EXPECT_GT(detections, 0u);
+}
+
+TEST(BarDetectorTest, BusyMintCostsOneScorePerBarAndStaysBounded) {
+  // About 50 trades a second for 20 minutes, sideways
+  std::vector<Trade> trades;
+  std::mt19937 rng(3);
+  std::uniform_real_distribution<double> noise(-0.01, 0.01);
+  for (int64_t i = 0; i < 60'000; ++i) {
+    Trade trade;
+    trade.timestamp = fromMicros(T0 + i * 20'000);
+    trade.market_cap_sol = 100.0 * (1.0 + noise(rng));
+    trade.sol_amount = 1.0;
+    trades.push_back(trade);
+  }
+
+  BarDetector detector(1s);
+  size_t retained = 0;
+  for (const auto &trade : trades) {
+    EXPECT_FALSE(detector.addTrade(trade, DetectionParams{}).rug_pulled);
+    retained = std::max(retained, detector.retainedBars());
+  }
+  EXPECT_FALSE(detector.flush(DetectionParams{}).rug_pulled);
+  EXPECT_EQ(detector.closedBars(), 1200u);
+  EXPECT_LE(retained,
+            static_cast<size_t>(DetectionParams{}.max_detection_time) + 3);
+
+  // A crash after the last trade is scored once its bar is due
+  detector.addTrade(T0 + 1'200'000'000, 30.0, 1.0, DetectionParams{});
+  EXPECT_FALSE(detector.closeDue(T0 + 1'200'500'000, DetectionParams{})
+                   .rug_pulled);
+  const auto result =
+      detector.closeDue(T0 + 1'201'000'000, DetectionParams{});
+  ASSERT_TRUE(result.rug_pulled);
+  EXPECT_EQ(result.debug_info.trigger_type, "stop_loss");
+  EXPECT_EQ(result.timestamp, fromMicros(T0 + 1'200'000'000));
+}
+
+TEST(BarToleranceTest, ReportsAgreementWithPerTradeDetection) {
+  std::vector<TradeColumns> columns;
+  for (uint32_t seed = 0; seed < 40; ++seed)
+    columns.push_back(toColumns(makeTrades(seed, 800, 0.1 * (seed % 8),
+                                           seed % 2)));
+  std::vector<TradeSeries> mints;
+  for (const auto &mint : columns)
+    mints.push_back(mint.view());
+
+  const auto per_trade = detectSeries(mints, DetectionParams{}, 2);
+  for (const auto resolution : BAR_RESOLUTIONS) {
+    SCOPED_TRACE(resolution.count());
+    const auto on_bars =
+        detectSeriesOnBars(mints, resolution, DetectionParams{}, 2);
+    ASSERT_EQ(on_bars.size(), mints.size());
+    for (size_t i = 0; i < mints.size(); ++i) {
+      const auto one = BarDetector::detect(mints[i], resolution,
+                                           DetectionParams{});
+      EXPECT_EQ(on_bars[i].rug_pulled, one.rug_pulled);
+    }
+
+    const auto report =
+        compareBarDetection(mints, per_trade, on_bars, resolution);
+    EXPECT_EQ(report.mints, mints.size());
+    EXPECT_LE(report.both + report.trade_only + report.bar_only,
+              report.mints);
+    EXPECT_LE(report.same_trigger, report.both);
+    EXPECT_EQ(report.trades, 40u * 800u);
+    EXPECT_LT(report.bars, report.trades);
+    EXPECT_GT(report.both, 0u);
+    EXPECT_GE(report.agreement(), 0.8);
+    EXPECT_LE(report.mean_lag_s, report.max_lag_s);
+    EXPECT_LE(report.p95_lag_s, report.max_lag_s);
+  }
+
+  EXPECT_THROW(compareBarDetection(mints, per_trade, {}, 1s),
+               std::invalid_argument);
+}
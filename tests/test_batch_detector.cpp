@@ -0,0 +1,147 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "batch_detector.hpp"
+#include "parallel_chunks.hpp"
+#include "redis_fixture.hpp"
+#include "rug_pull_detector.hpp"
+#include "trade_generators.hpp"
+
+namespace {
+
+using BatchDetectorTest = RedisTest;
+
+} // namespace
+
+TEST_F(BatchDetectorTest, MatchesPerKeyDetectionInKeyOrder) {
+  // More keys than one pipeline chunk, a mix of rugged, flat and missing
+  std::vector<std::string> keys;
+  for (size_t i = 0; i < BATCH_CHUNK_SIZE + 10; ++i) {
+    keys.push_back("recent_trades:test_batch_" + std::to_string(i));
+    if (i % 7 == 3)
+      continue; // never written
+    addTrades(keys.back(), 20, 50.0);
+    if (i % 2 == 0)
+      addTrades(keys.back(), 3, 20.0);
+  }
+
+  RedisClient redis(redisUrl(), 4);
+  DetectionConfig config;
+  const auto detections = detectBatch(redis, keys, config, 4);
+  ASSERT_EQ(detections.size(), keys.size());
+
+  for (size_t i = 0; i < keys.size(); ++i) {
+    SCOPED_TRACE(keys[i]);
+    auto trades = redis.getTrades(keys[i]);
+    EXPECT_EQ(detections[i].trade_count, trades.size());
+
+    RugPullDetector detector;
+    for (auto &&trade : trades)
+      detector.addTrade(std::move(trade));
+    const auto expected = detector.processTrades(config);
+
+    EXPECT_EQ(detections[i].result.rug_pulled, expected.rug_pulled);
+    EXPECT_EQ(detections[i].result.timestamp, expected.timestamp);
+    EXPECT_EQ(detections[i].result.debug_info.trigger_type,
+              expected.debug_info.trigger_type);
+  }
+}
+
+TEST_F(BatchDetectorTest, AnErrorReplyLeavesOnlyItsOwnKeyEmpty) {
+  // A key of the wrong type in the middle of one pipeline chunk
+  std::vector<std::string> keys;
+  for (size_t i = 0; i < 9; ++i) {
+    keys.push_back("recent_trades:test_batch_error_" + std::to_string(i));
+    if (i != 4)
+      addTrades(keys.back(), 10 + i, 50.0);
+  }
+  redis_->del(keys[4]);
+  redis_->rpush(keys[4], "not a sorted set");
+
+  RedisClient redis(redisUrl());
+  const auto trades = redis.getTradesBatch(keys);
+  const auto detections = detectBatch(redis, keys, DetectionConfig{}, 2);
+  redis_->del(keys[4]);
+
+  ASSERT_EQ(trades.size(), keys.size());
+  ASSERT_EQ(detections.size(), keys.size());
+  for (size_t i = 0; i < keys.size(); ++i) {
+    SCOPED_TRACE(keys[i]);
+    const size_t expected = i == 4 ? 0 : 10 + i;
+    EXPECT_EQ(trades[i].size(), expected);
+    EXPECT_EQ(detections[i].trade_count, expected);
+  }
+}
+
+TEST(DetectSeriesTest, ScoresMintsSharingFlatColumns) {
+  // Mints back to back in one set of columns, as detect_batch gets them
+  // from Python, with an empty one in the middle
+  TradeColumns flat;
+  std::vector<size_t> offsets{0};
+  std::vector<std::vector<Trade>> mints;
+  for (uint32_t seed = 0; seed < 2 * BATCH_CHUNK_SIZE + 3; ++seed) {
+    mints.push_back(seed == 5 ? std::vector<Trade>{}
+                              : makeTrades(seed, 200, seed % 3 * 0.3, false));
+    for (const auto &trade : mints.back())
+      flat.push_back(trade);
+    offsets.push_back(flat.size());
+  }
+
+  std::vector<TradeSeries> series;
+  for (size_t i = 0; i + 1 < offsets.size(); ++i)
+    series.push_back(
+        flat.view().subspan(offsets[i], offsets[i + 1] - offsets[i]));
+  const auto results = detectSeries(series, DetectionConfig{}, 3);
+  ASSERT_EQ(results.size(), mints.size());
+
+  size_t detections = 0;
+  for (size_t i = 0; i < mints.size(); ++i) {
+    SCOPED_TRACE(testing::Message() << "mint " << i);
+    RugPullDetector detector;
+    for (auto trade : mints[i])
+      detector.addTrade(std::move(trade));
+    const auto expected = mints[i].empty()
+                              ? DetectionResult{}
+                              : detector.processTrades(DetectionConfig{});
+    ASSERT_EQ(results[i].rug_pulled, expected.rug_pulled);
+    if (!expected.rug_pulled)
+      continue;
+    ++detections;
+    EXPECT_EQ(results[i].timestamp, expected.timestamp);
+    EXPECT_EQ(results[i].debug_info.trigger_type,
+              expected.debug_info.trigger_type);
+  }
+  EXPECT_GT(detections, 0u);
+}
+
+TEST(ParallelChunksTest, CoversEveryIndexOnceWithPerThreadState) {
+  for (size_t count : {size_t{0}, size_t{1}, size_t{7}, size_t{8},
+                       size_t{8 * 5 + 3}}) {
+    for (size_t threads : {size_t{0}, size_t{1}, size_t{3}, size_t{64}}) {
+      SCOPED_TRACE(std::to_string(count) + " items, " +
+                   std::to_string(threads) + " threads");
+      std::vector<std::atomic<int>> visits(count);
+      std::atomic<size_t> chunks{0};
+      parallelChunks(count, 8, threads,
+                     [&, owner = std::thread::id{}](size_t begin,
+                                                   size_t end) mutable {
+                       // Each copy of the callable stays on one thread
+                       if (owner == std::thread::id{})
+                         owner = std::this_thread::get_id();
+                       EXPECT_EQ(owner, std::this_thread::get_id());
+                       EXPECT_LT(begin, end);
+                       EXPECT_LE(end - begin, 8u);
+                       ++chunks;
+                       for (size_t i = begin; i < end; ++i)
+                         ++visits[i];
+                     });
+      EXPECT_EQ(chunks, (count + 7) / 8);
+      for (size_t i = 0; i < count; ++i)
+        EXPECT_EQ(visits[i], 1) << i;
+    }
+  }
+}
@@ -0,0 +1,88 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "key_worker.hpp"
+#include "redis_client.hpp"
+#include "redis_fixture.hpp"
+#include "trade_generators.hpp"
+#include "trade_record.hpp"
+
+namespace {
+
+using BinaryRecordsTest = RedisTest;
+
+void expectSameTrades(const std::vector<Trade> &actual,
+                      const std::vector<Trade> &expected) {
+  ASSERT_EQ(actual.size(), expected.size());
+  for (size_t i = 0; i < expected.size(); ++i) {
+    EXPECT_EQ(actual[i].timestamp, expected[i].timestamp) << "trade " << i;
+    EXPECT_EQ(actual[i].market_cap_sol, expected[i].market_cap_sol)
+        << "trade " << i;
+    EXPECT_EQ(actual[i].sol_amount, expected[i].sol_amount) << "trade " << i;
+  }
+}
+
+} // namespace
+
+TEST_F(BinaryRecordsTest, ConversionPreservesWhatTheDetectorReads) {
+  RedisClient redis(redisUrl(), 2);
+  const std::string key = "recent_trades:test_binary_records";
+  setTrades(key, makeTrades(3, 2500, 0.7, false));
+
+  const auto before = redis.getTrades(key);
+  KeyWorker worker;
+  const auto full_before = worker.check(redis, key, DetectionParams{});
+  const auto windowed_before =
+      worker.checkWindowed(redis, key, DetectionParams{});
+  ASSERT_TRUE(full_before.result.rug_pulled);
+
+  const auto conversion = redis.convertToBinary(key);
+  EXPECT_EQ(conversion.converted, before.size());
+  EXPECT_EQ(conversion.skipped, 0u);
+  EXPECT_EQ(conversion.bytes_after, before.size() * TRADE_RECORD_SIZE);
+  EXPECT_LT(conversion.bytes_after, conversion.bytes_before);
+
+  std::vector<std::string> members;
+  redis_->zrange(key, 0, -1, std::back_inserter(members));
+  ASSERT_EQ(members.size(), before.size());
+  for (const auto &member : members)
+    EXPECT_TRUE(isTradeRecord(member));
+
+  expectSameTrades(redis.getTrades(key), before);
+  for (const auto &check :
+       {worker.check(redis, key, DetectionParams{}),
+        worker.checkWindowed(redis, key, DetectionParams{})}) {
+    EXPECT_EQ(check.result.rug_pulled, full_before.result.rug_pulled);
+    EXPECT_EQ(check.result.timestamp, full_before.result.timestamp);
+    EXPECT_EQ(check.result.timestamp, windowed_before.result.timestamp);
+  }
+
+  // Converting again is a no-op
+  const auto again = redis.convertToBinary(key);
+  EXPECT_EQ(again.converted, 0u);
+  EXPECT_EQ(again.already_binary, before.size());
+}
+
+TEST_F(BinaryRecordsTest, ReadsKeysMixingBothFormats) {
+  RedisClient redis(redisUrl(), 2);
+  const std::string key = "recent_trades:test_binary_mixed";
+  addTrades(key, 40, 120.0);
+  const auto before = redis.getTrades(key);
+
+  // Rewrite every other member, as a reader racing the converter would see
+  std::vector<std::pair<std::string, double>> members;
+  redis_->zrange(key, 0, -1, std::back_inserter(members));
+  for (size_t i = 0; i < members.size(); i += 2) {
+    const auto &[member, score] = members[i];
+    const auto fields = decodeTradeMember(member);
+    redis_->zrem(key, member);
+    redis_->zadd(key,
+                 encodeTradeRecord(toMicros(scoreToTimePoint(score)),
+                                   fields.market_cap_sol, fields.sol_amount),
+                 score);
+  }
+
+  expectSameTrades(redis.getTrades(key), before);
+}
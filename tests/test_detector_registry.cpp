@@ -0,0 +1,224 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "detector_registry.hpp"
+#include "rug_pull_detector.hpp"
+#include "trade_generators.hpp"
+
+namespace {
+
+using namespace std::chrono_literals;
+
+// Hours of sideways trading, then a crash: long enough for compaction to
+// drop most of the history before the detection fires
+std::vector<Trade> makeLongTrades(uint32_t seed, size_t count) {
+  std::mt19937 rng(seed);
+  std::uniform_real_distribution<double> noise(-0.01, 0.01);
+  std::uniform_real_distribution<double> amount(0.5, 1.5);
+  std::uniform_int_distribution<int64_t> gap_us(200'000, 2'000'000);
+
+  std::vector<Trade> trades;
+  auto timestamp = std::chrono::system_clock::from_time_t(1739184338);
+  for (size_t i = 0; i < count; ++i) {
+    const double level = i + 50 < count ? 1.0 : 0.4;
+    Trade trade;
+    trade.timestamp = timestamp;
+    trade.market_cap_sol = 100.0 * level * (1.0 + noise(rng));
+    trade.sol_amount = amount(rng);
+    trades.push_back(trade);
+    timestamp += std::chrono::microseconds(gap_us(rng));
+  }
+  return trades;
+}
+
+void expectSameResult(const DetectionResult &actual,
+                      const DetectionResult &expected) {
+  ASSERT_EQ(actual.rug_pulled, expected.rug_pulled);
+  if (!expected.rug_pulled)
+    return;
+  EXPECT_EQ(actual.timestamp, expected.timestamp);
+  EXPECT_EQ(actual.debug_info.trigger_type, expected.debug_info.trigger_type);
+  EXPECT_DOUBLE_EQ(actual.debug_info.drop_percentage,
+                   expected.debug_info.drop_percentage);
+  EXPECT_DOUBLE_EQ(actual.debug_info.confidence,
+                   expected.debug_info.confidence);
+}
+
+// Feed the same chunks to a RugPullDetector and to the registry
+void expectMatchesDetector(const std::vector<Trade> &trades,
+                           size_t chunk_size) {
+  const DetectionParams params;
+  DetectorRegistry registry;
+  RugPullDetector detector;
+  const std::span<const Trade> all(trades);
+
+  for (size_t begin = 0; begin < trades.size(); begin += chunk_size) {
+    const auto chunk =
+        all.subspan(begin, std::min(chunk_size, trades.size() - begin));
+    for (auto trade : chunk)
+      detector.addTrade(std::move(trade));
+    const auto expected = detector.processTrades(params);
+    const auto actual = registry.update("mint", chunk, 0.0, params);
+    expectSameResult(actual, expected);
+    if (expected.rug_pulled)
+      return;
+  }
+  FAIL() << "no detection";
+}
+
+TEST(DetectorRegistryTest, MatchesDetectorAcrossChunkSizes) {
+  for (uint32_t seed = 0; seed < 8; ++seed) {
+    const auto trades = makeTrades(seed, 400, 0.6, seed % 2 == 0);
+    for (size_t chunk_size : {1, 7, 64, 400}) {
+      SCOPED_TRACE(testing::Message()
+                   << "seed " << seed << " chunk " << chunk_size);
+      expectMatchesDetector(trades, chunk_size);
+    }
+  }
+}
+
+TEST(DetectorRegistryTest, CompactionKeepsOnlyTheWindowTail) {
+  const auto trades = makeLongTrades(3, 20'000);
+  for (size_t chunk_size : {1, 13, 500}) {
+    SCOPED_TRACE(testing::Message() << "chunk " << chunk_size);
+    expectMatchesDetector(trades, chunk_size);
+  }
+
+  // Without the crash at the end, only about two windows' worth of trades
+  // (at most ~300 at 0.2 s spacing over 61 s) stay resident
+  const std::span<const Trade> quiet(trades.data(), trades.size() - 60);
+  DetectorRegistry registry;
+  for (size_t begin = 0; begin < quiet.size(); begin += 10)
+    registry.update("mint", quiet.subspan(begin, 10), 0.0, DetectionParams{});
+  EXPECT_LE(registry.stats().trades, 700u);
+}
+
+TEST(DetectorRegistryTest, FindsEveryMintThroughGrowthAndErase) {
+  DetectorRegistry registry(RegistryOptions{.shard_count = 4});
+  const auto trades = makeTrades(1, 3, 0.0, false);
+  constexpr int MINTS = 5000;
+  for (int i = 0; i < MINTS; ++i)
+    registry.update("mint" + std::to_string(i), trades, i, DetectionParams{});
+  EXPECT_EQ(registry.size(), static_cast<size_t>(MINTS));
+
+  for (int i = 0; i < MINTS; i += 2)
+    EXPECT_TRUE(registry.erase("mint" + std::to_string(i)));
+  EXPECT_FALSE(registry.erase("mint0"));
+  EXPECT_EQ(registry.size(), static_cast<size_t>(MINTS / 2));
+
+  for (int i = 0; i < MINTS; ++i) {
+    const auto cursor = registry.cursor("mint" + std::to_string(i));
+    EXPECT_EQ(cursor.last_score, i % 2 ? static_cast<double>(i)
+                                       : MintCursor{}.last_score)
+        << i;
+  }
+}
+
+TEST(DetectorRegistryTest, ErasesMintsByPredicate) {
+  DetectorRegistry registry(RegistryOptions{.shard_count = 4});
+  const auto trades = makeTrades(1, 3, 0.0, false);
+  for (int i = 0; i < 1000; ++i)
+    registry.update("mint" + std::to_string(i), trades, i, DetectionParams{});
+
+  const auto odd = [](std::string_view mint) { return (mint.back() - '0') % 2; };
+  EXPECT_EQ(registry.eraseIf(odd), 500u);
+  EXPECT_EQ(registry.size(), 500u);
+  EXPECT_EQ(registry.eraseIf(odd), 0u);
+  EXPECT_EQ(registry.cursor("mint7").last_score, MintCursor{}.last_score);
+  EXPECT_EQ(registry.cursor("mint8").last_score, 8.0);
+}
+
+TEST(DetectorRegistryTest, ReportedMintKeepsVerdictAndDropsTrades) {
+  DetectorRegistry registry;
+  const auto trades = makeTrades(2, 400, 0.6, false);
+  ASSERT_TRUE(registry.update("mint", trades, 7.0, DetectionParams{}).rug_pulled);
+
+  EXPECT_TRUE(registry.cursor("mint").reported);
+  EXPECT_EQ(registry.stats().trades, 0u);
+  EXPECT_FALSE(registry.update("mint", trades, 8.0, DetectionParams{}).rug_pulled);
+  EXPECT_EQ(registry.cursor("mint").last_score, 8.0);
+}
+
+TEST(DetectorRegistryTest, CursorKeepsMembersAtTheLastScore) {
+  DetectorRegistry registry;
+  const auto trades = makeTrades(3, 3, 0.0, false);
+  const std::vector<uint64_t> ties = {11, 12};
+  registry.update("mint", trades, 5.0, ties, DetectionParams{});
+  auto cursor = registry.cursor("mint");
+  EXPECT_EQ(cursor.last_score, 5.0);
+  EXPECT_TRUE(std::ranges::equal(cursor.lastMembers(), ties));
+
+  // Too many to remember: the next fetch falls back to an exclusive bound
+  const std::vector<uint64_t> many(MAX_CURSOR_TIES + 1, 7);
+  registry.update("mint", {}, 6.0, many, DetectionParams{});
+  EXPECT_TRUE(registry.cursor("mint").lastMembers().empty());
+}
+
+TEST(DetectorRegistryTest, EvictsIdleMints) {
+  DetectorRegistry registry(RegistryOptions{.idle_ttl = 1h});
+  const auto trades = makeTrades(4, 3, 0.0, false);
+  const auto start = DetectorRegistry::Clock::time_point{} + 100h;
+
+  registry.update("old", trades, 0.0, DetectionParams{}, start);
+  registry.update("new", trades, 0.0, DetectionParams{}, start + 30min);
+  EXPECT_EQ(registry.evictIdle(start + 50min), 0u);
+  EXPECT_EQ(registry.evictIdle(start + 61min), 1u);
+  EXPECT_EQ(registry.size(), 1u);
+  EXPECT_EQ(registry.stats().evicted_idle, 1u);
+
+  // Updating a shard also clears its idle mints
+  registry.update("new", trades, 0.0, DetectionParams{}, start + 3h);
+  EXPECT_EQ(registry.size(), 1u);
+}
+
+TEST(DetectorRegistryTest, StaysWithinMemoryBudget) {
+  constexpr size_t BUDGET = 256 * 1024;
+  DetectorRegistry registry(
+      RegistryOptions{.shard_count = 1, .memory_budget_bytes = BUDGET});
+  const auto trades = makeTrades(5, 200, 0.0, false);
+
+  for (int i = 0; i < 2000; ++i) {
+    registry.update("mint" + std::to_string(i), trades, 0.0,
+                    DetectionParams{});
+    ASSERT_LE(registry.stats().bytes, BUDGET) << i;
+  }
+  const auto stats = registry.stats();
+  EXPECT_GT(stats.evicted_budget, 0u);
+  EXPECT_LT(stats.mints, 2000u);
+  EXPECT_GT(stats.bytesPerMint(), 200.0 * 3 * sizeof(double));
+  // The most recent mint survives
+  EXPECT_EQ(registry.cursor("mint1999").last_score, 0.0);
+}
+
+TEST(DetectorRegistryTest, ReportedMintEvictedForBudgetStaysReported) {
+  DetectorRegistry registry(
+      RegistryOptions{.shard_count = 1, .memory_budget_bytes = 16 * 1024});
+  const auto crash = makeTrades(2, 400, 0.6, false);
+  ASSERT_TRUE(registry.update("mint", crash, 1.0, DetectionParams{}).rug_pulled);
+
+  const auto quiet = makeTrades(5, 200, 0.0, false);
+  for (int i = 0; i < 20; ++i) {
+    registry.update("other" + std::to_string(i), quiet, 0.0,
+                    DetectionParams{});
+  }
+  const auto stats = registry.stats();
+  ASSERT_GT(stats.evicted_budget, 0u);
+  EXPECT_EQ(stats.tombstones, 1u);
+
+  // Its feed is not fetched, and replaying it does not report it again
+  EXPECT_TRUE(registry.cursor("mint").reported);
+  EXPECT_FALSE(registry.update("mint", crash, 2.0, DetectionParams{}).rug_pulled);
+  EXPECT_EQ(registry.stats().tombstones, 1u);
+
+  // A deleted key is forgotten, tombstone included
+  EXPECT_TRUE(registry.erase("mint"));
+  EXPECT_FALSE(registry.cursor("mint").reported);
+  EXPECT_EQ(registry.stats().tombstones, 0u);
+}
+
+} // namespace
@@ -0,0 +1,225 @@
+#include <gtest/gtest.h>
+
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+
+#include <fmt/format.h>
+
+#include "key_worker.hpp"
+#include "rug_pull_detector.hpp"
+#include "trade_generators.hpp"
+#include "trade_reply.hpp"
+#include "worker_arena.hpp"
+
+// Counts heap allocations made by the current thread. Replacing the global
+// operator new applies to the whole test binary; it only counts.
+namespace {
+thread_local size_t g_allocations = 0;
+}
+
+void *operator new(std::size_t size) {
+  ++g_allocations;
+  if (void *p = std::malloc(size ? size : 1))
+    return p;
+  throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+
+namespace {
+
+// A hand-built ZRANGE ... WITHSCORES reply, in either protocol's shape
+class FakeReply {
+public:
+  FakeReply(const std::vector<Trade> &trades, bool resp3) {
+    for (const auto &trade : trades) {
+      addPair(fmt::format(R"({{"txType":"buy","solAmount":{},)"
+                          R"("marketCapSol":{},"pool":"pump"}})",
+                          trade.sol_amount, trade.market_cap_sol),
+              static_cast<double>(toMicros(trade.timestamp)) / 1e6);
+    }
+    build(resp3);
+  }
+
+  FakeReply(const std::vector<std::pair<std::string, double>> &pairs,
+            bool resp3) {
+    for (const auto &[member, score] : pairs)
+      addPair(member, score);
+    build(resp3);
+  }
+
+  const redisReply &get() const { return *root_; }
+
+private:
+  void addPair(std::string member, double score) {
+    members_.push_back(std::move(member));
+    scores_.push_back(score);
+  }
+
+  redisReply *node(int type) {
+    nodes_.push_back(std::make_unique<redisReply>());
+    redisReply *reply = nodes_.back().get();
+    *reply = redisReply{};
+    reply->type = type;
+    return reply;
+  }
+
+  redisReply *string(std::string &text) {
+    redisReply *reply = node(REDIS_REPLY_STRING);
+    reply->str = text.data();
+    reply->len = text.size();
+    return reply;
+  }
+
+  redisReply *array(std::vector<redisReply *> &children) {
+    redisReply *reply = node(REDIS_REPLY_ARRAY);
+    reply->elements = children.size();
+    reply->element = children.data();
+    return reply;
+  }
+
+  void build(bool resp3) {
+    score_text_.reserve(scores_.size());
+    pairs_.reserve(members_.size());
+    for (size_t i = 0; i < members_.size(); ++i) {
+      redisReply *member = string(members_[i]);
+      redisReply *score;
+      if (resp3) {
+        score = node(REDIS_REPLY_DOUBLE);
+        score->dval = scores_[i];
+      } else {
+        score_text_.push_back(fmt::format("{}", scores_[i]));
+        score = string(score_text_.back());
+      }
+      if (resp3) {
+        pairs_.push_back({member, score});
+        top_.push_back(array(pairs_.back()));
+      } else {
+        top_.push_back(member);
+        top_.push_back(score);
+      }
+    }
+    root_ = array(top_);
+  }
+
+  std::vector<std::string> members_;
+  std::vector<double> scores_;
+  std::vector<std::string> score_text_;
+  std::vector<std::unique_ptr<redisReply>> nodes_;
+  std::vector<std::vector<redisReply *>> pairs_;
+  std::vector<redisReply *> top_;
+  redisReply *root_ = nullptr;
+};
+
+TEST(TradeReplyTest, DecodesBothProtocolShapesAlike) {
+  const auto trades = makeTrades(1, 50, 0.5, false);
+  for (bool resp3 : {false, true}) {
+    SCOPED_TRACE(resp3 ? "RESP3" : "RESP2");
+    FakeReply reply(trades, resp3);
+    EXPECT_EQ(replyTradeCount(reply.get()), trades.size());
+    EXPECT_DOUBLE_EQ(*replyLastScore(reply.get()),
+                     static_cast<double>(toMicros(trades.back().timestamp)) /
+                         1e6);
+
+    TradeColumns columns;
+    appendReplyTrades(reply.get(), columns);
+    ASSERT_EQ(columns.size(), trades.size());
+    for (size_t i = 0; i < trades.size(); ++i) {
+      EXPECT_EQ(columns.timestamp_us(i), toMicros(trades[i].timestamp));
+      EXPECT_DOUBLE_EQ(columns.market_cap_sol(i), trades[i].market_cap_sol);
+      EXPECT_DOUBLE_EQ(columns.sol_amount(i), trades[i].sol_amount);
+    }
+  }
+}
+
+TEST(TradeReplyTest, SkipsMalformedMembersAndRejectsOtherReplies) {
+  FakeReply reply({{R"({"marketCapSol":10,"solAmount":1})", 1.0},
+                   {"not json", 2.0},
+                   {R"({"marketCapSol":11,"solAmount":2})", 3.0}},
+                  false);
+  std::vector<Trade> trades;
+  appendReplyTrades(reply.get(), trades);
+  ASSERT_EQ(trades.size(), 2u);
+  EXPECT_DOUBLE_EQ(trades[1].market_cap_sol, 11.0);
+
+  redisReply status{};
+  status.type = REDIS_REPLY_STATUS;
+  EXPECT_THROW(replyTradeCount(status), std::runtime_error);
+  EXPECT_FALSE(replyLastScore(FakeReply(
+                                  std::vector<std::pair<std::string, double>>{},
+                                  false)
+                                  .get()));
+}
+
+TEST(WorkerArenaTest, GrowsToCoverWhatSpilled) {
+  WorkerArena arena(1024);
+  EXPECT_EQ(arena.capacity(), 1024u);
+
+  EXPECT_NE(arena.resource()->allocate(4000), nullptr);
+  arena.reset();
+  EXPECT_GE(arena.capacity(), 4000u);
+
+  // Fits now: nothing reaches the heap
+  const size_t before = g_allocations;
+  EXPECT_NE(arena.resource()->allocate(4000), nullptr);
+  arena.reset();
+  EXPECT_EQ(g_allocations, before);
+}
+
+TEST(KeyWorkerTest, MatchesDetector) {
+  KeyWorker worker;
+  for (uint32_t seed = 0; seed < 6; ++seed) {
+    const auto trades = makeTrades(seed, 300, seed % 3 ? 0.6 : 0.0, true);
+    RugPullDetector detector;
+    for (auto trade : trades)
+      detector.addTrade(std::move(trade));
+    const auto expected = detector.processTrades(DetectionParams{});
+
+    const auto check = worker.check(FakeReply(trades, false).get(),
+                                    DetectionParams{});
+    EXPECT_EQ(check.trade_count, trades.size());
+    ASSERT_EQ(check.result.rug_pulled, expected.rug_pulled) << seed;
+    if (expected.rug_pulled) {
+      EXPECT_EQ(check.result.timestamp, expected.timestamp);
+      EXPECT_EQ(check.result.debug_info.trigger_type,
+                expected.debug_info.trigger_type);
+      EXPECT_DOUBLE_EQ(check.result.debug_info.confidence,
+                       expected.debug_info.confidence);
+    }
+  }
+}
+
+TEST(KeyWorkerTest, SteadyStateCheckDoesNotAllocate) {
+  // Keys of varying size, some detected (pattern and stop-loss), some not
+  std::vector<std::unique_ptr<FakeReply>> replies;
+  for (uint32_t seed = 0; seed < 8; ++seed) {
+    replies.push_back(std::make_unique<FakeReply>(
+        makeTrades(seed, 200 + 150 * seed, seed % 2 ? 0.6 : 0.0, false),
+        seed % 4 == 3));
+  }
+
+  // Start small so the arena has to grow during warm-up
+  KeyWorker worker(1024);
+  for (const auto &reply : replies)
+    worker.check(reply->get(), DetectionParams{});
+
+  constexpr size_t ROUNDS = 20;
+  std::vector<size_t> detected(ROUNDS, 0);
+  const size_t before = g_allocations;
+  for (size_t round = 0; round < ROUNDS; ++round) {
+    for (const auto &reply : replies)
+      detected[round] +=
+          worker.check(reply->get(), DetectionParams{}).result.rug_pulled;
+  }
+  const size_t allocations = g_allocations - before;
+
+  EXPECT_EQ(allocations, 0u);
+  EXPECT_GT(detected.front(), 0u);
+  EXPECT_LT(detected.front(), replies.size());
+}
+
+} // namespace
@@ -0,0 +1,80 @@
+#include <gtest/gtest.h>
+
+#include <iterator>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "live_monitor.hpp"
+#include "redis_fixture.hpp"
+
+namespace {
+
+class LiveMonitorTest : public RedisTest {
+protected:
+  const std::string key_ = "recent_trades:test_live_monitor";
+};
+
+} // namespace
+
+TEST_F(LiveMonitorTest, FetchesOnlyTradesNewerThanCursor) {
+  LiveMonitor monitor(redisUrl());
+
+  addTrades(key_, 20, 50.0);
+  EXPECT_EQ(monitor.onTradesAdded(key_).new_trades, 20u);
+  EXPECT_EQ(monitor.onTradesAdded(key_).new_trades, 0u);
+
+  addTrades(key_, 5, 50.0);
+  EXPECT_EQ(monitor.onTradesAdded(key_).new_trades, 5u);
+  EXPECT_EQ(monitor.trackedMints(), 1u);
+}
+
+TEST_F(LiveMonitorTest, FetchesTradesAddedLaterAtTheCursorScore) {
+  LiveMonitor monitor(redisUrl());
+  addTrades(key_, 10, 50.0);
+  EXPECT_EQ(monitor.onTradesAdded(key_).new_trades, 10u);
+
+  // Two more trades in the last trade's microsecond, in separate ZADDs,
+  // whose members sort before and after its own
+  std::vector<std::pair<std::string, double>> last;
+  redis_->zrange(key_, -1, -1, std::back_inserter(last));
+  ASSERT_EQ(last.size(), 1u);
+  const double score = last[0].second;
+  auto addAtScore = [&](double market_cap, const std::string &signature) {
+    const nlohmann::json record = {{"signature", signature},
+                                   {"mint", "test_live_monitor"},
+                                   {"timestamp", score},
+                                   {"marketCapSol", market_cap},
+                                   {"solAmount", 0.5}};
+    redis_->zadd(key_, record.dump(), score);
+  };
+  addAtScore(49.9, "tie_before");
+  EXPECT_EQ(monitor.onTradesAdded(key_).new_trades, 1u);
+  addAtScore(50.1, "tie_after");
+  EXPECT_EQ(monitor.onTradesAdded(key_).new_trades, 1u);
+  EXPECT_EQ(monitor.onTradesAdded(key_).new_trades, 0u);
+
+  addTrades(key_, 2, 50.0);
+  EXPECT_EQ(monitor.onTradesAdded(key_).new_trades, 2u);
+}
+
+TEST_F(LiveMonitorTest, ReportsDetectionOnceFromNewTrades) {
+  LiveMonitor monitor(redisUrl());
+
+  addTrades(key_, 30, 50.0);
+  auto update = monitor.onTradesAdded(key_);
+  EXPECT_FALSE(update.detection.has_value());
+
+  // A 60% drop from the peak trips the stop loss on the new trades alone
+  addTrades(key_, 3, 20.0);
+  update = monitor.onTradesAdded(key_);
+  EXPECT_EQ(update.new_trades, 3u);
+  ASSERT_TRUE(update.detection.has_value());
+  EXPECT_EQ(update.detection->debug_info.trigger_type, "stop_loss");
+
+  addTrades(key_, 3, 10.0);
+  EXPECT_FALSE(monitor.onTradesAdded(key_).detection.has_value());
+
+  monitor.onKeyRemoved(key_);
+  EXPECT_EQ(monitor.trackedMints(), 0u);
+}
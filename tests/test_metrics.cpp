@@ -0,0 +1,139 @@
+#include <gtest/gtest.h>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "metrics.hpp"
+#include "metrics_server.hpp"
+#include "trade_processor.hpp"
+
+namespace {
+
+using namespace std::chrono_literals;
+
+class MetricsTest : public ::testing::Test {
+protected:
+  void SetUp() override { metrics::reset(); }
+};
+
+std::string httpGet(uint16_t port, const std::string &path) {
+  const int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+  sockaddr_in address{};
+  address.sin_family = AF_INET;
+  address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  address.sin_port = htons(port);
+  if (::connect(fd, reinterpret_cast<sockaddr *>(&address),
+                sizeof(address)) != 0) {
+    ::close(fd);
+    return "";
+  }
+  const std::string request = "GET " + path + " HTTP/1.1\r\nHost: x\r\n\r\n";
+  ::send(fd, request.data(), request.size(), 0);
+
+  std::string response;
+  char buffer[4096];
+  ssize_t received;
+  while ((received = ::recv(fd, buffer, sizeof(buffer), 0)) > 0)
+    response.append(buffer, static_cast<size_t>(received));
+  ::close(fd);
+  return response;
+}
+
+} // namespace
+
+TEST(HistogramBucketsTest, KeepValuesWithinOneSixteenth) {
+  std::mt19937_64 rng(5);
+  for (int i = 0; i < 100000; ++i) {
+    const uint64_t value = rng() >> (rng() % 64);
+    const size_t index = metrics::bucketIndex(value);
+    ASSERT_LT(index, metrics::BUCKET_COUNT);
+    if (value >= (uint64_t{1} << metrics::MAX_VALUE_BITS))
+      continue; // clamped into the last bucket
+    const uint64_t upper = metrics::bucketUpperBound(index);
+    ASSERT_LE(value, upper);
+    if (index > 0) {
+      ASSERT_GT(value, metrics::bucketUpperBound(index - 1));
+    }
+    ASSERT_LE(upper - value, value / 16) << value;
+  }
+}
+
+TEST_F(MetricsTest, MergesThreadsIncludingExitedOnes) {
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([] {
+      for (int i = 1; i <= 1000; ++i) {
+        metrics::record(metrics::Stage::Detect, std::chrono::microseconds(i));
+        metrics::add(metrics::Counter::TradesDecoded, 2);
+      }
+    });
+  }
+  for (auto &thread : threads)
+    thread.join();
+
+  const auto snapshot = metrics::snapshot();
+  EXPECT_EQ(snapshot.counter(metrics::Counter::TradesDecoded), 8000u);
+  const auto &detect = snapshot.stage(metrics::Stage::Detect);
+  EXPECT_EQ(detect.count, 4000u);
+  EXPECT_EQ(detect.max_ns, 1'000'000u);
+  EXPECT_EQ(detect.sum_ns, 4u * 500'500'000u);
+  EXPECT_NEAR(static_cast<double>(detect.percentile(0.5)), 500e3, 500e3 / 16);
+  EXPECT_NEAR(static_cast<double>(detect.percentile(0.99)), 990e3, 990e3 / 16);
+  EXPECT_EQ(snapshot.stage(metrics::Stage::Decode).count, 0u);
+}
+
+TEST_F(MetricsTest, PrometheusHistogramIsCumulative) {
+  const std::chrono::nanoseconds durations[] = {500ns, 20us, 20us, 3ms, 2s};
+  for (auto duration : durations)
+    metrics::record(metrics::Stage::RedisFetch, duration);
+  metrics::add(metrics::Counter::Detections, 3);
+
+  const auto text = metrics::renderPrometheus(metrics::snapshot());
+  EXPECT_NE(text.find("rugpull_detections_total 3\n"), std::string::npos);
+  EXPECT_NE(text.find("rugpull_stage_seconds_bucket{stage=\"redis_fetch\","
+                      "le=\"1e-06\"} 1\n"),
+            std::string::npos);
+  EXPECT_NE(text.find("rugpull_stage_seconds_bucket{stage=\"redis_fetch\","
+                      "le=\"0.005\"} 4\n"),
+            std::string::npos);
+  EXPECT_NE(text.find("rugpull_stage_seconds_bucket{stage=\"redis_fetch\","
+                      "le=\"+Inf\"} 5\n"),
+            std::string::npos);
+  EXPECT_NE(text.find("rugpull_stage_seconds_count{stage=\"redis_fetch\"} 5\n"),
+            std::string::npos);
+}
+
+TEST_F(MetricsTest, TradeProcessorRecordsQueueWaitAndTasks) {
+  {
+    TradeProcessor processor(2, [](size_t, const std::string &) {
+      std::this_thread::sleep_for(100us);
+    });
+    for (int i = 0; i < 50; ++i)
+      processor.addTask("key");
+  }
+  const auto snapshot = metrics::snapshot();
+  EXPECT_EQ(snapshot.counter(metrics::Counter::TasksCompleted), 50u);
+  EXPECT_EQ(snapshot.stage(metrics::Stage::QueueWait).count, 50u);
+  EXPECT_EQ(snapshot.stage(metrics::Stage::Task).count, 50u);
+  EXPECT_GE(snapshot.stage(metrics::Stage::Task).percentile(0.5), 100'000u);
+}
+
+TEST_F(MetricsTest, ServerAnswersScrapes) {
+  metrics::add(metrics::Counter::KeysFetched, 7);
+  MetricsServer server(0);
+  ASSERT_NE(server.port(), 0);
+
+  const auto response = httpGet(server.port(), "/metrics");
+  EXPECT_TRUE(response.starts_with("HTTP/1.1 200 OK\r\n")) << response;
+  EXPECT_NE(response.find("rugpull_keys_fetched_total 7\n"), std::string::npos);
+
+  EXPECT_TRUE(httpGet(server.port(), "/").starts_with("HTTP/1.1 404"));
+}
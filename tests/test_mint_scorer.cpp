@@ -0,0 +1,181 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "mint_scorer.hpp"
+#include "parameter_sweep.hpp"
+#include "rug_pull_detector.hpp"
+#include "simd_kernels.hpp"
+#include "trade_generators.hpp"
+
+namespace {
+
+// Random rows around the default thresholds, with NaN patterns and exact
+// threshold hits mixed in
+MintFeatureColumns randomFeatures(uint32_t seed, size_t count) {
+  const DetectionParams config;
+  std::mt19937 rng(seed);
+  std::uniform_real_distribution<double> drop(0.0, 0.6);
+  std::uniform_int_distribution<int> seconds(0, 200);
+  std::uniform_real_distribution<double> signal(0.0, 2.0);
+  std::uniform_int_distribution<int> pick(0, 9);
+
+  MintFeatureColumns features;
+  features.resize(count);
+  for (size_t i = 0; i < count; ++i) {
+    double pattern = signal(rng);
+    double volume = signal(rng);
+    double d = drop(rng);
+    if (pick(rng) == 0) {
+      pattern = std::numeric_limits<double>::quiet_NaN();
+      volume = std::numeric_limits<double>::quiet_NaN();
+    }
+    if (pick(rng) == 0)
+      d = config.stop_loss_threshold;
+    if (pick(rng) == 0)
+      pattern = config.pattern_strength_threshold;
+    features.set(i, d, seconds(rng), pattern, volume);
+  }
+  return features;
+}
+
+} // namespace
+
+TEST(MintScorerTest, MatchesTheDetectorRulePerRow) {
+  const DetectionParams config;
+  const auto features = randomFeatures(3, 1003);
+  MintScores scores;
+  scoreMints(features, config, scores);
+  ASSERT_EQ(scores.size(), features.size());
+
+  size_t by_trigger[3] = {};
+  for (size_t i = 0; i < features.size(); ++i) {
+    SCOPED_TRACE(testing::Message() << "row " << i);
+    ++by_trigger[static_cast<size_t>(scores.trigger[i])];
+    if (features.drop[i] >= config.stop_loss_threshold) {
+      EXPECT_EQ(scores.trigger[i], SweepTrigger::StopLoss);
+      EXPECT_EQ(scores.confidence[i], 1.0);
+      continue;
+    }
+    const double expected = RugPullDetector::calculateConfidence(
+        features.drop[i], features.time_since_peak[i],
+        features.pattern_strength[i], features.volume_trend[i], config);
+    EXPECT_DOUBLE_EQ(scores.confidence[i], expected);
+    const bool fires = !std::isnan(features.pattern_strength[i]) &&
+                       expected >= config.min_confidence_score;
+    EXPECT_EQ(scores.trigger[i],
+              fires ? SweepTrigger::Pattern : SweepTrigger::None);
+  }
+  for (size_t count : by_trigger)
+    EXPECT_GT(count, 0u);
+
+  // Reused output, fewer rows
+  scoreMints(randomFeatures(4, 5), config, scores);
+  EXPECT_EQ(scores.size(), 5u);
+}
+
+TEST(MintScorerTest, ScoresARangeOfRows) {
+  const DetectionParams config;
+  const auto features = randomFeatures(5, 101);
+  MintScores all;
+  scoreMints(features, config, all);
+
+  // Odd offsets and lengths, so the vector body and tail both see them
+  MintScores range;
+  scoreMints(features, 13, 50, config, range);
+  ASSERT_EQ(range.size(), 37u);
+  for (size_t i = 0; i < range.size(); ++i) {
+    EXPECT_EQ(range.confidence[i], all.confidence[13 + i]) << i;
+    EXPECT_EQ(range.trigger[i], all.trigger[13 + i]) << i;
+  }
+
+  scoreMints(features, 7, 7, config, range);
+  EXPECT_EQ(range.size(), 0u);
+  EXPECT_THROW(scoreMints(features, 50, 13, config, range),
+               std::invalid_argument);
+  EXPECT_THROW(scoreMints(features, 0, 102, config, range),
+               std::invalid_argument);
+}
+
+TEST(MintScorerTest, FirstFiringRowIsTheSweepHit) {
+  // Scoring each trade of a mint as its own row must flag the same first
+  // trade as evaluateFeatures
+  DetectionParams config;
+  config.min_confidence_score = 0.55;
+  size_t detections = 0;
+  for (double depth : {0.05, 0.3, 0.6}) {
+    for (uint32_t seed = 1; seed <= 4; ++seed) {
+      TradeColumns columns;
+      for (const auto &trade : makeTrades(seed, 800, depth, false))
+        columns.push_back(trade);
+      const auto trade_features =
+          computeTradeFeatures(columns.view(), config.max_detection_time);
+      const auto hit = evaluateFeatures(trade_features, config);
+
+      MintFeatureColumns rows;
+      rows.resize(trade_features.size());
+      for (size_t i = 0; i < trade_features.size(); ++i)
+        rows.set(i, trade_features.drop[i],
+                 static_cast<double>(trade_features.time_since_peak[i]),
+                 trade_features.pattern_strength[i],
+                 trade_features.volume_trend[i]);
+      MintScores scores;
+      scoreMints(rows, config, scores);
+
+      size_t first = 0;
+      while (first < scores.size() &&
+             scores.trigger[first] == SweepTrigger::None)
+        ++first;
+
+      SCOPED_TRACE(testing::Message() << "depth " << depth << " seed "
+                                      << seed);
+      ASSERT_EQ(first < scores.size(), hit.detected());
+      if (!hit.detected())
+        continue;
+      ++detections;
+      EXPECT_EQ(scores.trigger[first], hit.trigger);
+      EXPECT_EQ(trade_features.timestamp_us[first], hit.timestamp_us);
+      EXPECT_DOUBLE_EQ(scores.confidence[first], hit.confidence);
+    }
+  }
+  EXPECT_GT(detections, 0u);
+}
+
+TEST(MintScorerTest, Avx2MatchesScalar) {
+  const auto *avx2 = simd::avx2Kernels();
+  if (!avx2)
+    GTEST_SKIP() << "CPU has no AVX2";
+  const auto &scalar = simd::scalarKernels();
+
+  const DetectionParams config;
+  const simd::ScoreThresholds thresholds{
+      config.peak_drop_threshold,
+      static_cast<double>(config.time_from_peak_threshold),
+      config.volume_spike_threshold,
+      config.pattern_strength_threshold,
+      config.min_confidence_score,
+      config.stop_loss_threshold};
+  // Odd sizes exercise the tail loop
+  for (size_t n : {0u, 1u, 3u, 4u, 7u, 64u, 1001u}) {
+    const auto features = randomFeatures(static_cast<uint32_t>(n), n);
+    const simd::MintScoreInputs in{
+        features.drop.data(), features.time_since_peak.data(),
+        features.pattern_strength.data(), features.volume_trend.data(), n};
+    std::vector<double> expected_confidence(n), actual_confidence(n);
+    std::vector<uint8_t> expected_trigger(n), actual_trigger(n);
+
+    scalar.score_mints(in, thresholds, expected_confidence.data(),
+                       expected_trigger.data());
+    avx2->score_mints(in, thresholds, actual_confidence.data(),
+                      actual_trigger.data());
+    // The scalar loop may be compiled with fused multiply-adds
+    for (size_t i = 0; i < n; ++i)
+      EXPECT_DOUBLE_EQ(expected_confidence[i], actual_confidence[i]) << i;
+    EXPECT_EQ(expected_trigger, actual_trigger);
+  }
+}
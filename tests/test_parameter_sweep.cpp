@@ -0,0 +1,90 @@
+#include <gtest/gtest.h>
+
+#include <random>
+#include <vector>
+
+#include "parameter_sweep.hpp"
+#include "rug_pull_detector.hpp"
+#include "trade_generators.hpp"
+
+namespace {
+
+std::vector<DetectionParams> randomGrid(uint32_t seed, size_t count) {
+  std::mt19937 rng(seed);
+  std::uniform_real_distribution<double> drop(0.02, 0.3);
+  std::uniform_int_distribution<int> seconds(20, 200);
+  std::uniform_real_distribution<double> volume(0.5, 2.0);
+  std::uniform_real_distribution<double> confidence(0.2, 0.9);
+  std::uniform_real_distribution<double> pattern(0.1, 0.8);
+  std::uniform_real_distribution<double> stop_loss(0.1, 0.7);
+  std::uniform_int_distribution<int> detection_time(15, 90);
+
+  std::vector<DetectionParams> grid(count);
+  for (auto &config : grid) {
+    config.peak_drop_threshold = drop(rng);
+    config.time_from_peak_threshold = seconds(rng);
+    config.volume_spike_threshold = volume(rng);
+    config.min_confidence_score = confidence(rng);
+    config.pattern_strength_threshold = pattern(rng);
+    config.stop_loss_threshold = stop_loss(rng);
+    // A few distinct window lengths so features are grouped
+    config.max_detection_time = detection_time(rng) / 15 * 15;
+  }
+  grid.front() = DetectionParams{};
+  return grid;
+}
+
+} // namespace
+
+TEST(ParameterSweepTest, MatchesDetectorForEveryConfigAndMint) {
+  std::vector<TradeColumns> corpus;
+  for (bool whole_seconds : {true, false}) {
+    for (double depth : {0.05, 0.3, 0.6}) {
+      for (uint32_t seed = 1; seed <= 4; ++seed) {
+        TradeColumns columns;
+        for (const auto &trade : makeTrades(seed, 800, depth, whole_seconds))
+          columns.push_back(trade);
+        corpus.push_back(std::move(columns));
+      }
+    }
+  }
+  corpus.emplace_back(); // a mint with no trades
+
+  std::vector<TradeSeries> mints;
+  for (const auto &columns : corpus)
+    mints.push_back(columns.view());
+  const auto grid = randomGrid(7, 60);
+
+  const auto results = runParameterSweep(mints, grid, 3);
+  ASSERT_EQ(results.configCount(), grid.size());
+  ASSERT_EQ(results.mintCount(), mints.size());
+
+  size_t by_trigger[3] = {};
+  for (size_t c = 0; c < grid.size(); ++c) {
+    for (size_t m = 0; m < mints.size(); ++m) {
+      RugPullDetector detector;
+      for (size_t i = 0; i < corpus[m].size(); ++i) {
+        detector.addTrade({fromMicros(corpus[m].timestamp_us(i)),
+                           corpus[m].market_cap_sol(i),
+                           corpus[m].sol_amount(i)});
+      }
+      const auto expected = detector.processTrades(grid[c]);
+      const auto &hit = results.at(c, m);
+
+      SCOPED_TRACE(testing::Message() << "config " << c << " mint " << m);
+      ASSERT_EQ(expected.rug_pulled, hit.detected());
+      ++by_trigger[static_cast<size_t>(hit.trigger)];
+      if (!hit.detected())
+        continue;
+      EXPECT_EQ(expected.debug_info.trigger_type, triggerName(hit.trigger));
+      EXPECT_EQ(toMicros(*expected.timestamp), hit.timestamp_us);
+      EXPECT_DOUBLE_EQ(expected.debug_info.confidence, hit.confidence);
+      EXPECT_DOUBLE_EQ(expected.debug_info.drop_percentage,
+                       hit.drop_percentage);
+    }
+  }
+  // Both trigger paths and misses have to show up to mean anything
+  EXPECT_GT(by_trigger[static_cast<size_t>(SweepTrigger::None)], 0u);
+  EXPECT_GT(by_trigger[static_cast<size_t>(SweepTrigger::StopLoss)], 0u);
+  EXPECT_GT(by_trigger[static_cast<size_t>(SweepTrigger::Pattern)], 0u);
+}
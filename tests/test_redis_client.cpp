@@ -0,0 +1,59 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <memory>
+
+#include "metrics.hpp"
+#include "redis_client.hpp"
+
+namespace {
+
+// Nothing listens on port 1, so any connection attempt is refused
+const std::string UNREACHABLE_URL = "tcp://127.0.0.1:1";
+
+// The registry is process-wide; put its options back afterwards
+class RedisClientRegistryTest : public ::testing::Test {
+protected:
+  void SetUp() override { saved_ = registry().options(); }
+  void TearDown() override { registry().configure(saved_); }
+
+  static RedisClientRegistry &registry() {
+    return RedisClientRegistry::instance();
+  }
+
+  RedisClientOptions saved_;
+};
+
+} // namespace
+
+TEST_F(RedisClientRegistryTest, SharesOneClientPerUrlAndOptions) {
+  RedisClientOptions options;
+  options.pool_size = 2;
+  registry().configure(options);
+
+  const auto first = registry().get(UNREACHABLE_URL);
+  EXPECT_EQ(registry().get(UNREACHABLE_URL), first);
+  EXPECT_NE(registry().get("tcp://127.0.0.1:2"), first);
+
+  // New options mean a new client; holders of the old one keep it
+  options.pool_size = 3;
+  registry().configure(options);
+  const auto second = registry().get(UNREACHABLE_URL);
+  EXPECT_NE(second, first);
+  EXPECT_EQ(registry().get(UNREACHABLE_URL), second);
+  EXPECT_EQ(registry().options().pool_size, 3u);
+}
+
+TEST_F(RedisClientRegistryTest, ConnectsOnFirstUse) {
+  RedisClientOptions options;
+  options.connect_timeout = std::chrono::milliseconds(200);
+  registry().configure(options);
+
+  // Creating the client opens nothing, so an unreachable server only
+  // shows once a command is sent
+  std::shared_ptr<RedisClient> client;
+  ASSERT_NO_THROW(client = registry().get(UNREACHABLE_URL));
+  const auto errors = metrics::snapshot().counter(metrics::Counter::RedisErrors);
+  EXPECT_TRUE(client->getTrades("recent_trades:missing").empty());
+  EXPECT_GT(metrics::snapshot().counter(metrics::Counter::RedisErrors), errors);
+}
@@ -0,0 +1,159 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <numeric>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "detector_registry.hpp"
+#include "registry_snapshot.hpp"
+#include "trade_generators.hpp"
+
+namespace {
+
+using namespace std::chrono_literals;
+
+class RegistrySnapshotTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    path_ = ::testing::TempDir() + "registry_snapshot_test_" +
+            ::testing::UnitTest::GetInstance()->current_test_info()->name() +
+            ".bin";
+  }
+  void TearDown() override { std::remove(path_.c_str()); }
+
+  std::string path_;
+};
+
+const int WINDOW = DetectionParams{}.max_detection_time;
+
+// Feed trades[begin, end) in chunks of 17, the score being the end index
+// and between none and MAX_CURSOR_TIES members tied at it
+void feed(DetectorRegistry &registry, const std::string &mint,
+          std::span<const Trade> trades, size_t begin, size_t end,
+          std::vector<DetectionResult> &results) {
+  for (size_t i = begin; i < end; i += 17) {
+    const size_t stop = std::min(end, i + 17);
+    std::vector<uint64_t> ties(stop % (MAX_CURSOR_TIES + 1));
+    std::iota(ties.begin(), ties.end(), stop * 1000);
+    results.push_back(registry.update(mint, trades.subspan(i, stop - i),
+                                      static_cast<double>(stop), ties,
+                                      DetectionParams{}));
+  }
+}
+
+} // namespace
+
+TEST_F(RegistrySnapshotTest, RestartResumesWhereTheFeedLeftOff) {
+  // Mints of every shape, interrupted somewhere in their history
+  std::vector<std::vector<Trade>> mints;
+  for (uint32_t seed = 0; seed < 24; ++seed)
+    mints.push_back(seed % 3 == 0 ? makeTrades(seed, 2000, 0.0, false)
+                                  : makeTrades(seed, 600, 0.6, seed % 2));
+
+  DetectorRegistry before(RegistryOptions{.shard_count = 4});
+  std::vector<size_t> split(mints.size());
+  for (size_t m = 0; m < mints.size(); ++m) {
+    split[m] = mints[m].size() * (m % 5 + 1) / 6;
+    std::vector<DetectionResult> ignored;
+    feed(before, "mint" + std::to_string(m), mints[m], 0, split[m], ignored);
+  }
+  const auto saved = before.stats();
+  EXPECT_EQ(saveRegistrySnapshot(before, path_, WINDOW), mints.size());
+  EXPECT_FALSE(std::filesystem::exists(path_ + ".tmp"));
+
+  // A different shard count is fine
+  DetectorRegistry after(RegistryOptions{.shard_count = 16});
+  const auto load = loadRegistrySnapshot(after, path_, WINDOW);
+  EXPECT_EQ(load.restored, mints.size());
+  EXPECT_EQ(load.skipped, 0u);
+  EXPECT_EQ(load.trades, saved.trades);
+  EXPECT_EQ(after.stats().trades, saved.trades);
+
+  size_t detections = 0;
+  for (size_t m = 0; m < mints.size(); ++m) {
+    const auto mint = "mint" + std::to_string(m);
+    SCOPED_TRACE(mint);
+    const auto cursor = after.cursor(mint);
+    EXPECT_EQ(cursor.last_score, before.cursor(mint).last_score);
+    EXPECT_TRUE(std::ranges::equal(cursor.lastMembers(),
+                                   before.cursor(mint).lastMembers()));
+    EXPECT_EQ(cursor.reported, before.cursor(mint).reported);
+
+    // Only the trades after the cursor are fed, as LiveMonitor would fetch
+    std::vector<DetectionResult> expected, actual;
+    feed(before, mint, mints[m], split[m], mints[m].size(), expected);
+    feed(after, mint, mints[m], split[m], mints[m].size(), actual);
+    ASSERT_EQ(expected.size(), actual.size());
+    for (size_t i = 0; i < expected.size(); ++i) {
+      ASSERT_EQ(expected[i].rug_pulled, actual[i].rug_pulled) << i;
+      if (!expected[i].rug_pulled)
+        continue;
+      ++detections;
+      EXPECT_EQ(expected[i].timestamp, actual[i].timestamp);
+      EXPECT_EQ(expected[i].debug_info.trigger_type,
+                actual[i].debug_info.trigger_type);
+      EXPECT_EQ(expected[i].debug_info.confidence,
+                actual[i].debug_info.confidence);
+    }
+  }
+  EXPECT_GT(detections, 0u);
+}
+
+TEST_F(RegistrySnapshotTest, SkipsIdleUnwantedAndTrackedMints) {
+  const auto trades = makeTrades(1, 50, 0.0, false);
+  const auto now = DetectorRegistry::Clock::now();
+  DetectorRegistry before(RegistryOptions{.idle_ttl = 1h});
+  before.update("idle", trades, 1.0, DetectionParams{}, now - 2h);
+  before.update("unwanted", trades, 2.0, DetectionParams{}, now);
+  before.update("tracked", trades, 3.0, DetectionParams{}, now);
+  before.update("fresh", trades, 4.0, DetectionParams{}, now - 30min);
+  ASSERT_EQ(saveRegistrySnapshot(before, path_, WINDOW), 4u);
+
+  DetectorRegistry after(RegistryOptions{.idle_ttl = 1h});
+  after.update("tracked", trades, 9.0, DetectionParams{}, now);
+  const auto load = loadRegistrySnapshot(
+      after, path_, WINDOW,
+      [](std::string_view mint) { return mint != "unwanted"; });
+  EXPECT_EQ(load.restored, 1u);
+  EXPECT_EQ(load.skipped, 3u);
+  EXPECT_EQ(after.cursor("fresh").last_score, 4.0);
+  EXPECT_EQ(after.cursor("tracked").last_score, 9.0);
+  EXPECT_EQ(after.size(), 2u);
+
+  // fresh keeps its age: gone once an hour has passed since its update
+  EXPECT_EQ(after.evictIdle(DetectorRegistry::Clock::now() + 31min), 1u);
+  EXPECT_EQ(after.cursor("fresh").last_score, MintCursor{}.last_score);
+}
+
+TEST_F(RegistrySnapshotTest, RejectsCorruptAndMismatchedFiles) {
+  DetectorRegistry registry;
+  registry.update("a", makeTrades(1, 50, 0.3, false), 1.0, DetectionParams{});
+  saveRegistrySnapshot(registry, path_, WINDOW);
+
+  DetectorRegistry target;
+  EXPECT_THROW(loadRegistrySnapshot(target, path_, WINDOW + 1),
+               std::runtime_error);
+
+  std::ifstream in(path_, std::ios::binary);
+  std::string bytes((std::istreambuf_iterator<char>(in)), {});
+  in.close();
+  // Cut inside the index
+  std::ofstream(path_, std::ios::binary | std::ios::trunc)
+      .write(bytes.data(), static_cast<std::streamsize>(bytes.size() - 20));
+  EXPECT_THROW(loadRegistrySnapshot(target, path_, WINDOW),
+               std::runtime_error);
+
+  bytes[0] = 'X';
+  std::ofstream(path_, std::ios::binary | std::ios::trunc)
+      .write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+  EXPECT_THROW(loadRegistrySnapshot(target, path_, WINDOW),
+               std::runtime_error);
+  EXPECT_THROW(loadRegistrySnapshot(target, path_ + ".missing", WINDOW),
+               std::runtime_error);
+  EXPECT_EQ(target.size(), 0u);
+}
@@ -0,0 +1,76 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <vector>
+
+#include "detector_registry.hpp"
+#include "risk_priority.hpp"
+#include "trade.hpp"
+
+TEST(RiskPriorityTest, ClassifiesByDropTimeAndRate) {
+  // Near the stop loss, however quiet
+  EXPECT_EQ(classify({0.35, 600.0, 0.01}), RiskClass::High);
+  // Off the peak and still dumping fast
+  EXPECT_EQ(classify({0.15, 20.0, 5.0}), RiskClass::High);
+  // Off the peak, but slow or long past it
+  EXPECT_EQ(classify({0.15, 20.0, 0.5}), RiskClass::Medium);
+  EXPECT_EQ(classify({0.15, 300.0, 5.0}), RiskClass::Medium);
+  // Busy near the peak
+  EXPECT_EQ(classify({0.02, 3.0, 8.0}), RiskClass::Medium);
+  EXPECT_EQ(classify({0.02, 3.0, 0.2}), RiskClass::Low);
+  EXPECT_EQ(classify({}), RiskClass::Low);
+
+  RiskPolicy strict;
+  strict.high_drop = 0.2;
+  EXPECT_EQ(classify({0.25, 600.0, 0.0}, strict), RiskClass::High);
+  EXPECT_STREQ(riskClassName(RiskClass::Medium), "medium");
+}
+
+TEST(RiskPriorityTest, ParsesSignalsAfterAKey) {
+  const auto signals = parseRiskSignals("0.35 12.5  40");
+  ASSERT_TRUE(signals);
+  EXPECT_EQ(signals->drop_from_peak, 0.35);
+  EXPECT_EQ(signals->seconds_since_peak, 12.5);
+  EXPECT_EQ(signals->trades_per_second, 40.0);
+
+  EXPECT_FALSE(parseRiskSignals(""));
+  EXPECT_FALSE(parseRiskSignals("0.35 12.5"));
+  EXPECT_FALSE(parseRiskSignals("0.35 12.5 40 7"));
+  EXPECT_FALSE(parseRiskSignals("0.35 x 40"));
+  EXPECT_FALSE(parseRiskSignals("nan 1 1"));
+}
+
+TEST(RiskPriorityTest, RegistrySignalsFollowTheResidentTrades) {
+  using Clock = std::chrono::system_clock;
+  const auto start = Clock::from_time_t(1739184338);
+  // 20 trades a second for 10 s, peaking at 4 s, ending 30% below the peak
+  std::vector<Trade> trades;
+  for (int i = 0; i < 200; ++i) {
+    const double t = i * 0.05;
+    Trade trade;
+    trade.timestamp = start + std::chrono::milliseconds(i * 50);
+    trade.market_cap_sol = t <= 4.0 ? 100.0 + t * 10.0 : 140.0 - (t - 4.0) * 7;
+    trade.sol_amount = 1.0;
+    trades.push_back(trade);
+  }
+  // Stop-loss off, so the mint stays unreported
+  DetectionParams params;
+  params.stop_loss_threshold = 2.0;
+  params.min_confidence_score = 2.0;
+
+  DetectorRegistry registry;
+  EXPECT_FALSE(registry.riskSignals("mint"));
+  registry.update("mint", trades, 1.0, params);
+  const auto signals = registry.riskSignals("mint");
+  ASSERT_TRUE(signals);
+  EXPECT_NEAR(signals->drop_from_peak,
+              (140.0 - trades.back().market_cap_sol) / 140.0, 1e-12);
+  EXPECT_NEAR(signals->seconds_since_peak, 5.95, 1e-9);
+  EXPECT_NEAR(signals->trades_per_second, 200 / 9.95, 1e-9);
+  EXPECT_EQ(classify(*signals), RiskClass::High);
+
+  // Reported mints are not scheduled any more
+  params.stop_loss_threshold = 0.1;
+  registry.update("mint", std::vector<Trade>{trades.back()}, 2.0, params);
+  EXPECT_FALSE(registry.riskSignals("mint"));
+}
@@ -0,0 +1,201 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "detection_config.hpp"
+#include "rug_pull_detector.hpp"
+#include "simd_kernels.hpp"
+#include "trade_generators.hpp"
+#include "window_stats.hpp"
+
+namespace {
+
+using Clock = std::chrono::system_clock;
+
+double referenceConfidence(double drop, double time_diff, double pattern,
+                           double volume, const DetectionConfig &config) {
+  double price_conf = static_cast<double>(drop >= config.peak_drop_threshold);
+  double time_conf =
+      std::max(0.0, 1.0 - time_diff / config.time_from_peak_threshold);
+  double pattern_conf =
+      static_cast<double>(pattern >= config.pattern_strength_threshold);
+  double volume_conf =
+      static_cast<double>(volume >= config.volume_spike_threshold);
+  return 0.4 * price_conf * time_conf + 0.3 * pattern_conf + 0.3 * volume_conf;
+}
+
+// processTrades as it was before the incremental window: a binary-searched
+// window and a full-window reduction for every trade
+DetectionResult referenceDetect(const std::vector<Trade> &trades,
+                                const DetectionConfig &config) {
+  DetectionResult result;
+  if (trades.empty())
+    return result;
+
+  double peak_mc = 0.0;
+  Clock::time_point peak_time;
+  for (const auto &trade : trades) {
+    if (trade.market_cap_sol > peak_mc) {
+      peak_mc = trade.market_cap_sol;
+      peak_time = trade.timestamp;
+    }
+  }
+  TradeColumns columns;
+  for (const auto &trade : trades)
+    columns.push_back(trade);
+  const auto series = columns.view();
+  const int64_t analysis_start = toMicros(trades.front().timestamp);
+
+  auto detected = [&](const Trade &trade, const char *trigger,
+                      double confidence, double drop) {
+    result.rug_pulled = true;
+    result.timestamp = trade.timestamp;
+    result.debug_info.trigger_type = trigger;
+    result.debug_info.confidence = confidence;
+    result.debug_info.drop_percentage = drop * 100;
+    result.debug_info.peak_market_cap = peak_mc;
+    result.debug_info.current_market_cap = trade.market_cap_sol;
+    return result;
+  };
+
+  for (const auto &trade : trades) {
+    auto window = getRecentTrades(series, analysis_start,
+                                  toMicros(trade.timestamp),
+                                  DetectionConfig::max_detection_time);
+    const auto time_since_peak =
+        std::chrono::duration_cast<std::chrono::seconds>(trade.timestamp -
+                                                         peak_time)
+            .count();
+    const double drop =
+        peak_mc > 0 ? (peak_mc - trade.market_cap_sol) / peak_mc : 0;
+
+    if (drop >= config.stop_loss_threshold)
+      return detected(trade, "stop_loss", 1.0, drop);
+
+    if (window.size() > 1 && time_since_peak >= 5) {
+      const auto stats = computeWindowStats(window);
+      const double confidence =
+          referenceConfidence(drop, time_since_peak, stats.pattern_strength,
+                              stats.volume_trend, config);
+      if (confidence >= config.min_confidence_score)
+        return detected(trade, "pattern", confidence, drop);
+    }
+  }
+  return result;
+}
+
+void expectSameResult(const DetectionResult &expected,
+                      const DetectionResult &actual) {
+  EXPECT_EQ(expected.rug_pulled, actual.rug_pulled);
+  EXPECT_EQ(expected.timestamp, actual.timestamp);
+  EXPECT_EQ(expected.debug_info.trigger_type, actual.debug_info.trigger_type);
+  EXPECT_DOUBLE_EQ(expected.debug_info.confidence,
+                   actual.debug_info.confidence);
+  EXPECT_DOUBLE_EQ(expected.debug_info.drop_percentage,
+                   actual.debug_info.drop_percentage);
+  EXPECT_DOUBLE_EQ(expected.debug_info.peak_market_cap,
+                   actual.debug_info.peak_market_cap);
+  EXPECT_DOUBLE_EQ(expected.debug_info.current_market_cap,
+                   actual.debug_info.current_market_cap);
+}
+
+} // namespace
+
+TEST(SlidingWindowStatsTest, MatchesFullScanAtEveryTrade) {
+  for (bool whole_seconds : {true, false}) {
+    for (uint32_t seed = 1; seed <= 8; ++seed) {
+      const auto trades = makeTrades(seed, 2000, 0.3, whole_seconds);
+      TradeColumns columns;
+      for (const auto &trade : trades)
+        columns.push_back(trade);
+      const auto series = columns.view();
+      const int64_t analysis_start = columns.timestamp_us(0);
+      SlidingWindowStats engine;
+
+      for (size_t i = 0; i < columns.size(); ++i) {
+        const int64_t now = columns.timestamp_us(i);
+        engine.advance(series, analysis_start, now,
+                       DetectionConfig::max_detection_time);
+        const auto window = getRecentTrades(
+            series, analysis_start, now, DetectionConfig::max_detection_time);
+        ASSERT_EQ(window.timestamp_us.data(),
+                  engine.window(series).timestamp_us.data());
+        ASSERT_EQ(window.size(), engine.size());
+
+        // Bit for bit, so no threshold compare can go the other way
+        const auto expected = computeWindowStats(window);
+        const auto actual = engine.stats(series);
+        ASSERT_EQ(expected.consecutive_drops, actual.consecutive_drops);
+        ASSERT_EQ(expected.volume_trend, actual.volume_trend);
+        ASSERT_EQ(expected.price_velocity, actual.price_velocity);
+        ASSERT_EQ(expected.pattern_strength, actual.pattern_strength);
+
+        SlidingWindowStats restored;
+        restored.restore(series, engine.start(), engine.end());
+        ASSERT_EQ(restored.stats(series).volume_trend, actual.volume_trend);
+      }
+    }
+  }
+}
+
+TEST(RugPullDetectorTest, MatchesPerTradeReferenceScan) {
+  DetectionConfig config;
+  size_t detections = 0;
+
+  for (bool whole_seconds : {true, false}) {
+    for (double depth : {0.05, 0.3, 0.6}) {
+      for (uint32_t seed = 1; seed <= 10; ++seed) {
+        auto trades = makeTrades(seed, 1500, depth, whole_seconds);
+        const auto expected = referenceDetect(trades, config);
+
+        RugPullDetector detector;
+        for (auto trade : trades)
+          detector.addTrade(std::move(trade));
+        const auto actual = detector.processTrades(config);
+
+        expectSameResult(expected, actual);
+        detections += expected.rug_pulled;
+      }
+    }
+  }
+  // The corpus has to exercise the trigger paths to mean anything
+  EXPECT_GT(detections, 0u);
+}
+
+TEST(SimdKernelsTest, Avx2MatchesScalar) {
+  const auto *avx2 = simd::avx2Kernels();
+  if (!avx2)
+    GTEST_SKIP() << "CPU has no AVX2";
+  const auto &scalar = simd::scalarKernels();
+
+  std::mt19937 rng(42);
+  std::uniform_real_distribution<double> value(-50.0, 50.0);
+  // Odd sizes exercise the tail loops
+  for (size_t n : {0u, 1u, 2u, 5u, 8u, 13u, 64u, 1001u}) {
+    std::vector<double> in(n);
+    for (auto &v : in)
+      v = value(rng);
+    const size_t out_size = n > 0 ? n - 1 : 0;
+    std::vector<double> expected(out_size), actual(out_size);
+
+    scalar.deltas(in.data(), n, expected.data());
+    avx2->deltas(in.data(), n, actual.data());
+    EXPECT_EQ(expected, actual);
+
+    scalar.abs_deltas(in.data(), n, expected.data());
+    avx2->abs_deltas(in.data(), n, actual.data());
+    EXPECT_EQ(expected, actual);
+  }
+}
+
+TEST(TradeTest, ScoreKeepsMicrosecondOrdering) {
+  // Two spec scores inside the same second must stay distinct and ordered
+  const auto first = scoreToTimePoint(1739184338.6333098);
+  const auto second = scoreToTimePoint(1739184338.6333112);
+  EXPECT_LT(first, second);
+  EXPECT_EQ(toMicros(first), 1739184338633310);
+  EXPECT_EQ(fromMicros(toMicros(second)), second);
+}
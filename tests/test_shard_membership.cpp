@@ -0,0 +1,70 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "redis_client.hpp"
+#include "redis_fixture.hpp"
+#include "shard_membership.hpp"
+
+namespace {
+
+using namespace std::chrono_literals;
+using ShardMembershipTest = RedisTest;
+
+const std::string GROUP = "rugpull:test_shards";
+
+MembershipOptions member(const std::string &id,
+                         std::chrono::milliseconds lease = 10s) {
+  MembershipOptions options;
+  options.id = id;
+  options.group_key = GROUP;
+  options.lease = lease;
+  return options;
+}
+
+} // namespace
+
+TEST_F(ShardMembershipTest, MembersAgreeAndSplitTheKeys) {
+  redis_->del(GROUP);
+  RedisClient redis(redisUrl(), 2);
+  ShardMembership a(redis, member("a"));
+  ShardMembership b(redis, member("b"));
+  // a joined first and saw only itself
+  EXPECT_TRUE(a.refresh());
+  EXPECT_FALSE(b.refresh());
+  ASSERT_EQ(a.ring().members(), (std::vector<std::string>{"a", "b"}));
+  ASSERT_EQ(b.ring().members(), a.ring().members());
+
+  size_t owned_by_a = 0;
+  for (int i = 0; i < 1000; ++i) {
+    const auto key = "recent_trades:mint" + std::to_string(i);
+    EXPECT_NE(a.owns(key), b.owns(key)) << key;
+    owned_by_a += a.owns(key);
+  }
+  EXPECT_GT(owned_by_a, 350u);
+  EXPECT_LT(owned_by_a, 650u);
+}
+
+TEST_F(ShardMembershipTest, LeavingAndLapsedMembersHandOver) {
+  redis_->del(GROUP);
+  RedisClient redis(redisUrl(), 2);
+  ShardMembership a(redis, member("a", 500ms));
+  {
+    ShardMembership b(redis, member("b", 500ms));
+    EXPECT_TRUE(a.refresh());
+  }
+  // b left on the way out
+  EXPECT_TRUE(a.refresh());
+  EXPECT_EQ(a.ring().members(), (std::vector<std::string>{"a"}));
+
+  // c stops renewing: gone once its lease runs out
+  ShardMembership c(redis, member("c", 200ms));
+  EXPECT_TRUE(a.refresh());
+  std::this_thread::sleep_for(300ms);
+  EXPECT_TRUE(a.refresh());
+  EXPECT_EQ(a.ring().members(), (std::vector<std::string>{"a"}));
+  redis_->del(GROUP);
+}
@@ -0,0 +1,113 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "redis_client.hpp"
+#include "shard_ring.hpp"
+
+namespace {
+
+std::vector<std::string> makeKeys(size_t count) {
+  std::vector<std::string> keys;
+  keys.reserve(count);
+  for (size_t i = 0; i < count; ++i)
+    keys.push_back("recent_trades:mint" + std::to_string(i * 7919) + "pump");
+  return keys;
+}
+
+std::vector<std::string> makeMembers(size_t count) {
+  std::vector<std::string> members;
+  for (size_t i = 0; i < count; ++i)
+    members.push_back("detector-" + std::to_string(i));
+  return members;
+}
+
+} // namespace
+
+TEST(ShardRingTest, HashIsFixed) {
+  // Pinned so that processes built at different times agree
+  EXPECT_EQ(shardHash(""), 0xefd01f60ba992926ULL);
+  EXPECT_EQ(shardHash("recent_trades:abc"), 0x78170e142b130a4dULL);
+  EXPECT_NE(shardHash("recent_trades:a"), shardHash("recent_trades:b"));
+}
+
+TEST(ShardRingTest, EmptyRingOwnsNothing) {
+  ShardRing ring;
+  EXPECT_EQ(ring.owner("recent_trades:x"), nullptr);
+  EXPECT_FALSE(ring.owns("detector-0", "recent_trades:x"));
+}
+
+TEST(ShardRingTest, SameMembersSameAssignment) {
+  auto members = makeMembers(5);
+  ShardRing a(members);
+  std::reverse(members.begin(), members.end());
+  members.push_back(members.front());
+  ShardRing b(members);
+
+  EXPECT_EQ(a.members(), b.members());
+  for (const auto &key : makeKeys(2000))
+    EXPECT_EQ(*a.owner(key), *b.owner(key)) << key;
+}
+
+TEST(ShardRingTest, SpreadsKeysEvenly) {
+  const auto keys = makeKeys(100'000);
+  for (size_t n : {2, 4, 8}) {
+    ShardRing ring(makeMembers(n));
+    std::map<std::string, size_t> counts;
+    for (const auto &key : keys)
+      ++counts[*ring.owner(key)];
+
+    ASSERT_EQ(counts.size(), n);
+    const double fair = static_cast<double>(keys.size()) / n;
+    for (const auto &[member, count] : counts) {
+      EXPECT_GT(count, 0.8 * fair) << member << " of " << n;
+      EXPECT_LT(count, 1.2 * fair) << member << " of " << n;
+    }
+  }
+}
+
+TEST(ShardRingTest, JoinAndLeaveMoveOnlyTheirShare) {
+  const auto keys = makeKeys(50'000);
+  auto members = makeMembers(4);
+  ShardRing before(members);
+  members.push_back("detector-new");
+  ShardRing after(members);
+
+  // A join only takes keys for the new member, about 1/5 of them
+  size_t moved = 0;
+  for (const auto &key : keys) {
+    const auto &old_owner = *before.owner(key);
+    const auto &new_owner = *after.owner(key);
+    if (old_owner != new_owner) {
+      EXPECT_EQ(new_owner, "detector-new") << key;
+      ++moved;
+    }
+  }
+  EXPECT_GT(moved, keys.size() / 5 * 8 / 10);
+  EXPECT_LT(moved, keys.size() / 5 * 12 / 10);
+
+  // A leave only hands out the leaving member's keys
+  members = makeMembers(4);
+  members.erase(members.begin() + 1);
+  ShardRing left(members);
+  for (const auto &key : keys) {
+    if (*before.owner(key) != "detector-1") {
+      EXPECT_EQ(*left.owner(key), *before.owner(key)) << key;
+    }
+  }
+}
+
+TEST(ClusterSlotTest, MatchesRedis) {
+  // CLUSTER KEYSLOT on a real server
+  EXPECT_EQ(clusterSlot("foo"), 12182);
+  EXPECT_EQ(clusterSlot("bar"), 5061);
+  EXPECT_EQ(clusterSlot("123456789"), 12739);
+
+  // Only a non-empty hash tag is hashed
+  EXPECT_EQ(clusterSlot("{user1000}.following"), clusterSlot("user1000"));
+  EXPECT_EQ(clusterSlot("recent_trades:{7}a"), clusterSlot("recent_trades:{7}b"));
+  EXPECT_EQ(clusterSlot("{}foo"), 9500);
+}
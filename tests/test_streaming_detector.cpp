@@ -0,0 +1,145 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <span>
+#include <thread>
+#include <vector>
+
+#include "rug_pull_detector.hpp"
+#include "streaming_detector.hpp"
+#include "trade_generators.hpp"
+#include "trade_ring.hpp"
+
+namespace {
+
+void expectSameResult(const DetectionResult &actual,
+                      const DetectionResult &expected) {
+  ASSERT_EQ(actual.rug_pulled, expected.rug_pulled);
+  if (!expected.rug_pulled)
+    return;
+  EXPECT_EQ(actual.timestamp, expected.timestamp);
+  EXPECT_EQ(actual.debug_info.trigger_type, expected.debug_info.trigger_type);
+  EXPECT_DOUBLE_EQ(actual.debug_info.drop_percentage,
+                   expected.debug_info.drop_percentage);
+  EXPECT_DOUBLE_EQ(actual.debug_info.confidence,
+                   expected.debug_info.confidence);
+}
+
+// Sideways trading with small noise, about one trade a second
+std::vector<Trade> makeSidewaysTrades(uint32_t seed, size_t count) {
+  std::mt19937 rng(seed);
+  std::uniform_real_distribution<double> noise(-0.01, 0.01);
+  std::uniform_int_distribution<int64_t> gap_us(500'000, 1'500'000);
+
+  std::vector<Trade> trades;
+  auto timestamp = std::chrono::system_clock::from_time_t(1739184338);
+  for (size_t i = 0; i < count; ++i) {
+    Trade trade;
+    trade.timestamp = timestamp;
+    trade.market_cap_sol = 100.0 * (1.0 + noise(rng));
+    trade.sol_amount = 1.0;
+    trades.push_back(trade);
+    timestamp += std::chrono::microseconds(gap_us(rng));
+  }
+  return trades;
+}
+
+} // namespace
+
+TEST(TradeRingTest, RunsStayContiguousAcrossTheWrap) {
+  TradeRing ring(8);
+  size_t released = 0;
+  for (int64_t i = 0; i < 100; ++i) {
+    ASSERT_TRUE(ring.tryPush(i, static_cast<double>(i), 0.0));
+    if (ring.published() - released == ring.capacity()) {
+      EXPECT_FALSE(ring.tryPush(-1, 0.0, 0.0));
+      const auto run = ring.view(released, ring.published());
+      ASSERT_EQ(run.size(), ring.capacity());
+      for (size_t j = 0; j < run.size(); ++j)
+        EXPECT_EQ(run.timestamp_us[j], static_cast<int64_t>(released + j));
+      released += 5;
+      ring.release(released);
+    }
+  }
+}
+
+TEST(StreamingDetectorTest, MatchesDetectorAcrossChunkSizes) {
+  const DetectionParams params;
+  for (uint32_t seed = 0; seed < 8; ++seed) {
+    const auto trades = makeTrades(seed, 400, 0.6, seed % 2 == 0);
+    for (size_t chunk_size : {1, 7, 64, 400}) {
+      SCOPED_TRACE(testing::Message()
+                   << "seed " << seed << " chunk " << chunk_size);
+      RugPullDetector detector;
+      StreamingDetector streaming(512);
+      const std::span<const Trade> all(trades);
+      bool detected = false;
+      for (size_t begin = 0; begin < trades.size() && !detected;
+           begin += chunk_size) {
+        const auto chunk =
+            all.subspan(begin, std::min(chunk_size, trades.size() - begin));
+        for (const auto &trade : chunk) {
+          ASSERT_TRUE(streaming.addTrade(trade));
+          detector.addTrade(Trade(trade));
+        }
+        const auto expected = detector.processTrades(params);
+        expectSameResult(streaming.processTrades(params), expected);
+        detected = expected.rug_pulled;
+      }
+      EXPECT_TRUE(detected);
+      EXPECT_EQ(streaming.droppedTrades(), 0u);
+    }
+  }
+}
+
+TEST(StreamingDetectorTest, RetainsOnlyTheWindow) {
+  // Two days at about a trade a second through a ring of 256
+  const auto trades = makeSidewaysTrades(3, 170'000);
+  const DetectionParams params;
+  StreamingDetector streaming(256);
+  const size_t bytes = streaming.bytes();
+
+  size_t most_retained = 0;
+  for (size_t i = 0; i < trades.size(); ++i) {
+    ASSERT_TRUE(streaming.addTrade(trades[i]));
+    if (i % 16 == 15) {
+      EXPECT_FALSE(streaming.processTrades(params).rug_pulled);
+      most_retained = std::max(most_retained, streaming.retainedTrades());
+    }
+  }
+  EXPECT_EQ(streaming.droppedTrades(), 0u);
+  EXPECT_EQ(streaming.bytes(), bytes);
+  // max_detection_time + 1 seconds of trades at one or two a second, plus
+  // one chunk in flight
+  EXPECT_LE(most_retained,
+            static_cast<size_t>(2 * (params.max_detection_time + 1) + 16));
+}
+
+TEST(StreamingDetectorTest, FeederAndScorerRunConcurrently) {
+  const auto trades = makeSidewaysTrades(5, 200'000);
+  const DetectionParams params;
+  StreamingDetector streaming(1024);
+  std::atomic<bool> fed{false};
+
+  std::thread feeder([&] {
+    for (const auto &trade : trades) {
+      // Spin rather than drop: the scorer frees room as it goes
+      while (!streaming.addTrade(trade))
+        std::this_thread::yield();
+    }
+    fed = true;
+  });
+
+  bool detected = false;
+  while (!fed.load()) {
+    detected |= streaming.processTrades(params).rug_pulled;
+  }
+  feeder.join();
+  detected |= streaming.processTrades(params).rug_pulled;
+
+  EXPECT_FALSE(detected);
+  EXPECT_LE(streaming.retainedTrades(), streaming.capacity());
+}
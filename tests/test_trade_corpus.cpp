@@ -0,0 +1,151 @@
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "batch_detector.hpp"
+#include "rug_pull_detector.hpp"
+#include "trade_corpus.hpp"
+#include "trade_generators.hpp"
+
+namespace {
+
+class TradeCorpusTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    path_ = ::testing::TempDir() + "trade_corpus_test_" +
+            ::testing::UnitTest::GetInstance()->current_test_info()->name() +
+            ".bin";
+  }
+  void TearDown() override { std::remove(path_.c_str()); }
+
+  std::string path_;
+};
+
+} // namespace
+
+TEST_F(TradeCorpusTest, RoundTripsColumnsAndNames) {
+  std::vector<std::vector<Trade>> mints;
+  for (uint32_t seed = 1; seed <= 5; ++seed)
+    mints.push_back(makeTrades(seed, 100 * seed, 0.3, seed % 2 == 0));
+  mints.insert(mints.begin() + 2, std::vector<Trade>{}); // empty mint
+
+  {
+    TradeCorpusWriter writer(path_);
+    for (size_t m = 0; m < mints.size(); ++m)
+      writer.addMint("recent_trades:mint_" + std::to_string(m), mints[m]);
+  }
+
+  TradeCorpus corpus(path_);
+  ASSERT_EQ(corpus.mintCount(), mints.size());
+  uint64_t total = 0;
+  for (size_t m = 0; m < mints.size(); ++m) {
+    EXPECT_EQ(corpus.mintName(m), "recent_trades:mint_" + std::to_string(m));
+    EXPECT_EQ(corpus.find(corpus.mintName(m)), m);
+
+    const auto series = corpus.series(m);
+    ASSERT_EQ(series.size(), mints[m].size());
+    for (size_t i = 0; i < series.size(); ++i) {
+      EXPECT_EQ(series.timestamp_us[i], toMicros(mints[m][i].timestamp));
+      EXPECT_EQ(series.market_cap_sol[i], mints[m][i].market_cap_sol);
+      EXPECT_EQ(series.sol_amount[i], mints[m][i].sol_amount);
+    }
+    total += mints[m].size();
+  }
+  EXPECT_EQ(corpus.tradeCount(), total);
+  EXPECT_FALSE(corpus.find("recent_trades:unknown"));
+}
+
+TEST_F(TradeCorpusTest, ReplayMatchesDetectorFedFromMemory) {
+  std::vector<std::vector<Trade>> mints;
+  for (double depth : {0.05, 0.3, 0.6})
+    for (uint32_t seed = 1; seed <= 4; ++seed)
+      mints.push_back(makeTrades(seed, 900, depth, seed % 2 == 0));
+  {
+    TradeCorpusWriter writer(path_);
+    for (size_t m = 0; m < mints.size(); ++m)
+      writer.addMint(std::to_string(m), mints[m]);
+  }
+
+  TradeCorpus corpus(path_);
+  const auto replayed = detectCorpus(corpus, DetectionConfig{}, 2);
+  ASSERT_EQ(replayed.size(), mints.size());
+
+  size_t detections = 0;
+  for (size_t m = 0; m < mints.size(); ++m) {
+    RugPullDetector detector;
+    for (auto trade : mints[m])
+      detector.addTrade(std::move(trade));
+    const auto expected = detector.processTrades(DetectionConfig{});
+
+    SCOPED_TRACE(m);
+    EXPECT_EQ(expected.rug_pulled, replayed[m].rug_pulled);
+    EXPECT_EQ(expected.timestamp, replayed[m].timestamp);
+    EXPECT_EQ(expected.debug_info.trigger_type,
+              replayed[m].debug_info.trigger_type);
+    EXPECT_EQ(expected.debug_info.confidence,
+              replayed[m].debug_info.confidence);
+    detections += expected.rug_pulled;
+  }
+  EXPECT_GT(detections, 0u);
+}
+
+TEST_F(TradeCorpusTest, RejectsTruncatedAndForeignFiles) {
+  {
+    TradeCorpusWriter writer(path_);
+    writer.addMint("a", makeTrades(1, 50, 0.3, false));
+  }
+  std::ifstream in(path_, std::ios::binary);
+  std::string bytes((std::istreambuf_iterator<char>(in)), {});
+  in.close();
+
+  // Cut inside the index
+  std::ofstream(path_, std::ios::binary | std::ios::trunc)
+      .write(bytes.data(), static_cast<std::streamsize>(bytes.size() - 20));
+  EXPECT_THROW(TradeCorpus{path_}, std::runtime_error);
+
+  bytes[0] = 'X';
+  std::ofstream(path_, std::ios::binary | std::ios::trunc)
+      .write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+  EXPECT_THROW(TradeCorpus{path_}, std::runtime_error);
+
+  EXPECT_THROW(TradeCorpus{path_ + ".missing"}, std::runtime_error);
+}
+
+TEST_F(TradeCorpusTest, RejectsIndexEntriesOutsideTheBlocks) {
+  {
+    TradeCorpusWriter writer(path_);
+    writer.addMint("a", makeTrades(1, 50, 0.3, false));
+    writer.addMint("b", makeTrades(2, 50, 0.3, false));
+  }
+  std::ifstream in(path_, std::ios::binary);
+  const std::string bytes((std::istreambuf_iterator<char>(in)), {});
+  in.close();
+  CorpusHeader header;
+  std::memcpy(&header, bytes.data(), sizeof(header));
+  const size_t second = header.index_offset + sizeof(CorpusIndexEntry);
+
+  // Each edit of the second entry must be caught, overflow included
+  const auto corrupt = [&](size_t field, uint64_t value) {
+    std::string edited = bytes;
+    std::memcpy(&edited[second + field], &value, sizeof(value));
+    std::ofstream(path_, std::ios::binary | std::ios::trunc)
+        .write(edited.data(), static_cast<std::streamsize>(edited.size()));
+    EXPECT_THROW(TradeCorpus{path_}, std::runtime_error) << field << ": " << value;
+  };
+  constexpr size_t BLOCK_OFFSET = offsetof(CorpusIndexEntry, block_offset);
+  constexpr size_t TRADE_COUNT = offsetof(CorpusIndexEntry, trade_count);
+  constexpr size_t NAME_OFFSET = offsetof(CorpusIndexEntry, name_offset);
+  constexpr size_t NAME_LENGTH = offsetof(CorpusIndexEntry, name_length);
+  corrupt(TRADE_COUNT, 51);                      // runs into the index
+  corrupt(TRADE_COUNT, (uint64_t{1} << 63) / 3); // count * 24 wraps
+  corrupt(BLOCK_OFFSET, header.index_offset);
+  corrupt(BLOCK_OFFSET, 1204);                   // misaligned
+  corrupt(BLOCK_OFFSET, ~uint64_t{0});
+  corrupt(NAME_OFFSET, header.names_size);
+  corrupt(NAME_LENGTH, ~uint64_t{0});
+}
@@ -0,0 +1,169 @@
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+#include <string>
+
+#include <nlohmann/json.hpp>
+
+#include "trade_decoder.hpp"
+#include "trade_record.hpp"
+
+namespace {
+
+// Example record from docs/REDIS_SPEC.md
+const std::string SPEC_RECORD = R"({
+  "signature": "5PEnuUTTiqyEoeXtSdFPC38pY1bFCXFAFXKq52WQBCUPzC8sJLhxNDxPDB9YBrQWZDxB6GTzJcPKH399ZpwUP1LY",
+  "mint": "14k7LpDRKvyVuMWfGe1vB5ByoQh1yUQPetApMBLuzw1f",
+  "traderPublicKey": "3c6KJRkWtYoGHokK1x1YrYUsNUT672J3RHRgsodhC6KJ",
+  "txType": "sell",
+  "tokenAmount": 36189.104326,
+  "solAmount": 0.001014365,
+  "newTokenBalance": 0,
+  "bondingCurveKey": "2bQpbWV1FYiddhyEceQf3FuviVPd4JQKYnptHnCEGKR5",
+  "vTokensInBondingCurve": 1071666285.328535,
+  "vSolInBondingCurve": 30.03733572726111,
+  "marketCapSol": 28.028628070587033,
+  "pool": "pump",
+  "timestamp": 1739184338.6333098,
+  "human_readable_time": "2025-02-10T10:45:38.633337+00:00"
+})";
+
+} // namespace
+
+TEST(TradeDecoderTest, DecodesSpecRecordLikeFullParser) {
+  TradeFields fields;
+  ASSERT_TRUE(decodeTradeFields(SPEC_RECORD, fields));
+
+  auto trade_json = nlohmann::json::parse(SPEC_RECORD);
+  EXPECT_EQ(fields.market_cap_sol, trade_json["marketCapSol"].get<double>());
+  EXPECT_EQ(fields.sol_amount, trade_json["solAmount"].get<double>());
+}
+
+TEST(TradeDecoderTest, SkipsNestedAndEscapedValues) {
+  const std::string member =
+      R"({"note":"a \"quoted\" } value","extra":{"marketCapSol":[1,{"x":"]"}]},)"
+      R"("solAmount":2.5e-3,"flags":[true,false,null],"marketCapSol":-1.25})";
+  TradeFields fields;
+  ASSERT_TRUE(decodeTradeFields(member, fields));
+  EXPECT_DOUBLE_EQ(fields.market_cap_sol, -1.25);
+  EXPECT_DOUBLE_EQ(fields.sol_amount, 0.0025);
+}
+
+TEST(TradeDecoderTest, RejectsWhatItCannotHandle) {
+  TradeFields fields;
+  EXPECT_FALSE(decodeTradeFields(R"({"marketCapSol":1.0})", fields));
+  EXPECT_FALSE(decodeTradeFields(R"({"marketCapSol":"1.0","solAmount":2})",
+                                 fields));
+  EXPECT_FALSE(
+      decodeTradeFields(R"({"marketCapSol":1.0,"solAmount":2} x)", fields));
+  EXPECT_FALSE(decodeTradeFields(R"({"marketCapSol":1.0,"solAmount":)", fields));
+  EXPECT_FALSE(decodeTradeFields("", fields));
+  // Unknown fields must still hold valid JSON values
+  EXPECT_FALSE(decodeTradeFields(
+      R"({"x": garbage,"marketCapSol":1.0,"solAmount":2})", fields));
+  EXPECT_FALSE(decodeTradeFields(
+      R"({"x":nan,"marketCapSol":1.0,"solAmount":2})", fields));
+  EXPECT_FALSE(decodeTradeFields(
+      R"({"x":truex,"marketCapSol":1.0,"solAmount":2})", fields));
+  EXPECT_THROW(
+      decodeTradeMember(R"({"x": garbage,"marketCapSol":1.0,"solAmount":2})"),
+      nlohmann::json::exception);
+}
+
+TEST(TradeDecoderTest, RejectsNumbersAndContainersJsonDoesNot) {
+  // Each is invalid JSON; the fast path must not accept it either, so
+  // decodeTradeMember reports it through nlohmann
+  const std::string tail = R"(,"marketCapSol":1.0,"solAmount":2})";
+  for (const std::string value :
+       {"01", "-01", "1.", "-.5", ".5", "-", "1e", "1e+", "+1", "0x10",
+        "[1}", "{\"a\":1]", R"({"a" 1})", R"({"a":1 "b":2})", "[1 2]",
+        "[1,]", R"({"a":1,})", "[", R"({1:2})", R"(["\q"])"}) {
+    SCOPED_TRACE(value);
+    const std::string member = R"({"x":)" + value + tail;
+    TradeFields fields;
+    EXPECT_FALSE(decodeTradeFields(member, fields));
+    EXPECT_THROW(decodeTradeMember(member), nlohmann::json::exception);
+  }
+  for (const std::string value : {"01", "-01", "1.", "-.5", "1e"}) {
+    SCOPED_TRACE(value);
+    const std::string member =
+        R"({"solAmount":2,"marketCapSol":)" + value + "}";
+    TradeFields fields;
+    EXPECT_FALSE(decodeTradeFields(member, fields));
+    EXPECT_THROW(decodeTradeMember(member), nlohmann::json::exception);
+  }
+}
+
+TEST(TradeDecoderTest, SkipsEveryJsonNumberAndContainerForm) {
+  const std::string member =
+      R"({"x":[0,-0,0.5,-0.5e+3,1E-2,10,[],{},[{}],{"a":[1,{"b":null}]}],)"
+      R"("y" : { "a" : 1 , "b" : [ "é\n" ] } ,)"
+      R"("marketCapSol":-0.0,"solAmount":1e2})";
+  TradeFields fields;
+  ASSERT_TRUE(decodeTradeFields(member, fields));
+  EXPECT_EQ(fields.market_cap_sol, 0.0);
+  EXPECT_EQ(fields.sol_amount, 100.0);
+}
+
+TEST(TradeDecoderTest, FallsBackToFullParser) {
+  // Escaped key names are legal JSON the fast path leaves to nlohmann
+  const std::string escaped_key = R"({"market\u0043apSol":1.5,"solAmount":2})";
+  TradeFields fast;
+  EXPECT_FALSE(decodeTradeFields(escaped_key, fast));
+
+  auto fields = decodeTradeMember(escaped_key);
+  EXPECT_DOUBLE_EQ(fields.market_cap_sol, 1.5);
+  EXPECT_DOUBLE_EQ(fields.sol_amount, 2.0);
+
+  EXPECT_THROW(decodeTradeMember(R"({"marketCapSol":1.0,)"),
+               nlohmann::json::exception);
+  EXPECT_THROW(decodeTradeMember(R"({"marketCapSol":"1.0","solAmount":2})"),
+               nlohmann::json::exception);
+}
+
+TEST(TradeRecordTest, RoundTripsBitExact) {
+  const int64_t timestamp_us = 1739184338633309;
+  const std::string record =
+      encodeTradeRecord(timestamp_us, 28.028628070587033, 0.001014365);
+  ASSERT_EQ(record.size(), TRADE_RECORD_SIZE);
+  EXPECT_TRUE(isTradeRecord(record));
+
+  TradeFields fields;
+  ASSERT_TRUE(decodeTradeRecord(record, fields));
+  EXPECT_EQ(fields.market_cap_sol, 28.028628070587033);
+  EXPECT_EQ(fields.sol_amount, 0.001014365);
+  EXPECT_EQ(tradeRecordTimestamp(record), timestamp_us);
+
+  // Little-endian on the wire whatever the host
+  EXPECT_EQ(static_cast<uint8_t>(record[2]),
+            static_cast<uint8_t>(timestamp_us & 0xFF));
+}
+
+TEST(TradeRecordTest, RejectsTruncatedAndUnknownVersions) {
+  const std::string record = encodeTradeRecord(1, 2.0, 3.0);
+  TradeFields fields;
+  EXPECT_FALSE(decodeTradeRecord(record.substr(0, TRADE_RECORD_SIZE - 1),
+                                 fields));
+  EXPECT_FALSE(decodeTradeRecord(record + '\0', fields));
+
+  std::string future = record;
+  future[1] = static_cast<char>(TRADE_RECORD_VERSION + 1);
+  EXPECT_FALSE(decodeTradeRecord(future, fields));
+  EXPECT_THROW(decodeTradeMember(future), std::invalid_argument);
+
+  EXPECT_FALSE(isTradeRecord(SPEC_RECORD));
+  EXPECT_FALSE(decodeTradeRecord(SPEC_RECORD, fields));
+}
+
+TEST(TradeRecordTest, MemberDecoderReadsBothFormats) {
+  auto trade_json = nlohmann::json::parse(SPEC_RECORD);
+  const double market_cap = trade_json["marketCapSol"].get<double>();
+  const double sol_amount = trade_json["solAmount"].get<double>();
+
+  auto from_json = decodeTradeMember(SPEC_RECORD);
+  auto from_binary =
+      decodeTradeMember(encodeTradeRecord(1739184338633309, market_cap,
+                                          sol_amount));
+  EXPECT_EQ(from_json.market_cap_sol, from_binary.market_cap_sol);
+  EXPECT_EQ(from_json.sol_amount, from_binary.sol_amount);
+}
@@ -0,0 +1,278 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "metrics.hpp"
+#include "trade_processor.hpp"
+#include "work_stealing_deque.hpp"
+
+TEST(WorkStealingDequeTest, OwnerPopsLifoAndThievesStealFifo) {
+  WorkStealingDeque<int> deque(2);
+  for (int i = 0; i < 10; ++i)
+    deque.push(i); // grows past the initial capacity
+
+  EXPECT_EQ(deque.steal(), 0);
+  EXPECT_EQ(deque.pop(), 9);
+  EXPECT_EQ(deque.sizeApprox(), 8u);
+}
+
+TEST(WorkStealingDequeTest, EveryItemTakenExactlyOnce) {
+  constexpr int ITEMS = 200000;
+  WorkStealingDeque<int> deque(64);
+  std::vector<std::atomic<int>> taken(ITEMS);
+  std::atomic<bool> done{false};
+
+  std::vector<std::thread> thieves;
+  for (int t = 0; t < 3; ++t) {
+    thieves.emplace_back([&] {
+      while (!done.load()) {
+        if (auto item = deque.steal())
+          taken[*item].fetch_add(1);
+      }
+    });
+  }
+
+  for (int i = 0; i < ITEMS; ++i) {
+    deque.push(i);
+    if (i % 3 == 0) {
+      if (auto item = deque.pop())
+        taken[*item].fetch_add(1);
+    }
+  }
+  while (auto item = deque.pop())
+    taken[*item].fetch_add(1);
+  done = true;
+  for (auto &thief : thieves)
+    thief.join();
+
+  for (int i = 0; i < ITEMS; ++i)
+    ASSERT_EQ(taken[i].load(), 1) << "item " << i;
+}
+
+TEST(TradeProcessorTest, RunsEveryTaskOnceBeforeDestruction) {
+  constexpr int TASKS = 50000;
+  std::mutex mutex;
+  std::multiset<std::string> seen;
+  {
+    TradeProcessor processor(4, [&](size_t, const std::string &key) {
+      std::lock_guard<std::mutex> lock(mutex);
+      seen.insert(key);
+    }, 64); // small injection queue to exercise producer backpressure
+    for (int i = 0; i < TASKS; ++i)
+      processor.addTask("key:" + std::to_string(i));
+  }
+
+  ASSERT_EQ(seen.size(), static_cast<size_t>(TASKS));
+  for (int i = 0; i < TASKS; ++i)
+    EXPECT_EQ(seen.count("key:" + std::to_string(i)), 1u);
+}
+
+TEST(TradeProcessorTest, WakesParkedWorkersForLateTasks) {
+  std::atomic<int> done{0};
+  TradeProcessor processor(
+      3, [&](size_t, const std::string &) { done.fetch_add(1); });
+
+  // Let every worker park, then trickle tasks in one at a time
+  for (int i = 0; i < 20; ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    processor.addTask("late");
+    const auto deadline =
+        std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (done.load() <= i && std::chrono::steady_clock::now() < deadline)
+      std::this_thread::yield();
+    ASSERT_EQ(done.load(), i + 1) << "task " << i << " was not picked up";
+  }
+}
+
+TEST(TradeProcessorTest, SpreadsWorkAcrossWorkers) {
+  std::vector<std::atomic<int>> per_worker(4);
+  {
+    TradeProcessor processor(4, [&](size_t worker, const std::string &) {
+      per_worker[worker].fetch_add(1);
+      std::this_thread::sleep_for(std::chrono::microseconds(200));
+    });
+    for (int i = 0; i < 400; ++i)
+      processor.addTask("slow");
+  }
+
+  int busy = 0;
+  for (auto &count : per_worker)
+    busy += count.load() > 0;
+  EXPECT_GT(busy, 1);
+}
+
+TEST(TradeProcessorTest, HandlerExceptionsDoNotKillWorkers) {
+  std::atomic<int> done{0};
+  {
+    TradeProcessor processor(1, [&](size_t, const std::string &key) {
+      if (key == "bad")
+        throw std::runtime_error("boom");
+      done.fetch_add(1);
+    });
+    processor.addTask("bad");
+    processor.addTask("good");
+  }
+  EXPECT_EQ(done.load(), 1);
+}
+
+TEST(TradeProcessorTest, PinsWorkersAndSetsThemUpOnTheirOwnThreads) {
+  const auto cpus = pinningOrder();
+  constexpr size_t WORKERS = 3;
+  std::vector<std::thread::id> setup_thread(WORKERS);
+  std::vector<std::atomic<int>> wrong_thread(WORKERS);
+  std::vector<std::atomic<int>> wrong_cpu(WORKERS);
+
+  TradeProcessorOptions options;
+  options.pin_workers = true;
+  options.on_worker_start = [&](size_t worker) {
+    setup_thread[worker] = std::this_thread::get_id();
+  };
+  {
+    TradeProcessor processor(
+        WORKERS,
+        [&](size_t worker, const std::string &) {
+          wrong_thread[worker] +=
+              setup_thread[worker] != std::this_thread::get_id();
+          if (!cpus.empty())
+            wrong_cpu[worker] +=
+                currentCpu() != cpus[worker % cpus.size()].cpu;
+        },
+        options);
+    for (int i = 0; i < 300; ++i)
+      processor.addTask("key");
+
+    // Counts trail the handler slightly
+    uint64_t total = 0;
+    for (int spins = 0; total < 300 && spins < 10000; ++spins) {
+      total = 0;
+      for (const auto &stats : processor.workerStats())
+        total += stats.tasks;
+      std::this_thread::yield();
+    }
+    EXPECT_EQ(total, 300u);
+
+    const auto stats = processor.workerStats();
+    ASSERT_EQ(stats.size(), WORKERS);
+    for (const auto &worker : stats) {
+      EXPECT_GE(worker.utilization, 0.0);
+      EXPECT_LE(worker.utilization, 1.0);
+      if (!cpus.empty()) {
+        EXPECT_EQ(worker.cpu, cpus[worker.worker_id % cpus.size()].cpu);
+      }
+    }
+  }
+  for (size_t i = 0; i < WORKERS; ++i) {
+    EXPECT_EQ(wrong_thread[i].load(), 0) << "worker " << i;
+    EXPECT_EQ(wrong_cpu[i].load(), 0) << "worker " << i;
+  }
+}
+
+namespace {
+
+// Holds the only worker inside its first task until released
+struct Gate {
+  std::atomic<bool> entered{false};
+  std::atomic<bool> open{false};
+
+  void pass() {
+    entered = true;
+    while (!open)
+      std::this_thread::yield();
+  }
+  void waitEntered() const {
+    while (!entered)
+      std::this_thread::yield();
+  }
+};
+
+} // namespace
+
+TEST(TradeProcessorTest, HigherRiskTasksOvertakeQueuedOnes) {
+  Gate gate;
+  std::mutex mutex;
+  std::vector<char> order;
+  {
+    TradeProcessor processor(1, [&](size_t, const std::string &key) {
+      if (key == "gate")
+        gate.pass();
+      std::lock_guard<std::mutex> lock(mutex);
+      order.push_back(key[0]);
+    });
+    processor.addTask("gate", RiskClass::Low);
+    gate.waitEntered();
+    for (int i = 0; i < 40; ++i)
+      processor.addTask("low", RiskClass::Low);
+    for (int i = 0; i < 5; ++i)
+      processor.addTask("medium");
+    processor.addTask("high", RiskClass::High);
+    gate.open = true;
+  }
+
+  const std::string expected =
+      "g" "h" + std::string(5, 'm') + std::string(40, 'l');
+  EXPECT_EQ(std::string(order.begin(), order.end()), expected);
+}
+
+TEST(TradeProcessorTest, ShedsLateLowRiskTasksAndCountsDeadlineMisses) {
+  const auto before = metrics::snapshot();
+  Gate gate;
+  std::atomic<int> high{0};
+  std::atomic<int> low{0};
+  TradeProcessorOptions options;
+  options.injection_capacity = 8;
+  options.deadlines = {std::chrono::milliseconds(5),
+                       std::chrono::milliseconds(5),
+                       std::chrono::milliseconds(5)};
+  options.shed_low_risk = true;
+  uint64_t shed = 0;
+  {
+    TradeProcessor processor(
+        1,
+        [&](size_t, const std::string &key) {
+          if (key == "gate")
+            gate.pass();
+          else
+            (key == "high" ? high : low).fetch_add(1);
+        },
+        options);
+    processor.addTask("gate", RiskClass::High);
+    gate.waitEntered();
+
+    // The Low queue holds 8; the rest are shed at once instead of waiting
+    size_t accepted = 0;
+    for (int i = 0; i < 20; ++i)
+      accepted += processor.addTask("low", RiskClass::Low);
+    EXPECT_EQ(accepted, 8u);
+    for (int i = 0; i < 3; ++i)
+      EXPECT_TRUE(processor.addTask("high", RiskClass::High));
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    gate.open = true;
+    // Everything queued is now past its deadline
+    while (high.load() < 3 || processor.shedTasks() < 20)
+      std::this_thread::yield();
+    shed = processor.shedTasks();
+  }
+
+  EXPECT_EQ(high.load(), 3);
+  EXPECT_EQ(low.load(), 0);
+  EXPECT_EQ(shed, 20u);
+  const auto after = metrics::snapshot();
+  using metrics::Counter;
+  EXPECT_EQ(after.counter(Counter::TasksShed) -
+                before.counter(Counter::TasksShed),
+            20u);
+  // The gate and the three queued behind it
+  EXPECT_EQ(after.counter(Counter::DeadlineMissesHigh) -
+                before.counter(Counter::DeadlineMissesHigh),
+            4u);
+  EXPECT_EQ(after.counter(Counter::DeadlineMissesLow) -
+                before.counter(Counter::DeadlineMissesLow),
+            0u);
+}
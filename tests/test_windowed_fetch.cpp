@@ -0,0 +1,142 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "key_worker.hpp"
+#include "metrics.hpp"
+#include "redis_client.hpp"
+#include "redis_fixture.hpp"
+#include "trade_generators.hpp"
+
+namespace {
+
+using WindowedFetchTest = RedisTest;
+
+// Hours of quiet trading ahead of a makeTrades pump and dump, so a full
+// fetch carries far more history than detection needs
+std::vector<Trade> withHistory(uint32_t seed, size_t history, size_t tail,
+                               double dump_depth) {
+  std::mt19937 rng(seed);
+  std::uniform_real_distribution<double> noise(-0.01, 0.01);
+  std::uniform_real_distribution<double> amount(0.1, 2.0);
+
+  auto pump = makeTrades(seed, tail, dump_depth, seed % 2 == 0);
+  std::vector<Trade> trades;
+  auto timestamp = pump.front().timestamp - std::chrono::seconds(2 * history);
+  for (size_t i = 0; i < history; ++i) {
+    trades.push_back({timestamp, 75.0 * (1.0 + noise(rng)), amount(rng)});
+    timestamp += std::chrono::seconds(2);
+  }
+  trades.insert(trades.end(), pump.begin(), pump.end());
+  return trades;
+}
+
+void expectSameCheck(const KeyWorker::Check &actual,
+                     const KeyWorker::Check &expected) {
+  EXPECT_EQ(actual.trade_count, expected.trade_count);
+  ASSERT_EQ(actual.result.rug_pulled, expected.result.rug_pulled);
+  if (!expected.result.rug_pulled)
+    return;
+  EXPECT_EQ(actual.result.timestamp, expected.result.timestamp);
+  EXPECT_EQ(actual.result.debug_info.trigger_type,
+            expected.result.debug_info.trigger_type);
+  EXPECT_DOUBLE_EQ(actual.result.debug_info.confidence,
+                   expected.result.debug_info.confidence);
+  EXPECT_DOUBLE_EQ(actual.result.debug_info.drop_percentage,
+                   expected.result.debug_info.drop_percentage);
+  EXPECT_DOUBLE_EQ(actual.result.debug_info.peak_market_cap,
+                   expected.result.debug_info.peak_market_cap);
+  EXPECT_DOUBLE_EQ(actual.result.debug_info.current_market_cap,
+                   expected.result.debug_info.current_market_cap);
+}
+
+uint64_t tradesDecoded() {
+  return metrics::snapshot().counter(metrics::Counter::TradesDecoded);
+}
+
+} // namespace
+
+TEST_F(WindowedFetchTest, MatchesFullFetch) {
+  RedisClient redis(redisUrl(), 2);
+  KeyWorker full_worker, windowed_worker;
+  const std::string key = "recent_trades:test_windowed";
+
+  size_t detections = 0;
+  for (uint32_t seed = 0; seed < 12; ++seed) {
+    // Shallow dumps never fire, moderate ones fire by pattern, deep ones by
+    // stop loss; short histories fit in one page, long ones need several
+    for (double depth : {0.05, 0.3, 0.7}) {
+      for (size_t history : {0, 200, 3000}) {
+        SCOPED_TRACE(testing::Message() << "seed " << seed << " depth "
+                                        << depth << " history " << history);
+        setTrades(key, withHistory(seed, history, 400, depth));
+
+        const auto expected =
+            full_worker.check(redis, key, DetectionParams{});
+        const auto actual =
+            windowed_worker.checkWindowed(redis, key, DetectionParams{});
+        expectSameCheck(actual, expected);
+        detections += expected.result.rug_pulled;
+      }
+    }
+  }
+  EXPECT_GT(detections, 0u);
+}
+
+TEST_F(WindowedFetchTest, FetchesOnlyTheWindow) {
+  RedisClient redis(redisUrl(), 2);
+  KeyWorker worker;
+  const std::string key = "recent_trades:test_windowed_bytes";
+  const DetectionParams params;
+
+  // Same crash behind one, ten and a hundred thousand quiet trades
+  std::vector<uint64_t> fetched;
+  for (size_t history : {1'000, 10'000, 100'000}) {
+    setTrades(key, withHistory(7, history, 400, 0.7));
+    const uint64_t before = tradesDecoded();
+    const auto check = worker.checkWindowed(redis, key, params);
+    fetched.push_back(tradesDecoded() - before);
+
+    ASSERT_TRUE(check.result.rug_pulled);
+    EXPECT_EQ(check.trade_count, history + 400);
+    EXPECT_LE(fetched.back(), 2 * WINDOWED_PAGE_SIZE);
+  }
+  EXPECT_EQ(fetched.front(), fetched.back());
+}
+
+TEST_F(WindowedFetchTest, PagesAcrossTiedScores) {
+  // Whole-second scores, 37 trades a second, so page boundaries fall inside
+  // runs of equal scores. A plateau 15% below the peak is a candidate from
+  // 5 s after it, but only the stop loss at the end fires, several pages
+  // later. Its market caps are all distinct, so the result pins down which
+  // trade fired, and a trade lost or repeated at a page boundary shows.
+  const std::string key = "recent_trades:test_windowed_ties";
+  RedisClient redis(redisUrl(), 2);
+  KeyWorker full_worker, windowed_worker;
+
+  for (size_t shift = 0; shift < 37; shift += 4) {
+    SCOPED_TRACE(testing::Message() << "shift " << shift);
+    std::vector<Trade> trades;
+    auto timestamp = std::chrono::system_clock::from_time_t(1739184338);
+    const size_t plateau = 2 * WINDOWED_PAGE_SIZE;
+    const size_t crash = plateau + 3 * WINDOWED_PAGE_SIZE + shift;
+    for (size_t i = 0; i < crash + 100; ++i) {
+      const double market_cap = i < plateau  ? 100.0
+                                : i < crash ? 85.0
+                                            : 55.0 - 0.01 * (i - crash);
+      trades.push_back({timestamp, market_cap, 0.5 + (i % 7) * 0.3});
+      if (i % 37 == 36)
+        timestamp += std::chrono::seconds(1);
+    }
+    setTrades(key, trades);
+
+    const auto expected = full_worker.check(redis, key, DetectionParams{});
+    ASSERT_TRUE(expected.result.rug_pulled);
+    EXPECT_EQ(expected.result.debug_info.trigger_type, "stop_loss");
+    expectSameCheck(windowed_worker.checkWindowed(redis, key, DetectionParams{}),
+                    expected);
+  }
+}
@@ -0,0 +1,41 @@
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "trade.hpp"
+
+// Pump-then-dump price path with noise. With whole_seconds the timestamps
+// look like the truncated Redis scores (lots of ties); otherwise they carry
+// microseconds.
+inline std::vector<Trade> makeTrades(uint32_t seed, size_t count,
+                                     double dump_depth, bool whole_seconds) {
+  std::mt19937 rng(seed);
+  std::uniform_real_distribution<double> noise(-0.02, 0.02);
+  std::uniform_real_distribution<double> amount(0.001, 4.0);
+  std::uniform_int_distribution<int64_t> gap_us(1, 3'000'000);
+
+  std::vector<Trade> trades;
+  trades.reserve(count);
+  using Clock = std::chrono::system_clock;
+  auto timestamp = Clock::from_time_t(1739184338);
+  const size_t peak_at = count * 2 / 5;
+
+  for (size_t i = 0; i < count; ++i) {
+    const double level =
+        i < peak_at
+            ? 0.75 + 0.25 * static_cast<double>(i) / peak_at
+            : 1.0 - dump_depth * std::min(1.0, (i - peak_at) / 60.0);
+    Trade trade;
+    trade.timestamp =
+        whole_seconds ? Clock::from_time_t(Clock::to_time_t(timestamp))
+                      : timestamp;
+    trade.market_cap_sol = 100.0 * level * (1.0 + noise(rng));
+    trade.sol_amount = amount(rng);
+    trades.push_back(trade);
+    timestamp += std::chrono::microseconds(gap_us(rng));
+  }
+  return trades;
+}